@@ -69,6 +69,10 @@ parseEPECOptions(
      modelTypeHelp.str().c_str())
     ("model", po::value(&opt.modelIndex)->default_value(opt.modelIndex),
      "select which model of a given type to run")
+    ("threads", po::value(&opt.threadCount)->default_value(opt.threadCount),
+     "number of threads used to fit indel model contexts")
+    ("starts", po::value(&opt.startCount)->default_value(opt.startCount),
+     "number of minimizer start points tried for each indel model context, the best fit is reported")
     ;
 
     po::options_description help("help");
@@ -123,5 +127,14 @@ parseEPECOptions(
     {
         usage(log_os,prog,visible,"Counts file does not exist");
     }
+
+    if (opt.threadCount < 1)
+    {
+        usage(log_os,prog,visible,"Thread count must be at least 1");
+    }
+    if (opt.startCount < 1)
+    {
+        usage(log_os,prog,visible,"Start point count must be at least 1");
+    }
 }
 
@@ -63,6 +63,12 @@ struct EPECOptions
 
     MODEL_TYPE::index_t modelType = MODEL_TYPE::NONE;
     int modelIndex = 1;
+
+    /// number of threads used to fit indel model contexts
+    unsigned threadCount = 1;
+
+    /// number of minimizer start points tried for each indel model context
+    unsigned startCount = 1;
 };
 
 
@@ -55,23 +55,23 @@ runEPEC(
         }
         else if (opt.modelIndex == 2)
         {
-            indelModelVariantAndIndyError(counts);
+            indelModelVariantAndIndyError(counts, opt);
         }
         else if (opt.modelIndex == 3)
         {
-            indelModelVariantAndBinomialMixtureError(counts);
+            indelModelVariantAndBinomialMixtureError(counts, opt);
         }
         else if (opt.modelIndex == 4)
         {
-            indelModelVariantAndIndyErrorNoOverlap(counts);
+            indelModelVariantAndIndyErrorNoOverlap(counts, opt);
         }
         else if (opt.modelIndex == 5)
         {
-            indelModelVariantAndBinomialMixtureErrorNoOverlap(counts);
+            indelModelVariantAndBinomialMixtureErrorNoOverlap(counts, opt);
         }
         else if (opt.modelIndex == 6)
         {
-            indelModelVariantAndBetaBinomialError(counts);
+            indelModelVariantAndBetaBinomialError(counts, opt);
         }
         else
         {
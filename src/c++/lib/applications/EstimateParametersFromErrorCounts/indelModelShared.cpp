@@ -0,0 +1,150 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "indelModelShared.hh"
+
+#include "blt_util/WorkerThreadPool.hh"
+#include "blt_util/log.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <sstream>
+
+
+
+void
+getIndelObservationHistogram(
+    const std::vector<ExportedIndelObservations>& observations,
+    std::vector<ExportedIndelObservations>& histogram)
+{
+    typedef std::pair<double, boost::array<unsigned,INDEL_SIGNAL_TYPE::SIZE>> pattern_t;
+    std::map<pattern_t, unsigned> patternCounts;
+    for (const ExportedIndelObservations& obs : observations)
+    {
+        patternCounts[std::make_pair(obs.refObservations, obs.altObservations)] += obs.observationCount;
+    }
+
+    histogram.clear();
+    ExportedIndelObservations histObs;
+    for (const auto& value : patternCounts)
+    {
+        histObs.refObservations = value.first.first;
+        histObs.altObservations = value.first.second;
+        histObs.observationCount = value.second;
+        histogram.push_back(histObs);
+    }
+}
+
+
+
+void
+perturbMinimizerStart(
+    const unsigned startIndex,
+    const unsigned dim,
+    double* minParams)
+{
+    if (startIndex == 0) return;
+
+    // minimizer parameters are log-scaled, so this shifts each parameter by up to a factor of e^2 in either direction:
+    static const double maxOffset(2.);
+    std::mt19937 randGen(startIndex);
+    std::uniform_real_distribution<double> offsetDist(-maxOffset, maxOffset);
+    for (unsigned paramIndex(0); paramIndex<dim; ++paramIndex)
+    {
+        minParams[paramIndex] += offsetDist(randGen);
+    }
+}
+
+
+
+/// true if the negative log-likelihood of fit a is better than b, any NaN score is worse than all others
+static
+bool
+isBetterFit(
+    const double a,
+    const double b)
+{
+    if (std::isnan(a)) return false;
+    if (std::isnan(b)) return true;
+    return (a < b);
+}
+
+
+
+void
+fitIndelContexts(
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt,
+    const IndelContextFitFunction& fitContext,
+    std::ostream& os)
+{
+    struct ContextObservations
+    {
+        const IndelErrorContext* context;
+        const IndelErrorData* data;
+        std::vector<ExportedIndelObservations> histogram;
+    };
+
+    std::vector<ContextObservations> contexts;
+    {
+        std::vector<ExportedIndelObservations> observations;
+        for (const auto& contextInfo : counts.getIndelCounts())
+        {
+            contextInfo.second.exportObservations(observations);
+            if (observations.empty()) continue;
+
+            log_os << "INFO: computing rates for context: " << contextInfo.first << "\n";
+            contexts.push_back(ContextObservations{&contextInfo.first, &contextInfo.second, {}});
+            getIndelObservationHistogram(observations, contexts.back().histogram);
+        }
+    }
+
+    // each task fits one context from one start point:
+    const unsigned startCount(opt.startCount);
+    const unsigned taskCount(contexts.size() * startCount);
+    std::vector<double> taskScore(taskCount);
+    std::vector<std::string> taskReport(taskCount);
+
+    WorkerThreadPool pool(std::min(opt.threadCount, taskCount));
+    pool.run(taskCount, [&](const unsigned taskIndex, const unsigned /*threadIndex*/)
+    {
+        const ContextObservations& contextObs(contexts[taskIndex / startCount]);
+        std::ostringstream oss;
+        taskScore[taskIndex] = fitContext(*contextObs.context, contextObs.histogram, *contextObs.data,
+                                          (taskIndex % startCount), oss);
+        taskReport[taskIndex] = oss.str();
+    });
+
+    for (unsigned contextIndex(0); contextIndex<contexts.size(); ++contextIndex)
+    {
+        const unsigned beginTaskIndex(contextIndex * startCount);
+        unsigned bestTaskIndex(beginTaskIndex);
+        for (unsigned taskIndex(beginTaskIndex+1); taskIndex<(beginTaskIndex + startCount); ++taskIndex)
+        {
+            if (isBetterFit(taskScore[taskIndex], taskScore[bestTaskIndex])) bestTaskIndex = taskIndex;
+        }
+        os << taskReport[bestTaskIndex];
+    }
+}
@@ -0,0 +1,77 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "EPECOptions.hh"
+#include "errorAnalysis/SequenceErrorCounts.hh"
+
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+
+/// collapse observations with identical ref and alt observation counts into a single histogram entry
+///
+/// the indel error models only use the ref and alt counts of each observation, so variant status
+/// is not part of the histogram key and is set to UNKNOWN for all histogram entries
+void
+getIndelObservationHistogram(
+    const std::vector<ExportedIndelObservations>& observations,
+    std::vector<ExportedIndelObservations>& histogram);
+
+
+/// move a model's standard minimizer start point to the start point for startIndex
+///
+/// start 0 is the standard start point and is left unchanged, every other start applies a
+/// deterministic pseudo-random offset to each of the first dim minimizer parameters
+void
+perturbMinimizerStart(
+    const unsigned startIndex,
+    const unsigned dim,
+    double* minParams);
+
+
+/// fit an indel model to one context from the given start point
+///
+/// the function should write the report for this fit to os, and return the total negative
+/// log-likelihood of the fitted model, which is used to select the best start point
+typedef std::function<double(
+    const IndelErrorContext& context,
+    const std::vector<ExportedIndelObservations>& observationHistogram,
+    const IndelErrorData& data,
+    const unsigned startIndex,
+    std::ostream& os)> IndelContextFitFunction;
+
+
+/// fit an indel model to every context which has observations
+///
+/// every combination of context and start point is fit independently over a pool of
+/// opt.threadCount threads. The report of the best fit among all start points for each
+/// context is written to os in context order.
+void
+fitIndelContexts(
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt,
+    const IndelContextFitFunction& fitContext,
+    std::ostream& os);
@@ -22,6 +22,7 @@
 ///
 
 #include "indelModelVariantAndBetaBinomialError.hh"
+#include "indelModelShared.hh"
 
 #include "blt_util/log.hh"
 #include "blt_util/math_util.hh"
@@ -398,12 +399,13 @@ reportIndelErrorRateSet(
 
 
 static
-void
+double
 reportExtendedContext(
     const bool isLockTheta,
     const IndelErrorContext& context,
     const std::vector<ExportedIndelObservations>& observations,
     const IndelErrorData& data,
+    const unsigned startIndex,
     std::ostream& os)
 {
     // Get summary counts for QC purposes. Note these are unrelated to minimization or model:
@@ -416,6 +418,7 @@ reportExtendedContext(
 
     // initialize conjugate direction minimizer settings and minimize lhood...
     //
+    double totalLoghood(0.);
     for (unsigned indelTypeIndex(0); indelTypeIndex<2; ++indelTypeIndex)
     {
         const bool isInsert(indelTypeIndex==0);
@@ -438,6 +441,7 @@ reportExtendedContext(
 
             std::fill(conjDir,conjDir+SIZE2,0.);
             const unsigned dim(isLockTheta ? MIN_PARAMS4::SIZE-1 : MIN_PARAMS4::SIZE);
+            perturbMinimizerStart(startIndex, dim, minParams);
             for (unsigned dimIndex(0); dimIndex<dim; ++dimIndex)
             {
                 conjDir[dimIndex*(dim+1)] = 0.0005;
@@ -462,7 +466,11 @@ reportExtendedContext(
             const std::string tag(isInsert ? "I" : "D");
             reportIndelErrorRateSet(context, tag.c_str(), sigInsertTotal, data, iter, -x_all_loghood, indelErrorMean, indelErrorConcentration, theta, os);
         }
+
+        totalLoghood += x_all_loghood;
     }
+
+    return totalLoghood;
 }
 
 }
@@ -471,7 +479,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndBetaBinomialError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt)
 {
     const bool isLockTheta(false);
 
@@ -479,19 +488,15 @@ indelModelVariantAndBetaBinomialError(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, alpha, beta, mean, concentration, theta\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto fitContext = [&](
+                          const IndelErrorContext& context,
+                          const std::vector<ExportedIndelObservations>& observations,
+                          const IndelErrorData& data,
+                          const unsigned startIndex,
+                          std::ostream& os)
     {
-        const auto& context(contextInfo.first);
-        const auto& data(contextInfo.second);
+        return reportExtendedContext(isLockTheta, context, observations, data, startIndex, os);
+    };
 
-        //if (context.repeatCount != 15) continue;
-
-        data.exportObservations(observations);
-
-        if (observations.empty()) continue;
-
-        log_os << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+    fitIndelContexts(counts, opt, fitContext, ros);
 }
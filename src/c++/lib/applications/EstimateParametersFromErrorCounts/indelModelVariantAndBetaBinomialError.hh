@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "EPECOptions.hh"
 #include "errorAnalysis/SequenceErrorCounts.hh"
 
 
@@ -30,4 +31,5 @@
 ///
 void
 indelModelVariantAndBetaBinomialError(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt);
@@ -25,6 +25,7 @@
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
 #include "indelModelVariantAndBinomialMixtureError.hh"
+#include "indelModelShared.hh"
 
 //#define CODEMIN_DEBUG
 #define CODEMIN_USE_BOOST
@@ -414,12 +415,13 @@ reportIndelErrorRateSet(
 
 
 static
-void
+double
 reportExtendedContext(
     const bool isLockTheta,
     const IndelErrorContext& context,
     const std::vector<ExportedIndelObservations>& observations,
     const IndelErrorData& data,
+    const unsigned startIndex,
     std::ostream& os)
 {
     // Get summary counts for QC purposes. Note these are unrelated to minimization or model:
@@ -452,6 +454,7 @@ reportExtendedContext(
 
         std::fill(conjDir, conjDir + SIZE2, 0.);
         const unsigned dim(isLockTheta ? MIN_PARAMS3::SIZE - 1 : MIN_PARAMS3::SIZE);
+        perturbMinimizerStart(startIndex, dim, minParams);
         for (unsigned i(0); i < dim; ++i)
         {
             conjDir[i * (dim + 1)] = 0.0005;
@@ -479,6 +482,8 @@ reportExtendedContext(
         const double deleteErrorRate(std::exp(normalizedParams[MIN_PARAMS3::LN_DELETE_ERROR_RATE]));
         reportIndelErrorRateSet(context, "D", sigDeleteTotal, data, iter, -x_all_loghood, deleteErrorRate, theta, noisyLocusRate, os);
     }
+
+    return x_all_loghood;
 }
 
 }
@@ -487,7 +492,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndBinomialMixtureError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt)
 {
     const bool isLockTheta(false);
 
@@ -495,17 +501,15 @@ indelModelVariantAndBinomialMixtureError(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, errorRate, theta, noisyLocusRate\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto fitContext = [&](
+                          const IndelErrorContext& context,
+                          const std::vector<ExportedIndelObservations>& observations,
+                          const IndelErrorData& data,
+                          const unsigned startIndex,
+                          std::ostream& os)
     {
-        const auto& context(contextInfo.first);
-        const auto& data(contextInfo.second);
+        return reportExtendedContext(isLockTheta, context, observations, data, startIndex, os);
+    };
 
-        data.exportObservations(observations);
-
-        if (observations.empty()) continue;
-
-        log_os << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+    fitIndelContexts(counts, opt, fitContext, ros);
 }
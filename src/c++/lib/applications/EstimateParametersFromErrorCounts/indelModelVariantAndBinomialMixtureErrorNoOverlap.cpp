@@ -22,6 +22,7 @@
 ///
 
 #include "indelModelVariantAndBinomialMixtureErrorNoOverlap.hh"
+#include "indelModelShared.hh"
 
 #include "blt_util/log.hh"
 #include "blt_util/math_util.hh"
@@ -349,12 +350,13 @@ reportIndelErrorRateSet(
 
 
 static
-void
+double
 reportExtendedContext(
     const bool isLockTheta,
     const IndelErrorContext& context,
     const std::vector<ExportedIndelObservations>& observations,
     const IndelErrorData& data,
+    const unsigned startIndex,
     std::ostream& os)
 {
     // Get summary counts for QC purposes. Note these are unrelated to minimization or model:
@@ -367,6 +369,7 @@ reportExtendedContext(
 
     // initialize conjugate direction minimizer settings and minimize lhood...
     //
+    double totalLoghood(0.);
     for (unsigned indelTypeIndex(0); indelTypeIndex<2; ++indelTypeIndex)
     {
         const bool isInsert(indelTypeIndex==0);
@@ -389,6 +392,7 @@ reportExtendedContext(
 
             std::fill(conjDir,conjDir+SIZE2,0.);
             const unsigned dim(isLockTheta ? MIN_PARAMS3::SIZE-1 : MIN_PARAMS3::SIZE);
+            perturbMinimizerStart(startIndex, dim, minParams);
             for (unsigned i(0); i<dim; ++i)
             {
                 conjDir[i*(dim+1)] = 0.0005;
@@ -414,7 +418,11 @@ reportExtendedContext(
             const std::string tag(isInsert ? "I" : "D");
             reportIndelErrorRateSet(context, tag.c_str(), sigInsertTotal, data, iter, -x_all_loghood, noisyLocusIndelErrorRate, noisyLocusRate, theta, os);
         }
+
+        totalLoghood += x_all_loghood;
     }
+
+    return totalLoghood;
 }
 
 }
@@ -423,7 +431,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndBinomialMixtureErrorNoOverlap(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt)
 {
     const bool isLockTheta(false);
 
@@ -431,17 +440,15 @@ indelModelVariantAndBinomialMixtureErrorNoOverlap(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, noisyErrorRate, cleanErrorRate, noisyLocusRate, simpleErrorRate, theta, \n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto fitContext = [&](
+                          const IndelErrorContext& context,
+                          const std::vector<ExportedIndelObservations>& observations,
+                          const IndelErrorData& data,
+                          const unsigned startIndex,
+                          std::ostream& os)
     {
-        const auto& context(contextInfo.first);
-        const auto& data(contextInfo.second);
+        return reportExtendedContext(isLockTheta, context, observations, data, startIndex, os);
+    };
 
-        data.exportObservations(observations);
-
-        if (observations.empty()) continue;
-
-        log_os << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+    fitIndelContexts(counts, opt, fitContext, ros);
 }
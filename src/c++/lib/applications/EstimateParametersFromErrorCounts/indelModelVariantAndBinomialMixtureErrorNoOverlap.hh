@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "EPECOptions.hh"
 #include "errorAnalysis/SequenceErrorCounts.hh"
 
 
@@ -32,4 +33,5 @@
 /// alleles at one locus
 void
 indelModelVariantAndBinomialMixtureErrorNoOverlap(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt);
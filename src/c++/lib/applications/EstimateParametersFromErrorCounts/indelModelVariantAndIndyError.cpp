@@ -22,6 +22,7 @@
 ///
 
 #include "indelModelVariantAndIndyError.hh"
+#include "indelModelShared.hh"
 
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
@@ -340,12 +341,13 @@ reportIndelErrorRateSet(
 
 
 static
-void
+double
 reportExtendedContext(
     const bool isLockTheta,
     const IndelErrorContext& context,
     const std::vector<ExportedIndelObservations>& observations,
     const IndelErrorData& data,
+    const unsigned startIndex,
     std::ostream& os)
 {
     // Get summary counts for QC purposes. Note these are unrelated to minimization or model:
@@ -377,6 +379,7 @@ reportExtendedContext(
 
         std::fill(conjDir,conjDir+SIZE2,0.);
         const unsigned dim(isLockTheta ? MIN_PARAMS::SIZE-1 : MIN_PARAMS::SIZE);
+        perturbMinimizerStart(startIndex, dim, minParams);
         for (unsigned i(0); i<dim; ++i)
         {
             conjDir[i*(dim+1)] = 0.001;
@@ -403,6 +406,8 @@ reportExtendedContext(
         const double deleteErrorRate(std::exp(normalizedParams[MIN_PARAMS::LN_DELETE_ERROR_RATE]));
         reportIndelErrorRateSet(context, "D", sigDeleteTotal, data, iter, -x_all_loghood, deleteErrorRate, theta, os);
     }
+
+    return x_all_loghood;
 }
 
 }
@@ -411,7 +416,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndIndyError(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt)
 {
     const bool isLockTheta(false);
 
@@ -419,17 +425,15 @@ indelModelVariantAndIndyError(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, rate, theta\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto fitContext = [&](
+                          const IndelErrorContext& context,
+                          const std::vector<ExportedIndelObservations>& observations,
+                          const IndelErrorData& data,
+                          const unsigned startIndex,
+                          std::ostream& os)
     {
-        const auto& context(contextInfo.first);
-        const auto& data(contextInfo.second);
+        return reportExtendedContext(isLockTheta, context, observations, data, startIndex, os);
+    };
 
-        data.exportObservations(observations);
-
-        if (observations.empty()) continue;
-
-        std::cerr << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+    fitIndelContexts(counts, opt, fitContext, ros);
 }
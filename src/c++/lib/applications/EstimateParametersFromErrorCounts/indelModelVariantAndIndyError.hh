@@ -23,10 +23,12 @@
 
 #pragma once
 
+#include "EPECOptions.hh"
 #include "errorAnalysis/SequenceErrorCounts.hh"
 
 
 /// model data as a mixture of variants and an independent error process
 void
 indelModelVariantAndIndyError(
-    const SequenceErrorCounts& counts);
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt);
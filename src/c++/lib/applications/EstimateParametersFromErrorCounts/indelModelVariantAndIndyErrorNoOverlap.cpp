@@ -24,6 +24,7 @@
 #include "blt_util/math_util.hh"
 #include "blt_util/prob_util.hh"
 #include "indelModelVariantAndIndyErrorNoOverlap.hh"
+#include "indelModelShared.hh"
 
 #define CODEMIN_USE_BOOST
 #include "minimize_conj_direction.h"
@@ -260,12 +261,13 @@ reportIndelErrorRateSet(
 
 
 static
-void
+double
 reportExtendedContext(
     const bool isLockTheta,
     const IndelErrorContext& context,
     const std::vector<ExportedIndelObservations>& observations,
     const IndelErrorData& data,
+    const unsigned startIndex,
     std::ostream& os)
 {
     // Get summary counts for QC purposes. Note these are unrelated to minimization or model:
@@ -278,6 +280,7 @@ reportExtendedContext(
 
     // initialize conjugate direction minimizer settings and minimize lhood...
     //
+    double totalLoghood(0.);
     for (unsigned indelTypeIndex(0); indelTypeIndex<2; ++indelTypeIndex)
     {
         const bool isInsert(indelTypeIndex==0);
@@ -300,6 +303,7 @@ reportExtendedContext(
 
             std::fill(conjDir,conjDir+SIZE2,0.);
             const unsigned dim(isLockTheta ? MIN_PARAMS::SIZE-1 : MIN_PARAMS::SIZE);
+            perturbMinimizerStart(startIndex, dim, minParams);
             for (unsigned dimIndex(0); dimIndex<dim; ++dimIndex)
             {
                 conjDir[dimIndex*(dim+1)] = 0.001;
@@ -324,7 +328,11 @@ reportExtendedContext(
             const std::string tag(isInsert ? "I" : "D");
             reportIndelErrorRateSet(context, tag.c_str(), sigInsertTotal, data, iter, -x_all_loghood, indelErrorRate, theta, os);
         }
+
+        totalLoghood += x_all_loghood;
     }
+
+    return totalLoghood;
 }
 
 }
@@ -333,7 +341,8 @@ reportExtendedContext(
 
 void
 indelModelVariantAndIndyErrorNoOverlap(
-    const SequenceErrorCounts& counts)
+    const SequenceErrorCounts& counts,
+    const EPECOptions& opt)
 {
     const bool isLockTheta(false);
 
@@ -341,17 +350,15 @@ indelModelVariantAndIndyErrorNoOverlap(
 
     ros << "context, excludedLoci, nonExcludedLoci, usedLoci, refReads, altReads, iter, lhood, rate, theta\n";
 
-    std::vector<ExportedIndelObservations> observations;
-    for (const auto& contextInfo : counts.getIndelCounts())
+    auto fitContext = [&](
+                          const IndelErrorContext& context,
+                          const std::vector<ExportedIndelObservations>& observations,
+                          const IndelErrorData& data,
+                          const unsigned startIndex,
+                          std::ostream& os)
     {
-        const auto& context(contextInfo.first);
-        const auto& data(contextInfo.second);
+        return reportExtendedContext(isLockTheta, context, observations, data, startIndex, os);
+    };
 
-        data.exportObservations(observations);
-
-        if (observations.empty()) continue;
-
-        std::cerr << "INFO: computing rates for context: " << context << "\n";
-        reportExtendedContext(isLockTheta, context, observations, data, ros);
-    }
+    fitIndelContexts(counts, opt, fitContext, ros);
 }
@@ -30,6 +30,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <numeric>
 #include <set>
 
@@ -48,11 +49,11 @@ struct ContextTotal
 
 
 
-template <typename K, typename V>
+template <typename M1, typename K, typename V>
 static
 void
 mergeMapKeys(
-    const std::map<K,V>& m1,
+    const M1& m1,
     std::map<K,V>& m2,
     const unsigned scale = 1)
 {
@@ -82,7 +83,7 @@ printExtendedContext(
     const ContextTotal& cTotal,
     const double refReadTotal,
     const double noiseLocusRefReadTotal,
-    const StrandBaseCounts::qual_count_t& noiseLocusAltQualCounts,
+    const std::map<uint16_t,unsigned>& noiseLocusAltQualCounts,
     std::ostream& os)
 {
     static const std::string sep(", ");
@@ -154,7 +155,7 @@ reportExtendedContext(
     //
     double refReadTotal(0);
     double noiseLocusRefReadTotal(0);
-    StrandBaseCounts::qual_count_t noiseLocusAltQualCounts;
+    std::map<uint16_t,unsigned> noiseLocusAltQualCounts;
 
     ContextTotal cTotal;
     for (const auto& value : data.error)
@@ -0,0 +1,245 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "indelModelShared.hh"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( indelModelShared_test )
+
+
+static
+ExportedIndelObservations
+getTestObservation(
+    const double refObservations,
+    const unsigned deleteObservations,
+    const unsigned observationCount,
+    const GENOTYPE_STATUS::genotype_t variantStatus)
+{
+    ExportedIndelObservations obs;
+    obs.refObservations = refObservations;
+    std::fill(obs.altObservations.begin(), obs.altObservations.end(), 0);
+    obs.altObservations[INDEL_SIGNAL_TYPE::DELETE_1] = deleteObservations;
+    obs.observationCount = observationCount;
+    obs.variantStatus = variantStatus;
+    return obs;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_getIndelObservationHistogram )
+{
+    // observations with the same ref and alt counts are combined regardless of variant status, and
+    // each histogram entry is weighted by the sum of the combined observation counts:
+    const std::vector<ExportedIndelObservations> observations =
+    {
+        getTestObservation(10, 1, 3, GENOTYPE_STATUS::UNKNOWN),
+        getTestObservation(5, 0, 2, GENOTYPE_STATUS::HET),
+        getTestObservation(10, 1, 4, GENOTYPE_STATUS::HOMALT),
+        getTestObservation(10, 2, 1, GENOTYPE_STATUS::UNKNOWN),
+        getTestObservation(5, 0, 7, GENOTYPE_STATUS::UNKNOWN)
+    };
+
+    std::vector<ExportedIndelObservations> histogram;
+    histogram.push_back(getTestObservation(1, 1, 1, GENOTYPE_STATUS::UNKNOWN));
+    getIndelObservationHistogram(observations, histogram);
+
+    BOOST_REQUIRE_EQUAL(histogram.size(), 3u);
+
+    BOOST_REQUIRE_EQUAL(histogram[0].refObservations, 5.);
+    BOOST_REQUIRE_EQUAL(histogram[0].altObservations[INDEL_SIGNAL_TYPE::DELETE_1], 0u);
+    BOOST_REQUIRE_EQUAL(histogram[0].observationCount, 9u);
+
+    BOOST_REQUIRE_EQUAL(histogram[1].refObservations, 10.);
+    BOOST_REQUIRE_EQUAL(histogram[1].altObservations[INDEL_SIGNAL_TYPE::DELETE_1], 1u);
+    BOOST_REQUIRE_EQUAL(histogram[1].observationCount, 7u);
+
+    BOOST_REQUIRE_EQUAL(histogram[2].refObservations, 10.);
+    BOOST_REQUIRE_EQUAL(histogram[2].altObservations[INDEL_SIGNAL_TYPE::DELETE_1], 2u);
+    BOOST_REQUIRE_EQUAL(histogram[2].observationCount, 1u);
+
+    unsigned totalCount(0);
+    for (const auto& histObs : histogram)
+    {
+        BOOST_REQUIRE_EQUAL(histObs.variantStatus, GENOTYPE_STATUS::UNKNOWN);
+        totalCount += histObs.observationCount;
+    }
+    BOOST_REQUIRE_EQUAL(totalCount, 17u);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_perturbMinimizerStart )
+{
+    static const unsigned dim(3);
+    static const unsigned paramCount(dim + 1);
+    static const double maxOffset(2.);
+    const double initParams[paramCount] = { -1., 0., 4., 7. };
+
+    // the standard start point is not changed:
+    {
+        double params[paramCount];
+        std::copy(initParams, initParams + paramCount, params);
+        perturbMinimizerStart(0, dim, params);
+        for (unsigned paramIndex(0); paramIndex<paramCount; ++paramIndex)
+        {
+            BOOST_REQUIRE_EQUAL(params[paramIndex], initParams[paramIndex]);
+        }
+    }
+
+    for (unsigned startIndex(1); startIndex<50; ++startIndex)
+    {
+        double params[paramCount];
+        std::copy(initParams, initParams + paramCount, params);
+        perturbMinimizerStart(startIndex, dim, params);
+
+        bool isChanged(false);
+        for (unsigned paramIndex(0); paramIndex<dim; ++paramIndex)
+        {
+            const double offset(params[paramIndex] - initParams[paramIndex]);
+            BOOST_REQUIRE_LE(std::abs(offset), maxOffset);
+            if (offset != 0.) isChanged = true;
+        }
+        BOOST_REQUIRE(isChanged);
+
+        // parameters beyond dim are not changed:
+        BOOST_REQUIRE_EQUAL(params[dim], initParams[dim]);
+
+        // each start point is reproducible:
+        double repeatParams[paramCount];
+        std::copy(initParams, initParams + paramCount, repeatParams);
+        perturbMinimizerStart(startIndex, dim, repeatParams);
+        for (unsigned paramIndex(0); paramIndex<paramCount; ++paramIndex)
+        {
+            BOOST_REQUIRE_EQUAL(params[paramIndex], repeatParams[paramIndex]);
+        }
+    }
+}
+
+
+
+/// add error observations to three contexts, and one context with no error observations
+static
+void
+addTestIndelCounts(
+    SequenceErrorCounts& counts)
+{
+    IndelErrorCounts& indelCounts(counts.getIndelCounts());
+    for (unsigned contextIndex(0); contextIndex<3; ++contextIndex)
+    {
+        const IndelErrorContext context(1, 1 + contextIndex);
+        for (unsigned obsIndex(0); obsIndex<(2 + contextIndex); ++obsIndex)
+        {
+            IndelErrorContextObservation errorObs;
+            errorObs.refCount = 10 + obsIndex;
+            errorObs.signalCounts[INDEL_SIGNAL_TYPE::DELETE_1] = (obsIndex % 2);
+            errorObs.variantStatus = GENOTYPE_STATUS::UNKNOWN;
+            indelCounts.addError(context, errorObs, 20);
+        }
+    }
+    indelCounts.addExcludedRegionSkip(IndelErrorContext(2, 2));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_fitIndelContexts )
+{
+    SequenceErrorCounts counts;
+    addTestIndelCounts(counts);
+
+    // the best (lowest) score for each context is at a different start point, and NaN scores
+    // are never chosen:
+    static const double nan(std::numeric_limits<double>::quiet_NaN());
+    const std::vector<std::vector<double>> contextStartScores =
+    {
+        { 5., 3., 4., nan },
+        { 1., 2., nan, 1.5 },
+        { nan, 9., 8., 7. }
+    };
+
+    // fits run on pool threads, so unexpected input is reported by exception rather than a test assertion:
+    const IndelContextFitFunction fitContext = [&](
+                                                   const IndelErrorContext& context,
+                                                   const std::vector<ExportedIndelObservations>& observationHistogram,
+                                                   const IndelErrorData&,
+                                                   const unsigned startIndex,
+                                                   std::ostream& os)
+    {
+        const unsigned contextIndex(context.getRepeatCount() - 1);
+        if ((context.getRepeatPatternSize() != 1) ||
+            (contextIndex >= contextStartScores.size()) ||
+            (observationHistogram.size() != (2 + contextIndex)))
+        {
+            throw std::logic_error("unexpected context");
+        }
+        os << context.getRepeatCount() << ":" << startIndex << "\n";
+        return contextStartScores[contextIndex][startIndex];
+    };
+
+    const std::string expected("1:1\n2:0\n3:3\n");
+
+    for (const unsigned threadCount : { 1u, 3u, 16u })
+    {
+        EPECOptions opt;
+        opt.threadCount = threadCount;
+        opt.startCount = 4;
+
+        std::ostringstream oss;
+        fitIndelContexts(counts, opt, fitContext, oss);
+        BOOST_REQUIRE_EQUAL(oss.str(), expected);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_fitIndelContextsError )
+{
+    SequenceErrorCounts counts;
+    addTestIndelCounts(counts);
+
+    // an error from any fit is passed on to the caller:
+    const IndelContextFitFunction fitContext = [](
+                                                   const IndelErrorContext& context,
+                                                   const std::vector<ExportedIndelObservations>&,
+                                                   const IndelErrorData&,
+                                                   const unsigned startIndex,
+                                                   std::ostream&)
+    {
+        if ((context.getRepeatCount() == 2) && (startIndex == 1))
+        {
+            throw std::runtime_error("fit error");
+        }
+        return 0.;
+    };
+
+    EPECOptions opt;
+    opt.threadCount = 4;
+    opt.startCount = 2;
+
+    std::ostringstream oss;
+    BOOST_REQUIRE_THROW(fitIndelContexts(counts, opt, fitContext, oss), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
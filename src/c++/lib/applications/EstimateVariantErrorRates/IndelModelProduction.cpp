@@ -29,311 +29,13 @@
 #include "IndelModelProduction.hh"
 #include "calibration/IndelErrorModelJson.hh"
 
+#include "IndelModelProductionMinFunc.hh"
+
 //#define CODEMIN_DEBUG
 #define CODEMIN_USE_BOOST
-#include "minimize_conj_direction.h"
-
-namespace MIN_PARAMS3
-{
-enum index_t
-{
-    LN_INSERT_ERROR_RATE,
-    LN_DELETE_ERROR_RATE,
-    LN_NOISY_LOCUS_RATE,
-    LN_THETA,
-    SIZE
-};
-}
-
-static
-double
-getObsLogLhood(
-    const double logHomPrior,
-    const double logHetPrior,
-    const double logAltHetPrior,
-    const double logNoIndelPrior,
-    const double logInsertErrorRate,
-    const double logDeleteErrorRate,
-    const double logNoIndelRefRate,
-    const ExportedIndelObservations& obs)
-{
-    static const double log0(-std::numeric_limits<double>::infinity());
-
-    static const double homAltRate(0.99);
-    static const double hetAltRate(0.5);
-
-    static const double logHomAltRate(std::log(homAltRate));
-    static const double logHomRefRate(std::log(1.-homAltRate));
-    static const double logHetRate(std::log(hetAltRate));
-
-    // get lhood of homref GT:
-    double noindel(log0);
-    {
-        unsigned totalInsertObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            totalInsertObservations += obs.altObservations[altIndex];
-        }
-
-        unsigned totalDeleteObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            totalDeleteObservations += obs.altObservations[altIndex];
-        }
-
-        noindel = (
-                      logInsertErrorRate*totalInsertObservations +
-                      logDeleteErrorRate*totalDeleteObservations +
-                      logNoIndelRefRate*obs.refObservations);
-    }
-
-    unsigned maxIndex(0);
-    for (unsigned altIndex(1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-    {
-        if (obs.altObservations[altIndex] > obs.altObservations[maxIndex]) maxIndex = altIndex;
-    }
+#include "minimizeBfgs.hh"
 
-    // get lhood of het and hom GT:
-    double het(log0);
-    double hom(log0);
-    {
-        // approximate that the most frequent observations is the only potential variant allele:
-
-        unsigned remainingInsertObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            remainingInsertObservations += obs.altObservations[altIndex];
-        }
-
-        unsigned remainingDeleteObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            remainingDeleteObservations += obs.altObservations[altIndex];
-        }
-
-        // compute lhood of het/hom states given that maxIndex is the variant allele:
-        het =(logHetRate*(obs.refObservations+obs.altObservations[maxIndex]) +
-              logInsertErrorRate*remainingInsertObservations +
-              logDeleteErrorRate*remainingDeleteObservations);
-
-        hom = (logHomAltRate*obs.altObservations[maxIndex] +
-               logHomRefRate*obs.refObservations +
-               logInsertErrorRate*remainingInsertObservations +
-               logDeleteErrorRate*remainingDeleteObservations);
-    }
-
-    // get lhood of althet GT:
-    double althet(log0);
-    {
-        // approximate that the two most frequent observations are the only potential variant alleles:
-        assert(INDEL_SIGNAL_TYPE::SIZE>1);
-        unsigned maxIndex2(maxIndex==0 ? 1 : 0);
-        for (unsigned altIndex(maxIndex2+1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex2]) maxIndex2 = altIndex;
-        }
 
-        unsigned remainingInsertObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            if (altIndex==maxIndex2) continue;
-            remainingInsertObservations += obs.altObservations[altIndex];
-        }
-
-        unsigned remainingDeleteObservations(0);
-        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
-        {
-            if (altIndex==maxIndex) continue;
-            if (altIndex==maxIndex2) continue;
-            remainingDeleteObservations += obs.altObservations[altIndex];
-        }
-
-        // compute lhood of het/hom states given that maxIndex is the variant allele:
-        althet =(logHetRate*(obs.altObservations[maxIndex]+obs.altObservations[maxIndex2]) +
-                 logHomRefRate*obs.refObservations +
-                 logInsertErrorRate*remainingInsertObservations +
-                 logDeleteErrorRate*remainingDeleteObservations);
-    }
-
-    return log_sum( log_sum(logHomPrior+hom,logHetPrior+het), log_sum(logNoIndelPrior+noindel,logAltHetPrior+althet) );
-}
-
-static
-double
-contextLogLhood(
-    const std::vector<ExportedIndelObservations>& observations,
-    const double logInsertErrorRate,
-    const double logDeleteErrorRate,
-    const double logNoisyLocusRate,
-    const double logTheta)
-{
-#ifdef DEBUG_MODEL3
-    log_os << "MODEL3: loghood input:"
-           << " insert: " << std::exp(logInsertErrorRate)
-           << " delete: " << std::exp(logDeleteErrorRate)
-           << " noise: " << std::exp(logNoisyLocusRate)
-           << " theta: " << std::exp(logTheta)
-           << "\n";
-#endif
-
-    static const double log2(std::log(2));
-    const double logHomPrior(logTheta-log2);
-    const double logHetPrior(logTheta);
-    const double logAltHetPrior(logTheta*2);
-    const double theta(std::exp(logTheta));
-    const double logNoIndelPrior(std::log(1-(theta*3./2.+(theta*theta))));
-
-    const double logNoIndelRefRate(std::log(1-std::exp(logInsertErrorRate)-std::exp(logDeleteErrorRate)));
-
-    const double logCleanLocusRate(std::log(1-std::exp(logNoisyLocusRate)));
-
-    static const double cleanLocusIndelRate(1e-8);
-    static const double logCleanLocusIndelRate(std::log(cleanLocusIndelRate));
-    static const double logCleanLocusRefRate(std::log(1-cleanLocusIndelRate));
-
-    double logLhood(0.);
-    for (const auto& obs : observations)
-    {
-        const double noisyMix(getObsLogLhood(logHomPrior, logHetPrior, logAltHetPrior, logNoIndelPrior,
-                                             logInsertErrorRate, logDeleteErrorRate, logNoIndelRefRate, obs));
-        const double cleanMix(getObsLogLhood(logHomPrior, logHetPrior, logAltHetPrior, logNoIndelPrior,
-                                             logCleanLocusIndelRate, logCleanLocusIndelRate, logCleanLocusRefRate, obs));
-
-        const double mix(log_sum(logCleanLocusRate+cleanMix,logNoisyLocusRate+noisyMix));
-
-#ifdef DEBUG_MODEL3
-        log_os << "MODEL3: loghood obs: noisy/clean/mix/delta: " << noisyMix << " " << cleanMix << " " << mix << " " << (mix*obs.repeatCount) << "\n";
-#endif
-
-        logLhood += (mix*obs.observationCount);
-    }
-
-#ifdef DEBUG_MODEL3
-    log_os << "MODEL3: loghood output:" << logLhood << "\n";
-#endif
-
-    return logLhood;
-}
-
-struct error_minfunc_model3 : public codemin::minfunc_interface<double>
-{
-    explicit
-    error_minfunc_model3(
-        const std::vector<ExportedIndelObservations>& observations, const double theta,
-        const bool isLockTheta = false)
-        : defaultLogTheta(theta),
-          _obs(observations),
-          _isLockTheta(isLockTheta)
-    {}
-    unsigned dim() const override
-    {
-        return (_isLockTheta ? (MIN_PARAMS3::SIZE-1) : MIN_PARAMS3::SIZE);
-    }
-
-    double val(const double* in) override
-    {
-        argToParameters(in,_params);
-        return -contextLogLhood(_obs,
-                                _params[MIN_PARAMS3::LN_INSERT_ERROR_RATE],
-                                _params[MIN_PARAMS3::LN_DELETE_ERROR_RATE],
-                                _params[MIN_PARAMS3::LN_NOISY_LOCUS_RATE],
-                                (_isLockTheta ? defaultLogTheta : _params[MIN_PARAMS3::LN_THETA]));
-    }
-
-    /// normalize the minimization values back to usable parameters
-    ///
-    /// most values are not valid on [-inf,inf] -- the minimizer doesn't
-    /// know this. here is where we fill in the gap:
-    ///
-    static
-    void
-    argToParameters(
-        const double* in,
-        double* out)
-    {
-        auto rateSmoother = [](double a) -> double
-        {
-            static const double triggerVal(1e-3);
-            static const double logTriggerVal(std::log(triggerVal));
-            if (a>logTriggerVal)
-            {
-                a = std::log1p(a-logTriggerVal) + logTriggerVal;
-            }
-            return (a>maxLogRate ? maxLogRate-std::abs(a-maxLogRate) : a);
-        };
-
-        auto locusRateSmoother = [](double a) -> double
-        {
-            static const double triggerVal(0.8);
-            static const double logTriggerVal(std::log(triggerVal));
-            if (a>logTriggerVal)
-            {
-                a = std::log1p(a-logTriggerVal) + logTriggerVal;
-            }
-            return (a>maxLogLocusRate ? maxLogLocusRate-std::abs(a-maxLogLocusRate) : a);
-        };
-
-        // A lot of conditioning is required to keep the model from winding
-        // theta around zero and getting confused, here we start applying a
-        // second log to the delta above triggerTheta, and finally put a hard stop
-        // at logMaxTheta -- hard stops are obviously bad b/c the model can get lost
-        // on the flat plane even if the ML value is well below this limit, but
-        // in practice this is such a ridiculously high value for theta, that
-        // I don't see the model getting trapped.
-        auto thetaSmoother = [](double a) -> double
-        {
-            static const double triggerVal(1e-3);
-            static const double logTriggerVal(std::log(triggerVal));
-
-            if (a>logTriggerVal)
-            {
-                a = std::log1p(a-logTriggerVal) + logTriggerVal;
-            }
-            return (a>maxLogTheta ? maxLogTheta-std::abs(a-maxLogTheta) : a);
-        };
-
-        for (unsigned paramIndex(MIN_PARAMS3::LN_INSERT_ERROR_RATE); paramIndex<MIN_PARAMS3::LN_NOISY_LOCUS_RATE; ++paramIndex)
-        {
-            out[paramIndex] = rateSmoother(in[paramIndex]);
-        }
-        out[MIN_PARAMS3::LN_NOISY_LOCUS_RATE] = locusRateSmoother(in[MIN_PARAMS3::LN_NOISY_LOCUS_RATE]);
-        out[MIN_PARAMS3::LN_THETA] = thetaSmoother(in[MIN_PARAMS3::LN_THETA]);
-    }
-
-#if 0
-    // this should help in theory, but in practice the minimizer is more likely to get stuck
-    bool
-    is_val_computable(
-        const double* in) override
-    {
-        if (in[MIN_PARAMS3::LN_INSERT_ERROR_RATE]>maxLogRate) return false;
-        if (in[MIN_PARAMS3::LN_DELETE_ERROR_RATE]>maxLogRate) return false;
-        if (in[MIN_PARAMS3::LN_NOISY_LOCUS_RATE]>maxLogLocusRate) return false;
-        if (in[MIN_PARAMS3::LN_THETA]>maxLogTheta) return false;
-        return true;
-    }
-#endif
-
-    const double defaultLogTheta;
-    static const double initLogTheta;
-    static const double maxLogTheta;
-    static const double maxLogRate;
-    static const double maxLogLocusRate;
-
-private:
-    const std::vector<ExportedIndelObservations>& _obs;
-    bool _isLockTheta;
-    double _params[MIN_PARAMS3::SIZE];
-};
-
-const double error_minfunc_model3::initLogTheta = std::log(1e-04);
-const double error_minfunc_model3::maxLogTheta = std::log(0.4);
-const double error_minfunc_model3::maxLogRate = std::log(0.5);
-const double error_minfunc_model3::maxLogLocusRate = std::log(1.0);
 
 static
 bool
@@ -346,40 +48,26 @@ computeExtendedContext(
     bool paramsAcceptable = true;
     std::vector<ExportedIndelObservations> observations;
     data.exportObservations(observations);
-    // initialize conjugate direction minimizer settings and minimize lhood...
+    // initialize quasi-Newton minimizer settings and minimize lhood...
     //
     double minParams[MIN_PARAMS3::SIZE];
 
     {
         unsigned iter;
         double x_all_loghood;
-        static const double line_tol(1e-10);
         static const double end_tol(1e-10);
         static const unsigned max_iter(40);
 
-        error_minfunc_model3 errFunc(observations, logTheta, isLockTheta);
+        IndelModelProductionMinFunc errFunc(observations, logTheta, isLockTheta);
+
         // initialize parameter search
         minParams[MIN_PARAMS3::LN_INSERT_ERROR_RATE] = std::log(1e-3);
         minParams[MIN_PARAMS3::LN_DELETE_ERROR_RATE] = std::log(1e-3);
         minParams[MIN_PARAMS3::LN_NOISY_LOCUS_RATE] = std::log(0.4);
         minParams[MIN_PARAMS3::LN_THETA] = errFunc.defaultLogTheta;
 
-        static const unsigned SIZE2(MIN_PARAMS3::SIZE*MIN_PARAMS3::SIZE);
-        double conjDir[SIZE2];
-
-        std::fill(conjDir,conjDir+SIZE2,0.);
-        const unsigned dim(isLockTheta ? MIN_PARAMS3::SIZE-1 : MIN_PARAMS3::SIZE);
-        for (unsigned i(0); i<dim; ++i)
-        {
-            conjDir[i*(dim+1)] = 0.0005;
-        }
-
-        double start_tol(end_tol);
         double final_dlh;
-
-
-        codemin::minimize_conj_direction(minParams,conjDir,errFunc,start_tol,end_tol,line_tol,
-                                         x_all_loghood,iter,final_dlh,max_iter);
+        minimizeBfgs(minParams,errFunc,end_tol,x_all_loghood,iter,final_dlh,max_iter);
 
         if (max_iter == iter)
         {
@@ -387,7 +75,7 @@ computeExtendedContext(
         }
     }
 
-    error_minfunc_model3::argToParameters(minParams,normalizedParams);
+    IndelModelProductionMinFunc::argToParameters(minParams,normalizedParams);
 
     return paramsAcceptable;
 }
@@ -0,0 +1,382 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "IndelModelProductionMinFunc.hh"
+
+#include "blt_util/math_util.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+
+
+const double IndelModelProductionMinFunc::maxLogTheta = std::log(0.4);
+const double IndelModelProductionMinFunc::maxLogRate = std::log(0.5);
+const double IndelModelProductionMinFunc::maxLogLocusRate = std::log(1.0);
+
+
+static const double homAltRate(0.99);
+static const double hetAltRate(0.5);
+
+static const double logHomAltRate(std::log(homAltRate));
+static const double logHomRefRate(std::log(1.-homAltRate));
+static const double logHetRate(std::log(hetAltRate));
+
+static const double cleanLocusIndelRate(1e-8);
+static const double logCleanLocusIndelRate(std::log(cleanLocusIndelRate));
+static const double logCleanLocusRefRate(std::log(1-cleanLocusIndelRate));
+
+
+
+namespace
+{
+
+/// genotype priors and their derivatives with respect to logTheta
+struct GenotypePriors
+{
+    explicit
+    GenotypePriors(const double logTheta)
+    {
+        static const double log2(std::log(2));
+        logHomPrior = (logTheta-log2);
+        logHetPrior = logTheta;
+        logAltHetPrior = (logTheta*2);
+
+        const double theta(std::exp(logTheta));
+        const double noIndelPrior(1-(theta*3./2.+(theta*theta)));
+        logNoIndelPrior = std::log(noIndelPrior);
+        logNoIndelPriorThetaDeriv = (-(theta*3./2.+(2*theta*theta))/noIndelPrior);
+    }
+
+    double logHomPrior;
+    double logHetPrior;
+    double logAltHetPrior;
+    double logNoIndelPrior;
+    double logNoIndelPriorThetaDeriv;
+};
+
+
+/// log(exp(x0)+exp(x1)+exp(x2)+exp(x3)), also providing the normalized weight of each term
+inline
+double
+logSum4(
+    const double x0,
+    const double x1,
+    const double x2,
+    const double x3,
+    double* weight)
+{
+    const double maxX(std::max(std::max(x0,x1),std::max(x2,x3)));
+    weight[0] = std::exp(x0-maxX);
+    weight[1] = std::exp(x1-maxX);
+    weight[2] = std::exp(x2-maxX);
+    weight[3] = std::exp(x3-maxX);
+    const double sum(weight[0]+weight[1]+weight[2]+weight[3]);
+    const double invSum(1./sum);
+    for (unsigned index(0); index<4; ++index)
+    {
+        weight[index] *= invSum;
+    }
+    return (maxX + std::log(sum));
+}
+
+
+/// apply the log-parameter smoothing transformation shared by all minimizer parameters
+///
+/// above the trigger value the parameter is compressed with a second log, and the result is reflected at maxVal
+inline
+double
+smoothLogParam(
+    double a,
+    const double logTriggerVal,
+    const double maxVal,
+    double& deriv)
+{
+    deriv = 1.;
+    if (a>logTriggerVal)
+    {
+        deriv = (1./(1.+(a-logTriggerVal)));
+        a = std::log1p(a-logTriggerVal) + logTriggerVal;
+    }
+    if (a>maxVal)
+    {
+        deriv = -deriv;
+        a = maxVal-std::abs(a-maxVal);
+    }
+    return a;
+}
+
+}
+
+
+
+IndelModelProductionMinFunc::
+IndelModelProductionMinFunc(
+    const std::vector<ExportedIndelObservations>& observations,
+    const double logTheta,
+    const bool isLockTheta)
+    : defaultLogTheta(logTheta),
+      _isLockTheta(isLockTheta),
+      _cleanLogTheta(logTheta)
+{
+    for (const auto& obs : observations)
+    {
+        unsigned totalInsertObservations(0);
+        for (unsigned altIndex(INDEL_SIGNAL_TYPE::INSERT_1); altIndex<INDEL_SIGNAL_TYPE::DELETE_1; ++altIndex)
+        {
+            totalInsertObservations += obs.altObservations[altIndex];
+        }
+
+        unsigned totalDeleteObservations(0);
+        for (unsigned altIndex(INDEL_SIGNAL_TYPE::DELETE_1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            totalDeleteObservations += obs.altObservations[altIndex];
+        }
+
+        // approximate that the most frequent observation is the only potential het/hom variant allele:
+        unsigned maxIndex(0);
+        for (unsigned altIndex(1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex]) maxIndex = altIndex;
+        }
+
+        // approximate that the two most frequent observations are the only potential alt-het variant alleles:
+        assert(INDEL_SIGNAL_TYPE::SIZE>1);
+        unsigned maxIndex2(maxIndex==0 ? 1 : 0);
+        for (unsigned altIndex(maxIndex2+1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            if (altIndex==maxIndex) continue;
+            if (obs.altObservations[altIndex] > obs.altObservations[maxIndex2]) maxIndex2 = altIndex;
+        }
+
+        const bool isMaxInsert(maxIndex<INDEL_SIGNAL_TYPE::DELETE_1);
+        const bool isMax2Insert(maxIndex2<INDEL_SIGNAL_TYPE::DELETE_1);
+        const unsigned maxCount(obs.altObservations[maxIndex]);
+        const unsigned max2Count(obs.altObservations[maxIndex2]);
+
+        const unsigned hetInsertCount(totalInsertObservations - (isMaxInsert ? maxCount : 0));
+        const unsigned hetDeleteCount(totalDeleteObservations - (isMaxInsert ? 0 : maxCount));
+
+        _count.push_back(obs.observationCount);
+        _refCount.push_back(obs.refObservations);
+        _insertCount.push_back(totalInsertObservations);
+        _deleteCount.push_back(totalDeleteObservations);
+        _hetInsertCount.push_back(hetInsertCount);
+        _hetDeleteCount.push_back(hetDeleteCount);
+        _altHetInsertCount.push_back(hetInsertCount - (isMax2Insert ? max2Count : 0));
+        _altHetDeleteCount.push_back(hetDeleteCount - (isMax2Insert ? 0 : max2Count));
+        _hetConst.push_back(logHetRate*(obs.refObservations+maxCount));
+        _homConst.push_back(logHomAltRate*maxCount + logHomRefRate*obs.refObservations);
+        _altHetConst.push_back(logHetRate*(maxCount+max2Count) + logHomRefRate*obs.refObservations);
+    }
+}
+
+
+
+void
+IndelModelProductionMinFunc::
+updateCleanLocusLhood(
+    const double logTheta)
+{
+    if (_isCleanLhoodValid && (logTheta == _cleanLogTheta)) return;
+
+    const GenotypePriors priors(logTheta);
+    const unsigned patternCount(_count.size());
+    _cleanLhood.resize(patternCount);
+    _cleanLhoodThetaDeriv.resize(patternCount);
+    double weight[4];
+    for (unsigned patternIndex(0); patternIndex<patternCount; ++patternIndex)
+    {
+        const double indelCount(_insertCount[patternIndex]+_deleteCount[patternIndex]);
+        const double hetIndelCount(_hetInsertCount[patternIndex]+_hetDeleteCount[patternIndex]);
+        const double altHetIndelCount(_altHetInsertCount[patternIndex]+_altHetDeleteCount[patternIndex]);
+        _cleanLhood[patternIndex] = logSum4(
+                                        priors.logNoIndelPrior + logCleanLocusIndelRate*indelCount + logCleanLocusRefRate*_refCount[patternIndex],
+                                        priors.logHetPrior + _hetConst[patternIndex] + logCleanLocusIndelRate*hetIndelCount,
+                                        priors.logHomPrior + _homConst[patternIndex] + logCleanLocusIndelRate*hetIndelCount,
+                                        priors.logAltHetPrior + _altHetConst[patternIndex] + logCleanLocusIndelRate*altHetIndelCount,
+                                        weight);
+        _cleanLhoodThetaDeriv[patternIndex] = (weight[0]*priors.logNoIndelPriorThetaDeriv + weight[1] + weight[2] + 2*weight[3]);
+    }
+
+    _cleanLogTheta = logTheta;
+    _isCleanLhoodValid = true;
+}
+
+
+
+double
+IndelModelProductionMinFunc::
+getLogLhood(
+    const double* params,
+    double* paramGradient)
+{
+    const double logInsertErrorRate(params[MIN_PARAMS3::LN_INSERT_ERROR_RATE]);
+    const double logDeleteErrorRate(params[MIN_PARAMS3::LN_DELETE_ERROR_RATE]);
+    const double logNoisyLocusRate(params[MIN_PARAMS3::LN_NOISY_LOCUS_RATE]);
+    const double logTheta(_isLockTheta ? defaultLogTheta : params[MIN_PARAMS3::LN_THETA]);
+
+    const GenotypePriors priors(logTheta);
+
+    const double insertErrorRate(std::exp(logInsertErrorRate));
+    const double deleteErrorRate(std::exp(logDeleteErrorRate));
+    const double noIndelRefRate(1-insertErrorRate-deleteErrorRate);
+    const double logNoIndelRefRate(std::log(noIndelRefRate));
+    const double logNoIndelRefRateInsertDeriv(-insertErrorRate/noIndelRefRate);
+    const double logNoIndelRefRateDeleteDeriv(-deleteErrorRate/noIndelRefRate);
+
+    const double noisyLocusRate(std::exp(logNoisyLocusRate));
+    const double logCleanLocusRate(std::log(1-noisyLocusRate));
+    const double logCleanLocusRateDeriv(-noisyLocusRate/(1-noisyLocusRate));
+
+    updateCleanLocusLhood(logTheta);
+
+    double gradInsert(0.);
+    double gradDelete(0.);
+    double gradNoisyLocus(0.);
+    double gradTheta(0.);
+
+    double logLhood(0.);
+    double weight[4];
+    const unsigned patternCount(_count.size());
+    for (unsigned patternIndex(0); patternIndex<patternCount; ++patternIndex)
+    {
+        const double hetIndelTerm(logInsertErrorRate*_hetInsertCount[patternIndex] +
+                                  logDeleteErrorRate*_hetDeleteCount[patternIndex]);
+        const double noisyLhood(logSum4(
+                                    priors.logNoIndelPrior +
+                                    logInsertErrorRate*_insertCount[patternIndex] +
+                                    logDeleteErrorRate*_deleteCount[patternIndex] +
+                                    logNoIndelRefRate*_refCount[patternIndex],
+                                    priors.logHetPrior + _hetConst[patternIndex] + hetIndelTerm,
+                                    priors.logHomPrior + _homConst[patternIndex] + hetIndelTerm,
+                                    priors.logAltHetPrior + _altHetConst[patternIndex] +
+                                    logInsertErrorRate*_altHetInsertCount[patternIndex] +
+                                    logDeleteErrorRate*_altHetDeleteCount[patternIndex],
+                                    weight));
+
+        const double cleanTerm(logCleanLocusRate+_cleanLhood[patternIndex]);
+        const double noisyTerm(logNoisyLocusRate+noisyLhood);
+        const double mix(log_sum(cleanTerm,noisyTerm));
+        const double count(_count[patternIndex]);
+        logLhood += (mix*count);
+
+        if (paramGradient == nullptr) continue;
+
+        const double cleanWeight(count*std::exp(cleanTerm-mix));
+        const double noisyWeight(count*std::exp(noisyTerm-mix));
+        const double hetWeight(weight[1]+weight[2]);
+
+        gradInsert += noisyWeight*(weight[0]*(_insertCount[patternIndex] + _refCount[patternIndex]*logNoIndelRefRateInsertDeriv) +
+                                   hetWeight*_hetInsertCount[patternIndex] +
+                                   weight[3]*_altHetInsertCount[patternIndex]);
+        gradDelete += noisyWeight*(weight[0]*(_deleteCount[patternIndex] + _refCount[patternIndex]*logNoIndelRefRateDeleteDeriv) +
+                                   hetWeight*_hetDeleteCount[patternIndex] +
+                                   weight[3]*_altHetDeleteCount[patternIndex]);
+        gradNoisyLocus += noisyWeight;
+        // guard against 0*inf when the noisy locus rate reaches 1:
+        if (cleanWeight > 0.) gradNoisyLocus += (cleanWeight*logCleanLocusRateDeriv);
+        gradTheta += (cleanWeight*_cleanLhoodThetaDeriv[patternIndex] +
+                      noisyWeight*(weight[0]*priors.logNoIndelPriorThetaDeriv + hetWeight + 2*weight[3]));
+    }
+
+    if (paramGradient != nullptr)
+    {
+        paramGradient[MIN_PARAMS3::LN_INSERT_ERROR_RATE] = gradInsert;
+        paramGradient[MIN_PARAMS3::LN_DELETE_ERROR_RATE] = gradDelete;
+        paramGradient[MIN_PARAMS3::LN_NOISY_LOCUS_RATE] = gradNoisyLocus;
+        paramGradient[MIN_PARAMS3::LN_THETA] = (_isLockTheta ? 0. : gradTheta);
+    }
+
+    return logLhood;
+}
+
+
+
+double
+IndelModelProductionMinFunc::
+getNegLogLhood(
+    const double* in,
+    double* dv)
+{
+    // the minimizer only provides the first dim() arguments:
+    double args[MIN_PARAMS3::SIZE];
+    std::copy(in, in+dim(), args);
+    if (_isLockTheta) args[MIN_PARAMS3::LN_THETA] = defaultLogTheta;
+
+    double params[MIN_PARAMS3::SIZE];
+    if (dv == nullptr)
+    {
+        argToParameters(args, params);
+        return -getLogLhood(params);
+    }
+
+    double paramDeriv[MIN_PARAMS3::SIZE];
+    double paramGradient[MIN_PARAMS3::SIZE];
+    argToParameters(args, params, paramDeriv);
+    const double logLhood(getLogLhood(params, paramGradient));
+    for (unsigned paramIndex(0); paramIndex<dim(); ++paramIndex)
+    {
+        dv[paramIndex] = -(paramGradient[paramIndex]*paramDeriv[paramIndex]);
+    }
+    return -logLhood;
+}
+
+
+
+void
+IndelModelProductionMinFunc::
+argToParameters(
+    const double* in,
+    double* out,
+    double* outDeriv)
+{
+    static const double logRateTriggerVal(std::log(1e-3));
+    static const double logLocusRateTriggerVal(std::log(0.8));
+
+    // A lot of conditioning is required to keep the model from winding
+    // theta around zero and getting confused, here we start applying a
+    // second log to the delta above the trigger value, and finally put a hard stop
+    // at maxLogTheta -- hard stops are obviously bad b/c the model can get lost
+    // on the flat plane even if the ML value is well below this limit, but
+    // in practice this is such a ridiculously high value for theta, that
+    // I don't see the model getting trapped.
+    static const double logThetaTriggerVal(std::log(1e-3));
+
+    double deriv[MIN_PARAMS3::SIZE];
+    for (unsigned paramIndex(MIN_PARAMS3::LN_INSERT_ERROR_RATE); paramIndex<MIN_PARAMS3::LN_NOISY_LOCUS_RATE; ++paramIndex)
+    {
+        out[paramIndex] = smoothLogParam(in[paramIndex], logRateTriggerVal, maxLogRate, deriv[paramIndex]);
+    }
+    out[MIN_PARAMS3::LN_NOISY_LOCUS_RATE] = smoothLogParam(in[MIN_PARAMS3::LN_NOISY_LOCUS_RATE], logLocusRateTriggerVal,
+                                                           maxLogLocusRate, deriv[MIN_PARAMS3::LN_NOISY_LOCUS_RATE]);
+    out[MIN_PARAMS3::LN_THETA] = smoothLogParam(in[MIN_PARAMS3::LN_THETA], logThetaTriggerVal, maxLogTheta,
+                                                deriv[MIN_PARAMS3::LN_THETA]);
+
+    if (outDeriv != nullptr)
+    {
+        std::copy(deriv, deriv+MIN_PARAMS3::SIZE, outDeriv);
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "errorAnalysis/IndelErrorCounts.hh"
+
+#include "minfunc_interface.h"
+
+#include <vector>
+
+
+namespace MIN_PARAMS3
+{
+enum index_t
+{
+    LN_INSERT_ERROR_RATE,
+    LN_DELETE_ERROR_RATE,
+    LN_NOISY_LOCUS_RATE,
+    LN_THETA,
+    SIZE
+};
+}
+
+
+/// negative log-likelihood of the production indel error model for one indel context, with analytic gradient
+///
+/// Each locus is modeled as a mixture of a clean and a noisy locus, where each locus type has its own indel error
+/// rates, and the locus genotype is a mixture of hom-ref, het, hom and alt-het states.
+///
+/// At construction all observations are reduced to a set of per-pattern constants, stored as one column per constant,
+/// so that each evaluation is a single pass over these columns without any per-observation signal counting. When
+/// theta is locked the clean locus likelihood does not depend on the minimization parameters, so it is only
+/// computed once.
+///
+struct IndelModelProductionMinFunc : public codemin::minfunc_gradient_interface<double>
+{
+    IndelModelProductionMinFunc(
+        const std::vector<ExportedIndelObservations>& observations,
+        const double logTheta,
+        const bool isLockTheta = false);
+
+    unsigned
+    dim() const override
+    {
+        return (_isLockTheta ? (MIN_PARAMS3::SIZE-1) : MIN_PARAMS3::SIZE);
+    }
+
+    double
+    val(const double* in) override
+    {
+        return getNegLogLhood(in, nullptr);
+    }
+
+    double
+    dval(
+        const double* in,
+        double* dv) override
+    {
+        return getNegLogLhood(in, dv);
+    }
+
+    /// log-likelihood of the model parameters (not the minimizer arguments), with optional gradient
+    ///
+    /// \param[out] paramGradient if non-null, the gradient of the log-likelihood with respect to each model
+    ///                           parameter is written here (MIN_PARAMS3::SIZE values)
+    double
+    getLogLhood(
+        const double* params,
+        double* paramGradient = nullptr);
+
+    /// normalize the minimization values back to usable parameters
+    ///
+    /// most values are not valid on [-inf,inf] -- the minimizer doesn't
+    /// know this. here is where we fill in the gap:
+    ///
+    /// \param[out] outDeriv if non-null, the derivative of each output parameter with respect to its input
+    ///                      minimization value is written here
+    static
+    void
+    argToParameters(
+        const double* in,
+        double* out,
+        double* outDeriv = nullptr);
+
+    const double defaultLogTheta;
+    static const double maxLogTheta;
+    static const double maxLogRate;
+    static const double maxLogLocusRate;
+
+private:
+    double
+    getNegLogLhood(
+        const double* in,
+        double* dv);
+
+    /// update the cached clean locus likelihood of each pattern for logTheta
+    void
+    updateCleanLocusLhood(
+        const double logTheta);
+
+    const bool _isLockTheta;
+
+    // per-pattern constants, one entry for each distinct observation pattern:
+
+    /// number of loci with this observation pattern
+    std::vector<double> _count;
+    std::vector<double> _refCount;
+    /// total insert and delete signal counts
+    std::vector<double> _insertCount;
+    std::vector<double> _deleteCount;
+    /// insert and delete counts excluding the most frequent signal, which is assumed to be the variant allele
+    std::vector<double> _hetInsertCount;
+    std::vector<double> _hetDeleteCount;
+    /// insert and delete counts excluding the two most frequent signals
+    std::vector<double> _altHetInsertCount;
+    std::vector<double> _altHetDeleteCount;
+    /// log-likelihood terms of the het, hom and alt-het genotypes which do not depend on the model parameters
+    std::vector<double> _hetConst;
+    std::vector<double> _homConst;
+    std::vector<double> _altHetConst;
+
+    /// clean locus log-likelihood of each pattern and its derivative with respect to logTheta, cached for _cleanLogTheta
+    std::vector<double> _cleanLhood;
+    std::vector<double> _cleanLhoodThetaDeriv;
+    double _cleanLogTheta;
+    bool _isCleanLhoodValid = false;
+};
@@ -0,0 +1,168 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "minimize_line.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+/// quasi-Newton (BFGS) minimization of a codemin gradient function
+///
+/// This follows the interface and convergence criteria of codemin::minimize_conj_gradient, but accumulates an
+/// approximation of the inverse hessian from the gradient history, which converges in far fewer line searches on
+/// the strongly correlated parameters of the indel error models.
+///
+/// \param[in,out] x starting point on input, location of the minimum on output
+/// \param[in] tol iteration stops when the function decreases by no more than tol in one iteration
+/// \param[out] fMin function value at the minimum
+/// \param[out] iter number of iterations performed
+/// \param[out] finalIterDeltaF decrease of the function value in the final iteration
+/// \param[in] initStepSize maximum length of any component of the initial steepest descent step
+///
+template <typename MinFunc>
+void
+minimizeBfgs(
+    double* x,
+    MinFunc& mf,
+    const double tol,
+    double& fMin,
+    unsigned& iter,
+    double& finalIterDeltaF,
+    const unsigned maxIter,
+    const double initStepSize = 1e-3)
+{
+    const unsigned n(mf.dim());
+
+    // inverse hessian approximation, row-major:
+    std::vector<double> invHessian(n*n);
+    auto resetInvHessian = [&]()
+    {
+        std::fill(invHessian.begin(), invHessian.end(), 0.);
+        for (unsigned i(0); i<n; ++i) invHessian[i*n+i] = 1.;
+    };
+    resetInvHessian();
+    bool isInvHessianScaled(false);
+
+    std::vector<double> grad(n);
+    std::vector<double> prevGrad(n);
+    std::vector<double> prevX(n);
+    std::vector<double> direction(n);
+    std::vector<double> s(n);
+    std::vector<double> y(n);
+    std::vector<double> hy(n);
+    std::vector<double> lineScratch(n);
+
+    fMin = mf.dval(x, grad.data());
+
+    iter=0;
+    while (iter<maxIter)
+    {
+        iter++;
+
+        double maxDirection(0.);
+        for (unsigned i(0); i<n; ++i)
+        {
+            direction[i] = 0.;
+            for (unsigned j(0); j<n; ++j) direction[i] -= invHessian[i*n+j]*grad[j];
+            maxDirection = std::max(maxDirection, std::abs(direction[i]));
+        }
+
+        if ((! isInvHessianScaled) && (maxDirection > initStepSize))
+        {
+            // without any curvature information the raw gradient can be arbitrarily large, so start the line
+            // search from a small step to keep it from bracketing a distant plateau:
+            for (unsigned i(0); i<n; ++i) direction[i] *= (initStepSize/maxDirection);
+        }
+
+        std::copy(x, x+n, prevX.begin());
+        std::swap(grad, prevGrad);
+        const double prevFMin(fMin);
+
+        codemin::minimize_line(x, direction.data(), prevFMin, mf, fMin, lineScratch.data());
+
+        finalIterDeltaF = (prevFMin-fMin);
+        if (finalIterDeltaF <= tol)
+        {
+            if (finalIterDeltaF<0.) throw codemin::minimize_exception("minimizeBfgs(): value of f increased in iteration");
+            if (! isInvHessianScaled) break;
+
+            // the hessian approximation can stall on a kink in the function (such as the parameter reflection
+            // boundaries used by the error models), so only accept convergence from a steepest descent step
+            // taken from the gradient at the line search result:
+            fMin = mf.dval(x, grad.data());
+            resetInvHessian();
+            isInvHessianScaled = false;
+            continue;
+        }
+
+        fMin = mf.dval(x, grad.data());
+
+        double sy(0.);
+        double yy(0.);
+        for (unsigned i(0); i<n; ++i)
+        {
+            s[i] = x[i]-prevX[i];
+            y[i] = grad[i]-prevGrad[i];
+            sy += s[i]*y[i];
+            yy += y[i]*y[i];
+        }
+
+        if (sy <= 0.)
+        {
+            // curvature condition failed, restart from steepest descent:
+            resetInvHessian();
+            isInvHessianScaled = false;
+            continue;
+        }
+
+        if (! isInvHessianScaled)
+        {
+            // scale the initial identity matrix to the curvature observed in the first step:
+            const double scale(sy/yy);
+            for (unsigned i(0); i<n; ++i) invHessian[i*n+i] = scale;
+            isInvHessianScaled = true;
+        }
+
+        // standard BFGS inverse hessian update:
+        //   H += ((sy + yHy)/(sy*sy)) * s*s' - (Hy*s' + s*(Hy)')/sy
+        double yhy(0.);
+        for (unsigned i(0); i<n; ++i)
+        {
+            hy[i] = 0.;
+            for (unsigned j(0); j<n; ++j) hy[i] += invHessian[i*n+j]*y[j];
+            yhy += y[i]*hy[i];
+        }
+        const double ssFactor((sy+yhy)/(sy*sy));
+        for (unsigned i(0); i<n; ++i)
+        {
+            for (unsigned j(0); j<n; ++j)
+            {
+                invHessian[i*n+j] += ssFactor*s[i]*s[j] - (hy[i]*s[j] + s[i]*hy[j])/sy;
+            }
+        }
+    }
+}
@@ -0,0 +1,251 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "IndelModelProductionMinFunc.hh"
+
+#define CODEMIN_USE_BOOST
+#include "minimizeBfgs.hh"
+
+#include "blt_util/math_util.hh"
+
+#include <cmath>
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( IndelModelProductionMinFunc_test )
+
+
+/// straightforward per-observation evaluation of a single genotype-mixture likelihood, used as a reference
+static
+double
+getReferenceObsLogLhood(
+    const double logTheta,
+    const double logInsertErrorRate,
+    const double logDeleteErrorRate,
+    const double logNoIndelRefRate,
+    const ExportedIndelObservations& obs)
+{
+    const double logHomRefRate(std::log(0.01));
+    const double logHomAltRate(std::log(0.99));
+    const double logHetRate(std::log(0.5));
+    const double theta(std::exp(logTheta));
+
+    auto isInsert = [](const unsigned altIndex)
+    {
+        return (altIndex < INDEL_SIGNAL_TYPE::DELETE_1);
+    };
+
+    auto getErrorTerm = [&](const unsigned skipIndex1, const unsigned skipIndex2)
+    {
+        double val(0);
+        for (unsigned altIndex(0); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            if ((altIndex == skipIndex1) || (altIndex == skipIndex2)) continue;
+            val += obs.altObservations[altIndex] * (isInsert(altIndex) ? logInsertErrorRate : logDeleteErrorRate);
+        }
+        return val;
+    };
+
+    unsigned maxIndex(0);
+    for (unsigned altIndex(1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+    {
+        if (obs.altObservations[altIndex] > obs.altObservations[maxIndex]) maxIndex = altIndex;
+    }
+    unsigned maxIndex2(maxIndex==0 ? 1 : 0);
+    for (unsigned altIndex(maxIndex2+1); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+    {
+        if (altIndex==maxIndex) continue;
+        if (obs.altObservations[altIndex] > obs.altObservations[maxIndex2]) maxIndex2 = altIndex;
+    }
+
+    const unsigned none(INDEL_SIGNAL_TYPE::SIZE);
+    const double noindel(std::log(1-(theta*3./2.+(theta*theta))) +
+                         getErrorTerm(none, none) + logNoIndelRefRate*obs.refObservations);
+    const double het(logTheta + logHetRate*(obs.refObservations+obs.altObservations[maxIndex]) +
+                     getErrorTerm(maxIndex, none));
+    const double hom(logTheta - std::log(2) + logHomAltRate*obs.altObservations[maxIndex] +
+                     logHomRefRate*obs.refObservations + getErrorTerm(maxIndex, none));
+    const double althet(logTheta*2 + logHetRate*(obs.altObservations[maxIndex]+obs.altObservations[maxIndex2]) +
+                        logHomRefRate*obs.refObservations + getErrorTerm(maxIndex, maxIndex2));
+
+    return log_sum(log_sum(hom,het), log_sum(noindel,althet));
+}
+
+
+static
+double
+getReferenceLogLhood(
+    const std::vector<ExportedIndelObservations>& observations,
+    const double* params)
+{
+    const double logInsertErrorRate(params[MIN_PARAMS3::LN_INSERT_ERROR_RATE]);
+    const double logDeleteErrorRate(params[MIN_PARAMS3::LN_DELETE_ERROR_RATE]);
+    const double logNoisyLocusRate(params[MIN_PARAMS3::LN_NOISY_LOCUS_RATE]);
+    const double logTheta(params[MIN_PARAMS3::LN_THETA]);
+
+    const double logNoIndelRefRate(std::log(1-std::exp(logInsertErrorRate)-std::exp(logDeleteErrorRate)));
+    const double logCleanLocusIndelRate(std::log(1e-8));
+    const double logCleanLocusRefRate(std::log(1-1e-8));
+
+    double logLhood(0);
+    for (const auto& obs : observations)
+    {
+        const double noisyMix(getReferenceObsLogLhood(logTheta, logInsertErrorRate, logDeleteErrorRate,
+                                                      logNoIndelRefRate, obs));
+        const double cleanMix(getReferenceObsLogLhood(logTheta, logCleanLocusIndelRate, logCleanLocusIndelRate,
+                                                      logCleanLocusRefRate, obs));
+        logLhood += obs.observationCount * log_sum(std::log(1-std::exp(logNoisyLocusRate))+cleanMix,
+                                                   logNoisyLocusRate+noisyMix);
+    }
+    return logLhood;
+}
+
+
+static
+std::vector<ExportedIndelObservations>
+getTestObservations()
+{
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<unsigned> signalDist(0,3);
+    std::uniform_int_distribution<unsigned> refDist(0,30);
+
+    std::vector<ExportedIndelObservations> observations;
+    for (unsigned patternIndex(0); patternIndex<40; ++patternIndex)
+    {
+        ExportedIndelObservations obs;
+        obs.observationCount = 1 + (patternIndex % 5);
+        obs.refObservations = refDist(generator);
+        for (unsigned altIndex(0); altIndex<INDEL_SIGNAL_TYPE::SIZE; ++altIndex)
+        {
+            // keep most signal counts empty, as in real data:
+            obs.altObservations[altIndex] = (((altIndex + patternIndex) % 7) == 0) ? signalDist(generator) : 0;
+        }
+        observations.push_back(obs);
+    }
+    return observations;
+}
+
+
+BOOST_AUTO_TEST_CASE( test_loglhood_matches_reference )
+{
+    const auto observations(getTestObservations());
+    IndelModelProductionMinFunc minFunc(observations, std::log(1e-4));
+
+    const double params[][MIN_PARAMS3::SIZE] =
+    {
+        { std::log(1e-3), std::log(1e-3), std::log(0.4), std::log(1e-4) },
+        { std::log(2e-2), std::log(5e-4), std::log(0.05), std::log(3e-3) },
+        { std::log(1e-5), std::log(1e-1), std::log(0.9), std::log(1e-2) }
+    };
+
+    for (const auto& param : params)
+    {
+        const double expect(getReferenceLogLhood(observations, param));
+        BOOST_REQUIRE_CLOSE(minFunc.getLogLhood(param), expect, 1e-8);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_gradient_matches_finite_difference )
+{
+    const auto observations(getTestObservations());
+
+    for (const bool isLockTheta : { false, true })
+    {
+        IndelModelProductionMinFunc minFunc(observations, std::log(1e-4), isLockTheta);
+        const unsigned dim(minFunc.dim());
+
+        // include arguments on both sides of the smoother trigger values:
+        const double args[][MIN_PARAMS3::SIZE] =
+        {
+            { std::log(1e-3)-0.5, std::log(1e-3)-1, std::log(0.4), std::log(1e-4) },
+            { std::log(5e-3), std::log(1e-4), std::log(0.85), std::log(2e-3) }
+        };
+
+        for (const auto& arg : args)
+        {
+            double grad[MIN_PARAMS3::SIZE];
+            minFunc.dval(arg, grad);
+
+            static const double step(1e-6);
+            for (unsigned argIndex(0); argIndex<dim; ++argIndex)
+            {
+                double argPlus[MIN_PARAMS3::SIZE];
+                double argMinus[MIN_PARAMS3::SIZE];
+                std::copy(arg, arg+MIN_PARAMS3::SIZE, argPlus);
+                std::copy(arg, arg+MIN_PARAMS3::SIZE, argMinus);
+                argPlus[argIndex] += step;
+                argMinus[argIndex] -= step;
+                const double numericGrad((minFunc.val(argPlus) - minFunc.val(argMinus)) / (2*step));
+                BOOST_REQUIRE_CLOSE(grad[argIndex], numericGrad, 1e-3);
+            }
+        }
+    }
+}
+
+/// strongly correlated quadratic with minimum at (1,2)
+struct CorrelatedQuadraticMinFunc : public codemin::minfunc_gradient_interface<double>
+{
+    unsigned dim() const override
+    {
+        return 2;
+    }
+
+    double
+    val(const double* in) override
+    {
+        return dval(in, nullptr);
+    }
+
+    double
+    dval(
+        const double* in,
+        double* dv) override
+    {
+        const double a(in[0]-1);
+        const double b(in[1]-2);
+        if (dv != nullptr)
+        {
+            dv[0] = 200*a - 199*b;
+            dv[1] = 200*b - 199*a;
+        }
+        return (100*a*a + 100*b*b - 199*a*b);
+    }
+};
+
+
+BOOST_AUTO_TEST_CASE( test_minimize_bfgs )
+{
+    CorrelatedQuadraticMinFunc minFunc;
+    double x[] = { -3., 5. };
+    double fMin;
+    unsigned iter;
+    double finalIterDeltaF;
+    static const unsigned maxIter(40);
+    minimizeBfgs(x, minFunc, 1e-12, fMin, iter, finalIterDeltaF, maxIter);
+
+    BOOST_REQUIRE_LT(iter, maxIter);
+    BOOST_REQUIRE_SMALL(fMin, 1e-8);
+    BOOST_REQUIRE_CLOSE(x[0], 1., 1e-3);
+    BOOST_REQUIRE_CLOSE(x[1], 2., 1e-3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
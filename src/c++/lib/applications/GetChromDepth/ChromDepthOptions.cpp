@@ -79,6 +79,20 @@ parseOptions(
         return true;
     }
 
+    if (opt.sampleWindowSize == 0)
+    {
+        errorMsg = "Sample window size must be greater than zero";
+        return true;
+    }
+
+    if (opt.threadCount == 0)
+    {
+        errorMsg = "Thread count must be greater than zero";
+        return true;
+    }
+
+    opt.isUseIndexReadCounts = vm.count("index-read-counts");
+
     return false;
 }
 
@@ -103,12 +117,27 @@ parseChromDepthOptions(
      "fasta reference sequence (required)")
     ;
 
+    po::options_description sample("sampling");
+    sample.add_options()
+    ("sample-windows", po::value(&opt.sampleWindowCount)->default_value(opt.sampleWindowCount),
+     "If non-zero, estimate the median depth of each chromosome from this many evenly spaced windows, and report "
+     "an approximate confidence interval for each estimate to the log. If zero, the chromosome is scanned until "
+     "the depth estimate converges.")
+    ("sample-window-size", po::value(&opt.sampleWindowSize)->default_value(opt.sampleWindowSize),
+     "Size of each sampled window in bases")
+    ("index-read-counts",
+     "Estimate mean chromosome depth from the read counts stored in the BAI/CSI index when read length is uniform. "
+     "Falls back to the alignment based estimate when this is not possible, such as for CRAM input.")
+    ("threads", po::value(&opt.threadCount)->default_value(opt.threadCount),
+     "Number of chromosomes to process concurrently")
+    ;
+
     po::options_description help("help");
     help.add_options()
     ("help,h","print this message");
 
     po::options_description visible("options");
-    visible.add(req).add(help);
+    visible.add(req).add(sample).add(help);
 
     bool po_parse_fail(false);
     po::variables_map vm;
@@ -33,6 +33,17 @@ struct ChromDepthOptions
 
     std::string referenceFilename;
     std::string outputFilename;
+
+    /// if non-zero, estimate depth from this many evenly spaced windows per chromosome instead of the default
+    /// convergence scan
+    unsigned sampleWindowCount = 0;
+    unsigned sampleWindowSize = 20000;
+
+    /// if true, estimate depth from BAI/CSI index read counts where possible
+    bool isUseIndexReadCounts = false;
+
+    /// number of chromosomes to process concurrently
+    unsigned threadCount = 1;
 };
 
 
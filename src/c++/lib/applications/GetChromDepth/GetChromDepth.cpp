@@ -21,13 +21,57 @@
 #include "ChromDepthOptions.hh"
 #include "ReadChromDepthUtil.hh"
 
+#include "blt_util/WorkerThreadPool.hh"
 #include "blt_util/log.hh"
 #include "common/OutStream.hh"
 
 #include <cstdlib>
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
+
+
+
+/// estimate depth of a single chromosome according to the sampling mode in opt
+///
+/// \param[out] logMsg any information on the estimate intended for the log
+static
+double
+getSingleChromDepth(
+    const ChromDepthOptions& opt,
+    const std::string& chromName,
+    std::string& logMsg)
+{
+    logMsg.clear();
+
+    if (opt.isUseIndexReadCounts)
+    {
+        double depth(0);
+        if (readChromDepthFromIndex(opt.referenceFilename, opt.alignmentFilename, chromName, depth))
+        {
+            return depth;
+        }
+    }
+
+    if (opt.sampleWindowCount == 0)
+    {
+        return readChromDepthFromAlignment(opt.referenceFilename, opt.alignmentFilename, chromName);
+    }
+
+    const ChromDepthEstimate estimate(
+        readChromDepthFromAlignmentSample(opt.referenceFilename, opt.alignmentFilename, chromName,
+                                          opt.sampleWindowCount, opt.sampleWindowSize));
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "INFO: Sampled depth for chromosome '" << chromName << "': " << estimate.depth
+        << " (95% CI: " << estimate.lowerDepth << "-" << estimate.upperDepth << ")"
+        << " from " << estimate.windowCount << " windows with read data\n";
+    logMsg = oss.str();
+    return estimate.depth;
+}
 
 
 
@@ -40,16 +84,25 @@ getChromDepth(const ChromDepthOptions& opt)
         OutStream outs(opt.outputFilename);
     }
 
-    std::vector<double> chromDepth;
-    for (const std::string& chromName : opt.chromNames)
+    const unsigned chromCount(opt.chromNames.size());
+    std::vector<double> chromDepth(chromCount,0);
+    std::vector<std::string> chromLogMsg(chromCount);
+
+    // each task opens its own alignment file stream for one chromosome:
+    WorkerThreadPool pool(std::min(opt.threadCount, chromCount));
+    pool.run(chromCount, [&](const unsigned chromIndex, const unsigned /*threadIndex*/)
+    {
+        chromDepth[chromIndex] = getSingleChromDepth(opt, opt.chromNames[chromIndex], chromLogMsg[chromIndex]);
+    });
+
+    for (const std::string& logMsg : chromLogMsg)
     {
-        chromDepth.push_back(readChromDepthFromAlignment(opt.referenceFilename, opt.alignmentFilename, chromName));
+        log_os << logMsg;
     }
 
     OutStream outs(opt.outputFilename);
     std::ostream& os(outs.getStream());
 
-    const unsigned chromCount(opt.chromNames.size());
     for (unsigned chromIndex(0); chromIndex<chromCount; ++chromIndex)
     {
         os << opt.chromNames[chromIndex] << "\t" << std::fixed << std::setprecision(2) << chromDepth[chromIndex] << "\n";
@@ -30,9 +30,12 @@
 #include "common/Exceptions.hh"
 #include "htsapi/bam_header_info.hh"
 #include "htsapi/bam_streamer.hh"
+#include "htsapi/samtools_fasta_util.hh"
 #include "starling_common/starling_read_filter_shared.hh"
 
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -359,17 +362,14 @@ getChromSegments(
 
 
 
-double
-readChromDepthFromAlignment(
-    const std::string& referenceFile,
+/// \return zero-indexed contig id of chromName in the alignment file header
+static
+int32_t
+getChromIndex(
+    const bam_header_info& bamHeader,
     const std::string& alignmentFile,
     const std::string& chromName)
 {
-    bam_streamer read_stream(alignmentFile.c_str(), referenceFile.c_str());
-
-    const bam_hdr_t& header(read_stream.get_header());
-    const bam_header_info bamHeader(header);
-
     const auto& chromToIndex(bamHeader.chrom_to_index);
     const auto chromIter(chromToIndex.find(chromName));
     if (chromIter == chromToIndex.end())
@@ -381,7 +381,23 @@ readChromDepthFromAlignment(
         BOOST_THROW_EXCEPTION(LogicException(oss.str()));
     }
 
-    const int32_t chromIndex(chromIter->second);
+    return chromIter->second;
+}
+
+
+
+double
+readChromDepthFromAlignment(
+    const std::string& referenceFile,
+    const std::string& alignmentFile,
+    const std::string& chromName)
+{
+    bam_streamer read_stream(alignmentFile.c_str(), referenceFile.c_str());
+
+    const bam_hdr_t& header(read_stream.get_header());
+    const bam_header_info bamHeader(header);
+
+    const int32_t chromIndex(getChromIndex(bamHeader, alignmentFile, chromName));
 
     const unsigned chromSize(bamHeader.chrom_data[chromIndex].length);
     unsigned segmentSize(2000000);
@@ -503,3 +519,204 @@ readChromDepthFromAlignment(
 
     return cdTracker.getDepth();
 }
+
+
+
+/// get the start positions of sample windows evenly spaced over a chromosome
+///
+/// all are zero-indexed
+static
+void
+getSampleWindows(
+    const unsigned chromSize,
+    const unsigned maxWindowCount,
+    const unsigned windowSize,
+    std::vector<unsigned>& startPos)
+{
+    assert(chromSize>0);
+    assert(windowSize>0);
+
+    startPos.clear();
+
+    const unsigned windowCount(std::max(1u,std::min(maxWindowCount, chromSize/windowSize)));
+    for (unsigned windowIndex(0); windowIndex<windowCount; ++windowIndex)
+    {
+        // center each window in one of windowCount equal chromosome partitions:
+        const uint64_t center(((2*static_cast<uint64_t>(windowIndex)+1)*chromSize)/(2*windowCount));
+        const uint64_t halfSize(windowSize/2);
+        startPos.push_back((center > halfSize) ? (center-halfSize) : 0);
+    }
+}
+
+
+
+ChromDepthEstimate
+readChromDepthFromAlignmentSample(
+    const std::string& referenceFile,
+    const std::string& alignmentFile,
+    const std::string& chromName,
+    const unsigned sampleWindowCount,
+    const unsigned sampleWindowSize)
+{
+    assert(sampleWindowCount>0);
+
+    bam_streamer read_stream(alignmentFile.c_str(), referenceFile.c_str());
+
+    const bam_hdr_t& header(read_stream.get_header());
+    const bam_header_info bamHeader(header);
+
+    const int32_t chromIndex(getChromIndex(bamHeader, alignmentFile, chromName));
+
+    const unsigned chromSize(bamHeader.chrom_data[chromIndex].length);
+    const unsigned windowSize(std::min(sampleWindowSize, chromSize));
+    std::vector<unsigned> windowStartPos;
+    getSampleWindows(chromSize, sampleWindowCount, windowSize, windowStartPos);
+
+    DepthTracker chromTracker;
+    std::vector<double> windowDepth;
+
+    for (const unsigned windowStart : windowStartPos)
+    {
+        const int32_t startPos(windowStart);
+        const int32_t endPos(std::min(windowStart+windowSize, chromSize));
+        read_stream.resetRegion(chromIndex, startPos, endPos);
+
+        chromTracker.setNewRegion();
+        DepthTracker windowTracker;
+
+        while (read_stream.next())
+        {
+            const bam_record& bamRead(*(read_stream.get_record_ptr()));
+            const int32_t readPos(bamRead.pos()-1);
+
+            // reads starting before the window belong to the (unsampled) upstream region:
+            if (readPos<startPos) continue;
+
+            const READ_FILTER_TYPE::index_t filterId(starling_read_filter_shared(bamRead));
+            if (filterId != READ_FILTER_TYPE::NONE) continue;
+
+            chromTracker.addRead(bamRead);
+            windowTracker.addRead(bamRead);
+        }
+
+        if (windowTracker.getReadCount() == 0) continue;
+        windowTracker.setNewRegion();
+        windowDepth.push_back(windowTracker.getDepth());
+    }
+    chromTracker.setNewRegion();
+
+    ChromDepthEstimate estimate;
+    estimate.windowCount = windowDepth.size();
+    if (windowDepth.empty()) return estimate;
+
+    estimate.depth = chromTracker.getDepth();
+
+    // distribution-free confidence interval of the median from the order statistics of the window medians:
+    std::sort(windowDepth.begin(), windowDepth.end());
+    const double n(windowDepth.size());
+    static const double halfZ(1.96/2.);
+    const double lowerRank(std::floor(n/2. - halfZ*std::sqrt(n)));
+    const double upperRank(std::ceil(n/2. + halfZ*std::sqrt(n)));
+    const unsigned maxRank(windowDepth.size()-1);
+    estimate.lowerDepth = windowDepth[static_cast<unsigned>(std::max(0., lowerRank))];
+    estimate.upperDepth = windowDepth[std::min(maxRank, static_cast<unsigned>(upperRank))];
+
+    return estimate;
+}
+
+
+
+/// count all non-N bases of a chromosome in the reference
+static
+uint64_t
+getKnownReferenceBaseCount(
+    const std::string& referenceFile,
+    const std::string& chromName,
+    const unsigned chromSize)
+{
+    // read the reference in chunks to bound memory use on large chromosomes:
+    static const unsigned chunkSize(1 << 24);
+
+    uint64_t knownBaseCount(0);
+    std::string refSeq;
+    for (unsigned beginPos(0); beginPos<chromSize; beginPos += std::min(chunkSize, chromSize-beginPos))
+    {
+        const unsigned endPos(std::min(chromSize, beginPos+chunkSize));
+        get_standardized_region_seq(referenceFile, chromName, beginPos, endPos-1, refSeq);
+        knownBaseCount += std::count_if(refSeq.begin(), refSeq.end(), [](const char c)
+        {
+            return (c != 'N');
+        });
+    }
+    return knownBaseCount;
+}
+
+
+
+bool
+readChromDepthFromIndex(
+    const std::string& referenceFile,
+    const std::string& alignmentFile,
+    const std::string& chromName,
+    double& depth)
+{
+    depth = 0;
+
+    bam_streamer read_stream(alignmentFile.c_str(), referenceFile.c_str());
+
+    const bam_hdr_t& header(read_stream.get_header());
+    const bam_header_info bamHeader(header);
+
+    const int32_t chromIndex(getChromIndex(bamHeader, alignmentFile, chromName));
+
+    uint64_t mappedCount(0), unmappedCount(0);
+    if (! read_stream.getIndexReadCounts(chromIndex, mappedCount, unmappedCount)) return false;
+    if (mappedCount == 0) return true;
+
+    // sample reads from evenly spaced positions across the chromosome to check for uniform read length, and
+    // find the fraction of mapped reads which pass the depth filters:
+    const unsigned chromSize(bamHeader.chrom_data[chromIndex].length);
+
+    static const unsigned sampleLocationCount(10);
+    static const unsigned maxLocationSampleReadCount(1000);
+    unsigned sampleReadCount(0);
+    unsigned passedReadCount(0);
+    unsigned readLength(0);
+    for (unsigned locationIndex(0); locationIndex<sampleLocationCount; ++locationIndex)
+    {
+        const int32_t beginPos((static_cast<uint64_t>(chromSize)*locationIndex)/sampleLocationCount);
+        read_stream.resetRegion(chromIndex, beginPos, chromSize);
+
+        unsigned locationSampleReadCount(0);
+        while ((locationSampleReadCount < maxLocationSampleReadCount) && read_stream.next())
+        {
+            const bam_record& bamRead(*(read_stream.get_record_ptr()));
+            if (bamRead.is_unmapped()) continue;
+
+            const unsigned readSize(bamRead.read_size());
+            if (sampleReadCount == 0)
+            {
+                readLength = readSize;
+            }
+            else if (readSize != readLength)
+            {
+                return false;
+            }
+            sampleReadCount++;
+            locationSampleReadCount++;
+
+            const READ_FILTER_TYPE::index_t filterId(starling_read_filter_shared(bamRead));
+            if (filterId == READ_FILTER_TYPE::NONE) passedReadCount++;
+        }
+    }
+
+    if (sampleReadCount == 0) return true;
+
+    // depth is averaged over known reference bases only, so that N gaps do not dilute the estimate:
+    const uint64_t knownBaseCount(getKnownReferenceBaseCount(referenceFile, chromName, chromSize));
+    if (knownBaseCount == 0) return true;
+
+    const double passedFraction(static_cast<double>(passedReadCount)/sampleReadCount);
+    depth = (mappedCount * passedFraction * readLength) / knownBaseCount;
+    return true;
+}
@@ -34,3 +34,53 @@ readChromDepthFromAlignment(
     const std::string& referenceFile,
     const std::string& alignmentFile,
     const std::string& chromName);
+
+
+/// Chromosome depth estimated from a sample of alignment windows
+struct ChromDepthEstimate
+{
+    /// median depth over all sampled positions with non-zero depth
+    double depth = 0;
+
+    /// approximate 95% confidence interval of the median depth, based on the spread of per-window median depths
+    double lowerDepth = 0;
+    double upperDepth = 0;
+
+    /// number of sampled windows which contained at least one read
+    unsigned windowCount = 0;
+};
+
+
+/// Chrom depth estimator for BAM/CRAM files which only reads a fixed number of evenly spaced windows
+///
+/// Only the index-selected part of the alignment file overlapping each window is read and decoded, so the
+/// cost of the estimate does not depend on the layout of reads along the chromosome.
+///
+/// \param sampleWindowCount maximum number of windows to read from the chromosome
+/// \param sampleWindowSize size of each window in bases
+ChromDepthEstimate
+readChromDepthFromAlignmentSample(
+    const std::string& referenceFile,
+    const std::string& alignmentFile,
+    const std::string& chromName,
+    const unsigned sampleWindowCount,
+    const unsigned sampleWindowSize);
+
+
+/// Chrom depth estimator using the mapped read count stored in a BAI/CSI index
+///
+/// The result is the mean read depth over the known (non-N) reference bases of the chromosome, found from the
+/// index read count, scaled by the fraction of reads passing the depth filters in read samples taken from evenly
+/// spaced positions across the chromosome. This is a lower resolution estimate than the median depths of the
+/// alignment based estimators, because the mean still includes any sequenced regions without read coverage.
+///
+/// \param[out] depth average chromosome depth
+///
+/// \return false if the estimate is not available, because the index does not store read counts or read length
+///         is not uniform in the read sample
+bool
+readChromDepthFromIndex(
+    const std::string& referenceFile,
+    const std::string& alignmentFile,
+    const std::string& chromName,
+    double& depth);
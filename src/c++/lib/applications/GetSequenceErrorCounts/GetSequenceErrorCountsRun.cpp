@@ -138,6 +138,7 @@ getSequenceErrorCountsRun(
             const vcf_streamer& vcfStream(
                 streamData.registerVcf(opt.knownVariantsFile.c_str(), INPUT_TYPE::KNOWN_VARIANTS));
             vcfStream.validateBamHeaderChromSync(referenceHeader);
+            vcfStream.requireTextVcf("Known variants VCF");
         }
 
         for (const std::string& excludeRegionFilename : opt.excludedRegionsFileList)
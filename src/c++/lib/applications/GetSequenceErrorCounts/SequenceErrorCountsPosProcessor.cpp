@@ -107,6 +107,11 @@ completeProcessing()
 {
     reset();
 
+    _baseCounts.exportCounts(_counts.getBaseCounts());
+    _indelCounts.exportCounts(_counts.getIndelCounts());
+    _baseCounts.clear();
+    _indelCounts.clear();
+
     _counts.save(_opt.countsFilename.c_str());
 
     if (! _opt.nonEmptySiteCountFilename.empty())
@@ -407,8 +412,8 @@ process_pos_error_counts(
 
     if (refBase=='N') return;
 
-    BaseErrorCounts& baseCounts(_counts.getBaseCounts());
-    IndelErrorCounts& indelCounts(_counts.getIndelCounts());
+    BaseErrorCountsAccumulator& baseCounts(_baseCounts);
+    IndelErrorCountsAccumulator& indelCounts(_indelCounts);
 
     // right now there's only one baseContext (ie. only one context used for SNVs and basecalls), this
     // is why we set it as const here
@@ -511,7 +516,8 @@ process_pos_error_counts(
         {
             bool isEmpty(true);
             const uint8_t ref_id(base_to_id(refBase));
-            BaseErrorContextInputObservation obs;
+            BaseErrorContextInputObservation& obs(_siteObservation);
+            obs.clear();
             for (const base_call& bc : sinfo.calls)
             {
                 if (bc.is_call_filter) continue;
@@ -25,6 +25,8 @@
 
 #include "SequenceErrorCountsOptions.hh"
 #include "SequenceErrorCountsStreams.hh"
+#include "errorAnalysis/BaseErrorCountsAccumulator.hh"
+#include "errorAnalysis/IndelErrorCountsAccumulator.hh"
 #include "errorAnalysis/SequenceErrorCounts.hh"
 #include "starling_common/starling_pos_processor_base.hh"
 
@@ -95,6 +97,13 @@ private:
 
     SequenceErrorCounts _counts;
 
+    /// site and indel observations are accumulated here and transferred to _counts when processing completes
+    BaseErrorCountsAccumulator _baseCounts;
+    IndelErrorCountsAccumulator _indelCounts;
+
+    /// reused for every site observation to avoid reinitializing the per-quality count arrays
+    BaseErrorContextInputObservation _siteObservation;
+
     double _max_candidate_normal_sample_depth = -1;
 
     RegionTracker _excludedRegions;
@@ -58,11 +58,11 @@ parseMRSOptions(
 
     req.add_options()
     ("stats-file", po::value(&opt.statsFilename),
-     "input run stats file (may be specified multiple times)")
+     "input run stats file in binary or xml format (may be specified multiple times)")
     ("stats-file-list", po::value(&opt.statsFilenameList),
      "file listing all input stats files, one filename per line (specified only once)")
     ("output-file", po::value(&opt.outputFilename),
-     "merged output stats file (required)")
+     "merged output stats file in xml format (required)")
     ("report-file", po::value(&opt.reportFilename),
      "provide a summary report based on the merged stats");
 
@@ -63,6 +63,8 @@ parseMSECOptions(
      "file listing all input counts files, one filename per line (specified only once)")
     ("output-file", po::value(&opt.outputFilename),
      "merged output counts file (required)")
+    ("threads", po::value(&opt.threadCount)->default_value(opt.threadCount),
+     "number of threads used to load and merge input counts files")
     ;
 
     po::options_description help("help");
@@ -146,5 +148,10 @@ parseMSECOptions(
     {
         usage(log_os,prog,visible, "Must specify merged counts output file");
     }
+
+    if (opt.threadCount < 1)
+    {
+        usage(log_os,prog,visible, "Thread count must be at least 1");
+    }
 }
 
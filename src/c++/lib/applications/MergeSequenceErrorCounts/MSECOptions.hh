@@ -35,6 +35,7 @@ struct MSECOptions
     std::vector<std::string> countsFilename;
     std::string countsFilenameList;
     std::string outputFilename;
+    unsigned threadCount = 1;
 };
 
 
@@ -25,8 +25,46 @@
 #include "MSECOptions.hh"
 #include "errorAnalysis/SequenceErrorCounts.hh"
 
+#include "blt_util/WorkerThreadPool.hh"
 #include "common/OutStream.hh"
 
+#include <algorithm>
+
+
+
+/// merge a range of counts files into mergedCounts
+///
+/// files are loaded in batches, and each batch is combined with the current merged result in one
+/// k-way merge, this limits memory use while keeping the number of merge passes low
+///
+static
+void
+mergeCountsFiles(
+    const std::vector<std::string>& countsFilenames,
+    const unsigned beginIndex,
+    const unsigned endIndex,
+    SequenceErrorCounts& mergedCounts)
+{
+    static const unsigned maxBatchSize(64);
+
+    std::vector<SequenceErrorCounts> batch;
+    std::vector<const SequenceErrorCounts*> batchPtrs;
+    for (unsigned batchBeginIndex(beginIndex); batchBeginIndex < endIndex; batchBeginIndex += maxBatchSize)
+    {
+        const unsigned batchEndIndex(std::min(endIndex, batchBeginIndex + maxBatchSize));
+        batch.clear();
+        batch.resize(batchEndIndex - batchBeginIndex);
+        batchPtrs.clear();
+        for (unsigned fileIndex(batchBeginIndex); fileIndex < batchEndIndex; ++fileIndex)
+        {
+            SequenceErrorCounts& inputCounts(batch[fileIndex - batchBeginIndex]);
+            inputCounts.load(countsFilenames[fileIndex].c_str());
+            batchPtrs.push_back(&inputCounts);
+        }
+        mergedCounts.merge(batchPtrs);
+    }
+}
+
 
 
 static
@@ -38,21 +76,33 @@ runMSEC(const MSECOptions& opt)
         OutStream outs(opt.outputFilename);
     }
 
+    // each task merges a contiguous block of the input files, and the partial results from all
+    // tasks are reduced in a final k-way merge:
+    const unsigned fileCount(opt.countsFilename.size());
+    const unsigned blockCount(std::max(1u, std::min(opt.threadCount, fileCount)));
+    std::vector<SequenceErrorCounts> blockCounts(blockCount);
+
+    WorkerThreadPool pool(blockCount);
+    pool.run(blockCount, [&](const unsigned blockIndex, const unsigned /*threadIndex*/)
+    {
+        const unsigned beginIndex((fileCount * blockIndex) / blockCount);
+        const unsigned endIndex((fileCount * (blockIndex + 1)) / blockCount);
+        mergeCountsFiles(opt.countsFilename, beginIndex, endIndex, blockCounts[blockIndex]);
+    });
+
     SequenceErrorCounts mergedCounts;
-    bool isFirst(true);
-    for (const std::string& countsFilename : opt.countsFilename)
+    if (blockCount == 1)
     {
-        if (isFirst)
-        {
-            mergedCounts.load(countsFilename.c_str());
-            isFirst=false;
-        }
-        else
+        std::swap(mergedCounts, blockCounts[0]);
+    }
+    else
+    {
+        std::vector<const SequenceErrorCounts*> blockCountsPtrs;
+        for (const SequenceErrorCounts& counts : blockCounts)
         {
-            SequenceErrorCounts inputCounts;
-            inputCounts.load(countsFilename.c_str());
-            mergedCounts.merge(inputCounts);
+            blockCountsPtrs.push_back(&counts);
         }
+        mergedCounts.merge(blockCountsPtrs);
     }
 
     mergedCounts.save(opt.outputFilename.c_str());
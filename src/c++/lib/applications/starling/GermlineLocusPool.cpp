@@ -0,0 +1,88 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+
+#include "GermlineLocusPool.hh"
+
+
+
+std::unique_ptr<GermlineDiploidSiteLocusInfo>
+GermlineLocusPool::
+getDiploidSiteLocus(
+    const pos_t pos,
+    const uint8_t refBaseIndex,
+    const bool isForcedOutput)
+{
+    if (_siteLoci.empty())
+    {
+        return std::unique_ptr<GermlineDiploidSiteLocusInfo>(
+                   new GermlineDiploidSiteLocusInfo(_gvcfDerivedOptions, _sampleCount, pos, refBaseIndex, isForcedOutput));
+    }
+
+    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(std::move(_siteLoci.back()));
+    _siteLoci.pop_back();
+    locusPtr->reset(pos, refBaseIndex, isForcedOutput);
+    return locusPtr;
+}
+
+
+
+std::unique_ptr<GermlineDiploidIndelLocusInfo>
+GermlineLocusPool::
+getDiploidIndelLocus()
+{
+    if (_indelLoci.empty())
+    {
+        return std::unique_ptr<GermlineDiploidIndelLocusInfo>(
+                   new GermlineDiploidIndelLocusInfo(_gvcfDerivedOptions, _sampleCount));
+    }
+
+    std::unique_ptr<GermlineDiploidIndelLocusInfo> locusPtr(std::move(_indelLoci.back()));
+    _indelLoci.pop_back();
+    locusPtr->reset();
+    return locusPtr;
+}
+
+
+
+void
+GermlineLocusPool::
+recycle(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
+{
+    if (not locusPtr) return;
+    if (not GermlineDiploidSiteLocusInfo::isInstance(*locusPtr)) return;
+    assert(locusPtr->getSampleCount() == _sampleCount);
+
+    _siteLoci.emplace_back(static_cast<GermlineDiploidSiteLocusInfo*>(locusPtr.release()));
+}
+
+
+
+void
+GermlineLocusPool::
+recycle(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
+{
+    if (not locusPtr) return;
+    if (not GermlineDiploidIndelLocusInfo::isInstance(*locusPtr)) return;
+    assert(locusPtr->getSampleCount() == _sampleCount);
+
+    _indelLoci.emplace_back(static_cast<GermlineDiploidIndelLocusInfo*>(locusPtr.release()));
+}
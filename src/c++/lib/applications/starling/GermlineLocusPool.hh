@@ -0,0 +1,80 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+
+#pragma once
+
+#include "gvcf_locus_info.hh"
+
+#include <memory>
+#include <vector>
+
+
+/// Recycles germline locus objects passed through the variant pipeline
+///
+/// Each locus carries per-sample and per-allele vectors which would otherwise be allocated for every
+/// locus created by the position processor and freed after the locus is written by the gVCF writer.
+/// Loci returned to the pool are reset and handed out again with all of their storage retained.
+///
+/// All loci in a pool share the sample count given on construction. Only the diploid locus types are
+/// recycled, other locus types returned to the pool are deleted.
+///
+struct GermlineLocusPool
+{
+    GermlineLocusPool(
+        const gvcf_deriv_options& gvcfDerivedOptions,
+        const unsigned sampleCount)
+        : _gvcfDerivedOptions(gvcfDerivedOptions),
+          _sampleCount(sampleCount)
+    {}
+
+    unsigned
+    getSampleCount() const
+    {
+        return _sampleCount;
+    }
+
+    /// get a diploid site locus in the same state as a newly constructed locus
+    std::unique_ptr<GermlineDiploidSiteLocusInfo>
+    getDiploidSiteLocus(
+        const pos_t pos,
+        const uint8_t refBaseIndex,
+        const bool isForcedOutput = false);
+
+    /// get a diploid indel locus in the same state as a newly constructed locus
+    std::unique_ptr<GermlineDiploidIndelLocusInfo>
+    getDiploidIndelLocus();
+
+    /// return a site locus to the pool
+    void
+    recycle(std::unique_ptr<GermlineSiteLocusInfo> locusPtr);
+
+    /// return an indel locus to the pool
+    void
+    recycle(std::unique_ptr<GermlineIndelLocusInfo> locusPtr);
+
+private:
+    const gvcf_deriv_options& _gvcfDerivedOptions;
+    const unsigned _sampleCount;
+
+    std::vector<std::unique_ptr<GermlineDiploidSiteLocusInfo>> _siteLoci;
+    std::vector<std::unique_ptr<GermlineDiploidIndelLocusInfo>> _indelLoci;
+};
@@ -0,0 +1,609 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "GermlineSiteEvidence.hh"
+
+#include "common/BinaryColumnIO.hh"
+#include "common/Exceptions.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+
+static const char siteEvidenceFileMagic[8] = {'S','T','R','K','S','E','V','\0'};
+
+/// increment when the site evidence file format changes
+static const uint32_t siteEvidenceFileVersion(2);
+
+
+namespace SITE_EVIDENCE_BLOCK
+{
+enum index_t : uint8_t
+{
+    END,
+    REGION,
+    SITE,
+    INDEL
+};
+}
+
+
+
+void
+GermlineSiteSampleEvidence::
+clear()
+{
+    groupLocusPloidy = 2;
+    spanningIndelPloidyModification = 0;
+    dgt.reset();
+    fwdBaseCounts.fill(0);
+    revBaseCounts.fill(0);
+    usedCallCount = 0;
+    unusedCallCount = 0;
+    spanningDeletionReadCount = 0;
+    mapqTracker.clear();
+    isScoringFeatures = false;
+    ReadPosRankSum = 0;
+    MQRankSum = 0;
+    BaseQRankSum = 0;
+    meanDistanceFromReadEdge = 0;
+    rawPos = 0;
+    avgBaseQ = 0;
+    haplotypeId.fill(0);
+    altHaplotypeCountRatio = 0;
+    activeRegionId = -1;
+    isIndelCandidateOverlap = false;
+    rawPileupPtr = nullptr;
+}
+
+
+
+void
+GermlineSiteSampleEvidence::
+setScoringFeatures(const snp_pos_info& pi)
+{
+    isScoringFeatures = true;
+    ReadPosRankSum = pi.get_read_pos_ranksum();
+    MQRankSum = pi.get_mq_ranksum();
+    BaseQRankSum = pi.get_baseq_ranksum();
+    meanDistanceFromReadEdge = pi.distanceFromReadEdge.mean();
+    rawPos = pi.get_raw_pos();
+    avgBaseQ = pi.get_raw_baseQ();
+}
+
+
+
+static
+void
+writeResultSet(
+    std::ostream& os,
+    const diploid_genotype::result_set& resultSet)
+{
+    using namespace BinaryColumnIO;
+    writeValue(os, resultSet.max_gt);
+    writeValue(os, resultSet.ref_pprob);
+    writeValue(os, resultSet.snp_qphred);
+    writeValue(os, resultSet.max_gt_qphred);
+}
+
+
+
+static
+void
+readResultSet(
+    std::istream& is,
+    diploid_genotype::result_set& resultSet)
+{
+    using namespace BinaryColumnIO;
+    readValue(is, resultSet.max_gt);
+    readValue(is, resultSet.ref_pprob);
+    readValue(is, resultSet.snp_qphred);
+    readValue(is, resultSet.max_gt_qphred);
+}
+
+
+
+static
+void
+writeSiteSampleEvidence(
+    std::ostream& os,
+    const GermlineSiteSampleEvidence& evidence)
+{
+    using namespace BinaryColumnIO;
+
+    writeValue(os, evidence.groupLocusPloidy);
+    writeValue(os, evidence.spanningIndelPloidyModification);
+
+    const diploid_genotype& dgt(evidence.dgt);
+    writeValue(os, dgt.ploidy);
+    writeValue(os, dgt.ref_gt);
+    writeValue(os, dgt.strand_bias);
+    writeResultSet(os, dgt.genome);
+    writeResultSet(os, dgt.poly);
+    for (const unsigned phredLoghood : dgt.phredLoghood)
+    {
+        writeValue(os, phredLoghood);
+    }
+
+    writeValue(os, evidence.fwdBaseCounts);
+    writeValue(os, evidence.revBaseCounts);
+    writeValue(os, evidence.usedCallCount);
+    writeValue(os, evidence.unusedCallCount);
+    writeValue(os, evidence.spanningDeletionReadCount);
+    writeValue(os, evidence.mapqTracker.count);
+    writeValue(os, evidence.mapqTracker.zeroCount);
+    writeValue(os, evidence.mapqTracker.sumSquare);
+
+    writeValue(os, evidence.isScoringFeatures);
+    if (evidence.isScoringFeatures)
+    {
+        writeValue(os, evidence.ReadPosRankSum);
+        writeValue(os, evidence.MQRankSum);
+        writeValue(os, evidence.BaseQRankSum);
+        writeValue(os, evidence.meanDistanceFromReadEdge);
+        writeValue(os, evidence.rawPos);
+        writeValue(os, evidence.avgBaseQ);
+    }
+
+    writeValue(os, evidence.haplotypeId);
+    writeValue(os, evidence.altHaplotypeCountRatio);
+    writeValue(os, evidence.activeRegionId);
+}
+
+
+
+static
+void
+readSiteSampleEvidence(
+    std::istream& is,
+    GermlineSiteSampleEvidence& evidence)
+{
+    using namespace BinaryColumnIO;
+
+    evidence.clear();
+
+    readValue(is, evidence.groupLocusPloidy);
+    readValue(is, evidence.spanningIndelPloidyModification);
+
+    diploid_genotype& dgt(evidence.dgt);
+    readValue(is, dgt.ploidy);
+    readValue(is, dgt.ref_gt);
+    readValue(is, dgt.strand_bias);
+    readResultSet(is, dgt.genome);
+    readResultSet(is, dgt.poly);
+    for (unsigned& phredLoghood : dgt.phredLoghood)
+    {
+        readValue(is, phredLoghood);
+    }
+
+    readValue(is, evidence.fwdBaseCounts);
+    readValue(is, evidence.revBaseCounts);
+    readValue(is, evidence.usedCallCount);
+    readValue(is, evidence.unusedCallCount);
+    readValue(is, evidence.spanningDeletionReadCount);
+    readValue(is, evidence.mapqTracker.count);
+    readValue(is, evidence.mapqTracker.zeroCount);
+    readValue(is, evidence.mapqTracker.sumSquare);
+
+    readValue(is, evidence.isScoringFeatures);
+    if (evidence.isScoringFeatures)
+    {
+        readValue(is, evidence.ReadPosRankSum);
+        readValue(is, evidence.MQRankSum);
+        readValue(is, evidence.BaseQRankSum);
+        readValue(is, evidence.meanDistanceFromReadEdge);
+        readValue(is, evidence.rawPos);
+        readValue(is, evidence.avgBaseQ);
+    }
+
+    readValue(is, evidence.haplotypeId);
+    readValue(is, evidence.altHaplotypeCountRatio);
+    readValue(is, evidence.activeRegionId);
+}
+
+
+
+GermlineSiteEvidenceWriter::
+GermlineSiteEvidenceWriter(
+    const std::string& filename,
+    const std::string& sampleName,
+    const bam_hdr_t& header)
+    : _filename(filename),
+      _ofs(filename, std::ios::binary),
+      _headerInfo(header)
+{
+    using namespace illumina::common;
+
+    if (! _ofs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to open site evidence file for writing: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    using namespace BinaryColumnIO;
+
+    _ofs.write(siteEvidenceFileMagic, sizeof(siteEvidenceFileMagic));
+    writeValue(_ofs, siteEvidenceFileVersion);
+    writeString(_ofs, sampleName);
+    writeString(_ofs, std::string(header.text, header.l_text));
+}
+
+
+
+void
+GermlineSiteEvidenceWriter::
+resetRegion(const std::string& chromName)
+{
+    const auto chromIter(_headerInfo.chrom_to_index.find(chromName));
+    assert(chromIter != _headerInfo.chrom_to_index.end());
+    const int32_t tid(chromIter->second);
+
+    if (tid != _regionTid)
+    {
+        if (tid < _regionTid)
+        {
+            using namespace illumina::common;
+            std::ostringstream oss;
+            oss << "ERROR: Site evidence regions are not in reference order at chromosome '" << chromName
+                << "' in site evidence file: '" << _filename << "'\n";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+        }
+        _regionTid = tid;
+        _lastRecordPos = 0;
+    }
+
+    using namespace BinaryColumnIO;
+    writeValue(_ofs, SITE_EVIDENCE_BLOCK::REGION);
+    writeValue(_ofs, tid);
+}
+
+
+
+void
+GermlineSiteEvidenceWriter::
+checkRecordOrder(const pos_t pos)
+{
+    assert(not _isFinalized);
+    assert(_regionTid >= 0);
+
+    if (pos < _lastRecordPos)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Site evidence records are not in reference order at position " << (pos+1)
+            << " in site evidence file: '" << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+    _lastRecordPos = pos;
+}
+
+
+
+void
+GermlineSiteEvidenceWriter::
+writeSite(
+    const pos_t pos,
+    const GermlineSiteSampleEvidence& evidence)
+{
+    checkRecordOrder(pos);
+
+    using namespace BinaryColumnIO;
+    writeValue(_ofs, SITE_EVIDENCE_BLOCK::SITE);
+    writeValue(_ofs, pos);
+    writeSiteSampleEvidence(_ofs, evidence);
+}
+
+
+
+void
+GermlineSiteEvidenceWriter::
+writeIndel(const known_pos_range2& indelRange)
+{
+    checkRecordOrder(indelRange.begin_pos());
+
+    using namespace BinaryColumnIO;
+    writeValue(_ofs, SITE_EVIDENCE_BLOCK::INDEL);
+    writeValue(_ofs, indelRange.begin_pos());
+    writeValue(_ofs, indelRange.end_pos());
+}
+
+
+
+void
+GermlineSiteEvidenceWriter::
+finalize()
+{
+    assert(not _isFinalized);
+
+    BinaryColumnIO::writeValue(_ofs, SITE_EVIDENCE_BLOCK::END);
+    _ofs.flush();
+    _isFinalized = true;
+
+    if (! _ofs)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write site evidence file: '" << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
+
+
+
+GermlineSiteEvidenceReader::
+GermlineSiteEvidenceReader(const std::string& filename)
+    : _filename(filename),
+      _ifs(filename, std::ios::binary)
+{
+    using namespace illumina::common;
+
+    if (! _ifs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to open site evidence file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    readPreamble();
+
+    _header = sam_hdr_parse(_headerText.size(), _headerText.c_str());
+    if (nullptr == _header)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to parse alignment header in site evidence file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    // sam_hdr_parse only parses the reference sequences, so restore the full header text as well:
+    _header->l_text = _headerText.size();
+    _header->text = static_cast<char*>(std::malloc(_headerText.size()+1));
+    std::memcpy(_header->text, _headerText.c_str(), _headerText.size()+1);
+
+    _headerInfo = bam_header_info(*_header);
+}
+
+
+
+GermlineSiteEvidenceReader::
+~GermlineSiteEvidenceReader()
+{
+    if (nullptr != _header) bam_hdr_destroy(_header);
+}
+
+
+
+void
+GermlineSiteEvidenceReader::
+readPreamble()
+{
+    using namespace illumina::common;
+
+    char magic[sizeof(siteEvidenceFileMagic)];
+    _ifs.read(magic, sizeof(magic));
+    if ((! _ifs) || (std::memcmp(magic, siteEvidenceFileMagic, sizeof(magic)) != 0))
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Unrecognized site evidence file format in file: '" << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    using namespace BinaryColumnIO;
+
+    uint32_t version(0);
+    readFromFile(_filename, [&]()
+    {
+        readValue(_ifs, version);
+    });
+    if (version != siteEvidenceFileVersion)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Unsupported site evidence file format version '" << version << "' in file: '" << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(UnsupportedVersionException(oss.str()));
+    }
+
+    std::string sampleName;
+    std::string headerText;
+    readFromFile(_filename, [&]()
+    {
+        readString(_ifs, sampleName);
+        readString(_ifs, headerText);
+    });
+
+    if (nullptr == _header)
+    {
+        _sampleName = sampleName;
+        _headerText = headerText;
+    }
+    else if ((sampleName != _sampleName) or (headerText != _headerText))
+    {
+        // a repeated preamble is expected when the site evidence of several genome segments from the same sample
+        // is concatenated:
+        std::ostringstream oss;
+        oss << "ERROR: Site evidence file contains concatenated segments with different samples or alignment headers: '"
+            << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
+
+
+
+void
+GermlineSiteEvidenceReader::
+resetRegion(
+    const std::string& chromName,
+    const known_pos_range2& regionRange)
+{
+    const auto chromIter(_headerInfo.chrom_to_index.find(chromName));
+    assert(chromIter != _headerInfo.chrom_to_index.end());
+    const int32_t tid(chromIter->second);
+
+    // site records are only read forward, so a region preceding the last requested region would silently miss
+    // any site records that have already been skipped:
+    const bool isRegionOutOfOrder((tid < _regionTid) or
+                                  ((tid == _regionTid) and (regionRange.begin_pos() < _regionRange.end_pos())));
+    if (isRegionOutOfOrder)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Site evidence regions must be requested in reference order, region '" << chromName << ":"
+            << (regionRange.begin_pos()+1) << "-" << regionRange.end_pos()
+            << "' precedes the previous region in site evidence file: '" << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    _regionTid = tid;
+    _regionRange = regionRange;
+}
+
+
+
+bool
+GermlineSiteEvidenceReader::
+next()
+{
+    while (true)
+    {
+        if (not _isSiteBuffered) readSite();
+        if (not _isSiteBuffered) return false;
+
+        const bool isSitePrecedingRegion((_siteTid < _regionTid) or
+                                         ((_siteTid == _regionTid) and (_sitePos < _regionRange.begin_pos())));
+        if (not isSitePrecedingRegion) break;
+        _isSiteBuffered = false;
+    }
+
+    if ((_siteTid != _regionTid) or (_sitePos >= _regionRange.end_pos())) return false;
+
+    // all indel records starting at or before the site have been read by this point:
+    _indelRanges.removeToPos(_sitePos-1);
+    _evidence.isIndelCandidateOverlap = _indelRanges.isIntersectRegion(_sitePos);
+
+    _isSiteBuffered = false;
+    return true;
+}
+
+
+
+void
+GermlineSiteEvidenceReader::
+checkRecordOrder(const pos_t pos)
+{
+    if (pos < _lastRecordPos)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Site evidence records are not in reference order at position " << (pos+1)
+            << " in site evidence file: '" << _filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+    _lastRecordPos = pos;
+}
+
+
+
+void
+GermlineSiteEvidenceReader::
+readSite()
+{
+    using namespace BinaryColumnIO;
+
+    assert(not _isSiteBuffered);
+
+    while (not _isFileEnd)
+    {
+        SITE_EVIDENCE_BLOCK::index_t blockType;
+        readFromFile(_filename, [&]()
+        {
+            readValue(_ifs, blockType);
+        });
+
+        if (blockType == SITE_EVIDENCE_BLOCK::REGION)
+        {
+            int32_t tid(-1);
+            readFromFile(_filename, [&]()
+            {
+                readValue(_ifs, tid);
+            });
+            if (tid != _fileTid)
+            {
+                if (tid < _fileTid)
+                {
+                    using namespace illumina::common;
+                    std::ostringstream oss;
+                    oss << "ERROR: Site evidence records are not in reference order in site evidence file: '"
+                        << _filename << "'\n";
+                    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+                }
+                _fileTid = tid;
+                _lastRecordPos = 0;
+                _indelRanges.clear();
+            }
+        }
+        else if (blockType == SITE_EVIDENCE_BLOCK::SITE)
+        {
+            readFromFile(_filename, [&]()
+            {
+                readValue(_ifs, _sitePos);
+                readSiteSampleEvidence(_ifs, _evidence);
+            });
+            checkRecordOrder(_sitePos);
+            _siteTid = _fileTid;
+            _isSiteBuffered = true;
+            return;
+        }
+        else if (blockType == SITE_EVIDENCE_BLOCK::INDEL)
+        {
+            pos_t beginPos(0);
+            pos_t endPos(0);
+            readFromFile(_filename, [&]()
+            {
+                readValue(_ifs, beginPos);
+                readValue(_ifs, endPos);
+            });
+            checkRecordOrder(beginPos);
+            _indelRanges.addRegion(known_pos_range2(beginPos, endPos));
+        }
+        else if (blockType == SITE_EVIDENCE_BLOCK::END)
+        {
+            // site evidence written for consecutive genome segments may be concatenated into one file, in which
+            // case each segment starts with its own preamble:
+            if (_ifs.peek() == std::char_traits<char>::eof())
+            {
+                _isFileEnd = true;
+            }
+            else
+            {
+                readPreamble();
+            }
+        }
+        else
+        {
+            using namespace illumina::common;
+            std::ostringstream oss;
+            oss << "ERROR: Unexpected record type in site evidence file: '" << _filename << "'\n";
+            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+        }
+    }
+}
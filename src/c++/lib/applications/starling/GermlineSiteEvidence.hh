@@ -0,0 +1,257 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+/// Per-sample germline site evidence, and the file format used to cache it between runs
+///
+
+#pragma once
+
+#include "blt_common/MapqTracker.hh"
+#include "blt_common/position_snp_call_pprob_digt.hh"
+#include "blt_common/snp_pos_info.hh"
+#include "blt_util/blt_types.hh"
+#include "blt_util/known_pos_range2.hh"
+#include "blt_util/RegionTracker.hh"
+#include "htsapi/bam_header_info.hh"
+#include "starling_common/CandidateSnvBuffer.hh"
+#include "starling_common/starling_types.hh"
+
+#include "boost/utility.hpp"
+
+#include <array>
+#include <fstream>
+#include <string>
+
+
+/// \brief Summary of all evidence from one sample required to add the sample to a germline site locus
+///
+/// This is computed from the sample's cleaned pileup at the site, but once computed it is sufficient to
+/// genotype the site jointly with other samples, without revisiting the sample's read alignments.
+///
+struct GermlineSiteSampleEvidence
+{
+    GermlineSiteSampleEvidence()
+    {
+        clear();
+    }
+
+    void
+    clear();
+
+    /// ploidy used by the site genotype model, a locus ploidy of 0 is genotyped as diploid
+    int
+    getCallerPloidy() const
+    {
+        return ((groupLocusPloidy == 0) ? 2 : groupLocusPloidy);
+    }
+
+    /// total count of each known base call
+    void
+    getKnownCounts(std::array<double, N_BASE>& baseCounts) const
+    {
+        for (unsigned baseIndex(0); baseIndex < N_BASE; ++baseIndex)
+        {
+            baseCounts[baseIndex] = fwdBaseCounts[baseIndex] + revBaseCounts[baseIndex];
+        }
+    }
+
+    /// set the empirical scoring features from the sample's raw pileup
+    void
+    setScoringFeatures(const snp_pos_info& pi);
+
+    int groupLocusPloidy;
+    int spanningIndelPloidyModification;
+
+    diploid_genotype dgt;
+
+    /// known base call counts on each strand from the cleaned pileup
+    std::array<unsigned, N_BASE> fwdBaseCounts;
+    std::array<unsigned, N_BASE> revBaseCounts;
+
+    unsigned usedCallCount;
+    unsigned unusedCallCount;
+    unsigned spanningDeletionReadCount;
+
+    MapqTracker mapqTracker;
+
+    /// true if the empirical scoring features below have been set
+    bool isScoringFeatures;
+    double ReadPosRankSum;
+    double MQRankSum;
+    double BaseQRankSum;
+    double meanDistanceFromReadEdge;
+    double rawPos;
+    double avgBaseQ;
+
+    std::array<HaplotypeId, N_BASE> haplotypeId;
+    float altHaplotypeCountRatio;
+
+    ActiveRegionId activeRegionId;
+
+    /// true if the site overlaps a candidate indel of the sample
+    ///
+    /// This is set from the indel records of a site evidence file when the evidence is read back, it is not
+    /// stored with the site record itself.
+    bool isIndelCandidateOverlap;
+
+    /// raw pileup that the evidence was summarized from, used to find scoring features on demand
+    ///
+    /// This is only available when the evidence is summarized directly from the sample's reads.
+    const snp_pos_info* rawPileupPtr;
+};
+
+
+/// \brief Write the site evidence of a single sample to a binary file
+///
+/// Site and indel records are expected in reference order, and any site not written is treated as having no
+/// read coverage in the sample.
+///
+/// The file is only complete once finalize() is called, a file written by a run which fails before this point
+/// is rejected by GermlineSiteEvidenceReader.
+///
+struct GermlineSiteEvidenceWriter : private boost::noncopyable
+{
+    GermlineSiteEvidenceWriter(
+        const std::string& filename,
+        const std::string& sampleName,
+        const bam_hdr_t& header);
+
+    /// start writing site records on a new chromosome region
+    void
+    resetRegion(const std::string& chromName);
+
+    void
+    writeSite(
+        const pos_t pos,
+        const GermlineSiteSampleEvidence& evidence);
+
+    /// write the reference range of all candidate indels starting at the same position
+    ///
+    /// Sites in this range are not genotyped reliably from site evidence alone, because indel realignment
+    /// in a joint analysis depends on the indel candidates of all samples.
+    void
+    writeIndel(const known_pos_range2& indelRange);
+
+    /// mark the end of the site evidence and flush the file
+    void
+    finalize();
+
+private:
+    /// check that records are written in reference order
+    void
+    checkRecordOrder(const pos_t pos);
+
+    std::string _filename;
+    std::ofstream _ofs;
+    bam_header_info _headerInfo;
+
+    int32_t _regionTid = -1;
+    pos_t _lastRecordPos = 0;
+    bool _isFinalized = false;
+};
+
+
+/// \brief Read the site evidence of a single sample from a file produced by GermlineSiteEvidenceWriter
+///
+struct GermlineSiteEvidenceReader : private boost::noncopyable
+{
+    explicit
+    GermlineSiteEvidenceReader(const std::string& filename);
+
+    ~GermlineSiteEvidenceReader();
+
+    const std::string&
+    getSampleName() const
+    {
+        return _sampleName;
+    }
+
+    /// alignment header of the sample's original input alignment file
+    const bam_hdr_t&
+    getHeader() const
+    {
+        return *_header;
+    }
+
+    /// set the reader to iterate over site records in a region
+    ///
+    /// Regions must be requested in reference order, any site records preceding the region are skipped.
+    void
+    resetRegion(
+        const std::string& chromName,
+        const known_pos_range2& regionRange);
+
+    /// advance to the next site record in the current region
+    ///
+    /// \return False if there are no more site records in the region
+    bool
+    next();
+
+    pos_t
+    getPos() const
+    {
+        return _sitePos;
+    }
+
+    const GermlineSiteSampleEvidence&
+    getEvidence() const
+    {
+        return _evidence;
+    }
+
+private:
+    /// read the file preamble, which is repeated at the start of each file concatenated into the same stream
+    void
+    readPreamble();
+
+    /// read the next site record from the file into the site buffer
+    void
+    readSite();
+
+    /// check that records in the file are in reference order
+    void
+    checkRecordOrder(const pos_t pos);
+
+    std::string _filename;
+    std::ifstream _ifs;
+    std::string _sampleName;
+    std::string _headerText;
+    bam_hdr_t* _header = nullptr;
+    bam_header_info _headerInfo;
+
+    int32_t _regionTid = -1;
+    known_pos_range2 _regionRange;
+
+    /// chromosome and position of the last record read from the file
+    int32_t _fileTid = -1;
+    pos_t _lastRecordPos = 0;
+    bool _isFileEnd = false;
+
+    /// candidate indel ranges of the sample on the current chromosome, which may overlap the buffered site
+    RegionTracker _indelRanges;
+
+    /// true if the site buffer holds a site record which has not yet been returned by next()
+    bool _isSiteBuffered = false;
+    int32_t _siteTid = -1;
+    pos_t _sitePos = 0;
+    GermlineSiteSampleEvidence _evidence;
+};
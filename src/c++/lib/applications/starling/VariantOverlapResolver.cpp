@@ -69,6 +69,22 @@ process(std::unique_ptr<GermlineSiteLocusInfo> siteLocusPtr)
 
 
 
+void
+VariantOverlapResolver::
+processNonVariantSite(GermlineDiploidSiteLocusInfo& siteLocus)
+{
+    // the site must go through the standard path if it could interact with a buffered indel:
+    if (! _variantIndelBuffer.empty())
+    {
+        process(copySite(siteLocus));
+        return;
+    }
+
+    _sink->processNonVariantSite(siteLocus);
+}
+
+
+
 void
 VariantOverlapResolver::
 process(std::unique_ptr<GermlineIndelLocusInfo> indelLocusPtr)
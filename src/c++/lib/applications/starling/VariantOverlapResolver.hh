@@ -52,6 +52,7 @@ struct VariantOverlapResolver : public variant_pipe_stage_base
 
     void process(std::unique_ptr<GermlineSiteLocusInfo> siteLocusPtr) override;
     void process(std::unique_ptr<GermlineIndelLocusInfo> indelLocusPtr) override;
+    void processNonVariantSite(GermlineDiploidSiteLocusInfo& siteLocus) override;
 
     /// Adjust site record details for greater consistency with the overlapping indel
     ///
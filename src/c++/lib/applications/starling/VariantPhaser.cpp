@@ -62,6 +62,24 @@ process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
     processLocus(std::move(locusPtr));
 }
 
+void
+VariantPhaser::
+processNonVariantSite(GermlineDiploidSiteLocusInfo& locus)
+{
+    // sites in an active region must be buffered with the other loci of the region:
+    if (_opt.isUseVariantPhaser and (locus.getActiveRegionId() >= 0))
+    {
+        processLocus(copySite(locus));
+        return;
+    }
+
+    if (_opt.isUseVariantPhaser)
+    {
+        outputBuffer();
+    }
+    _sink->processNonVariantSite(locus);
+}
+
 
 /// batch process all loci belonging to the same active region
 void
@@ -49,6 +49,8 @@ struct VariantPhaser : public variant_pipe_stage_base
 
     void process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr) override;
 
+    void processNonVariantSite(GermlineDiploidSiteLocusInfo& locus) override;
+
 private:
     const starling_options& _opt;
     const unsigned _sampleCount;
@@ -25,6 +25,44 @@
 
 
 
+/// pass-through pipeline stage which attributes the processing time of all downstream stages to one run stage
+class RunStagePipeStage : public variant_pipe_stage_base
+{
+public:
+    RunStagePipeStage(
+        RunStatsManager& statsManager,
+        const RUN_STAGE::index_t stage,
+        const std::shared_ptr<variant_pipe_stage_base>& destination)
+        : variant_pipe_stage_base(destination),
+          _statsManager(statsManager),
+          _stage(stage)
+    {}
+
+    void process(std::unique_ptr<GermlineSiteLocusInfo> si) override
+    {
+        RunStageScope stageScope(_statsManager, _stage);
+        _sink->process(std::move(si));
+    }
+
+    void process(std::unique_ptr<GermlineIndelLocusInfo> ii) override
+    {
+        RunStageScope stageScope(_statsManager, _stage);
+        _sink->process(std::move(ii));
+    }
+
+    void processNonVariantSite(GermlineDiploidSiteLocusInfo& si) override
+    {
+        RunStageScope stageScope(_statsManager, _stage);
+        _sink->processNonVariantSite(si);
+    }
+
+private:
+    RunStatsManager& _statsManager;
+    const RUN_STAGE::index_t _stage;
+};
+
+
+
 gvcf_aggregator::
 gvcf_aggregator(
     const starling_options& opt,
@@ -33,21 +71,26 @@ gvcf_aggregator(
     const reference_contig_segment& ref,
     const RegionTracker& nocompressRegions,
     const RegionTracker& callRegions,
-    const unsigned sampleCount)
-    : _scoringModels(opt, dopt.gvcf)
+    const unsigned sampleCount,
+    RunStatsManager& statsManager)
+    : _scoringModels(opt, dopt.gvcf),
+      _locusPool(dopt.gvcf, sampleCount)
 {
     if (! opt.gvcf.is_gvcf_output())
         throw std::invalid_argument("gvcf_aggregator cannot be constructed with nothing to do.");
 
-    _gvcfWriterPtr.reset(new gvcf_writer(opt, dopt, streams, ref, nocompressRegions, callRegions, _scoringModels));
-    std::shared_ptr<variant_pipe_stage_base> nextPipeStage(_gvcfWriterPtr);
+    _gvcfWriterPtr.reset(new gvcf_writer(opt, dopt, streams, ref, nocompressRegions, callRegions, _scoringModels, _locusPool));
+
+    // the gvcf writer is attributed to output, all stages from the head up to the writer are attributed to scoring:
+    std::shared_ptr<variant_pipe_stage_base> nextPipeStage(new RunStagePipeStage(statsManager, RUN_STAGE::OUTPUT, _gvcfWriterPtr));
     if (opt.is_ploidy_prior)
     {
         std::shared_ptr<variant_pipe_stage_base> variantOverlapResolver(new VariantOverlapResolver(_scoringModels, nextPipeStage));
         _variantPhaserPtr.reset(new VariantPhaser(opt, sampleCount, variantOverlapResolver));
         nextPipeStage = _variantPhaserPtr;
     }
-    _head.reset(new variant_prefilter_stage(_scoringModels, nextPipeStage));
+    nextPipeStage.reset(new variant_prefilter_stage(_scoringModels, nextPipeStage));
+    _head.reset(new RunStagePipeStage(statsManager, RUN_STAGE::SCORING, nextPipeStage));
 }
 
 gvcf_aggregator::~gvcf_aggregator()
@@ -62,6 +105,14 @@ add_site(std::unique_ptr<GermlineSiteLocusInfo> si)
     _head->process(std::move(si));
 }
 
+void
+gvcf_aggregator::
+add_nonvariant_site(GermlineDiploidSiteLocusInfo& si)
+{
+    assert(not si.isVariantLocus());
+    _head->processNonVariantSite(si);
+}
+
 void
 gvcf_aggregator::add_indel(std::unique_ptr<GermlineIndelLocusInfo> info)
 {
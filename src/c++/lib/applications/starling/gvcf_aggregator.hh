@@ -21,10 +21,12 @@
 
 
 #include "VariantPhaser.hh"
+#include "appstats/RunStatsManager.hh"
 #include "gvcf_block_site_record.hh"
 #include "gvcf_locus_info.hh"
 #include "gvcf_compressor.hh"
 #include "gvcf_writer.hh"
+#include "GermlineLocusPool.hh"
 #include "ScoringModelManager.hh"
 #include "starling_streams.hh"
 
@@ -44,13 +46,20 @@ public:
         const reference_contig_segment& ref,
         const RegionTracker& nocompressRegions,
         const RegionTracker& callRegions,
-        const unsigned sampleCount);
+        const unsigned sampleCount,
+        RunStatsManager& statsManager);
 
     ~gvcf_aggregator();
 
     void add_site(std::unique_ptr<GermlineSiteLocusInfo> si);
 
     void add_indel(std::unique_ptr<GermlineIndelLocusInfo> info);
+
+    /// add a non-variant site without transferring ownership, so that the caller can reuse the locus
+    ///
+    /// the locus may be modified by the pipeline
+    void add_nonvariant_site(GermlineDiploidSiteLocusInfo& si);
+
     void reset();
 
     void
@@ -69,9 +78,19 @@ public:
         return _scoringModels.getMaxDepth();
     }
 
+    /// source of recycled locus objects for all loci sent to this aggregator
+    GermlineLocusPool&
+    getLocusPool()
+    {
+        return _locusPool;
+    }
+
 private:
     ScoringModelManager _scoringModels;
 
+    /// declared ahead of the pipeline stages so that loci recycled by the final flush have a destination
+    GermlineLocusPool _locusPool;
+
     std::shared_ptr<VariantPhaser> _variantPhaserPtr;
     std::shared_ptr<gvcf_writer> _gvcfWriterPtr;
     std::shared_ptr<variant_pipe_stage_base> _head;
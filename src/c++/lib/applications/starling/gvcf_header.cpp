@@ -112,6 +112,11 @@ add_gvcf_filters(
     // even if no ploidy bed file is provided, this filter should still exist, so I don't
     // see any reason to leave it in the header for all cases:
     write_vcf_filter(os,get_label(PloidyConflict),"Genotype call from variant caller not consistent with chromosome ploidy");
+
+    if (sopt.isJointSiteEvidenceMode())
+    {
+        write_vcf_filter(os,get_label(UngenotypedIndel),"Site overlaps a candidate indel in this sample, which is not genotyped when calling from site evidence files");
+    }
 }
 
 
@@ -124,6 +129,11 @@ finish_gvcf_header(
     const std::vector<std::string>& sampleNames,
     std::ostream& os)
 {
+    if (opt.isJointSiteEvidenceMode())
+    {
+        os << "##siteEvidenceAnalysis=SNV sites only. Genotypes were computed from per-sample site evidence files without indel calling or joint indel realignment. Sites overlapping a candidate indel of a sample are filtered with " << GERMLINE_VARIANT_VCF_FILTERS::get_label(GERMLINE_VARIANT_VCF_FILTERS::UngenotypedIndel) << " in that sample.\n";
+    }
+
     //INFO:
     os << "##INFO=<ID=END,Number=1,Type=Integer,Description=\"End position of the region described in this record\">\n";
 
@@ -39,11 +39,11 @@
 
 void
 GermlineFilterKeeper::
-write(std::ostream& os) const
+write(TextBuffer& buffer) const
 {
     if (filters.none())
     {
-        os << "PASS";
+        buffer.append("PASS");
         return;
     }
 
@@ -54,18 +54,29 @@ write(std::ostream& os) const
 
         if (is_sep)
         {
-            os << ";";
+            buffer.append(';');
         }
         else
         {
             is_sep=true;
         }
-        os << GERMLINE_VARIANT_VCF_FILTERS::get_label(i);
+        buffer.append(GERMLINE_VARIANT_VCF_FILTERS::get_label(i));
     }
 }
 
 
 
+void
+GermlineFilterKeeper::
+write(std::ostream& os) const
+{
+    TextBuffer buffer(0);
+    write(buffer);
+    buffer.flush(os);
+}
+
+
+
 std::ostream&
 operator<<(
     std::ostream& os,
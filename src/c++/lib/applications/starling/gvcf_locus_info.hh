@@ -31,6 +31,7 @@
 #include "blt_util/align_path.hh"
 #include "blt_util/math_util.hh"
 #include "blt_util/PolymorphicObject.hh"
+#include "blt_util/TextBuffer.hh"
 #include "htsapi/vcf_util.hh"
 #include "starling_common/starling_indel_call_pprob_digt.hh"
 #include "starling_common/LocusSupportingReadStats.hh"
@@ -56,6 +57,7 @@ enum index_t
     HighSNVHPOL,
     HighRefRep,
     LowDepth,
+    UngenotypedIndel,
     SIZE
 };
 
@@ -87,6 +89,8 @@ get_label(const unsigned idx)
         return "PloidyConflict";
     case LowDepth:
         return "LowDepth";
+    case UngenotypedIndel:
+        return "UngenotypedIndel";
     default:
         assert(false && "Unknown VCF filter value");
         return nullptr;
@@ -131,6 +135,9 @@ struct GermlineFilterKeeper
     void
     write(std::ostream& os) const;
 
+    void
+    write(TextBuffer& buffer) const;
+
     bool
     operator==(const GermlineFilterKeeper& rhs) const
     {
@@ -417,17 +424,54 @@ private:
 std::ostream& operator<<(std::ostream& os,const LocusSampleInfo& lsi);
 
 
+/// type tag identifying the concrete type of each locus object
+///
+/// the tag is used to resolve locus types in the variant pipeline without RTTI lookups
+namespace GERMLINE_LOCUS_TYPE
+{
+enum index_t
+{
+    DIPLOID_SITE,
+    CONTINUOUS_SITE,
+    BLOCK_SITE,
+    DIPLOID_INDEL,
+    CONTINUOUS_INDEL
+};
+
+inline
+bool
+isSite(const index_t locusType)
+{
+    return ((locusType == DIPLOID_SITE) or (locusType == CONTINUOUS_SITE) or (locusType == BLOCK_SITE));
+}
+
+inline
+bool
+isIndel(const index_t locusType)
+{
+    return ((locusType == DIPLOID_INDEL) or (locusType == CONTINUOUS_INDEL));
+}
+}
+
+
 /// represents a locus in the sense of multiple alleles which interact in some way such that they would be represented in a single VCF record
 struct LocusInfo : public PolymorphicObject
 {
-    explicit
     LocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount,
         const pos_t initPos = 0)
         : pos(initPos),
+          _locusType(locusType),
           _sampleInfo(sampleCount)
     {}
 
+    GERMLINE_LOCUS_TYPE::index_t
+    getLocusType() const
+    {
+        return _locusType;
+    }
+
     unsigned
     getAltAlleleCount() const
     {
@@ -520,6 +564,7 @@ public:
     GermlineFilterKeeper filters;
 
 private:
+    GERMLINE_LOCUS_TYPE::index_t _locusType;
     std::vector<LocusSampleInfo> _sampleInfo;
     unsigned _altAlleleCount = 0;
 
@@ -564,15 +609,24 @@ struct GermlineIndelSampleInfo
 /// represents an indel call at the level of a full VCF record, containing possibly multiple alleles/SimpleGenotypes
 struct GermlineIndelLocusInfo : public LocusInfo
 {
-    explicit
     GermlineIndelLocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount)
-        : LocusInfo(sampleCount),
+        : LocusInfo(locusType, sampleCount),
           _indelSampleInfo(sampleCount), _commonPrefixLength(0)
-    {}
+    {
+        assert(GERMLINE_LOCUS_TYPE::isIndel(locusType));
+    }
 
     virtual ~GermlineIndelLocusInfo() {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return GERMLINE_LOCUS_TYPE::isIndel(locus.getLocusType());
+    }
+
     const known_pos_range2&
     range() const
     {
@@ -693,6 +747,20 @@ struct GermlineIndelLocusInfo : public LocusInfo
         assert (sampleCount == _indelSampleInfo.size());
     }
 
+protected:
+    void
+    clear()
+    {
+        LocusInfo::clear();
+        _indelAlleleInfo.clear();
+        for (auto& indelSample : _indelSampleInfo)
+        {
+            indelSample = GermlineIndelSampleInfo();
+        }
+        _range = known_pos_range2();
+        _commonPrefixLength = 0;
+    }
+
 private:
     std::vector<GermlineIndelAlleleInfo> _indelAlleleInfo;
     std::vector<GermlineIndelSampleInfo> _indelSampleInfo;
@@ -712,11 +780,18 @@ struct GermlineDiploidIndelLocusInfo : public GermlineIndelLocusInfo
     GermlineDiploidIndelLocusInfo(
         const gvcf_deriv_options& gvcfDerivedOptions,
         const unsigned sampleCount)
-        : GermlineIndelLocusInfo(sampleCount)
+        : GermlineIndelLocusInfo(GERMLINE_LOCUS_TYPE::DIPLOID_INDEL, sampleCount)
         , evsFeatures(gvcfDerivedOptions.indelFeatureSet)
         , evsDevelopmentFeatures(gvcfDerivedOptions.indelDevelopmentFeatureSet)
     {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::DIPLOID_INDEL);
+    }
+
     /// \param allSampleChromDepth expected depth summed over all samples
     static
     void
@@ -737,6 +812,14 @@ struct GermlineDiploidIndelLocusInfo : public GermlineIndelLocusInfo
         evsDevelopmentFeatures.clear();
     }
 
+    /// reset to the state of a newly constructed locus, so that one object can be reused for many indels
+    void
+    reset()
+    {
+        clear();
+        clearEVSFeatures();
+    }
+
     /// production and development features used in the empirical scoring model:
     VariantScoringFeatureKeeper evsFeatures;
     VariantScoringFeatureKeeper evsDevelopmentFeatures;
@@ -749,8 +832,15 @@ struct GermlineContinuousIndelLocusInfo : public GermlineIndelLocusInfo
     explicit
     GermlineContinuousIndelLocusInfo(
         const unsigned sampleCount)
-        : GermlineIndelLocusInfo(sampleCount)
+        : GermlineIndelLocusInfo(GERMLINE_LOCUS_TYPE::CONTINUOUS_INDEL, sampleCount)
     {}
+
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::CONTINUOUS_INDEL);
+    }
 };
 
 
@@ -830,6 +920,7 @@ struct GermlineSiteSampleInfo
         ReadPosRankSum = 0;
         BaseQRankSum = 0;
         MQRankSum = 0;
+        meanDistanceFromReadEdge = 0;
         avgBaseQ = 0;
         rawPos = 0;
         strandBias = 0;
@@ -868,23 +959,34 @@ struct GermlineSiteLocusInfo : public LocusInfo
     typedef LocusInfo base_t;
 
     GermlineSiteLocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount,
         const pos_t initPos,
         const uint8_t initRefBaseIndex,
         const bool initIsForcedOutput = false)
-        : base_t(sampleCount, initPos),
+        : base_t(locusType, sampleCount, initPos),
           refBaseIndex(initRefBaseIndex),
           _siteSampleInfo(sampleCount)
     {
+        assert(GERMLINE_LOCUS_TYPE::isSite(locusType));
         isForcedOutput = initIsForcedOutput;
     }
 
-    explicit
     GermlineSiteLocusInfo(
+        const GERMLINE_LOCUS_TYPE::index_t locusType,
         const unsigned sampleCount)
-        : base_t(sampleCount),
+        : base_t(locusType, sampleCount),
           _siteSampleInfo(sampleCount)
-    {}
+    {
+        assert(GERMLINE_LOCUS_TYPE::isSite(locusType));
+    }
+
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return GERMLINE_LOCUS_TYPE::isSite(locus.getLocusType());
+    }
 
     bool
     isRefUnknown() const
@@ -1014,7 +1116,7 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
         const pos_t init_pos,
         const uint8_t initRefBaseIndex,
         const bool is_forced_output = false)
-        : GermlineSiteLocusInfo(sampleCount, init_pos, initRefBaseIndex, is_forced_output),
+        : GermlineSiteLocusInfo(GERMLINE_LOCUS_TYPE::DIPLOID_SITE, sampleCount, init_pos, initRefBaseIndex, is_forced_output),
           evsFeatures(gvcfDerivedOptions.snvFeatureSet),
           evsDevelopmentFeatures(gvcfDerivedOptions.snvDevelopmentFeatureSet)
     {}
@@ -1022,11 +1124,18 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
     GermlineDiploidSiteLocusInfo(
         const gvcf_deriv_options& gvcfDerivedOptions,
         const unsigned sampleCount)
-        : GermlineSiteLocusInfo(sampleCount),
+        : GermlineSiteLocusInfo(GERMLINE_LOCUS_TYPE::DIPLOID_SITE, sampleCount),
           evsFeatures(gvcfDerivedOptions.snvFeatureSet),
           evsDevelopmentFeatures(gvcfDerivedOptions.snvDevelopmentFeatureSet)
     {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::DIPLOID_SITE);
+    }
+
     /// \param allSampleChromDepth expected depth summed over all samples
     static
     void
@@ -1047,6 +1156,20 @@ struct GermlineDiploidSiteLocusInfo : public GermlineSiteLocusInfo
         evsDevelopmentFeatures.clear();
     }
 
+    /// reset to the state of a newly constructed locus, so that one object can be reused for many positions
+    void
+    reset(
+        const pos_t initPos,
+        const uint8_t initRefBaseIndex,
+        const bool initIsForcedOutput = false)
+    {
+        clear();
+        clearEVSFeatures();
+        pos = initPos;
+        refBaseIndex = initRefBaseIndex;
+        isForcedOutput = initIsForcedOutput;
+    }
+
     /// production and development features used in the empirical scoring model:
     VariantScoringFeatureKeeper evsFeatures;
     VariantScoringFeatureKeeper evsDevelopmentFeatures;
@@ -1086,10 +1209,17 @@ struct GermlineContinuousSiteLocusInfo : public GermlineSiteLocusInfo
         const pos_t init_pos,
         const uint8_t initRefBaseIndex,
         const bool is_forced_output = false)
-        : base_t(sampleCount, init_pos, initRefBaseIndex, is_forced_output),
+        : base_t(GERMLINE_LOCUS_TYPE::CONTINUOUS_SITE, sampleCount, init_pos, initRefBaseIndex, is_forced_output),
           _continuousSiteSampleInfo(sampleCount)
     {}
 
+    static
+    bool
+    isInstance(const LocusInfo& locus)
+    {
+        return (locus.getLocusType() == GERMLINE_LOCUS_TYPE::CONTINUOUS_SITE);
+    }
+
     void
     clear()
     {
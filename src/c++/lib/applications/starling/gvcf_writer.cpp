@@ -29,10 +29,8 @@
 #include "variant_prefilter_stage.hh"
 
 #include "blt_common/ref_context.hh"
-#include "blt_util/io_util.hh"
 #include "blt_util/log.hh"
 
-#include <iomanip>
 #include <iostream>
 #include <sstream>
 
@@ -55,7 +53,8 @@ gvcf_writer(
     const reference_contig_segment& ref,
     const RegionTracker& nocompressRegions,
     const RegionTracker& callRegions,
-    const ScoringModelManager& scoringModels)
+    const ScoringModelManager& scoringModels,
+    GermlineLocusPool& locusPool)
     : _opt(opt)
     , _streams(streams)
     , _ref(ref)
@@ -65,6 +64,7 @@ gvcf_writer(
     , _headPos(0)
     , _gvcf_comp(opt.gvcf,nocompressRegions)
     , _scoringModels(scoringModels)
+    , _locusPool(locusPool)
 {
     if (! opt.gvcf.is_gvcf_output())
         throw std::invalid_argument("gvcf_writer cannot be constructed with nothing to do.");
@@ -86,6 +86,7 @@ gvcf_writer(
     {
         _blockPerSample.emplace_back(_opt.gvcf);
     }
+    _sampleBuffer.resize(sampleCount);
 
     // add appropriate filters to empty_site, as if it had gone through the standard pipeline:
     _scoringModels.classify_site(_empty_site);
@@ -101,8 +102,8 @@ writeSampleNonVariantBlockRecord(
     auto& block(_blockPerSample[sampleIndex]);
     if (block.count<=0) return;
 
-    std::ostream& os(_streams.gvcfSampleStream(sampleIndex));
-    write_site_record(block, os);
+    writeNonVariantBlockRecord(getChromName(), _dopt.block_label, block, _sampleBuffer[sampleIndex]);
+    flushSampleBufferIfReady(sampleIndex);
     block.reset();
 }
 
@@ -117,7 +118,7 @@ modifySiteForConsistencyWithUpstreamIndels(
     {
         if (locus.pos >= _lastVariantIndelWritten->end())
         {
-            _lastVariantIndelWritten.reset(nullptr);
+            _locusPool.recycle(std::move(_lastVariantIndelWritten));
         }
         else
         {
@@ -196,6 +197,7 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
 
         skip_to_pos(locusPtr->pos);
         add_site_internal(*locusPtr);
+        _locusPool.recycle(std::move(locusPtr));
     }
     catch (...)
     {
@@ -207,6 +209,27 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
 
 
 
+void
+gvcf_writer::
+processNonVariantSite(GermlineDiploidSiteLocusInfo& locus)
+{
+    try
+    {
+        assert(locus.getSampleCount() == getSampleCount());
+
+        skip_to_pos(locus.pos);
+        add_site_internal(locus);
+    }
+    catch (...)
+    {
+        log_os << "ERROR: Exception caught in gvcf_writer while processing site:\n";
+        log_os << locus << "\n";
+        throw;
+    }
+}
+
+
+
 void
 gvcf_writer::
 process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
@@ -219,12 +242,14 @@ process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
         writeAllNonVariantBlockRecords();
 
         write_indel_record(*locusPtr);
-        if (locusPtr->isVariantLocus())
+        if (locusPtr->isVariantLocus() and GermlineDiploidIndelLocusInfo::isInstance(*locusPtr))
         {
-            if (dynamic_cast<GermlineDiploidIndelLocusInfo*>(locusPtr.get()) != nullptr)
-            {
-                _lastVariantIndelWritten = std::move(locusPtr);
-            }
+            _locusPool.recycle(std::move(_lastVariantIndelWritten));
+            _lastVariantIndelWritten = std::move(locusPtr);
+        }
+        else
+        {
+            _locusPool.recycle(std::move(locusPtr));
         }
     }
     catch (...)
@@ -247,9 +272,16 @@ flush_impl()
         writeAllNonVariantBlockRecords();
     }
 
+    _variantsBuffer.flush(_streams.gvcfVariantsStream());
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        _sampleBuffer[sampleIndex].flush(_streams.gvcfSampleStream(sampleIndex));
+    }
+
     _chromName.clear();
     _headPos = 0;
-    _lastVariantIndelWritten.reset(nullptr);
+    _locusPool.recycle(std::move(_lastVariantIndelWritten));
 }
 
 
@@ -259,10 +291,9 @@ gvcf_writer::
 add_site_internal(
     GermlineSiteLocusInfo& locus)
 {
-    GermlineDiploidSiteLocusInfo* diploidLocusPtr(dynamic_cast<GermlineDiploidSiteLocusInfo*>(&locus));
-    if (diploidLocusPtr != nullptr)
+    if (GermlineDiploidSiteLocusInfo::isInstance(locus))
     {
-        modifySiteForConsistencyWithUpstreamIndels(*diploidLocusPtr);
+        modifySiteForConsistencyWithUpstreamIndels(static_cast<GermlineDiploidSiteLocusInfo&>(locus));
     }
 
     _headPos=locus.pos+1;
@@ -340,19 +371,19 @@ static
 void
 writeSiteVcfAltField(
     const std::vector<GermlineSiteAlleleInfo>& siteAlleles,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     if (siteAlleles.empty())
     {
-        os << '.';
+        buffer.append('.');
     }
     else
     {
         const unsigned altAlleleCount(siteAlleles.size());
         for (unsigned altAlleleIndex(0); altAlleleIndex < altAlleleCount; altAlleleIndex++)
         {
-            if (altAlleleIndex != 0) os <<',';
-            os << id_to_base(siteAlleles[altAlleleIndex].baseIndex);
+            if (altAlleleIndex != 0) buffer.append(',');
+            buffer.append(id_to_base(siteAlleles[altAlleleIndex].baseIndex));
         }
     }
 }
@@ -365,18 +396,18 @@ void
 printSampleAD(
     const LocusSupportingReadStats& counts,
     const unsigned expectedAltAlleleCount,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     // verify locus and sample allele counts are in sync:
     assert(counts.getAltCount() == expectedAltAlleleCount);
     const unsigned fullAlleleCount(expectedAltAlleleCount+1);
 
     // AD
-    os << ':';
+    buffer.append(':');
     for (unsigned alleleIndex(0); alleleIndex < fullAlleleCount; ++alleleIndex)
     {
-        if (alleleIndex>0) os << ',';
-        os << (counts.getCounts(true).confidentAlleleCount(alleleIndex) + counts.getCounts(false).confidentAlleleCount(alleleIndex));
+        if (alleleIndex>0) buffer.append(',');
+        buffer.appendUnsigned(counts.getCounts(true).confidentAlleleCount(alleleIndex) + counts.getCounts(false).confidentAlleleCount(alleleIndex));
     }
 
     // ADF/ADR
@@ -386,53 +417,126 @@ printSampleAD(
         const bool isFwdStrand(strandIndex==0);
         const auto& strandCounts(counts.getCounts(isFwdStrand));
 
-        os << ':';
+        buffer.append(':');
         for (unsigned alleleIndex(0); alleleIndex < fullAlleleCount; ++alleleIndex)
         {
-            if (alleleIndex>0) os << ',';
-            os << strandCounts.confidentAlleleCount(alleleIndex);
+            if (alleleIndex>0) buffer.append(',');
+            buffer.appendUnsigned(strandCounts.confidentAlleleCount(alleleIndex));
         }
     }
 }
 
 
 
+/// print output limits:
+static const unsigned maxPL(999);
+
+
+
+/// print sample PL, each value is capped at maxPL
+static
 void
-gvcf_writer::
-write_site_record_instance(
+printSamplePL(
+    const GenotypeLikelihoods& genotypePhredLoghood,
+    TextBuffer& buffer)
+{
+    bool isFirst(true);
+    for (const auto pls : genotypePhredLoghood)
+    {
+        if (isFirst)
+        {
+            isFirst = false;
+        }
+        else
+        {
+            buffer.append(',');
+        }
+        buffer.appendUnsigned(std::min(pls, maxPL));
+    }
+}
+
+
+
+/// print sample PS
+static
+void
+printSamplePS(
+    const LocusSampleInfo& sampleInfo,
+    TextBuffer& buffer)
+{
+    buffer.append(':');
+    if (sampleInfo.phaseSetId < 0)
+    {
+        buffer.append('.');
+    }
+    else
+    {
+        buffer.appendInt(sampleInfo.phaseSetId);
+    }
+}
+
+
+
+/// print the EVSF INFO field, if the locus EVS features have been computed
+template <typename LocusType>
+void
+printEVSFeatures(
+    const LocusType& locus,
+    TextBuffer& buffer)
+{
+    // EVS features may not be computed for certain records, so check first:
+    if (locus.evsFeatures.empty()) return;
+
+    static const int evsFeaturePrecision(5);
+    buffer.append(";EVSF=");
+    locus.evsFeatures.writeValues(buffer, evsFeaturePrecision);
+    buffer.append(',');
+    locus.evsDevelopmentFeatures.writeValues(buffer, evsFeaturePrecision);
+}
+
+
+
+void
+writeSiteRecord(
+    const std::string& chromName,
+    const reference_contig_segment& ref,
+    const bool isReportEVSFeatures,
     const GermlineSiteLocusInfo& locus,
-    std::ostream& os,
-    const int targetSampleIndex) const
+    TextBuffer& buffer,
+    const int targetSampleIndex)
 {
     const auto& siteAlleles(locus.getSiteAlleles());
     const unsigned altAlleleCount(siteAlleles.size());
     const bool isAltAlleles(altAlleleCount > 0);
     const unsigned sampleCount(locus.getSampleCount());
 
-    os << getChromName() << '\t'  // CHROM
-       << (locus.pos + 1) << '\t'  // POS
-       << ".\t";           // ID
+    buffer.append(chromName);  // CHROM
+    buffer.append('\t');
+    buffer.appendInt(locus.pos + 1);  // POS
+    buffer.append('\t');
+    buffer.append(".\t");  // ID
 
-    os << id_to_base(locus.refBaseIndex) << '\t'; // REF
+    buffer.append(id_to_base(locus.refBaseIndex)); // REF
+    buffer.append('\t');
 
     // ALT
-    writeSiteVcfAltField(locus.getSiteAlleles(), os);
-    os << '\t';
+    writeSiteVcfAltField(locus.getSiteAlleles(), buffer);
+    buffer.append('\t');
 
     // QUAL:
     if (locus.isQual())
     {
-        os << locus.anyVariantAlleleQuality;
+        buffer.appendInt(locus.anyVariantAlleleQuality);
     }
     else
     {
-        os << '.';
+        buffer.append('.');
     }
-    os << '\t';
+    buffer.append('\t');
 
     // FILTER:
-    getExtendedLocusFilters(locus, targetSampleIndex).write(os);
-    os << '\t';
+    getExtendedLocusFilters(locus, targetSampleIndex).write(buffer);
+    buffer.append('\t');
 
     // INFO:
     // SNVHPOL
@@ -441,11 +545,12 @@ write_site_record_instance(
         if (not locus.isVariantLocus())
         {
             // we never computed this upfront for non-variants (b/c not running EVS and saves time)
-            hpol = get_snp_hpol_size(locus.pos, _ref);
+            hpol = get_snp_hpol_size(locus.pos, ref);
         }
-        os << "SNVHPOL=" << hpol;
+        buffer.append("SNVHPOL=");
+        buffer.appendUnsigned(hpol);
     }
-    os << ';';
+    buffer.append(';');
 
     // MQ
     {
@@ -458,46 +563,37 @@ write_site_record_instance(
                 mapqTracker.merge(siteSampleInfo.mapqTracker);
             }
         }
-        os << "MQ=" << std::lround(mapqTracker.getRMS());
+        buffer.append("MQ=");
+        buffer.appendInt(std::lround(mapqTracker.getRMS()));
     }
 
-    const GermlineDiploidSiteLocusInfo* diploidLocusPtr(dynamic_cast<const GermlineDiploidSiteLocusInfo*>(&locus));
-    if (diploidLocusPtr != nullptr)
+    if (GermlineDiploidSiteLocusInfo::isInstance(locus))
     {
-        const GermlineDiploidSiteLocusInfo& diploidLocus(*diploidLocusPtr);
+        const GermlineDiploidSiteLocusInfo& diploidLocus(static_cast<const GermlineDiploidSiteLocusInfo&>(locus));
 
         if (locus.isVariantLocus())
         {
-            if (_opt.isReportEVSFeatures)
+            if (isReportEVSFeatures)
             {
-                // EVS features may not be computed for certain records, so check first:
-                if (not diploidLocus.evsFeatures.empty())
-                {
-                    const StreamScoper ss(os);
-                    os << std::setprecision(5);
-                    os << ";EVSF=";
-                    diploidLocus.evsFeatures.writeValues(os);
-                    os << ",";
-                    diploidLocus.evsDevelopmentFeatures.writeValues(os);
-                }
+                printEVSFeatures(diploidLocus, buffer);
             }
         }
-        os << '\t';
+        buffer.append('\t');
 
         //FORMAT
-        os << "GT:GQ:GQX:DP:DPF";
+        buffer.append("GT:GQ:GQX:DP:DPF");
         if (isAltAlleles)
         {
-            os << ":AD:ADF:ADR";
+            buffer.append(":AD:ADF:ADR");
         }
         if (isAltAlleles)
         {
-            os << ":SB";
+            buffer.append(":SB");
         }
-        os << ":FT";
+        buffer.append(":FT");
         if (isAltAlleles)
         {
-            os << ":PL";
+            buffer.append(":PL");
         }
 
         bool isAnyPhased(false);
@@ -513,7 +609,7 @@ write_site_record_instance(
 
         if (isAnyPhased)
         {
-            os << ":PS";
+            buffer.append(":PS");
         }
 
         //SAMPLE
@@ -527,81 +623,63 @@ write_site_record_instance(
             const auto& sampleInfo(locus.getSample(sampleIndex));
             const auto& siteSampleInfo(locus.getSiteSample(sampleIndex));
 
-            os << '\t';
+            buffer.append('\t');
 
-            os << sampleInfo.max_gt() << ':';
+            VcfGenotypeUtil::writeGenotype(sampleInfo.max_gt(), buffer);
+            buffer.append(':');
             if (locus.is_gqx(sampleIndex))
             {
-                os << sampleInfo.genotypeQualityPolymorphic << ':';
-                os << ((sampleInfo.empiricalVariantScore >= 0) ? sampleInfo.empiricalVariantScore : sampleInfo.gqx);
+                buffer.appendInt(sampleInfo.genotypeQualityPolymorphic);
+                buffer.append(':');
+                buffer.appendInt((sampleInfo.empiricalVariantScore >= 0) ? sampleInfo.empiricalVariantScore : sampleInfo.gqx);
             }
             else
             {
-                os << ".:.";
+                buffer.append(".:.");
             }
-            os << ':';
+            buffer.append(':');
             //print DP:DPF
-            os << siteSampleInfo.n_used_calls << ':'
-               << siteSampleInfo.n_unused_calls;
+            buffer.appendUnsigned(siteSampleInfo.n_used_calls);
+            buffer.append(':');
+            buffer.appendUnsigned(siteSampleInfo.n_unused_calls);
 
             // AD/ADF/ADR
             if (isAltAlleles)
             {
-                printSampleAD(sampleInfo.supportCounts, altAlleleCount, os);
+                printSampleAD(sampleInfo.supportCounts, altAlleleCount, buffer);
             }
 
             // SB
             if (isAltAlleles)
             {
-                os << ":";
-                const StreamScoper ss(os);
-                os << std::fixed << std::setprecision(1) << siteSampleInfo.strandBias;
+                buffer.append(':');
+                buffer.appendFixed(siteSampleInfo.strandBias, 1);
             }
 
             // FT
-            os << ':';
-            sampleInfo.filters.write(os);
+            buffer.append(':');
+            sampleInfo.filters.write(buffer);
 
             // PL
             if (isAltAlleles)
             {
                 const bool isUnknonwnGT(sampleInfo.max_gt().isUnknown());
 
-                os << ':';
+                buffer.append(':');
                 if (isUnknonwnGT)
                 {
-                    os << '.';
+                    buffer.append('.');
                 }
                 else
                 {
-                    bool isFirst(true);
-                    for (const auto pls : sampleInfo.genotypePhredLoghood)
-                    {
-                        if (isFirst)
-                        {
-                            isFirst = false;
-                        }
-                        else
-                        {
-                            os << ',';
-                        }
-                        os << std::min(pls, maxPL);
-                    }
+                    printSamplePL(sampleInfo.genotypePhredLoghood, buffer);
                 }
             }
 
             // PS
             if (isAnyPhased)
             {
-                os << ':';
-                if (sampleInfo.phaseSetId < 0)
-                {
-                    os << '.';
-                }
-                else
-                {
-                    os << sampleInfo.phaseSetId;
-                }
+                printSamplePS(sampleInfo, buffer);
             }
         }
     }
@@ -610,26 +688,25 @@ write_site_record_instance(
         // special constraint on continuous allele reporting right now:
         assert(altAlleleCount == 1);
 
-        const GermlineContinuousSiteLocusInfo* contLocusPtr(dynamic_cast<const GermlineContinuousSiteLocusInfo*>(&locus));
-        assert(contLocusPtr != nullptr);
-        const GermlineContinuousSiteLocusInfo& contLocus(*contLocusPtr);
+        assert(GermlineContinuousSiteLocusInfo::isInstance(locus));
+        const GermlineContinuousSiteLocusInfo& contLocus(static_cast<const GermlineContinuousSiteLocusInfo&>(locus));
 
-        os << '\t';
+        buffer.append('\t');
 
         //FORMAT
-        os << "GT";
-        os << ":GQ";
-        os << ":GQX";
-        os << ":DP:DPF";
+        buffer.append("GT");
+        buffer.append(":GQ");
+        buffer.append(":GQX");
+        buffer.append(":DP:DPF");
         if (isAltAlleles)
         {
-            os << ":AD:ADF:ADR";
+            buffer.append(":AD:ADF:ADR");
         }
         if (isAltAlleles)
         {
-            os << ":SB";
+            buffer.append(":SB");
         }
-        os << ":FT:VF";
+        buffer.append(":FT:VF");
 
         //SAMPLE
         for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
@@ -642,46 +719,50 @@ write_site_record_instance(
             const auto& sampleInfo(locus.getSample(sampleIndex));
             const auto& siteSampleInfo(locus.getSiteSample(sampleIndex));
 
-            os << '\t';
+            buffer.append('\t');
 
-            VcfGenotypeUtil::writeGenotype(sampleInfo.max_gt(),os);
+            VcfGenotypeUtil::writeGenotype(sampleInfo.max_gt(), buffer);
 
             //SAMPLE
-            os << ':' << sampleInfo.genotypeQualityPolymorphic
-               << ':' << sampleInfo.gqx;
+            buffer.append(':');
+            buffer.appendInt(sampleInfo.genotypeQualityPolymorphic);
+            buffer.append(':');
+            buffer.appendInt(sampleInfo.gqx);
 
             // DP:DPF
-            os << ':' << siteSampleInfo.n_used_calls << ':' << siteSampleInfo.n_unused_calls;
+            buffer.append(':');
+            buffer.appendUnsigned(siteSampleInfo.n_used_calls);
+            buffer.append(':');
+            buffer.appendUnsigned(siteSampleInfo.n_unused_calls);
 
             // AD/ADF/ADR
             if (isAltAlleles)
             {
-                printSampleAD(sampleInfo.supportCounts, altAlleleCount, os);
+                printSampleAD(sampleInfo.supportCounts, altAlleleCount, buffer);
             }
 
             // SB
             if (isAltAlleles)
             {
-                const StreamScoper ss(os);
-                os << ':';
-                os << std::fixed << std::setprecision(1) << siteSampleInfo.strandBias;
+                buffer.append(':');
+                buffer.appendFixed(siteSampleInfo.strandBias, 1);
             }
 
             // FT
-            os << ':';
-            sampleInfo.filters.write(os);
+            buffer.append(':');
+            sampleInfo.filters.write(buffer);
 
             // VF
             {
                 const auto& continuousSiteSampleInfo(contLocus.getContinuousSiteSample(sampleIndex));
-                const StreamScoper ss(os);
-                os << ':' << std::fixed << std::setprecision(3) << continuousSiteSampleInfo.getContinuousAlleleFrequency();
+                buffer.append(':');
+                buffer.appendFixed(continuousSiteSampleInfo.getContinuousAlleleFrequency(), 3);
             }
 
         }
     }
 
-    os << '\n';
+    buffer.append('\n');
 }
 
 
@@ -689,172 +770,189 @@ write_site_record_instance(
 void
 gvcf_writer::
 write_site_record(
-    const GermlineSiteLocusInfo& locus) const
+    const GermlineSiteLocusInfo& locus)
 {
     const unsigned sampleCount(locus.getSampleCount());
 
-    write_site_record_instance(locus, _streams.gvcfVariantsStream());
+    writeSiteRecord(getChromName(), _ref, _opt.isReportEVSFeatures, locus, _variantsBuffer);
+    flushVariantsBufferIfReady();
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
-        write_site_record_instance(locus, _streams.gvcfSampleStream(sampleIndex), sampleIndex);
+        writeSiteRecord(getChromName(), _ref, _opt.isReportEVSFeatures, locus, _sampleBuffer[sampleIndex], sampleIndex);
+        flushSampleBufferIfReady(sampleIndex);
     }
 }
 
 
 
 void
-gvcf_writer::
-write_site_record(
+writeNonVariantBlockRecord(
+    const std::string& chromName,
+    const std::string& blockLabel,
     const gvcf_block_site_record& locus,
-    std::ostream& os) const
+    TextBuffer& buffer)
 {
-    os << getChromName() << '\t'  // CHROM
-       << (locus.pos+1) << '\t'  // POS
-       << ".\t";           // ID
+    buffer.append(chromName);  // CHROM
+    buffer.append('\t');
+    buffer.appendInt(locus.pos+1);  // POS
+    buffer.append('\t');
+    buffer.append(".\t");  // ID
 
-    os  << id_to_base(locus.refBaseIndex) << '\t'; // REF
+    buffer.append(id_to_base(locus.refBaseIndex)); // REF
+    buffer.append('\t');
 
     // ALT
-    os << '.';
-    os << '\t';
+    buffer.append(".\t");
 
     // QUAL:
-    os << '.';
-    os << '\t';
+    buffer.append(".\t");
 
     // FILTER:
-    getExtendedLocusFilters(locus).write(os);
-    os << '\t';
+    getExtendedLocusFilters(locus).write(buffer);
+    buffer.append('\t');
 
     // INFO:
     if (locus.count>1)
     {
-        os << "END=" << (locus.pos+locus.count) << ';';
-        os << _dopt.block_label;
+        buffer.append("END=");
+        buffer.appendInt(locus.pos+locus.count);
+        buffer.append(';');
+        buffer.append(blockLabel);
     }
     else
     {
-        os << '.';
+        buffer.append('.');
     }
-    os << '\t';
+    buffer.append('\t');
 
     //FORMAT
-    os << "GT";
-    os << ":GQX:DP:DPF:MIN_DP";
-    os << '\t';
+    buffer.append("GT:GQX:DP:DPF:MIN_DP\t");
 
     //SAMPLE
     // there should be exactly one sample:
     assert(1 == locus.getSampleCount());
     const auto& sampleInfo(locus.getSample(0));
-    os << sampleInfo.max_gt() << ':';
+    VcfGenotypeUtil::writeGenotype(sampleInfo.max_gt(), buffer);
+    buffer.append(':');
     if (locus.isBlockGqxDefined)
     {
         // The value we want here is the genotype confidence of the entire block. Instead we only have the GT
         // probabilities from each site in the block, so an approximation is used: The minimum site genotype
         // confidence from all sites in the block provides a reasonable upper-bound on our confidence that
         // the block as a whole is 0/0 (in all cases, completely neglecting possible indel evidence in the block)
-        os << locus.block_gqx.min();
+        buffer.appendDouble(locus.block_gqx.min());
     }
     else
     {
-        os << '.';
+        buffer.append('.');
     }
-    os << ':';
+    buffer.append(':');
     //print DP:DPF:MIN_DP
-    os << std::round(locus.block_dpu.mean()) << ':'
-       << std::round(locus.block_dpf.mean()) << ':'
-       << locus.block_dpu.min();
-    os << '\n';
+    buffer.appendDouble(std::round(locus.block_dpu.mean()));
+    buffer.append(':');
+    buffer.appendDouble(std::round(locus.block_dpf.mean()));
+    buffer.append(':');
+    buffer.appendDouble(locus.block_dpu.min());
+    buffer.append('\n');
 }
 
 
 
 void
-gvcf_writer::
-write_indel_record_instance(
+writeIndelRecord(
+    const std::string& chromName,
+    const reference_contig_segment& ref,
+    const bool isReportEVSFeatures,
     const GermlineIndelLocusInfo& locus,
-    std::ostream& os,
-    const int targetSampleIndex) const
+    TextBuffer& buffer,
+    const int targetSampleIndex)
 {
     const unsigned sampleCount(locus.getSampleCount());
 
     // create VCF specific transformation of the alt allele list
     const auto& indelAlleles(locus.getIndelAlleles());
     OrthogonalAlleleSetLocusReportInfo locusReportInfo;
-    getLocusReportInfoFromAlleles(_ref, indelAlleles, locus.getCommonPrefixLength(), locusReportInfo);
+    getLocusReportInfoFromAlleles(ref, indelAlleles, locus.getCommonPrefixLength(), locusReportInfo);
 
-    os << getChromName() << '\t'   // CHROM
-       << locusReportInfo.vcfPos << '\t'   // POS
-       << ".\t"            // ID
-       << locusReportInfo.vcfRefSeq << '\t'; // REF
+    buffer.append(chromName);   // CHROM
+    buffer.append('\t');
+    buffer.appendInt(locusReportInfo.vcfPos);   // POS
+    buffer.append('\t');
+    buffer.append(".\t");            // ID
+    buffer.append(locusReportInfo.vcfRefSeq); // REF
+    buffer.append('\t');
 
     // ALT
     const unsigned altAlleleCount(locus.getAltAlleleCount());
 
     for (unsigned altAlleleIndex(0); altAlleleIndex < altAlleleCount; ++altAlleleIndex)
     {
-        if (altAlleleIndex > 0) os << ',';
-        os << locusReportInfo.altAlleles[altAlleleIndex].vcfAltSeq;
+        if (altAlleleIndex > 0) buffer.append(',');
+        buffer.append(locusReportInfo.altAlleles[altAlleleIndex].vcfAltSeq);
     }
-    os << '\t';
+    buffer.append('\t');
 
-    os << locus.anyVariantAlleleQuality << '\t'; //QUAL
+    buffer.appendInt(locus.anyVariantAlleleQuality); //QUAL
+    buffer.append('\t');
 
     // FILTER:
-    getExtendedLocusFilters(locus, targetSampleIndex).write(os);
-    os << '\t';
+    getExtendedLocusFilters(locus, targetSampleIndex).write(buffer);
+    buffer.append('\t');
 
     // INFO
-    os << "CIGAR=";
+    buffer.append("CIGAR=");
     for (unsigned altAlleleIndex(0); altAlleleIndex < altAlleleCount; ++altAlleleIndex)
     {
-        if (altAlleleIndex > 0) os << ',';
-        os << locusReportInfo.altAlleles[altAlleleIndex].vcfCigar;
+        if (altAlleleIndex > 0) buffer.append(',');
+        for (const auto& ps : locusReportInfo.altAlleles[altAlleleIndex].vcfCigar)
+        {
+            buffer.appendUnsigned(ps.length);
+            buffer.append(ALIGNPATH::segment_type_to_cigar_code(ps.type));
+        }
     }
-    os << ';';
-    os << "RU=";
+    buffer.append(';');
+    buffer.append("RU=");
     for (unsigned altAlleleIndex(0); altAlleleIndex < altAlleleCount; ++altAlleleIndex)
     {
-        if (altAlleleIndex > 0) os << ',';
+        if (altAlleleIndex > 0) buffer.append(',');
         const auto& iri(indelAlleles[altAlleleIndex].indelReportInfo);
         if (iri.isRepeatUnit() && iri.repeatUnit.size() <= 20)
         {
-            os << iri.repeatUnit;
+            buffer.append(iri.repeatUnit);
         }
         else
         {
-            os << '.';
+            buffer.append('.');
         }
     }
-    os << ';';
-    os << "REFREP=";
+    buffer.append(';');
+    buffer.append("REFREP=");
     for (unsigned altAlleleIndex(0); altAlleleIndex < altAlleleCount; ++altAlleleIndex)
     {
-        if (altAlleleIndex > 0) os << ',';
+        if (altAlleleIndex > 0) buffer.append(',');
         const auto& iri(indelAlleles[altAlleleIndex].indelReportInfo);
         if (iri.isRepeatUnit())
         {
-            os << iri.refRepeatCount;
+            buffer.appendUnsigned(iri.refRepeatCount);
         }
         else
         {
-            os << '.';
+            buffer.append('.');
         }
     }
-    os << ';';
-    os << "IDREP=";
+    buffer.append(';');
+    buffer.append("IDREP=");
     for (unsigned altAlleleIndex(0); altAlleleIndex < altAlleleCount; ++altAlleleIndex)
     {
-        if (altAlleleIndex > 0) os << ',';
+        if (altAlleleIndex > 0) buffer.append(',');
         const auto& iri(indelAlleles[altAlleleIndex].indelReportInfo);
         if (iri.isRepeatUnit())
         {
-            os << iri.indelRepeatCount;
+            buffer.appendUnsigned(iri.indelRepeatCount);
         }
         else
         {
-            os << '.';
+            buffer.append('.');
         }
     }
 
@@ -867,33 +965,24 @@ write_indel_record_instance(
             mapqTracker.merge(indelSampleInfo.mapqTracker);
         }
     }
-    os << ';';
-    os << "MQ=" << std::lround(mapqTracker.getRMS());
+    buffer.append(';');
+    buffer.append("MQ=");
+    buffer.appendInt(std::lround(mapqTracker.getRMS()));
 
-    const GermlineDiploidIndelLocusInfo* diploidLocusPtr(dynamic_cast<const GermlineDiploidIndelLocusInfo*>(&locus));
-    if (diploidLocusPtr != nullptr)
+    if (GermlineDiploidIndelLocusInfo::isInstance(locus))
     {
-        const GermlineDiploidIndelLocusInfo& diploidLocus(*diploidLocusPtr);
+        const GermlineDiploidIndelLocusInfo& diploidLocus(static_cast<const GermlineDiploidIndelLocusInfo&>(locus));
 
         //FORMAT
-        if (_opt.isReportEVSFeatures)
+        if (isReportEVSFeatures)
         {
-            // EVS features may not be computed for certain records, so check first:
-            if (! diploidLocus.evsFeatures.empty())
-            {
-                const StreamScoper ss(os);
-                os << std::setprecision(5);
-                os << ";EVSF=";
-                diploidLocus.evsFeatures.writeValues(os);
-                os << ",";
-                diploidLocus.evsDevelopmentFeatures.writeValues(os);
-            }
+            printEVSFeatures(diploidLocus, buffer);
         }
 
-        os << '\t';
+        buffer.append('\t');
 
         //FORMAT
-        os << "GT:GQ:GQX:DPI:AD:ADF:ADR:FT:PL";
+        buffer.append("GT:GQ:GQX:DPI:AD:ADF:ADR:FT:PL");
 
         bool isAnyPhased(false);
         for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
@@ -908,7 +997,7 @@ write_indel_record_instance(
 
         if (isAnyPhased)
         {
-            os << ":PS";
+            buffer.append(":PS");
         }
 
         //SAMPLE
@@ -922,49 +1011,32 @@ write_indel_record_instance(
             const auto& sampleInfo(locus.getSample(sampleIndex));
             const auto& indelSampleInfo(locus.getIndelSample(sampleIndex));
 
-            os << '\t';
+            buffer.append('\t');
 
-            os << sampleInfo.max_gt();
-            os << ':' << sampleInfo.genotypeQualityPolymorphic;
+            VcfGenotypeUtil::writeGenotype(sampleInfo.max_gt(), buffer);
+            buffer.append(':');
+            buffer.appendInt(sampleInfo.genotypeQualityPolymorphic);
 
-            os << ':' << ((sampleInfo.empiricalVariantScore >= 0) ? sampleInfo.empiricalVariantScore : sampleInfo.gqx);
+            buffer.append(':');
+            buffer.appendInt((sampleInfo.empiricalVariantScore >= 0) ? sampleInfo.empiricalVariantScore : sampleInfo.gqx);
 
-            os << ':' << indelSampleInfo.tier1Depth;
+            buffer.append(':');
+            buffer.appendUnsigned(indelSampleInfo.tier1Depth);
 
-            printSampleAD(sampleInfo.supportCounts, altAlleleCount, os);
+            printSampleAD(sampleInfo.supportCounts, altAlleleCount, buffer);
 
             // FT
-            os << ':';
-            sampleInfo.filters.write(os);
+            buffer.append(':');
+            sampleInfo.filters.write(buffer);
 
             // PL
-            os << ":";
-            bool isFirst(true);
-            for (const auto pls : sampleInfo.genotypePhredLoghood)
-            {
-                if (isFirst)
-                {
-                    isFirst = false;
-                }
-                else
-                {
-                    os << ',';
-                }
-                os << std::min(pls, maxPL);
-            }
+            buffer.append(':');
+            printSamplePL(sampleInfo.genotypePhredLoghood, buffer);
 
             // PS
             if (isAnyPhased)
             {
-                os << ':';
-                if (sampleInfo.phaseSetId < 0)
-                {
-                    os << '.';
-                }
-                else
-                {
-                    os << sampleInfo.phaseSetId;
-                }
+                printSamplePS(sampleInfo, buffer);
             }
         }
     }
@@ -973,10 +1045,10 @@ write_indel_record_instance(
         // special constraint on continuous allele reporting right now:
         assert(altAlleleCount == 1);
 
-        os << '\t';
+        buffer.append('\t');
 
         //FORMAT
-        os << "GT:GQ:GQX:DPI:AD:ADF:ADR:FT:VF";
+        buffer.append("GT:GQ:GQX:DPI:AD:ADF:ADR:FT:VF");
 
         //SAMPLE
         for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
@@ -989,45 +1061,52 @@ write_indel_record_instance(
             const auto& sampleInfo(locus.getSample(sampleIndex));
             const auto& indelSampleInfo(locus.getIndelSample(sampleIndex));
 
-            os << '\t';
+            buffer.append('\t');
 
             //SAMPLE
-            os << sampleInfo.max_gt();
-            os << ':' << sampleInfo.genotypeQualityPolymorphic;
+            VcfGenotypeUtil::writeGenotype(sampleInfo.max_gt(), buffer);
+            buffer.append(':');
+            buffer.appendInt(sampleInfo.genotypeQualityPolymorphic);
 
-            os << ':' << sampleInfo.gqx;
+            buffer.append(':');
+            buffer.appendInt(sampleInfo.gqx);
 
-            os << ':' << indelSampleInfo.tier1Depth;
+            buffer.append(':');
+            buffer.appendUnsigned(indelSampleInfo.tier1Depth);
 
             {
                 const auto& sampleReportInfo(indelSampleInfo.legacyReportInfo);
 
                 // AD:
-                os << ':' << sampleReportInfo.n_confident_ref_reads
-                   << ',' << sampleReportInfo.n_confident_indel_reads;
+                buffer.append(':');
+                buffer.appendUnsigned(sampleReportInfo.n_confident_ref_reads);
+                buffer.append(',');
+                buffer.appendUnsigned(sampleReportInfo.n_confident_indel_reads);
 
                 // ADF
-                os << ':' << sampleReportInfo.n_confident_ref_reads_fwd
-                   << ',' << sampleReportInfo.n_confident_indel_reads_fwd;
+                buffer.append(':');
+                buffer.appendUnsigned(sampleReportInfo.n_confident_ref_reads_fwd);
+                buffer.append(',');
+                buffer.appendUnsigned(sampleReportInfo.n_confident_indel_reads_fwd);
 
                 // ADR
-                os << ':' << sampleReportInfo.n_confident_ref_reads_rev
-                   << ',' << sampleReportInfo.n_confident_indel_reads_rev;
+                buffer.append(':');
+                buffer.appendUnsigned(sampleReportInfo.n_confident_ref_reads_rev);
+                buffer.append(',');
+                buffer.appendUnsigned(sampleReportInfo.n_confident_indel_reads_rev);
             }
 
             // FT
-            os << ':';
-            sampleInfo.filters.write(os);
+            buffer.append(':');
+            sampleInfo.filters.write(buffer);
 
             // VF
-            {
-                const StreamScoper ss(os);
-                os << ':' << std::setprecision(3) << indelSampleInfo.alleleFrequency();
-            }
+            buffer.append(':');
+            buffer.appendDouble(indelSampleInfo.alleleFrequency(), 3);
         }
     }
 
-    os << '\n';
+    buffer.append('\n');
 }
 
 
@@ -1035,7 +1114,7 @@ write_indel_record_instance(
 void
 gvcf_writer::
 write_indel_record(
-    const GermlineIndelLocusInfo& locus) const
+    const GermlineIndelLocusInfo& locus)
 {
     if (! _reportRange.is_pos_intersect(locus.pos)) return;
     if (_opt.isUseCallRegions())
@@ -1045,9 +1124,11 @@ write_indel_record(
 
     const unsigned sampleCount(locus.getSampleCount());
 
-    write_indel_record_instance(locus, _streams.gvcfVariantsStream());
+    writeIndelRecord(getChromName(), _ref, _opt.isReportEVSFeatures, locus, _variantsBuffer);
+    flushVariantsBufferIfReady();
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
-        write_indel_record_instance(locus, _streams.gvcfSampleStream(sampleIndex), sampleIndex);
+        writeIndelRecord(getChromName(), _ref, _opt.isReportEVSFeatures, locus, _sampleBuffer[sampleIndex], sampleIndex);
+        flushSampleBufferIfReady(sampleIndex);
     }
 }
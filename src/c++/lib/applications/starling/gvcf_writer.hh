@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "GermlineLocusPool.hh"
 #include "gvcf_block_site_record.hh"
 #include "gvcf_compressor.hh"
 #include "ScoringModelManager.hh"
@@ -31,10 +32,55 @@
 #include "variant_pipe_stage_base.hh"
 
 #include "blt_util/RegionTracker.hh"
+#include "blt_util/TextBuffer.hh"
 
 #include <iosfwd>
 
 
+/// format a compressed non-variant block record as a single line of gVCF text
+///
+/// \param blockLabel INFO field label used to indicate a multi-site block
+///
+void
+writeNonVariantBlockRecord(
+    const std::string& chromName,
+    const std::string& blockLabel,
+    const gvcf_block_site_record& block,
+    TextBuffer& buffer);
+
+
+/// format a site record as a single line of gVCF text
+///
+/// \param ref reference used to find the homopolymer length of non-variant sites
+/// \param isReportEVSFeatures if true, add the EVS features of variant loci to the INFO field
+/// \param targetSampleIndex if non-negative, format the record for only this sample, otherwise format all samples
+///
+void
+writeSiteRecord(
+    const std::string& chromName,
+    const reference_contig_segment& ref,
+    const bool isReportEVSFeatures,
+    const GermlineSiteLocusInfo& locus,
+    TextBuffer& buffer,
+    const int targetSampleIndex = -1);
+
+
+/// format an indel record as a single line of gVCF text
+///
+/// \param ref reference used to find the VCF REF and ALT sequences of the indel alleles
+/// \param isReportEVSFeatures if true, add the EVS features of the locus to the INFO field
+/// \param targetSampleIndex if non-negative, format the record for only this sample, otherwise format all samples
+///
+void
+writeIndelRecord(
+    const std::string& chromName,
+    const reference_contig_segment& ref,
+    const bool isReportEVSFeatures,
+    const GermlineIndelLocusInfo& locus,
+    TextBuffer& buffer,
+    const int targetSampleIndex = -1);
+
+
 /// Assembles all site and indel call information into a consistent set, blocks output
 /// and writes to a VCF stream
 ///
@@ -47,10 +93,12 @@ struct gvcf_writer : public variant_pipe_stage_base
         const reference_contig_segment& ref,
         const RegionTracker& nocompressRegions,
         const RegionTracker& callRegions,
-        const ScoringModelManager& scoringModels);
+        const ScoringModelManager& scoringModels,
+        GermlineLocusPool& locusPool);
 
     void process(std::unique_ptr<GermlineSiteLocusInfo>) override;
     void process(std::unique_ptr<GermlineIndelLocusInfo>) override;
+    void processNonVariantSite(GermlineDiploidSiteLocusInfo& locus) override;
 
     void
     resetRegion(
@@ -112,35 +160,32 @@ private:
     queue_site_record(
         const GermlineSiteLocusInfo& locus);
 
-    /// write site record out to a single VCF stream
-    void
-    write_site_record_instance(
-        const GermlineSiteLocusInfo& locus,
-        std::ostream& os,
-        const int targetSampleIndex = -1) const;
-
     /// write site record out to all VCF streams
     void
     write_site_record(
-        const GermlineSiteLocusInfo& locus) const;
+        const GermlineSiteLocusInfo& locus);
 
-    /// special write function for gvcf compressed non-reference site blocks
+    /// write indel record out to all VCF streams
     void
-    write_site_record(
-        const gvcf_block_site_record& locus,
-        std::ostream& os) const;
+    write_indel_record(
+        const GermlineIndelLocusInfo& locus);
 
-    /// write indel record out to a single VCF stream
+    /// write buffered records to the variants gVCF stream once enough text has accumulated
     void
-    write_indel_record_instance(
-        const GermlineIndelLocusInfo& locus,
-        std::ostream& os,
-        const int targetSampleIndex = -1) const;
+    flushVariantsBufferIfReady()
+    {
+        if (! _variantsBuffer.isFlushReady()) return;
+        _variantsBuffer.flush(_streams.gvcfVariantsStream());
+    }
 
-    /// write indel record out to all VCF streams
+    /// write buffered records for one sample to its gVCF stream once enough text has accumulated
     void
-    write_indel_record(
-        const GermlineIndelLocusInfo& locus) const;
+    flushSampleBufferIfReady(const unsigned sampleIndex)
+    {
+        TextBuffer& buffer(_sampleBuffer[sampleIndex]);
+        if (! buffer.isFlushReady()) return;
+        buffer.flush(_streams.gvcfSampleStream(sampleIndex));
+    }
 
     /// fill in missing sites
     void skip_to_pos(const pos_t target_pos);
@@ -164,6 +209,12 @@ private:
     const reference_contig_segment& _ref;
     const gvcf_deriv_options _dopt;
     std::vector<gvcf_block_site_record> _blockPerSample;
+
+    /// formatted records pending output to the variants gVCF stream
+    TextBuffer _variantsBuffer;
+
+    /// formatted records for each sample, pending output to the sample gVCF stream
+    std::vector<TextBuffer> _sampleBuffer;
     GermlineDiploidSiteLocusInfo _empty_site;
 
     const RegionTracker& _callRegions;
@@ -184,6 +235,6 @@ private:
     gvcf_compressor _gvcf_comp;
     const ScoringModelManager& _scoringModels;
 
-    /// print output limits:
-    const unsigned maxPL = 999;
+    /// loci are returned to this pool once written
+    GermlineLocusPool& _locusPool;
 };
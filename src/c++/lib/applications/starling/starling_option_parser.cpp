@@ -24,9 +24,13 @@
 
 #include "starling_option_parser.hh"
 #include "options/AlignmentFileOptionsParser.hh"
+#include "options/optionsUtil.hh"
 
 #include "boost/filesystem.hpp"
 
+#include <set>
+#include <sstream>
+
 
 //#define DEBUG_OPTIONS
 #ifdef DEBUG_OPTIONS
@@ -97,8 +101,16 @@ get_starling_option_parser(
      "Change to RNA-Seq analysis settings")
     ;
 
+    po::options_description evidence_opt("Site evidence options");
+    evidence_opt.add_options()
+    ("site-evidence-file", po::value(&opt.siteEvidenceFilename),
+     "Write the SNV site evidence of the input sample to this file, so that the sample can later be jointly genotyped with other samples without re-reading its alignments (single-sample analysis only)")
+    ("joint-site-evidence-file", po::value(&opt.jointSiteEvidenceFilenames)->multitoken(),
+     "Jointly genotype SNV sites from the given per-sample site evidence files instead of input alignment files. Indels are not called in this mode, and sites overlapping a candidate indel of a sample are filtered in that sample. May be specified multiple times, each file is analyzed as one sample.")
+    ;
+
     po::options_description starling_parse_opt("Germline calling options");
-    starling_parse_opt.add(aligndesc).add(gvcf_opt).add(phase_opt).add(score_opt);
+    starling_parse_opt.add(aligndesc).add(gvcf_opt).add(phase_opt).add(score_opt).add(evidence_opt);
 
     // final assembly
     po::options_description visible("Options");
@@ -126,12 +138,70 @@ finalize_starling_options(
 {
     parseOptions(vm, opt.alignFileOpt);
     std::string errorMsg;
-    if (checkOptions(opt.alignFileOpt, errorMsg))
+    if (opt.isJointSiteEvidenceMode())
+    {
+        if (not opt.alignFileOpt.alignmentFilenames.empty())
+        {
+            pinfo.usage("Input alignment files cannot be combined with joint site evidence files");
+        }
+
+        std::set<std::string> nameCheck;
+        for (std::string& evidenceFilename : opt.jointSiteEvidenceFilenames)
+        {
+            if (checkStandardizeInputFile(evidenceFilename, "joint site evidence file", errorMsg))
+            {
+                pinfo.usage(errorMsg.c_str());
+            }
+            if (nameCheck.count(evidenceFilename))
+            {
+                std::ostringstream oss;
+                oss << "Repeated joint site evidence filename: " << evidenceFilename;
+                pinfo.usage(oss.str().c_str());
+            }
+            nameCheck.insert(evidenceFilename);
+        }
+
+        // joint genotyping from site evidence only covers SNV sites, and does not support inputs which
+        // would require the sample alignments:
+        if (not opt.siteEvidenceFilename.empty())
+        {
+            pinfo.usage("Site evidence output cannot be combined with joint site evidence input");
+        }
+        if (not opt.is_ploidy_prior)
+        {
+            pinfo.usage("Joint site evidence input does not support continuous variant frequency calling");
+        }
+        if (not (opt.force_output_vcf.empty() and opt.input_candidate_indel_vcf.empty()))
+        {
+            pinfo.usage("Joint site evidence input does not support forced genotype or candidate indel VCF input");
+        }
+        if (not opt.ploidy_region_vcf.empty())
+        {
+            pinfo.usage("Joint site evidence input does not support ploidy VCF input");
+        }
+        if (not opt.gvcf.nocompress_region_bedfile.empty())
+        {
+            pinfo.usage("Joint site evidence input does not support nocompress BED input");
+        }
+    }
+    else if (checkOptions(opt.alignFileOpt, errorMsg))
     {
         pinfo.usage(errorMsg.c_str());
         //usage(log_os,prog,visible,errorMsg.c_str());
     }
 
+    if (not opt.siteEvidenceFilename.empty())
+    {
+        if (1 != opt.alignFileOpt.alignmentFilenames.size())
+        {
+            pinfo.usage("Site evidence can only be written when analyzing a single sample");
+        }
+        if (not opt.is_ploidy_prior)
+        {
+            pinfo.usage("Site evidence output does not support continuous variant frequency calling");
+        }
+    }
+
     // gvcf option handlers:
     opt.gvcf.is_min_gqx = (opt.gvcf.min_gqx >= 0);
     opt.gvcf.is_min_homref_gqx = (opt.gvcf.min_homref_gqx >= 0);
@@ -152,7 +222,7 @@ finalize_starling_options(
     if (opt.isReportEVSFeatures)
     {
         /// EVS feature output is contrained to the single-sample input case right now:
-        const unsigned sampleCount(opt.alignFileOpt.alignmentFilenames.size());
+        const unsigned sampleCount(opt.getAnalysisSampleCount());
         if (1 != sampleCount)
         {
             pinfo.usage("EVS features can only be reported when analyzing a single sample");
@@ -42,7 +42,7 @@ starling_pos_processor(
     const reference_contig_segment& ref,
     const starling_streams& fileStreams,
     RunStatsManager& statsManager)
-    : base_t(opt, dopt, ref, fileStreams, opt.alignFileOpt.alignmentFilenames.size(), statsManager),
+    : base_t(opt, dopt, ref, fileStreams, fileStreams.getSampleNames().size(), statsManager),
       _opt(opt),
       _dopt(dopt),
       _streams(fileStreams)
@@ -54,7 +54,7 @@ starling_pos_processor(
     if (_opt.gvcf.is_gvcf_output())
     {
         _gvcfer.reset(new gvcf_aggregator(
-                          _opt, _dopt, _streams, ref, _nocompress_regions, _callRegions, sampleCount));
+                          _opt, _dopt, _streams, ref, _nocompress_regions, _callRegions, sampleCount, _statsManager));
     }
 
     // setup indel buffer samples:
@@ -82,6 +82,11 @@ resetRegion(
     assert(_gvcfer);
     _gvcfer->resetRegion(chromName, reportRegion);
 
+    if (nullptr != _streams.getSiteEvidenceWriter())
+    {
+        _streams.getSiteEvidenceWriter()->resetRegion(chromName);
+    }
+
     // setup indel buffer max depth:
     {
         double maxIndelCandidateDepthSumOverNormalSamples(-1.);
@@ -137,6 +142,7 @@ reset()
     }
     _nocompress_regions.clear();
     _variantLocusAlreadyOutputToPos = -1;
+    _jointSiteEvidence.clear();
 }
 
 
@@ -151,11 +157,18 @@ process_pos_snp(const pos_t pos)
 
         const bool isForcedOutput(is_forced_output_pos(pos));
 
+        if (_opt.isJointSiteEvidenceMode())
+        {
+            process_pos_snp_site_evidence(pos);
+            return;
+        }
+
         const bool isSkippable(!isForcedOutput);
 
+        bool isZeroCoverage(false);
         if (isSkippable)
         {
-            bool isZeroCoverage(true);
+            isZeroCoverage = true;
             for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
             {
                 const sample_info& sif(sample(sampleIndex));
@@ -169,7 +182,7 @@ process_pos_snp(const pos_t pos)
                 }
             }
 
-            if (isZeroCoverage) return;
+            if (isZeroCoverage and (not isZeroCoverageSiteEvidence())) return;
         }
 
         // prep step 1) clean pileups in all samples:
@@ -180,10 +193,11 @@ process_pos_snp(const pos_t pos)
 
         if (_opt.is_bsnp_diploid())
         {
-            process_pos_snp_digt(pos);
+            process_pos_snp_digt(pos, isZeroCoverage);
         }
         else
         {
+            assert(not isZeroCoverage);
             process_pos_snp_continuous(pos);
         }
 
@@ -197,33 +211,47 @@ process_pos_snp(const pos_t pos)
 
 
 
+/// set the site evidence used by all site genotype models from a sample's pileup
+static
+void
+setSitePileupEvidence(
+    const CleanedPileup& cpi,
+    GermlineSiteSampleEvidence& evidence)
+{
+    const snp_pos_info& pi(cpi.rawPileup());
+    evidence.usedCallCount = cpi.n_used_calls();
+    evidence.unusedCallCount = cpi.n_unused_calls();
+    evidence.spanningDeletionReadCount = cpi.cleanedPileup().spanningDeletionReadCount;
+    evidence.mapqTracker = pi.mapqTracker;
+    evidence.rawPileupPtr = &pi;
+}
+
+
+
 /// setup siteSampleInfo assuming that corresponding sampleInfo has already been initialized
 static
 void
 updateSiteSampleInfo(
     const starling_base_options& opt,
     const unsigned sampleIndex,
-    const CleanedPileup& cpi,
     const bool isOverlappingHomAltDeletion,
     const double strandBias,
+    GermlineSiteSampleEvidence& evidence,
     GermlineSiteLocusInfo& locus)
 {
-    const snp_pos_info& good_pi(cpi.cleanedPileup());
-
     GermlineSiteSampleInfo siteSampleInfo;
 
     // note - these two values related to overlapping deletions come from diff sources, one is based on the
     // most likely genotype of overlapping indels, and the other is counts of overlapping reads.
     siteSampleInfo.isOverlappingHomAltDeletion = isOverlappingHomAltDeletion;
 
-    siteSampleInfo.spanningDeletionReadCount = good_pi.spanningDeletionReadCount;
+    siteSampleInfo.spanningDeletionReadCount = evidence.spanningDeletionReadCount;
 
-    siteSampleInfo.n_used_calls=cpi.n_used_calls();
-    siteSampleInfo.n_unused_calls=cpi.n_unused_calls();
+    siteSampleInfo.n_used_calls=evidence.usedCallCount;
+    siteSampleInfo.n_unused_calls=evidence.unusedCallCount;
 
     // MQ is computed/reported whether EVS features are needed or not, it is also used by EVS
-    const auto& pi(cpi.rawPileup());
-    siteSampleInfo.mapqTracker = pi.mapqTracker;
+    siteSampleInfo.mapqTracker = evidence.mapqTracker;
 
     siteSampleInfo.strandBias = strandBias;
 
@@ -234,13 +262,21 @@ updateSiteSampleInfo(
         // calculate empirical scoring metrics
         if (opt.is_compute_germline_scoring_metrics())
         {
-            siteSampleInfo.ReadPosRankSum = pi.get_read_pos_ranksum();
-            siteSampleInfo.MQRankSum = pi.get_mq_ranksum();
-            siteSampleInfo.BaseQRankSum = pi.get_baseq_ranksum();
+            // scoring features are only found from the raw pileup when needed, unless they were already
+            // summarized with the rest of the site evidence:
+            if (not evidence.isScoringFeatures)
+            {
+                assert(nullptr != evidence.rawPileupPtr);
+                evidence.setScoringFeatures(*evidence.rawPileupPtr);
+            }
+
+            siteSampleInfo.ReadPosRankSum = evidence.ReadPosRankSum;
+            siteSampleInfo.MQRankSum = evidence.MQRankSum;
+            siteSampleInfo.BaseQRankSum = evidence.BaseQRankSum;
 
-            siteSampleInfo.meanDistanceFromReadEdge = pi.distanceFromReadEdge.mean();
-            siteSampleInfo.rawPos = pi.get_raw_pos();
-            siteSampleInfo.avgBaseQ = pi.get_raw_baseQ();
+            siteSampleInfo.meanDistanceFromReadEdge = evidence.meanDistanceFromReadEdge;
+            siteSampleInfo.rawPos = evidence.rawPos;
+            siteSampleInfo.avgBaseQ = evidence.avgBaseQ;
         }
     }
 
@@ -254,11 +290,10 @@ void
 computeSampleDiploidSiteGenotype(
     const starling_base_options& opt,
     const starling_deriv_options& dopt,
-    const starling_pos_processor::sample_info& sif,
+    const extended_pos_info& good_epi,
     const unsigned ploidy,
     diploid_genotype& dgt)
 {
-    const extended_pos_info& good_epi(sif.cpi.getExtendedPosInfo());
     dgt.ploidy=ploidy;
     dopt.pdcaller().position_snp_call_pprob_digt(
         opt, good_epi, dgt, opt.is_all_sites());
@@ -336,31 +371,27 @@ static
 void
 updateSnvLocusWithSampleInfo(
     const starling_base_options& opt,
-    const starling_pos_processor::sample_info& sif,
-    const unsigned callerPloidy,
-    const unsigned groupLocusPloidy,
-    const diploid_genotype& dgt,
     const unsigned sampleIndex,
-    const ActiveRegionId activeRegionId,
-    const CandidateSnvBuffer& candidateSnvBuffer,
+    GermlineSiteSampleEvidence& evidence,
     GermlineDiploidSiteLocusInfo& locus,
     double& homRefLogProb)
 {
+    const int callerPloidy(evidence.getCallerPloidy());
+    const int groupLocusPloidy(evidence.groupLocusPloidy);
+    const diploid_genotype& dgt(evidence.dgt);
+
     auto& sampleInfo(locus.getSample(sampleIndex));
     sampleInfo.setPloidy(callerPloidy);
 
-    sampleInfo.setActiveRegionId(activeRegionId);
+    sampleInfo.setActiveRegionId(evidence.activeRegionId);
 
     bool isOverlappingHomAltDeletion(false);
     if (groupLocusPloidy == 0)
     {
-        const int locusPloidyAdjustment(sif.cpi.rawPileup().spanningIndelPloidyModification);
-        isOverlappingHomAltDeletion=(locusPloidyAdjustment < 0);
+        isOverlappingHomAltDeletion=(evidence.spanningIndelPloidyModification < 0);
     }
 
-    const CleanedPileup& cpi(sif.cpi);
-
-    if (cpi.n_used_calls() != 0)
+    if (evidence.usedCallCount != 0)
     {
         // the principle of this filter is that there's supposed to be no coverage here
         // we make an exception for sites inside of homalt deletions, maybe we shouldn't?
@@ -370,7 +401,7 @@ updateSnvLocusWithSampleInfo(
         }
     }
 
-    if     (locus.isRefUnknown() or (cpi.n_used_calls() == 0) or isOverlappingHomAltDeletion)
+    if     (locus.isRefUnknown() or (evidence.usedCallCount == 0) or isOverlappingHomAltDeletion)
     {
         sampleInfo.genotypeQuality = 0;
         sampleInfo.maxGenotypeIndex.setGenotypeFromAlleleIndices();
@@ -454,13 +485,12 @@ updateSnvLocusWithSampleInfo(
 
             sampleInfo.supportCounts.setAltCount(altAlleleCount);
 
-            const snp_pos_info& good_pi(cpi.cleanedPileup());
-            for (const auto& call : good_pi.calls)
+            for (unsigned baseIndex(0); baseIndex < N_BASE; ++baseIndex)
             {
-                if (call.base_id == BASE_ID::ANY) continue;
-                const uint8_t alleleIndex(baseIndexToAlleleIndex[call.base_id]);
+                const uint8_t alleleIndex(baseIndexToAlleleIndex[baseIndex]);
                 if (alleleIndex == fullAlleleCount) continue;
-                sampleInfo.supportCounts.getCounts(call.is_fwd_strand).incrementAlleleCount(alleleIndex);
+                sampleInfo.supportCounts.getCounts(true).incrementAlleleCount(alleleIndex, evidence.fwdBaseCounts[baseIndex]);
+                sampleInfo.supportCounts.getCounts(false).incrementAlleleCount(alleleIndex, evidence.revBaseCounts[baseIndex]);
             }
         }
 
@@ -471,7 +501,7 @@ updateSnvLocusWithSampleInfo(
         // allele.strandBias=dgt.strand_bias;
     }
 
-    updateSiteSampleInfo(opt, sampleIndex, cpi, isOverlappingHomAltDeletion, dgt.strand_bias, locus);
+    updateSiteSampleInfo(opt, sampleIndex, isOverlappingHomAltDeletion, dgt.strand_bias, evidence, locus);
 
     // set complex allele ids
     auto& maxGt = sampleInfo.max_gt();
@@ -481,9 +511,7 @@ updateSnvLocusWithSampleInfo(
         if (allele0Index > 0)
         {
             maxGt.setAllele0HaplotypeId(
-                candidateSnvBuffer.getHaplotypeId(sampleIndex,
-                                                  locus.pos, locus.getSiteAlleles()[allele0Index-1].baseIndex)
-            );
+                evidence.haplotypeId[locus.getSiteAlleles()[allele0Index-1].baseIndex]);
         }
     }
     if (maxGt.getPloidy() == 2)
@@ -492,12 +520,10 @@ updateSnvLocusWithSampleInfo(
         if (allele1Index > 0)
         {
             maxGt.setAllele1HaplotypeId(
-                candidateSnvBuffer.getHaplotypeId(sampleIndex,
-                                                  locus.pos, locus.getSiteAlleles()[allele1Index-1].baseIndex)
-            );
+                evidence.haplotypeId[locus.getSiteAlleles()[allele1Index-1].baseIndex]);
         }
     }
-    maxGt.addAltAlleleHaplotypeCountRatio(candidateSnvBuffer.getAltHaplotypeCountRatio(sampleIndex, locus.pos));
+    maxGt.addAltAlleleHaplotypeCountRatio(evidence.altHaplotypeCountRatio);
 }
 
 
@@ -506,7 +532,7 @@ void
 starling_pos_processor::
 getSiteAltAlleles(
     const uint8_t refBaseIndex,
-    const std::vector<diploid_genotype>& allDgt,
+    const std::vector<GermlineSiteSampleEvidence>& siteEvidence,
     std::vector<uint8_t>& altAlleles) const
 {
     const unsigned sampleCount(getSampleCount());
@@ -518,9 +544,7 @@ getSiteAltAlleles(
     std::array<double, N_BASE> sampleBaseCounts;
     for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
     {
-        const auto& cpi(sample(sampleIndex).cpi);
-        const auto& good_pi(cpi.cleanedPileup());
-        good_pi.get_known_counts(sampleBaseCounts);
+        siteEvidence[sampleIndex].getKnownCounts(sampleBaseCounts);
 
         static const double minAlleleFraction(0.10);
         unsigned minCount(0);
@@ -533,7 +557,7 @@ getSiteAltAlleles(
             minCount = std::max(1u, minCount);
         }
 
-        const auto ploidy(allDgt[sampleIndex].ploidy);
+        const auto ploidy(siteEvidence[sampleIndex].dgt.ploidy);
         for (int ploidyIndex(0); ploidyIndex < ploidy; ++ploidyIndex)
         {
             unsigned maxBaseIndex(0);
@@ -578,7 +602,7 @@ getSiteAltAlleles(
     // go through most likely genotypes and add any remaining bases in essentially random order
     for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
     {
-        const auto& dgt(allDgt[sampleIndex]);
+        const auto& dgt(siteEvidence[sampleIndex].dgt);
         const int ploidy(dgt.ploidy);
 
         auto checkGtChrom = [&](const unsigned genotypeIndex, const unsigned chromIndex)
@@ -613,89 +637,229 @@ getSiteAltAlleles(
 
 
 
+void
+starling_pos_processor::
+getSiteSampleEvidence(
+    const pos_t pos,
+    const unsigned sampleIndex,
+    GermlineSiteSampleEvidence& evidence) const
+{
+    evidence.clear();
+
+    const sample_info& sif(sample(sampleIndex));
+    const CleanedPileup& cpi(sif.cpi);
+    const snp_pos_info& pi(cpi.rawPileup());
+    const snp_pos_info& good_pi(cpi.cleanedPileup());
+
+    // setup ploidy:
+    //
+    // groupLocusPloidy of 0 is treated as a special case, if this happens the
+    // entire calling method reverts to a ploidy of 2 for the sample, but the
+    // locus ploidy is passed into the gVCF writer as 0. The gVCF writer can
+    // decide what to do with this information from there.
+    //
+    const int regionPloidy(get_ploidy(pos, sampleIndex));
+    evidence.spanningIndelPloidyModification = pi.spanningIndelPloidyModification;
+    evidence.groupLocusPloidy = std::max(0, regionPloidy+evidence.spanningIndelPloidyModification);
+
+    // compute diploid genotype object using older "4-allele" model:
+    computeSampleDiploidSiteGenotype(
+        _opt, _dopt, cpi.getExtendedPosInfo(), evidence.getCallerPloidy(), evidence.dgt);
+
+    for (const auto& call : good_pi.calls)
+    {
+        if (call.base_id == BASE_ID::ANY) continue;
+        auto& baseCounts(call.is_fwd_strand ? evidence.fwdBaseCounts : evidence.revBaseCounts);
+        baseCounts[call.base_id]++;
+    }
+
+    setSitePileupEvidence(cpi, evidence);
+
+    const CandidateSnvBuffer& candidateSnvBuffer(getCandidateSnvBuffer());
+    for (unsigned baseIndex(0); baseIndex < N_BASE; ++baseIndex)
+    {
+        evidence.haplotypeId[baseIndex] =
+            candidateSnvBuffer.getHaplotypeId(sampleIndex, pos, static_cast<BASE_ID::index_t>(baseIndex));
+    }
+    evidence.altHaplotypeCountRatio = candidateSnvBuffer.getAltHaplotypeCountRatio(sampleIndex, pos);
+    evidence.activeRegionId = getActiveRegionDetector(sampleIndex).getActiveRegionId(pos);
+}
+
+
+
+void
+starling_pos_processor::
+getEmptySiteSampleEvidence(
+    const pos_t pos,
+    const unsigned sampleIndex,
+    GermlineSiteSampleEvidence& evidence) const
+{
+    evidence.clear();
+    evidence.groupLocusPloidy = get_ploidy(pos, sampleIndex);
+
+    snp_pos_info emptyPileup;
+    emptyPileup.set_ref_base(_ref.get_base(pos));
+    static const std::vector<float> emptyDependentErrorProb;
+    const extended_pos_info emptyEpi(emptyPileup, emptyDependentErrorProb);
+    computeSampleDiploidSiteGenotype(_opt, _dopt, emptyEpi, evidence.getCallerPloidy(), evidence.dgt);
+}
+
+
+
+bool
+starling_pos_processor::
+isZeroCoverageSiteEvidence() const
+{
+    // a sample's site evidence includes uncovered sites where a spanning indel changes the locus ploidy, so that
+    // the ploidy change is reproduced when the sample is jointly genotyped:
+    if (nullptr == _streams.getSiteEvidenceWriter()) return false;
+    static const unsigned sampleIndex(0);
+    return (sample(sampleIndex).cpi.rawPileup().spanningIndelPloidyModification != 0);
+}
+
+
+
 void
 starling_pos_processor::
 process_pos_snp_digt(
-    const pos_t pos)
+    const pos_t pos,
+    const bool isZeroCoverage)
 {
     const unsigned sampleCount(getSampleCount());
-    const bool isForcedOutput(is_forced_output_pos(pos));
 
     /// TODO currently using old "4-allele" genotyping system and then reducing down to number
     /// of called alleles, transition this to work more like current indel model, where up to
     /// 4 alleles are nominated as candidates and genotyping is based on the candidate alleles
     /// only.
 
-    // -----------------------------------------------
-    // prep data for site locus creation:
-    //
-
-    // prep step 2) setup ploidy arrays:
-    std::vector<int> groupLocusPloidy;
-    std::vector<int> callerPloidy;
+    _siteSampleEvidence.resize(sampleCount);
     for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
     {
-        // groupLocusPloidy of 0 is treated as a special case, if this happens the
-        // entire calling method reverts to a ploidy of 2 for the sample, but the
-        // locus ploidy is passed into the gVCF writer as 0. The gVCF writer can
-        // decide what to do with this information from there.
-        //
-        const int regionPloidy(get_ploidy(pos, sampleIndex));
-        const int locusPloidyAdjustment(sample(sampleIndex).cpi.rawPileup().spanningIndelPloidyModification);
-        const int ploidy = std::max(0, regionPloidy+locusPloidyAdjustment);
-        groupLocusPloidy.push_back(ploidy);
-        callerPloidy.push_back((ploidy == 0) ? 2 : ploidy);
+        getSiteSampleEvidence(pos, sampleIndex, _siteSampleEvidence[sampleIndex]);
+    }
+
+    GermlineSiteEvidenceWriter* siteEvidenceWriterPtr(_streams.getSiteEvidenceWriter());
+    if (nullptr != siteEvidenceWriterPtr)
+    {
+        static const unsigned sampleIndex(0);
+        GermlineSiteSampleEvidence& evidence(_siteSampleEvidence[sampleIndex]);
+        evidence.setScoringFeatures(*evidence.rawPileupPtr);
+        siteEvidenceWriterPtr->writeSite(pos, evidence);
     }
 
-    // prep step 3) compute diploid genotype object using older "4-allele" model:
-    std::vector<diploid_genotype> allDgt(sampleCount);
+    if (isZeroCoverage) return;
+
+    addSiteLocus(pos, is_forced_output_pos(pos), _siteSampleEvidence);
+}
+
+
+
+void
+starling_pos_processor::
+process_pos_snp_site_evidence(const pos_t pos)
+{
+    const auto siteIter(_jointSiteEvidence.find(pos));
+    if (siteIter == _jointSiteEvidence.end()) return;
+
+    JointSiteEvidence& site(siteIter->second);
+    const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
     {
-        computeSampleDiploidSiteGenotype(
-            _opt, _dopt, sample(sampleIndex), callerPloidy[sampleIndex], allDgt[sampleIndex]);
+        if (site.isSampleEvidence[sampleIndex]) continue;
+        getEmptySiteSampleEvidence(pos, sampleIndex, site.sampleEvidence[sampleIndex]);
     }
 
-    // prep step 4) rank each allele in each sample, allowing up to ploidy alleles.
-    //              approximate an aggregate rank over all samples:
+    static const bool isForcedOutput(false);
+    addSiteLocus(pos, isForcedOutput, site.sampleEvidence);
+}
+
+
+
+void
+starling_pos_processor::
+insertSiteEvidence(
+    const pos_t pos,
+    const unsigned sampleIndex,
+    const GermlineSiteSampleEvidence& evidence)
+{
+    _stagemanPtr->validate_new_pos_value(pos, STAGE::READ_BUFFER);
+
+    JointSiteEvidence& site(_jointSiteEvidence[pos]);
+    if (site.sampleEvidence.empty())
+    {
+        const unsigned sampleCount(getSampleCount());
+        site.isSampleEvidence.resize(sampleCount, false);
+        site.sampleEvidence.resize(sampleCount);
+    }
+    site.isSampleEvidence[sampleIndex] = true;
+    site.sampleEvidence[sampleIndex] = evidence;
+    _is_skip_process_pos=false;
+}
+
+
+
+void
+starling_pos_processor::
+addSiteLocus(
+    const pos_t pos,
+    const bool isForcedOutput,
+    std::vector<GermlineSiteSampleEvidence>& siteEvidence)
+{
+    const unsigned sampleCount(getSampleCount());
+    assert(siteEvidence.size() == sampleCount);
+
+    // rank each allele in each sample, allowing up to ploidy alleles.
+    // approximate an aggregate rank over all samples:
     const uint8_t refBaseIndex(base_to_id(_ref.get_base(pos)));
     std::vector<uint8_t> altAlleles;
     if (refBaseIndex != BASE_ID::ANY)
     {
-        getSiteAltAlleles(refBaseIndex, allDgt, altAlleles);
+        getSiteAltAlleles(refBaseIndex, siteEvidence, altAlleles);
     }
 
     // -----------------------------------------------
     // create site locus object:
     //
-    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(new GermlineDiploidSiteLocusInfo(_dopt.gvcf, sampleCount, pos, refBaseIndex, isForcedOutput));
-
+    GermlineLocusPool& locusPool(_gvcfer->getLocusPool());
+    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(locusPool.getDiploidSiteLocus(pos, refBaseIndex, isForcedOutput));
+    GermlineDiploidSiteLocusInfo& locus(*locusPtr);
 
     // add all candidate alternate alleles:
     for (const auto baseId : altAlleles)
     {
-        locusPtr->addAltSiteAllele(static_cast<BASE_ID::index_t>(baseId));
+        locus.addAltSiteAllele(static_cast<BASE_ID::index_t>(baseId));
     }
 
     double homRefLogProb(0);
     for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
     {
-        ActiveRegionId activeRegionId(getActiveRegionDetector(sampleIndex).getActiveRegionId(pos));
-        updateSnvLocusWithSampleInfo(
-            _opt, sample(sampleIndex), callerPloidy[sampleIndex], groupLocusPloidy[sampleIndex],
-            allDgt[sampleIndex], sampleIndex, activeRegionId, getCandidateSnvBuffer(), *locusPtr, homRefLogProb);
+        updateSnvLocusWithSampleInfo(_opt, sampleIndex, siteEvidence[sampleIndex], locus, homRefLogProb);
+
+        // indels are not genotyped from site evidence files, so the sample's genotype is not reliable where it
+        // overlaps one of the sample's own candidate indels:
+        if (siteEvidence[sampleIndex].isIndelCandidateOverlap)
+        {
+            locus.getSample(sampleIndex).filters.set(GERMLINE_VARIANT_VCF_FILTERS::UngenotypedIndel);
+        }
     }
 
     // add sample-independent info:
-    locusPtr->anyVariantAlleleQuality = ln_error_prob_to_qphred(homRefLogProb);
+    locus.anyVariantAlleleQuality = ln_error_prob_to_qphred(homRefLogProb);
 
-    if (locusPtr->isVariantLocus())
+    //Add site to gvcf
+    if (locus.isVariantLocus())
     {
         // hpol filter
-        locusPtr->hpol = get_snp_hpol_size(pos,_ref);
-    }
+        locus.hpol = get_snp_hpol_size(pos,_ref);
 
-    //Add site to gvcf
-    _gvcfer->add_site(std::move(locusPtr));
+        _gvcfer->add_site(std::move(locusPtr));
+    }
+    else
+    {
+        // non-variant sites are not retained by the pipeline, so the locus can be recycled immediately:
+        _gvcfer->add_nonvariant_site(locus);
+        locusPool.recycle(std::move(locusPtr));
+    }
 }
 
 
@@ -835,8 +999,11 @@ updateContinuousSnvLocusWithSampleInfo(
         }
     }
 
+    GermlineSiteSampleEvidence evidence;
+    setSitePileupEvidence(cpi, evidence);
+
     static const bool isOverlappingHomAltDeletion(false);
-    updateSiteSampleInfo(opt, sampleIndex, cpi, isOverlappingHomAltDeletion, strandBias, locus);
+    updateSiteSampleInfo(opt, sampleIndex, isOverlappingHomAltDeletion, strandBias, evidence, locus);
 
     static const uint8_t variantAlleleIndex(1);
     const uint8_t updateAlleleIndex(isRefAllele ? 0 : variantAlleleIndex);
@@ -1010,6 +1177,11 @@ process_pos_indel(
         // segmented genome boundary between two processes. Without this step is is possible to duplicate or drop
         // indel calls across a segment boundary.
         process_pos_indel_digt(pos);
+
+        if ((not isPosPrecedingReportableRange) and (nullptr != _streams.getSiteEvidenceWriter()))
+        {
+            writeIndelSiteEvidence(pos);
+        }
     }
     else
     {
@@ -1580,6 +1752,22 @@ getIndelAllelesAtPosition(
 
 
 
+void
+starling_pos_processor::
+writeIndelSiteEvidence(const pos_t pos) const
+{
+    OrthogonalVariantAlleleCandidateGroup candidateAlleles;
+    getIndelAllelesAtPosition(getIndelBuffer(), pos, candidateAlleles);
+    if (candidateAlleles.empty()) return;
+
+    // an insertion is treated as overlapping the reference base following the insertion point:
+    const known_pos_range candidateRange(candidateAlleles.getReferenceRange());
+    const known_pos_range2 indelRange(pos, std::max(candidateRange.end_pos, (pos+1)));
+    _streams.getSiteEvidenceWriter()->writeIndel(indelRange);
+}
+
+
+
 void
 starling_pos_processor::
 process_pos_indel_digt(const pos_t pos)
@@ -1707,8 +1895,7 @@ process_pos_indel_digt(const pos_t pos)
             static OrthogonalVariantAlleleCandidateGroup emptyGroup;
 
             // setup new indel locus:
-            std::unique_ptr<GermlineIndelLocusInfo> locusPtr(
-                new GermlineDiploidIndelLocusInfo(_dopt.gvcf, sampleCount));
+            std::unique_ptr<GermlineIndelLocusInfo> locusPtr(_gvcfer->getLocusPool().getDiploidIndelLocus());
 
             // cycle through variant alleles and add them to locus
             // (the locus interface requires that this is done before any other locus information is added):
@@ -1775,6 +1962,9 @@ process_pos_indel_digt(const pos_t pos)
                     _gvcfer->add_indel(std::move(locusPtr));
                 }
             }
+
+            // return any locus which was not sent down the pipe:
+            _gvcfer->getLocusPool().recycle(std::move(locusPtr));
         }
     }
 
@@ -1858,7 +2048,7 @@ process_pos_indel_digt(const pos_t pos)
              forcedOutputAlleleIndex < forcedOutputAlleleCount; ++forcedOutputAlleleIndex)
         {
             // setup new indel locus:
-            std::unique_ptr<GermlineIndelLocusInfo> locusPtr(new GermlineDiploidIndelLocusInfo(_dopt.gvcf, sampleCount));
+            std::unique_ptr<GermlineIndelLocusInfo> locusPtr(_gvcfer->getLocusPool().getDiploidIndelLocus());
 
             // fake an allele group with only the forced output allele so that we can output using
             // standard data structures
@@ -1892,6 +2082,9 @@ process_pos_indel_digt(const pos_t pos)
                 // finished! send this locus down the pipe:
                 _gvcfer->add_indel(std::move(locusPtr));
             }
+
+            // return the locus if it was not sent down the pipe:
+            _gvcfer->getLocusPool().recycle(std::move(locusPtr));
         }
     }
 }
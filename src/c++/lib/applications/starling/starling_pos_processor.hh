@@ -19,12 +19,15 @@
 
 #pragma once
 
+#include "GermlineSiteEvidence.hh"
 #include "gvcf_aggregator.hh"
 #include "starling_shared.hh"
 #include "starling_streams.hh"
 
 #include "starling_common/starling_pos_processor_base.hh"
 
+#include <map>
+
 
 /// \brief Coordinate the germline-specific details of variant calling
 ///
@@ -51,12 +54,25 @@ struct starling_pos_processor : public starling_pos_processor_base
 
     void reset() override;
 
+    /// add the site evidence of one sample, when jointly genotyping sites from site evidence files
+    void
+    insertSiteEvidence(
+        const pos_t pos,
+        const unsigned sampleIndex,
+        const GermlineSiteSampleEvidence& evidence);
+
 private:
 
     bool
     derived_empty() const override
     {
-        return (_nocompress_regions.empty());
+        return (_nocompress_regions.empty() and _jointSiteEvidence.empty());
+    }
+
+    void
+    clear_pos_annotation(const pos_t pos) override
+    {
+        _jointSiteEvidence.erase(pos);
     }
 
     void
@@ -77,8 +93,43 @@ private:
     void
     process_pos_snp(const pos_t pos);
 
+    /// write the range of the candidate indels at this position to the site evidence file
+    void
+    writeIndelSiteEvidence(const pos_t pos) const;
+
+    void
+    process_pos_snp_digt(
+        const pos_t pos,
+        const bool isZeroCoverage);
+
+    /// genotype a site from the site evidence inserted for each sample
+    void
+    process_pos_snp_site_evidence(const pos_t pos);
+
+    /// summarize the pileup of one sample at a site
+    void
+    getSiteSampleEvidence(
+        const pos_t pos,
+        const unsigned sampleIndex,
+        GermlineSiteSampleEvidence& evidence) const;
+
+    /// get site evidence for a sample without read coverage at the site
+    void
+    getEmptySiteSampleEvidence(
+        const pos_t pos,
+        const unsigned sampleIndex,
+        GermlineSiteSampleEvidence& evidence) const;
+
+    /// \return True if site evidence is written for the current position even though it has no read coverage
+    bool
+    isZeroCoverageSiteEvidence() const;
+
+    /// create a site locus from the site evidence of all samples and add it to the gVCF pipeline
     void
-    process_pos_snp_digt(const pos_t pos);
+    addSiteLocus(
+        const pos_t pos,
+        const bool isForcedOutput,
+        std::vector<GermlineSiteSampleEvidence>& siteEvidence);
 
     void
     process_pos_snp_continuous(const pos_t pos);
@@ -94,9 +145,16 @@ private:
     void
     getSiteAltAlleles(
         const uint8_t refBaseIndex,
-        const std::vector<diploid_genotype>& allDgt,
+        const std::vector<GermlineSiteSampleEvidence>& siteEvidence,
         std::vector<uint8_t>& altAlleles) const;
 
+    /// site evidence of all samples, indexed on sample
+    struct JointSiteEvidence
+    {
+        std::vector<bool> isSampleEvidence;
+        std::vector<GermlineSiteSampleEvidence> sampleEvidence;
+    };
+
     const starling_options& _opt;
     const starling_deriv_options& _dopt;
     const starling_streams& _streams;
@@ -108,4 +166,11 @@ private:
     /// The furthest upstream position already covered by a variant indel locus.
     /// Further indel output is suppressed until going past this point.
     pos_t _variantLocusAlreadyOutputToPos = -1;
+
+    /// site evidence buffer for each sample, reused at each site
+    std::vector<GermlineSiteSampleEvidence> _siteSampleEvidence;
+
+    /// site evidence input for sites ahead of the current position, only used when jointly genotyping
+    /// sites from site evidence files
+    std::map<pos_t, JointSiteEvidence> _jointSiteEvidence;
 };
@@ -110,7 +110,8 @@ callRegion(
     starling_read_counts& readCounts,
     reference_contig_segment& ref,
     HtsMergeStreamer& streamData,
-    starling_pos_processor& posProcessor)
+    starling_pos_processor& posProcessor,
+    RunStatsManager& statsManager)
 {
     using namespace illumina::common;
 
@@ -120,6 +121,10 @@ callRegion(
     streamData.resetRegion(regionInfo.streamerRegion.c_str());
     setRefSegment(opt, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
 
+    // time spent in the input stream loop which is not claimed by a downstream stage is attributed to read loading:
+    RunCallRegionScope regionScope(statsManager, regionInfo.regionRange.size());
+    RunStageScope stageScope(statsManager, RUN_STAGE::READ_LOADING);
+
     while (streamData.next())
     {
         const pos_t currentPos(streamData.getCurrentPos());
@@ -247,6 +252,139 @@ callRegion(
 
 
 
+/// \brief Jointly genotype SNV sites in one region from the site evidence of each sample
+static
+void
+callRegionFromSiteEvidence(
+    const starling_options& opt,
+    const AnalysisRegionInfo& regionInfo,
+    const bool isCallRegion,
+    std::vector<std::unique_ptr<GermlineSiteEvidenceReader>>& siteEvidenceReaders,
+    reference_contig_segment& ref,
+    starling_pos_processor& posProcessor,
+    RunStatsManager& statsManager)
+{
+    posProcessor.resetRegion(regionInfo.regionChrom, regionInfo.regionRange);
+    setRefSegment(opt, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
+    if (isCallRegion)
+    {
+        posProcessor.insertCallRegion(regionInfo.regionRange);
+    }
+
+    RunCallRegionScope regionScope(statsManager, regionInfo.regionRange.size());
+
+    const unsigned sampleCount(siteEvidenceReaders.size());
+    std::vector<bool> isSampleSite(sampleCount);
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        GermlineSiteEvidenceReader& reader(*siteEvidenceReaders[sampleIndex]);
+        reader.resetRegion(regionInfo.regionChrom, regionInfo.regionRange);
+        isSampleSite[sampleIndex] = reader.next();
+    }
+
+    // merge the site records of all samples in position order:
+    while (true)
+    {
+        bool isSite(false);
+        pos_t sitePos(0);
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            if (not isSampleSite[sampleIndex]) continue;
+            const pos_t samplePos(siteEvidenceReaders[sampleIndex]->getPos());
+            if ((not isSite) or (samplePos < sitePos)) sitePos = samplePos;
+            isSite = true;
+        }
+        if (not isSite) break;
+
+        // wind posProcessor forward to position behind buffer head:
+        posProcessor.set_head_pos(sitePos-1);
+
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            if (not isSampleSite[sampleIndex]) continue;
+            GermlineSiteEvidenceReader& reader(*siteEvidenceReaders[sampleIndex]);
+            if (reader.getPos() != sitePos) continue;
+            posProcessor.insertSiteEvidence(sitePos, sampleIndex, reader.getEvidence());
+            isSampleSite[sampleIndex] = reader.next();
+        }
+    }
+}
+
+
+
+/// \brief Jointly genotype SNV sites from per-sample site evidence files, without reading any alignments
+static
+void
+starlingSiteEvidenceRun(
+    const prog_info& pinfo,
+    const starling_options& opt,
+    const starling_deriv_options& dopt,
+    RunStatsManager& statsManager)
+{
+    using namespace illumina::common;
+
+    reference_contig_segment ref;
+
+    std::vector<std::unique_ptr<GermlineSiteEvidenceReader>> siteEvidenceReaders;
+    std::vector<std::reference_wrapper<const bam_hdr_t>> bamHeaders;
+    std::vector<std::string> sampleNames;
+    for (const auto& evidenceFilename : opt.jointSiteEvidenceFilenames)
+    {
+        siteEvidenceReaders.emplace_back(new GermlineSiteEvidenceReader(evidenceFilename));
+        const GermlineSiteEvidenceReader& reader(*siteEvidenceReaders.back());
+        if (not bamHeaders.empty())
+        {
+            if (not check_header_compatibility(bamHeaders.front(), reader.getHeader()))
+            {
+                std::ostringstream oss;
+                oss << "ERROR: chromosome names or lengths in site evidence file '" << evidenceFilename
+                    << "' do not match site evidence file '" << opt.jointSiteEvidenceFilenames.front() << "'\n";
+                BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+            }
+        }
+        bamHeaders.push_back(reader.getHeader());
+        sampleNames.push_back(reader.getSampleName());
+    }
+
+    starling_streams fileStreams(opt, pinfo, bamHeaders, sampleNames);
+    starling_pos_processor posProcessor(opt, dopt, ref, fileStreams, statsManager);
+
+    const bam_header_info referenceHeaderInfo(bamHeaders.front());
+
+    std::vector<AnalysisRegionInfo> regionInfoList;
+    getStrelkaAnalysisRegions(opt, opt.jointSiteEvidenceFilenames.front(), referenceHeaderInfo, opt.maxIndelSize,
+                              regionInfoList);
+
+    for (const auto& regionInfo : regionInfoList)
+    {
+        if (not opt.isUseCallRegions())
+        {
+            static const bool isCallRegion(false);
+            callRegionFromSiteEvidence(opt, regionInfo, isCallRegion, siteEvidenceReaders, ref, posProcessor,
+                                       statsManager);
+        }
+        else
+        {
+            std::vector<known_pos_range2> subRegionRanges;
+            getSubRegionsFromBedTrack(opt.callRegionsBedFilename, regionInfo.regionChrom, regionInfo.regionRange, subRegionRanges);
+
+            for (const auto& subRegionRange : subRegionRanges)
+            {
+                AnalysisRegionInfo subRegionInfo;
+                getStrelkaAnalysisRegionInfo(regionInfo.regionChrom, subRegionRange.begin_pos(), subRegionRange.end_pos(),
+                                             opt.maxIndelSize, subRegionInfo);
+
+                static const bool isCallRegion(true);
+                callRegionFromSiteEvidence(opt, subRegionInfo, isCallRegion, siteEvidenceReaders, ref, posProcessor,
+                                           statsManager);
+            }
+        }
+    }
+    posProcessor.reset();
+}
+
+
+
 void
 starling_run(
     const prog_info& pinfo,
@@ -260,6 +398,13 @@ starling_run(
     opt.validate();
 
     const starling_deriv_options dopt(opt);
+
+    if (opt.isJointSiteEvidenceMode())
+    {
+        starlingSiteEvidenceRun(pinfo, opt, dopt, statsManager);
+        return;
+    }
+
     starling_read_counts readCounts;
     reference_contig_segment ref;
 
@@ -302,6 +447,7 @@ starling_run(
         {
             const vcf_streamer& vcfStream(streamData.registerVcf(opt.ploidy_region_vcf.c_str(), INPUT_TYPE::PLOIDY_REGION));
             vcfStream.validateBamHeaderChromSync(referenceHeader);
+            vcfStream.requireTextVcf("Ploidy VCF");
 
             mapVcfSampleIndices(vcfStream, sampleNames, sampleIndexToPloidyVcfSampleIndex);
             ploidyVcfSampleCount = vcfStream.getSampleCount();
@@ -339,22 +485,39 @@ starling_run(
         if (not opt.isUseCallRegions())
         {
             callRegion(opt, regionInfo, fileStreams, sampleIndexToPloidyVcfSampleIndex, ploidyVcfSampleCount,
-                       readCounts, ref, streamData, posProcessor);
+                       readCounts, ref, streamData, posProcessor, statsManager);
         }
         else
         {
             std::vector<known_pos_range2> subRegionRanges;
             getSubRegionsFromBedTrack(opt.callRegionsBedFilename, regionInfo.regionChrom, regionInfo.regionRange, subRegionRanges);
 
+            std::vector<AnalysisRegionInfo> subRegionInfoList;
+            std::vector<std::string> subRegionStreamerRegions;
             for (const auto& subRegionRange : subRegionRanges)
             {
-                AnalysisRegionInfo subRegionInfo;
+                subRegionInfoList.emplace_back();
+                AnalysisRegionInfo& subRegionInfo(subRegionInfoList.back());
                 getStrelkaAnalysisRegionInfo(regionInfo.regionChrom, subRegionRange.begin_pos(), subRegionRange.end_pos(),
                                              supplementalRegionBorderSize, subRegionInfo);
+                subRegionStreamerRegions.push_back(subRegionInfo.streamerRegion);
+            }
+
+            // read alignments for all sub-regions in a single pass over the merged index chunks:
+            streamData.setAlignmentRegionPlan(subRegionStreamerRegions);
+
+            for (const auto& subRegionInfo : subRegionInfoList)
+            {
                 callRegion(opt, subRegionInfo, fileStreams, sampleIndexToPloidyVcfSampleIndex, ploidyVcfSampleCount,
-                           readCounts, ref, streamData, posProcessor);
+                           readCounts, ref, streamData, posProcessor, statsManager);
             }
         }
     }
     posProcessor.reset();
+
+    // site evidence is only marked complete after all regions have been processed successfully:
+    if (nullptr != fileStreams.getSiteEvidenceWriter())
+    {
+        fileStreams.getSiteEvidenceWriter()->finalize();
+    }
 }
@@ -78,6 +78,20 @@ struct starling_options : public starling_base_options
         return alignFileOpt;
     }
 
+    /// \brief True if sites are jointly genotyped from per-sample site evidence files instead of alignment files
+    bool
+    isJointSiteEvidenceMode() const
+    {
+        return (not jointSiteEvidenceFilenames.empty());
+    }
+
+    /// \return Number of samples analyzed, from either the input alignment files or site evidence files
+    unsigned
+    getAnalysisSampleCount() const
+    {
+        return (isJointSiteEvidenceMode() ? jointSiteEvidenceFilenames.size() : alignFileOpt.alignmentFilenames.size());
+    }
+
     AlignmentFileOptions alignFileOpt;
 
     // empirical scoring models
@@ -90,6 +104,12 @@ struct starling_options : public starling_base_options
     /// \brief Apply special behaviors for RNA-Seq analysis if true
     bool isRNA = false;
 
+    /// \brief If non-empty, write the site evidence of the (single) input sample to this file
+    std::string siteEvidenceFilename;
+
+    /// \brief If non-empty, jointly genotype SNV sites from these per-sample site evidence files
+    std::vector<std::string> jointSiteEvidenceFilenames;
+
     gvcf_options gvcf;
 };
 
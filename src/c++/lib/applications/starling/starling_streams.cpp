@@ -82,6 +82,13 @@ starling_streams(
         }
     }
 
+    if (not opt.siteEvidenceFilename.empty())
+    {
+        assert(1 == sampleNames.size());
+        _siteEvidenceWriterPtr.reset(
+            new GermlineSiteEvidenceWriter(opt.siteEvidenceFilename, sampleNames.front(), referenceHeader));
+    }
+
     if (opt.is_realigned_read_file())
     {
         const unsigned inputAlignFileCount(bamHeaders.size());
@@ -89,7 +96,7 @@ starling_streams(
         {
             std::ostringstream rfile;
             rfile << opt.realignedReadFilenamePrefix << ".S" << alignFileIndex << ".bam";
-            _realign_bam_ptr[alignFileIndex] = initialize_realign_bam(rfile.str(), bamHeaders[alignFileIndex]);
+            _realign_bam_ptr[alignFileIndex] = initialize_realign_bam(opt, rfile.str(), bamHeaders[alignFileIndex]);
         }
     }
 }
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "GermlineSiteEvidence.hh"
 #include "starling_shared.hh"
 #include "starling_common/starling_streams_base.hh"
 
@@ -55,6 +56,13 @@ struct starling_streams : public starling_streams_base
         return _sampleNames;
     }
 
+    /// \return Site evidence writer, or nullptr if site evidence output is not enabled
+    GermlineSiteEvidenceWriter*
+    getSiteEvidenceWriter() const
+    {
+        return _siteEvidenceWriterPtr.get();
+    }
+
 private:
     static
     std::ostream*
@@ -68,4 +76,5 @@ private:
     std::unique_ptr<std::ostream> _gvcfVariantsStreamPtr;
     std::vector<std::unique_ptr<std::ostream>> _gvcfSampleStreamPtr;
     std::vector<std::string> _sampleNames;
+    std::unique_ptr<GermlineSiteEvidenceWriter> _siteEvidenceWriterPtr;
 };
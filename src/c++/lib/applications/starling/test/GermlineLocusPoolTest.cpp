@@ -0,0 +1,113 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "GermlineLocusPool.hh"
+#include "starling_shared.hh"
+
+
+BOOST_AUTO_TEST_SUITE( GermlineLocusPool_test )
+
+
+BOOST_AUTO_TEST_CASE( siteLocusRecycleTest )
+{
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 100;
+    opt.alignFileOpt.alignmentFilenames.push_back("sample.bam");
+    const starling_deriv_options dopt(opt);
+
+    const unsigned sampleCount(2);
+    GermlineLocusPool pool(dopt.gvcf, sampleCount);
+
+    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(pool.getDiploidSiteLocus(10, BASE_ID::A));
+    BOOST_REQUIRE_EQUAL(locusPtr->getSampleCount(), sampleCount);
+    BOOST_REQUIRE_EQUAL(locusPtr->getLocusType(), GERMLINE_LOCUS_TYPE::DIPLOID_SITE);
+
+    locusPtr->addAltSiteAllele(BASE_ID::C);
+    locusPtr->hpol = 3;
+    locusPtr->getSample(1).setActiveRegionId(8);
+    const GermlineDiploidSiteLocusInfo* recycledAddress(locusPtr.get());
+
+    pool.recycle(std::unique_ptr<GermlineSiteLocusInfo>(std::move(locusPtr)));
+
+    // the recycled object should be handed out again in the state of a new locus:
+    locusPtr = pool.getDiploidSiteLocus(20, BASE_ID::G, true);
+    BOOST_REQUIRE_EQUAL(locusPtr.get(), recycledAddress);
+    BOOST_REQUIRE_EQUAL(locusPtr->pos, 20);
+    BOOST_REQUIRE_EQUAL(locusPtr->refBaseIndex, BASE_ID::G);
+    BOOST_REQUIRE(locusPtr->isForcedOutput);
+    BOOST_REQUIRE_EQUAL(locusPtr->getAltAlleleCount(), 0u);
+    BOOST_REQUIRE(locusPtr->getSiteAlleles().empty());
+    BOOST_REQUIRE_EQUAL(locusPtr->hpol, 0u);
+    BOOST_REQUIRE_EQUAL(locusPtr->getSample(1).getActiveRegionId(), -1);
+
+    // the pool should be empty again:
+    std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr2(pool.getDiploidSiteLocus(21, BASE_ID::G));
+    BOOST_REQUIRE(locusPtr2.get() != recycledAddress);
+
+    // locus types other than diploid are not retained by the pool:
+    pool.recycle(std::unique_ptr<GermlineSiteLocusInfo>(
+                     new GermlineContinuousSiteLocusInfo(sampleCount, 30, BASE_ID::A)));
+    locusPtr2 = pool.getDiploidSiteLocus(31, BASE_ID::A);
+    BOOST_REQUIRE(GermlineDiploidSiteLocusInfo::isInstance(*locusPtr2));
+}
+
+
+BOOST_AUTO_TEST_CASE( indelLocusRecycleTest )
+{
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 100;
+    opt.alignFileOpt.alignmentFilenames.push_back("sample.bam");
+    const starling_deriv_options dopt(opt);
+
+    const unsigned sampleCount(1);
+    GermlineLocusPool pool(dopt.gvcf, sampleCount);
+
+    std::unique_ptr<GermlineDiploidIndelLocusInfo> locusPtr(pool.getDiploidIndelLocus());
+    BOOST_REQUIRE(GermlineIndelLocusInfo::isInstance(*locusPtr));
+    BOOST_REQUIRE(not GermlineSiteLocusInfo::isInstance(*locusPtr));
+    BOOST_REQUIRE(not GermlineContinuousIndelLocusInfo::isInstance(*locusPtr));
+
+    IndelKey indelKey(6, INDEL::INDEL, 2);
+    const IndelData indelData(1, indelKey);
+    locusPtr->addAltIndelAllele(indelKey, indelData);
+    locusPtr->anyVariantAlleleQuality = 40;
+    BOOST_REQUIRE_EQUAL(locusPtr->pos, 6);
+    const GermlineDiploidIndelLocusInfo* recycledAddress(locusPtr.get());
+
+    pool.recycle(std::unique_ptr<GermlineIndelLocusInfo>(std::move(locusPtr)));
+
+    locusPtr = pool.getDiploidIndelLocus();
+    BOOST_REQUIRE_EQUAL(locusPtr.get(), recycledAddress);
+    BOOST_REQUIRE_EQUAL(locusPtr->pos, 0);
+    BOOST_REQUIRE_EQUAL(locusPtr->anyVariantAlleleQuality, 0);
+    BOOST_REQUIRE_EQUAL(locusPtr->getAltAlleleCount(), 0u);
+    BOOST_REQUIRE(locusPtr->getIndelAlleles().empty());
+    BOOST_REQUIRE_EQUAL(locusPtr->getCommonPrefixLength(), 0u);
+
+    // alleles can be added to the recycled locus:
+    locusPtr->addAltIndelAllele(indelKey, indelData);
+    BOOST_REQUIRE_EQUAL(locusPtr->range().begin_pos(), 6);
+    BOOST_REQUIRE_EQUAL(locusPtr->range().end_pos(), 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,461 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "test_config.h"
+
+#include "GermlineSiteEvidence.hh"
+#include "starling.hh"
+
+#include "common/Exceptions.hh"
+
+#include "boost/algorithm/string.hpp"
+#include "boost/filesystem.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( GermlineSiteEvidence_test )
+
+
+/// create site evidence with values determined by the seed
+static
+GermlineSiteSampleEvidence
+getTestEvidence(const unsigned seed)
+{
+    GermlineSiteSampleEvidence evidence;
+    evidence.groupLocusPloidy = (seed % 3);
+    evidence.spanningIndelPloidyModification = -static_cast<int>(seed % 2);
+    evidence.dgt.ploidy = evidence.getCallerPloidy();
+    evidence.dgt.genome.max_gt = seed % DIGT::SIZE;
+    evidence.dgt.genome.max_gt_qphred = 10 + seed;
+    evidence.dgt.genome.ref_pprob = 0.5 / (seed + 1);
+    evidence.dgt.poly.max_gt = (seed + 1) % DIGT::SIZE;
+    evidence.dgt.strand_bias = -1.5 * seed;
+    for (unsigned gtIndex(0); gtIndex < DIGT::SIZE; ++gtIndex)
+    {
+        evidence.dgt.phredLoghood[gtIndex] = seed * gtIndex;
+    }
+    for (unsigned baseIndex(0); baseIndex < N_BASE; ++baseIndex)
+    {
+        evidence.fwdBaseCounts[baseIndex] = seed + baseIndex;
+        evidence.revBaseCounts[baseIndex] = 2 * seed + baseIndex;
+        evidence.haplotypeId[baseIndex] = (seed + baseIndex) % 3;
+    }
+    evidence.usedCallCount = 30 + seed;
+    evidence.unusedCallCount = seed;
+    evidence.spanningDeletionReadCount = seed % 4;
+    evidence.mapqTracker.add(60);
+    evidence.mapqTracker.add(seed % 2);
+    if ((seed % 2) == 0)
+    {
+        evidence.isScoringFeatures = true;
+        evidence.ReadPosRankSum = 0.25 * seed;
+        evidence.avgBaseQ = 30 + seed;
+    }
+    evidence.altHaplotypeCountRatio = 0.125f * seed;
+    evidence.activeRegionId = (seed % 2) ? -1 : static_cast<ActiveRegionId>(100 + seed);
+    return evidence;
+}
+
+
+
+static
+void
+checkEvidence(
+    const GermlineSiteSampleEvidence& evidence,
+    const GermlineSiteSampleEvidence& expected)
+{
+    BOOST_REQUIRE_EQUAL(evidence.groupLocusPloidy, expected.groupLocusPloidy);
+    BOOST_REQUIRE_EQUAL(evidence.spanningIndelPloidyModification, expected.spanningIndelPloidyModification);
+    BOOST_REQUIRE_EQUAL(evidence.dgt.ploidy, expected.dgt.ploidy);
+    BOOST_REQUIRE_EQUAL(evidence.dgt.genome.max_gt, expected.dgt.genome.max_gt);
+    BOOST_REQUIRE_EQUAL(evidence.dgt.genome.max_gt_qphred, expected.dgt.genome.max_gt_qphred);
+    BOOST_REQUIRE_EQUAL(evidence.dgt.genome.ref_pprob, expected.dgt.genome.ref_pprob);
+    BOOST_REQUIRE_EQUAL(evidence.dgt.poly.max_gt, expected.dgt.poly.max_gt);
+    BOOST_REQUIRE_EQUAL(evidence.dgt.strand_bias, expected.dgt.strand_bias);
+    BOOST_REQUIRE(evidence.dgt.phredLoghood == expected.dgt.phredLoghood);
+    BOOST_REQUIRE(evidence.fwdBaseCounts == expected.fwdBaseCounts);
+    BOOST_REQUIRE(evidence.revBaseCounts == expected.revBaseCounts);
+    BOOST_REQUIRE_EQUAL(evidence.usedCallCount, expected.usedCallCount);
+    BOOST_REQUIRE_EQUAL(evidence.unusedCallCount, expected.unusedCallCount);
+    BOOST_REQUIRE_EQUAL(evidence.spanningDeletionReadCount, expected.spanningDeletionReadCount);
+    BOOST_REQUIRE_EQUAL(evidence.mapqTracker.count, expected.mapqTracker.count);
+    BOOST_REQUIRE_EQUAL(evidence.mapqTracker.zeroCount, expected.mapqTracker.zeroCount);
+    BOOST_REQUIRE_EQUAL(evidence.mapqTracker.sumSquare, expected.mapqTracker.sumSquare);
+    BOOST_REQUIRE_EQUAL(evidence.isScoringFeatures, expected.isScoringFeatures);
+    BOOST_REQUIRE_EQUAL(evidence.ReadPosRankSum, expected.ReadPosRankSum);
+    BOOST_REQUIRE_EQUAL(evidence.avgBaseQ, expected.avgBaseQ);
+    BOOST_REQUIRE(evidence.haplotypeId == expected.haplotypeId);
+    BOOST_REQUIRE_EQUAL(evidence.altHaplotypeCountRatio, expected.altHaplotypeCountRatio);
+    BOOST_REQUIRE_EQUAL(evidence.activeRegionId, expected.activeRegionId);
+}
+
+
+
+/// create an alignment header with two chromosomes
+static
+bam_hdr_t*
+getTestHeader(const std::string& headerText)
+{
+    bam_hdr_t* header(sam_hdr_parse(headerText.size(), headerText.c_str()));
+    BOOST_REQUIRE(nullptr != header);
+    header->l_text = headerText.size();
+    header->text = static_cast<char*>(std::malloc(headerText.size()+1));
+    std::memcpy(header->text, headerText.c_str(), headerText.size()+1);
+    return header;
+}
+
+
+
+static const std::string testHeaderText("@SQ\tSN:chr1\tLN:1000\n@SQ\tSN:chr2\tLN:2000\n@RG\tID:rg1\tSM:sample1\n");
+
+
+
+static
+boost::filesystem::path
+getTestEvidencePath()
+{
+    namespace bf = boost::filesystem;
+    return (bf::temp_directory_path() / bf::unique_path("GermlineSiteEvidence_test_%%%%-%%%%.bin"));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_write_read )
+{
+    namespace bf = boost::filesystem;
+    const bf::path evidencePath(getTestEvidencePath());
+
+    bam_hdr_t* header(getTestHeader(testHeaderText));
+    {
+        GermlineSiteEvidenceWriter writer(evidencePath.string(), "sample1", *header);
+        writer.resetRegion("chr1");
+        writer.writeSite(10, getTestEvidence(1));
+        writer.writeIndel(known_pos_range2(18, 21));
+        writer.writeSite(20, getTestEvidence(2));
+        writer.writeSite(30, getTestEvidence(3));
+        writer.resetRegion("chr2");
+        writer.writeSite(5, getTestEvidence(4));
+        writer.finalize();
+    }
+    bam_hdr_destroy(header);
+
+    {
+        GermlineSiteEvidenceReader reader(evidencePath.string());
+        BOOST_REQUIRE_EQUAL(reader.getSampleName(), "sample1");
+        BOOST_REQUIRE_EQUAL(reader.getHeader().n_targets, 2);
+        BOOST_REQUIRE_EQUAL(std::string(reader.getHeader().target_name[1]), "chr2");
+        BOOST_REQUIRE_EQUAL(std::string(reader.getHeader().text), testHeaderText);
+
+        // sites preceding the region are skipped, and the site overlapping the indel record is marked:
+        reader.resetRegion("chr1", known_pos_range2(15, 25));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 20);
+        checkEvidence(reader.getEvidence(), getTestEvidence(2));
+        BOOST_REQUIRE(reader.getEvidence().isIndelCandidateOverlap);
+        BOOST_REQUIRE(not reader.next());
+
+        // the site following the previous region is retained for the next region:
+        reader.resetRegion("chr1", known_pos_range2(25, 100));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 30);
+        checkEvidence(reader.getEvidence(), getTestEvidence(3));
+        BOOST_REQUIRE(not reader.getEvidence().isIndelCandidateOverlap);
+        BOOST_REQUIRE(not reader.next());
+
+        reader.resetRegion("chr2", known_pos_range2(0, 100));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 5);
+        checkEvidence(reader.getEvidence(), getTestEvidence(4));
+        BOOST_REQUIRE(not reader.next());
+    }
+    bf::remove(evidencePath);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_unfinalized_file )
+{
+    // a file which is not finalized, such as one left by a failed run, must not be read as complete:
+    namespace bf = boost::filesystem;
+    const bf::path evidencePath(getTestEvidencePath());
+
+    bam_hdr_t* header(getTestHeader(testHeaderText));
+    {
+        GermlineSiteEvidenceWriter writer(evidencePath.string(), "sample1", *header);
+        writer.resetRegion("chr1");
+        writer.writeSite(10, getTestEvidence(1));
+    }
+    bam_hdr_destroy(header);
+
+    {
+        GermlineSiteEvidenceReader reader(evidencePath.string());
+        reader.resetRegion("chr1", known_pos_range2(0, 100));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_THROW(reader.next(), illumina::common::LogicException);
+    }
+    bf::remove(evidencePath);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_region_order )
+{
+    namespace bf = boost::filesystem;
+    const bf::path evidencePath(getTestEvidencePath());
+
+    bam_hdr_t* header(getTestHeader(testHeaderText));
+    {
+        GermlineSiteEvidenceWriter writer(evidencePath.string(), "sample1", *header);
+        writer.resetRegion("chr2");
+        writer.writeSite(10, getTestEvidence(1));
+        BOOST_REQUIRE_THROW(writer.writeSite(5, getTestEvidence(2)), illumina::common::LogicException);
+        BOOST_REQUIRE_THROW(writer.resetRegion("chr1"), illumina::common::LogicException);
+        writer.finalize();
+    }
+    bam_hdr_destroy(header);
+
+    {
+        GermlineSiteEvidenceReader reader(evidencePath.string());
+        reader.resetRegion("chr2", known_pos_range2(20, 100));
+        BOOST_REQUIRE(not reader.next());
+        BOOST_REQUIRE_THROW(reader.resetRegion("chr2", known_pos_range2(0, 20)), illumina::common::LogicException);
+        BOOST_REQUIRE_THROW(reader.resetRegion("chr1", known_pos_range2(0, 100)), illumina::common::LogicException);
+    }
+    bf::remove(evidencePath);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_concatenated_segments )
+{
+    // site evidence files written for consecutive genome segments can be concatenated into a single file:
+    namespace bf = boost::filesystem;
+    const bf::path segmentPath1(getTestEvidencePath());
+    const bf::path segmentPath2(getTestEvidencePath());
+    const bf::path evidencePath(getTestEvidencePath());
+
+    bam_hdr_t* header(getTestHeader(testHeaderText));
+    {
+        GermlineSiteEvidenceWriter writer(segmentPath1.string(), "sample1", *header);
+        writer.resetRegion("chr1");
+        writer.writeSite(10, getTestEvidence(1));
+        writer.writeIndel(known_pos_range2(48, 60));
+        writer.finalize();
+    }
+    {
+        GermlineSiteEvidenceWriter writer(segmentPath2.string(), "sample1", *header);
+        writer.resetRegion("chr1");
+        writer.writeSite(50, getTestEvidence(2));
+        writer.resetRegion("chr2");
+        writer.writeSite(5, getTestEvidence(3));
+        writer.finalize();
+    }
+    bam_hdr_destroy(header);
+
+    {
+        std::ofstream ofs(evidencePath.string(), std::ios::binary);
+        ofs << std::ifstream(segmentPath1.string(), std::ios::binary).rdbuf();
+        ofs << std::ifstream(segmentPath2.string(), std::ios::binary).rdbuf();
+    }
+
+    {
+        GermlineSiteEvidenceReader reader(evidencePath.string());
+        reader.resetRegion("chr1", known_pos_range2(0, 1000));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 10);
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 50);
+        checkEvidence(reader.getEvidence(), getTestEvidence(2));
+        BOOST_REQUIRE(reader.getEvidence().isIndelCandidateOverlap);
+        BOOST_REQUIRE(not reader.next());
+
+        reader.resetRegion("chr2", known_pos_range2(0, 100));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 5);
+        BOOST_REQUIRE(not reader.next());
+    }
+
+    // segments concatenated out of order are rejected:
+    {
+        std::ofstream ofs(evidencePath.string(), std::ios::binary);
+        ofs << std::ifstream(segmentPath2.string(), std::ios::binary).rdbuf();
+        ofs << std::ifstream(segmentPath1.string(), std::ios::binary).rdbuf();
+    }
+
+    {
+        GermlineSiteEvidenceReader reader(evidencePath.string());
+        reader.resetRegion("chr1", known_pos_range2(0, 1000));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 50);
+        BOOST_REQUIRE(not reader.next());
+
+        reader.resetRegion("chr2", known_pos_range2(0, 100));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.getPos(), 5);
+        BOOST_REQUIRE_THROW(reader.next(), illumina::common::LogicException);
+    }
+
+    bf::remove(segmentPath1);
+    bf::remove(segmentPath2);
+    bf::remove(evidencePath);
+}
+
+
+
+/// run the germline caller on the demo data with the given sample inputs and output prefix
+static
+void
+runGermlineDemo(
+    const std::vector<std::string>& inputArgs,
+    const std::string& outputPrefix)
+{
+    const std::string demoDataPath(DEMO_DATA_PATH);
+    const std::string modelPath(INDEL_ERROR_MODEL_PATH);
+    std::vector<std::string> args = {
+        "starling2", "--ref", demoDataPath + "/demo20.fa", "--region", "demo20:1-5000",
+        "-genome-size", "5000", "-max-indel-size", "50", "-min-mapping-quality", "20",
+        "--theta-file", modelPath + "/theta.json", "--indel-error-models-file", modelPath + "/indelErrorModel.json",
+        "--gvcf-output-prefix", outputPrefix };
+    args.insert(args.end(), inputArgs.begin(), inputArgs.end());
+
+    std::vector<char*> argv;
+    for (std::string& arg : args)
+    {
+        argv.push_back(&arg[0]);
+    }
+    starling().runInternal(argv.size(), argv.data());
+}
+
+
+
+/// get all non-header lines of a VCF file
+static
+std::vector<std::string>
+getVcfRecords(const std::string& vcfPath)
+{
+    std::ifstream ifs(vcfPath);
+    BOOST_REQUIRE(ifs);
+    std::vector<std::string> records;
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (line.empty() or (line[0] == '#')) continue;
+        records.push_back(line);
+    }
+    return records;
+}
+
+
+
+/// \\return True if all alleles in the VCF record are single bases
+static
+bool
+isSnvRecord(const std::vector<std::string>& fields)
+{
+    if (fields[3].size() != 1) return false;
+    std::vector<std::string> altAlleles;
+    boost::split(altAlleles, fields[4], boost::is_any_of(","));
+    for (const std::string& altAllele : altAlleles)
+    {
+        if (altAllele.size() != 1) return false;
+    }
+    return true;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_joint_site_evidence_run )
+{
+    // jointly genotyping SNVs from the site evidence of each sample should reproduce the SNV calls of a joint run
+    // over the alignment files on the demo data, while sites overlapping each indel called in the joint alignment
+    // run are filtered:
+    namespace bf = boost::filesystem;
+    const bf::path testDir(bf::temp_directory_path() / bf::unique_path("GermlineSiteEvidence_test_%%%%-%%%%"));
+    bf::create_directories(testDir);
+
+    const std::string demoDataPath(DEMO_DATA_PATH);
+    const std::vector<std::string> bamPaths = {
+        demoDataPath + "/NA12891_demo20.bam", demoDataPath + "/NA12892_demo20.bam" };
+    const unsigned sampleCount(bamPaths.size());
+
+    const std::string alignmentPrefix((testDir / "alignment.").string());
+    runGermlineDemo({"--align-file", bamPaths[0], "--align-file", bamPaths[1]}, alignmentPrefix);
+
+    std::vector<std::string> jointArgs;
+    for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+    {
+        const std::string samplePrefix((testDir / ("sample" + std::to_string(sampleIndex) + ".")).string());
+        const std::string evidencePath(samplePrefix + "evidence.bin");
+        runGermlineDemo({"--align-file", bamPaths[sampleIndex], "--site-evidence-file", evidencePath}, samplePrefix);
+        jointArgs.push_back("--joint-site-evidence-file");
+        jointArgs.push_back(evidencePath);
+    }
+
+    const std::string evidencePrefix((testDir / "evidence.").string());
+    runGermlineDemo(jointArgs, evidencePrefix);
+
+    std::vector<std::string> alignmentSnvRecords;
+    std::vector<pos_t> alignmentIndelPositions;
+    for (const std::string& record : getVcfRecords(alignmentPrefix + "variants.vcf"))
+    {
+        std::vector<std::string> fields;
+        boost::split(fields, record, boost::is_any_of("\t"));
+        if (isSnvRecord(fields))
+        {
+            alignmentSnvRecords.push_back(record);
+        }
+        else
+        {
+            alignmentIndelPositions.push_back(std::stoi(fields[1]));
+        }
+    }
+    BOOST_REQUIRE(not alignmentSnvRecords.empty());
+    BOOST_REQUIRE(not alignmentIndelPositions.empty());
+
+    const std::vector<std::string> evidenceRecords(getVcfRecords(evidencePrefix + "variants.vcf"));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(evidenceRecords.begin(), evidenceRecords.end(),
+                                    alignmentSnvRecords.begin(), alignmentSnvRecords.end());
+
+    // the first reference base following each indel's VCF anchor position should be filtered in at least one sample:
+    for (const pos_t indelPos : alignmentIndelPositions)
+    {
+        bool isFiltered(false);
+        for (unsigned sampleIndex(0); sampleIndex < sampleCount; ++sampleIndex)
+        {
+            const std::string gvcfPath(evidencePrefix + "genome.S" + std::to_string(sampleIndex+1) + ".vcf");
+            for (const std::string& record : getVcfRecords(gvcfPath))
+            {
+                std::vector<std::string> fields;
+                boost::split(fields, record, boost::is_any_of("\t"));
+                if ((std::stoi(fields[1]) == (indelPos+1)) and (fields[6] == "UngenotypedIndel")) isFiltered = true;
+            }
+        }
+        BOOST_REQUIRE_MESSAGE(isFiltered, "Site following indel at position " << indelPos << " is not filtered");
+    }
+
+    bf::remove_all(testDir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
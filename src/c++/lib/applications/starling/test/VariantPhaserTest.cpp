@@ -22,6 +22,9 @@
 
 #include "VariantPhaser.hh"
 
+namespace
+{
+
 struct DummyVariantSink : public variant_pipe_stage_base
 {
     DummyVariantSink() : variant_pipe_stage_base() {}
@@ -34,6 +37,10 @@ struct DummyVariantSink : public variant_pipe_stage_base
     {
         _indelLoci.push_back(std::move(indelLocus));
     }
+    void processNonVariantSite(GermlineDiploidSiteLocusInfo& siteLocus) override
+    {
+        _nonVariantSitePos.push_back(siteLocus.pos);
+    }
 
     bool check(const unsigned sampleIndex, const bool isSnv, const pos_t pos,
                const bool isPhased, const uint8_t allele0Index, const uint8_t allele1Index)
@@ -68,8 +75,11 @@ struct DummyVariantSink : public variant_pipe_stage_base
 
     std::vector<std::unique_ptr<GermlineSiteLocusInfo>> _siteLoci;
     std::vector<std::unique_ptr<GermlineIndelLocusInfo>> _indelLoci;
+    std::vector<pos_t> _nonVariantSitePos;
 };
 
+}
+
 
 
 static
@@ -276,4 +286,40 @@ BOOST_AUTO_TEST_CASE( phasingConflictTest )
     BOOST_REQUIRE(next->check(sampleIndex, true, 6, true, 1, 0));
 }
 
+BOOST_AUTO_TEST_CASE( nonVariantSiteTest )
+{
+    const starling_options opt = getMockOptions("CAAACAAAAA");
+    const starling_deriv_options dopt(opt);
+
+    std::shared_ptr<DummyVariantSink> next(new DummyVariantSink);
+
+    const unsigned sampleCount(1);
+    const unsigned sampleIndex(0);
+    const ActiveRegionId activeRegionId(3);
+
+    VariantPhaser phaser(opt, sampleCount, next);
+
+    // a reusable non-variant site outside of any active region is passed through by reference:
+    GermlineDiploidSiteLocusInfo siteLocus(dopt.gvcf, sampleCount);
+    siteLocus.reset(1, base_to_id('A'));
+    phaser.processNonVariantSite(siteLocus);
+    BOOST_REQUIRE_EQUAL(next->_nonVariantSitePos.size(), 1u);
+    BOOST_REQUIRE_EQUAL(next->_nonVariantSitePos[0], 1);
+
+    // a non-variant site in an active region is copied into the phasing buffer:
+    siteLocus.reset(4, base_to_id('C'));
+    siteLocus.getSample(sampleIndex).setActiveRegionId(activeRegionId);
+    phaser.processNonVariantSite(siteLocus);
+    BOOST_REQUIRE_EQUAL(next->_nonVariantSitePos.size(), 1u);
+    BOOST_REQUIRE(next->_siteLoci.empty());
+
+    // reuse of the source object must not change the buffered copy:
+    siteLocus.reset(5, base_to_id('A'));
+
+    phaser.flush();
+    BOOST_REQUIRE_EQUAL(next->_siteLoci.size(), 1u);
+    BOOST_REQUIRE_EQUAL(next->_siteLoci[0]->pos, 4);
+    BOOST_REQUIRE_EQUAL(next->_siteLoci[0]->getSample(sampleIndex).getActiveRegionId(), activeRegionId);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
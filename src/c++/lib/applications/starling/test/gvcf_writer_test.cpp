@@ -28,6 +28,9 @@
 
 #include "starling_common/pos_basecall_buffer.hh"
 
+#include <fstream>
+#include <sstream>
+
 BOOST_AUTO_TEST_SUITE( gvcf_writer_test )
 
 BOOST_AUTO_TEST_CASE( test_removeCommonPrefix )
@@ -58,4 +61,464 @@ BOOST_AUTO_TEST_CASE( test_removeCommonPrefix )
     BOOST_REQUIRE_EQUAL(ALIGNPATH::apath_to_cigar(locusReportInfo.altAlleles[2].vcfCigar), "1M5D6M");
 }
 
+
+
+/// create a set of non-variant blocks covering formatting edge cases
+static
+std::vector<gvcf_block_site_record>
+getTestNonVariantBlocks()
+{
+    const gvcf_options opt;
+    std::vector<gvcf_block_site_record> blocks;
+
+    // single-site block
+    blocks.emplace_back(opt);
+    {
+        auto& block(blocks.back());
+        block.pos = 0;
+        block.refBaseIndex = BASE_ID::A;
+        block.count = 1;
+        block.getSample(0).max_gt() = VcfGenotype(0,0);
+        block.block_gqx.add(42);
+        block.block_dpu.add(30);
+        block.block_dpf.add(2);
+        block.isBlockGqxDefined = true;
+    }
+
+    // multi-site filtered block with non-integral depth means
+    blocks.emplace_back(opt);
+    {
+        auto& block(blocks.back());
+        block.pos = 999999;
+        block.refBaseIndex = BASE_ID::G;
+        block.count = 500;
+        block.getSample(0).max_gt() = VcfGenotype(0,0);
+        block.getSample(0).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+        block.getSample(0).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowDepth);
+        for (const double val : {17., 23., 19.})
+        {
+            block.block_gqx.add(val);
+        }
+        for (const double val : {33., 34., 35., 35., 36.})
+        {
+            block.block_dpu.add(val);
+        }
+        for (const double val : {0., 1.})
+        {
+            block.block_dpf.add(val);
+        }
+        block.isBlockGqxDefined = true;
+    }
+
+    // haploid block with undefined GQX and very high depth
+    blocks.emplace_back(opt);
+    {
+        auto& block(blocks.back());
+        block.pos = 2147483000;
+        block.refBaseIndex = BASE_ID::ANY;
+        block.count = 2;
+        block.getSample(0).max_gt() = VcfGenotype(0);
+        block.block_dpu.add(1234567);
+        block.block_dpu.add(1234568);
+        block.block_dpf.add(999999);
+        block.isBlockGqxDefined = false;
+    }
+
+    // block with unknown genotype and no depth observations
+    blocks.emplace_back(opt);
+    {
+        auto& block(blocks.back());
+        block.pos = 12;
+        block.refBaseIndex = BASE_ID::T;
+        block.count = 3;
+        block.getSample(0).max_gt() = VcfGenotype();
+        block.isBlockGqxDefined = true;
+    }
+    return blocks;
+}
+
+
+
+/// check that formatted records match a golden gVCF file in the test data directory
+static
+void
+checkGoldenRecords(
+    TextBuffer& buffer,
+    const char* goldenFileName)
+{
+    const std::string goldenPath(std::string(TEST_DATA_PATH) + "/" + goldenFileName);
+    std::ifstream ifs(goldenPath);
+    BOOST_REQUIRE(ifs);
+    std::stringstream golden;
+    golden << ifs.rdbuf();
+
+    BOOST_REQUIRE_EQUAL(buffer.str(), golden.str());
+
+    std::ostringstream oss;
+    buffer.flush(oss);
+    BOOST_REQUIRE(buffer.empty());
+    BOOST_REQUIRE_EQUAL(oss.str(), golden.str());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_nonVariantBlockRecordGolden )
+{
+    TextBuffer buffer;
+    for (const auto& block : getTestNonVariantBlocks())
+    {
+        writeNonVariantBlockRecord("chr20", "BLOCKAVG_min30p3a", block, buffer);
+    }
+
+    checkGoldenRecords(buffer, "gvcf_writer_block_record_test.vcf");
+}
+
+
+
+/// reference shared by the site and indel record tests
+static
+const reference_contig_segment&
+getTestReference()
+{
+    static reference_contig_segment ref;
+    if (ref.seq().empty())
+    {
+        ref.seq() = "GATTACAGCAGCAGTTTTTTGCATGCAACGTACGTAAAAAAAAAC";
+    }
+    return ref;
+}
+
+
+
+/// set every EVS feature to a value from a list covering stream formatting edge cases
+static
+void
+setTestEVSFeatures(
+    VariantScoringFeatureKeeper& features)
+{
+    static const double values[] = { 0., 1., 0.5, 123.456789, 1e-7, 1234567., -3.14159265, 2./3. };
+    static const unsigned valueCount(sizeof(values)/sizeof(double));
+    const unsigned featureCount(features.getFeatureSet().size());
+    for (unsigned featureIndex(0); featureIndex<featureCount; ++featureIndex)
+    {
+        features.set(featureIndex, values[featureIndex % valueCount]);
+    }
+}
+
+
+
+/// set strand-specific allele support counts for one sample, counts are given in REF,ALT1,ALT2... order
+static
+void
+setTestSupportCounts(
+    const std::vector<unsigned>& fwdCounts,
+    const std::vector<unsigned>& revCounts,
+    LocusSupportingReadStats& supportCounts)
+{
+    assert(fwdCounts.size() == revCounts.size());
+    supportCounts.setAltCount(fwdCounts.size()-1);
+    for (unsigned alleleIndex(0); alleleIndex<fwdCounts.size(); ++alleleIndex)
+    {
+        supportCounts.getCounts(true).incrementAlleleCount(alleleIndex, fwdCounts[alleleIndex]);
+        supportCounts.getCounts(false).incrementAlleleCount(alleleIndex, revCounts[alleleIndex]);
+    }
+}
+
+
+
+/// format a set of site loci covering formatting edge cases, each locus is written for all samples
+/// and then for each sample in turn, matching the variants and sample gVCF outputs
+static
+void
+writeTestSiteRecords(
+    TextBuffer& buffer)
+{
+    const reference_contig_segment& ref(getTestReference());
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = ref.seq().size();
+    opt.alignFileOpt.alignmentFilenames.push_back("sample1.bam");
+    opt.alignFileOpt.alignmentFilenames.push_back("sample2.bam");
+    const starling_deriv_options dopt(opt);
+
+    std::vector<std::unique_ptr<GermlineSiteLocusInfo>> loci;
+
+    // two sample het SNV with EVS features, phasing, sample filters and a capped PL value
+    {
+        std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(
+            new GermlineDiploidSiteLocusInfo(dopt.gvcf, 2, 7, BASE_ID::G));
+        auto& locus(*locusPtr);
+        locus.addAltSiteAllele(BASE_ID::T);
+        locus.anyVariantAlleleQuality = 57;
+        locus.hpol = 2;
+        locus.filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighSNVHPOL);
+        setTestEVSFeatures(locus.evsFeatures);
+        setTestEVSFeatures(locus.evsDevelopmentFeatures);
+
+        for (unsigned sampleIndex(0); sampleIndex<2; ++sampleIndex)
+        {
+            auto& sampleInfo(locus.getSample(sampleIndex));
+            sampleInfo.max_gt() = VcfGenotype(0, 1);
+            sampleInfo.genotypeQualityPolymorphic = 45 + sampleIndex;
+            sampleInfo.gqx = 40;
+            sampleInfo.genotypePhredLoghood.getGenotypeLikelihood() = { 57, 0, 1500 };
+            setTestSupportCounts({ 10, 7 }, { 12, 5 }, sampleInfo.supportCounts);
+
+            GermlineSiteSampleInfo siteSampleInfo;
+            siteSampleInfo.n_used_calls = 34 + sampleIndex;
+            siteSampleInfo.n_unused_calls = 2;
+            siteSampleInfo.strandBias = -12.345;
+            for (const uint8_t mapq : { 60, 60, 20, 0 })
+            {
+                siteSampleInfo.mapqTracker.add(mapq);
+            }
+            locus.setSiteSampleInfo(sampleIndex, siteSampleInfo);
+        }
+        locus.getSample(0).empiricalVariantScore = 35;
+        locus.getSample(0).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+        locus.getSample(1).max_gt().setPhased(true);
+        locus.getSample(1).phaseSetId = 100;
+        loci.push_back(std::move(locusPtr));
+    }
+
+    // multi-allelic SNV without EVS features, with one unknown genotype
+    {
+        std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(
+            new GermlineDiploidSiteLocusInfo(dopt.gvcf, 2, 23, BASE_ID::T));
+        auto& locus(*locusPtr);
+        locus.addAltSiteAllele(BASE_ID::G);
+        locus.addAltSiteAllele(BASE_ID::C);
+        locus.anyVariantAlleleQuality = 310;
+        locus.hpol = 1;
+
+        auto& sampleInfo(locus.getSample(0));
+        sampleInfo.max_gt() = VcfGenotype(1, 2);
+        sampleInfo.genotypeQualityPolymorphic = 99;
+        sampleInfo.gqx = 99;
+        sampleInfo.genotypePhredLoghood.getGenotypeLikelihood() = { 999, 300, 250, 410, 0, 370 };
+        setTestSupportCounts({ 0, 9, 11 }, { 1, 8, 10 }, sampleInfo.supportCounts);
+        locus.getSample(1).max_gt() = VcfGenotype();
+        setTestSupportCounts({ 0, 0, 0 }, { 0, 0, 0 }, locus.getSample(1).supportCounts);
+        locus.getSample(1).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowDepth);
+
+        GermlineSiteSampleInfo siteSampleInfo;
+        siteSampleInfo.n_used_calls = 39;
+        siteSampleInfo.strandBias = 0.05;
+        siteSampleInfo.mapqTracker.add(45);
+        locus.setSiteSampleInfo(0, siteSampleInfo);
+        loci.push_back(std::move(locusPtr));
+    }
+
+    // non-variant site with only filtered basecalls, the homopolymer length is found from the reference
+    {
+        std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(
+            new GermlineDiploidSiteLocusInfo(dopt.gvcf, 2, 16, BASE_ID::T));
+        auto& locus(*locusPtr);
+        for (unsigned sampleIndex(0); sampleIndex<2; ++sampleIndex)
+        {
+            locus.getSample(sampleIndex).max_gt() = VcfGenotype(0, 0);
+            GermlineSiteSampleInfo siteSampleInfo;
+            siteSampleInfo.n_unused_calls = 3;
+            locus.setSiteSampleInfo(sampleIndex, siteSampleInfo);
+        }
+        locus.getSample(0).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+        locus.getSample(1).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+        loci.push_back(std::move(locusPtr));
+    }
+
+    // haploid non-variant site with an unknown reference base
+    {
+        std::unique_ptr<GermlineDiploidSiteLocusInfo> locusPtr(
+            new GermlineDiploidSiteLocusInfo(dopt.gvcf, 2, 44, BASE_ID::ANY));
+        auto& locus(*locusPtr);
+        locus.getSample(0).max_gt() = VcfGenotype(0);
+        loci.push_back(std::move(locusPtr));
+    }
+
+    // continuous frequency SNV
+    {
+        std::unique_ptr<GermlineContinuousSiteLocusInfo> locusPtr(
+            new GermlineContinuousSiteLocusInfo(2, 29, BASE_ID::G));
+        auto& locus(*locusPtr);
+        locus.addAltSiteAllele(BASE_ID::A);
+        locus.anyVariantAlleleQuality = 3;
+        locus.hpol = 1;
+
+        for (unsigned sampleIndex(0); sampleIndex<2; ++sampleIndex)
+        {
+            auto& sampleInfo(locus.getSample(sampleIndex));
+            sampleInfo.max_gt() = VcfGenotype(0, 1);
+            sampleInfo.genotypeQualityPolymorphic = 3;
+            sampleInfo.gqx = 3;
+            setTestSupportCounts({ 1, 1 }, { 0, 1 }, sampleInfo.supportCounts);
+
+            GermlineSiteSampleInfo siteSampleInfo;
+            siteSampleInfo.n_used_calls = 3;
+            siteSampleInfo.strandBias = 1.96;
+            siteSampleInfo.mapqTracker.add(33);
+            locus.setSiteSampleInfo(sampleIndex, siteSampleInfo);
+
+            GermlineContinuousSiteSampleInfo continuousSiteSampleInfo;
+            continuousSiteSampleInfo.continuousTotalDepth = 3;
+            continuousSiteSampleInfo.continuousAlleleDepth = 2 - sampleIndex;
+            locus.setContinuousSiteSampleInfo(sampleIndex, continuousSiteSampleInfo);
+        }
+        locus.getSample(1).filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+        loci.push_back(std::move(locusPtr));
+    }
+
+    static const bool isReportEVSFeatures(true);
+    for (const auto& locusPtr : loci)
+    {
+        writeSiteRecord("chr20", ref, isReportEVSFeatures, *locusPtr, buffer);
+        const unsigned sampleCount(locusPtr->getSampleCount());
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            writeSiteRecord("chr20", ref, isReportEVSFeatures, *locusPtr, buffer, sampleIndex);
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_siteRecordGolden )
+{
+    TextBuffer buffer;
+    writeTestSiteRecords(buffer);
+    checkGoldenRecords(buffer, "gvcf_writer_site_record_test.vcf");
+}
+
+
+
+/// format a set of indel loci covering formatting edge cases, each locus is written for all samples
+/// and then for each sample in turn, matching the variants and sample gVCF outputs
+static
+void
+writeTestIndelRecords(
+    TextBuffer& buffer)
+{
+    const reference_contig_segment& ref(getTestReference());
+    starling_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = ref.seq().size();
+    opt.alignFileOpt.alignmentFilenames.push_back("sample1.bam");
+    opt.alignFileOpt.alignmentFilenames.push_back("sample2.bam");
+    const starling_deriv_options dopt(opt);
+
+    std::vector<std::unique_ptr<GermlineIndelLocusInfo>> loci;
+
+    // two sample, two allele STR indel locus with EVS features, phasing and a capped PL value
+    {
+        std::unique_ptr<GermlineDiploidIndelLocusInfo> locusPtr(new GermlineDiploidIndelLocusInfo(dopt.gvcf, 2));
+        auto& locus(*locusPtr);
+        for (const IndelKey& indelKey : { IndelKey(5, INDEL::INDEL, 3), IndelKey(5, INDEL::INDEL, 0, "CAG") })
+        {
+            IndelData indelData(2, indelKey);
+            indelData.initializeAuxInfo(opt, dopt, ref);
+            locus.addAltIndelAllele(indelKey, indelData);
+        }
+        locus.anyVariantAlleleQuality = 112;
+        setTestEVSFeatures(locus.evsFeatures);
+        setTestEVSFeatures(locus.evsDevelopmentFeatures);
+
+        for (unsigned sampleIndex(0); sampleIndex<2; ++sampleIndex)
+        {
+            auto& sampleInfo(locus.getSample(sampleIndex));
+            sampleInfo.genotypeQualityPolymorphic = 80 - sampleIndex;
+            sampleInfo.gqx = 78;
+            sampleInfo.genotypePhredLoghood.getGenotypeLikelihood() = { 1200, 40, 0, 999, 50, 1000 };
+            setTestSupportCounts({ 2, 6, 5 }, { 1, 7, 4 }, sampleInfo.supportCounts);
+
+            GermlineIndelSampleInfo indelSampleInfo;
+            indelSampleInfo.tier1Depth = 26 + sampleIndex;
+            for (const uint8_t mapq : { 60, 50, 0 })
+            {
+                indelSampleInfo.mapqTracker.add(mapq);
+            }
+            locus.setIndelSampleInfo(sampleIndex, indelSampleInfo);
+        }
+        locus.getSample(0).max_gt() = VcfGenotype(1, 2);
+        locus.getSample(0).empiricalVariantScore = 21;
+        locus.getSample(1).max_gt() = VcfGenotype(2, 0, true);
+        locus.getSample(1).phaseSetId = 6;
+        locus.getSample(1).filters.set(GERMLINE_VARIANT_VCF_FILTERS::PhasingConflict);
+        loci.push_back(std::move(locusPtr));
+    }
+
+    // homopolymer deletion filtered in all samples, without EVS features
+    {
+        std::unique_ptr<GermlineDiploidIndelLocusInfo> locusPtr(new GermlineDiploidIndelLocusInfo(dopt.gvcf, 2));
+        auto& locus(*locusPtr);
+        const IndelKey indelKey(35, INDEL::INDEL, 2);
+        IndelData indelData(2, indelKey);
+        indelData.initializeAuxInfo(opt, dopt, ref);
+        locus.addAltIndelAllele(indelKey, indelData);
+        locus.anyVariantAlleleQuality = 0;
+        locus.filters.set(GERMLINE_VARIANT_VCF_FILTERS::HighRefRep);
+        for (unsigned sampleIndex(0); sampleIndex<2; ++sampleIndex)
+        {
+            auto& sampleInfo(locus.getSample(sampleIndex));
+            sampleInfo.max_gt() = VcfGenotype(0, 1);
+            sampleInfo.genotypePhredLoghood.getGenotypeLikelihood() = { 3, 0, 20 };
+            sampleInfo.filters.set(GERMLINE_VARIANT_VCF_FILTERS::LowGQX);
+            setTestSupportCounts({ 3, 1 }, { 2, 0 }, sampleInfo.supportCounts);
+            locus.setIndelSampleInfo(sampleIndex, GermlineIndelSampleInfo());
+        }
+        loci.push_back(std::move(locusPtr));
+    }
+
+    // continuous frequency homopolymer insertion
+    {
+        std::unique_ptr<GermlineContinuousIndelLocusInfo> locusPtr(new GermlineContinuousIndelLocusInfo(2));
+        auto& locus(*locusPtr);
+        const IndelKey indelKey(14, INDEL::INDEL, 0, "T");
+        IndelData indelData(2, indelKey);
+        indelData.initializeAuxInfo(opt, dopt, ref);
+        locus.addAltIndelAllele(indelKey, indelData);
+        locus.anyVariantAlleleQuality = 7;
+
+        for (unsigned sampleIndex(0); sampleIndex<2; ++sampleIndex)
+        {
+            auto& sampleInfo(locus.getSample(sampleIndex));
+            sampleInfo.max_gt() = VcfGenotype(0, 1);
+            sampleInfo.genotypeQualityPolymorphic = 7;
+            sampleInfo.gqx = 7 - sampleIndex;
+
+            GermlineIndelSampleInfo indelSampleInfo;
+            indelSampleInfo.tier1Depth = 100;
+            indelSampleInfo.mapqTracker.add(60);
+            auto& sampleReportInfo(indelSampleInfo.legacyReportInfo);
+            sampleReportInfo.n_confident_ref_reads = 90 + sampleIndex;
+            sampleReportInfo.n_confident_indel_reads = 5;
+            sampleReportInfo.n_confident_alt_reads = 5;
+            sampleReportInfo.n_confident_ref_reads_fwd = 40;
+            sampleReportInfo.n_confident_indel_reads_fwd = 2;
+            sampleReportInfo.n_confident_ref_reads_rev = 50 + sampleIndex;
+            sampleReportInfo.n_confident_indel_reads_rev = 3;
+            locus.setIndelSampleInfo(sampleIndex, indelSampleInfo);
+        }
+        loci.push_back(std::move(locusPtr));
+    }
+
+    static const bool isReportEVSFeatures(true);
+    for (const auto& locusPtr : loci)
+    {
+        writeIndelRecord("chr20", ref, isReportEVSFeatures, *locusPtr, buffer);
+        const unsigned sampleCount(locusPtr->getSampleCount());
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            writeIndelRecord("chr20", ref, isReportEVSFeatures, *locusPtr, buffer, sampleIndex);
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_indelRecordGolden )
+{
+    TextBuffer buffer;
+    writeTestIndelRecords(buffer);
+    checkGoldenRecords(buffer, "gvcf_writer_indel_record_test.vcf");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -44,6 +44,18 @@ public:
         if (_sink) _sink->process(std::move(ii));
     }
 
+    /// Insert a non-variant site locus into this pipeline stage without transferring ownership
+    ///
+    /// Non-variant sites make up nearly all positions and are typically folded into a non-variant
+    /// block by the gVCF writer, so this path allows the caller to reuse a single locus object
+    /// instead of allocating a new one at every position. Stages which forward sites unchanged pass
+    /// the reference down the pipe, stages which need to retain the site copy it into an owned
+    /// locus and continue on the standard process() path.
+    virtual void processNonVariantSite(GermlineDiploidSiteLocusInfo& si)
+    {
+        if (_sink) _sink->processNonVariantSite(si);
+    }
+
     void flush()
     {
         flush_impl();
@@ -60,21 +72,27 @@ protected:
 
     virtual void flush_impl() {}
 
+    /// create an owned copy of a site locus passed in through processNonVariantSite()
+    static std::unique_ptr<GermlineSiteLocusInfo> copySite(const GermlineDiploidSiteLocusInfo& si)
+    {
+        return std::unique_ptr<GermlineSiteLocusInfo>(new GermlineDiploidSiteLocusInfo(si));
+    }
+
+    /// locus types are resolved from the locus type tag instead of RTTI
     template <class TDerived, class TBase>
     static std::unique_ptr<TDerived> downcast(std::unique_ptr<TBase> basePtr)
     {
-        TDerived* ptr(dynamic_cast<TDerived*>(basePtr.release()));
-        if (ptr != nullptr)
+        if (TDerived::isInstance(*basePtr))
         {
-            return std::unique_ptr<TDerived>(ptr);
+            return std::unique_ptr<TDerived>(static_cast<TDerived*>(basePtr.release()));
         }
         throw std::bad_cast();
     }
 
     template <class TDerived, class TBase>
-    inline bool isInstanceOf(TBase& Instance)
+    static bool isInstanceOf(const TBase& Instance)
     {
-        return (dynamic_cast<TDerived*>(&Instance) != nullptr);
+        return TDerived::isInstance(Instance);
     }
 
     std::shared_ptr<variant_pipe_stage_base> _sink;
@@ -53,13 +53,14 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
     applySharedLocusFilters(*locusPtr);
 
     // apply filtration/EVS model:
-    if (dynamic_cast<GermlineContinuousSiteLocusInfo*>(locusPtr.get()) != nullptr)
+    if (GermlineContinuousSiteLocusInfo::isInstance(*locusPtr))
     {
         _model.default_classify_site_locus(*locusPtr);
     }
     else
     {
-        _model.classify_site(dynamic_cast<GermlineDiploidSiteLocusInfo&>(*locusPtr));
+        assert(GermlineDiploidSiteLocusInfo::isInstance(*locusPtr));
+        _model.classify_site(static_cast<GermlineDiploidSiteLocusInfo&>(*locusPtr));
     }
 
     _sink->process(std::move(locusPtr));
@@ -67,6 +68,18 @@ process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr)
 
 
 
+void
+variant_prefilter_stage::
+processNonVariantSite(GermlineDiploidSiteLocusInfo& locus)
+{
+    applySharedLocusFilters(locus);
+    _model.classify_site(locus);
+
+    _sink->processNonVariantSite(locus);
+}
+
+
+
 void
 variant_prefilter_stage::
 process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
@@ -80,13 +93,14 @@ process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr)
     applySharedLocusFilters(*locusPtr);
 
     // apply filtration/EVS model:
-    if (dynamic_cast<GermlineContinuousIndelLocusInfo*>(locusPtr.get()) != nullptr)
+    if (GermlineContinuousIndelLocusInfo::isInstance(*locusPtr))
     {
         _model.default_classify_indel_locus(*locusPtr);
     }
     else
     {
-        _model.classify_indel(dynamic_cast<GermlineDiploidIndelLocusInfo&>(*locusPtr));
+        assert(GermlineDiploidIndelLocusInfo::isInstance(*locusPtr));
+        _model.classify_indel(static_cast<GermlineDiploidIndelLocusInfo&>(*locusPtr));
     }
 
     _sink->process(std::move(locusPtr));
@@ -39,6 +39,7 @@ struct variant_prefilter_stage : public variant_pipe_stage_base
 
     void process(std::unique_ptr<GermlineSiteLocusInfo> locusPtr) override;
     void process(std::unique_ptr<GermlineIndelLocusInfo> locusPtr) override;
+    void processNonVariantSite(GermlineDiploidSiteLocusInfo& locus) override;
 
 private:
     void
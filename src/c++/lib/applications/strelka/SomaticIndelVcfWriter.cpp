@@ -26,11 +26,9 @@
 #include "somatic_indel_grid.hh"
 #include "somatic_indel_scoring_features.hh"
 #include "blt_util/blt_exception.hh"
-#include "blt_util/io_util.hh"
 #include "blt_util/fisher_exact_test.hh"
 #include "blt_util/binomial_test.hh"
 
-#include <iomanip>
 #include <iostream>
 
 
@@ -41,35 +39,39 @@ write_vcf_isri_tiers(
     const AlleleSampleReportInfo& isri1,
     const AlleleSampleReportInfo& isri2,
     const win_avg_set& was,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     static const char sep(':');
 //  DP:DP2:TAR:TIR:TOR...
-    os << isri1.tier1Depth
-       << sep
-       << isri2.tier1Depth
-       << sep
-       << isri1.n_confident_ref_reads+isri1.n_confident_alt_reads << ','
-       << isri2.n_confident_ref_reads+isri2.n_confident_alt_reads
-       << sep
-       << isri1.n_confident_indel_reads << ','
-       << isri2.n_confident_indel_reads
-       << sep
-       << isri1.n_other_reads << ','
-       << isri2.n_other_reads;
+    buffer.appendUnsigned(isri1.tier1Depth);
+    buffer.append(sep);
+    buffer.appendUnsigned(isri2.tier1Depth);
+    buffer.append(sep);
+    buffer.appendUnsigned(isri1.n_confident_ref_reads+isri1.n_confident_alt_reads);
+    buffer.append(',');
+    buffer.appendUnsigned(isri2.n_confident_ref_reads+isri2.n_confident_alt_reads);
+    buffer.append(sep);
+    buffer.appendUnsigned(isri1.n_confident_indel_reads);
+    buffer.append(',');
+    buffer.appendUnsigned(isri2.n_confident_indel_reads);
+    buffer.append(sep);
+    buffer.appendUnsigned(isri1.n_other_reads);
+    buffer.append(',');
+    buffer.appendUnsigned(isri2.n_other_reads);
 
     const float used(was.ss_used_win.avg());
     const float filt(was.ss_filt_win.avg());
     const float submap(was.ss_submap_win.avg());
 
-    const StreamScoper ss(os);
-    os << std::fixed << std::setprecision(2);
-
-    os << sep << (used+filt)
-       << sep << filt
-       << sep << submap
-       << sep << calculateBCNoise(was)
-       ;
+    static const int windowPrecision(2);
+    buffer.append(sep);
+    buffer.appendFixed(used+filt, windowPrecision);
+    buffer.append(sep);
+    buffer.appendFixed(filt, windowPrecision);
+    buffer.append(sep);
+    buffer.appendFixed(submap, windowPrecision);
+    buffer.append(sep);
+    buffer.appendFixed(calculateBCNoise(was), windowPrecision);
 }
 
 
@@ -85,7 +87,7 @@ writeSomaticIndelVcfGrid(
     const win_avg_set& wasNormal,
     const win_avg_set& wasTumor,
     const double maxChromDepth,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     const indel_result_set& rs(siInfo.sindel.rs);
 
@@ -149,69 +151,87 @@ writeSomaticIndelVcfGrid(
 
     static const char sep('\t');
     // CHROM
-    os << chromName;
+    buffer.append(chromName);
 
     // POS+
-    os << sep << output_pos;
+    buffer.append(sep);
+    buffer.appendInt(output_pos);
 
     // ID
-    os << sep << ".";
+    buffer.append(sep);
+    buffer.append('.');
 
     // REF/ALT
-    os << sep << siInfo.vcf_ref_seq
-       << sep << siInfo.vcf_indel_seq;
+    buffer.append(sep);
+    buffer.append(siInfo.vcf_ref_seq);
+    buffer.append(sep);
+    buffer.append(siInfo.vcf_indel_seq);
 
     //QUAL:
-    os << sep << ".";
+    buffer.append(sep);
+    buffer.append('.');
 
     //FILTER:
-    os << sep;
-    smod.filters.write(os);
+    buffer.append(sep);
+    smod.filters.write(buffer);
 
     //INFO
-    os << sep
-       << "SOMATIC";
-
-    os << ";QSI=" << rs.qphred
-       << ";TQSI=" << (siInfo.sindel.sindel_tier+1)
-       << ";NT=" << NTYPE::label(rs.ntype)
-       << ";QSI_NT=" << rs.from_ntype_qphred
-       << ";TQSI_NT=" << (siInfo.sindel.sindel_from_ntype_tier+1)
-       << ";SGT="; // << static_cast<SOMATIC_DIGT::index_t>(rs.max_gt);
-    DDIGT::write_indel_state(static_cast<DDIGT::index_t>(rs.max_gt),os);
+    buffer.append(sep);
+    buffer.append("SOMATIC");
+
+    buffer.append(";QSI=");
+    buffer.appendInt(rs.qphred);
+    buffer.append(";TQSI=");
+    buffer.appendInt(siInfo.sindel.sindel_tier+1);
+    buffer.append(";NT=");
+    buffer.append(NTYPE::label(rs.ntype));
+    buffer.append(";QSI_NT=");
+    buffer.appendInt(rs.from_ntype_qphred);
+    buffer.append(";TQSI_NT=");
+    buffer.appendInt(siInfo.sindel.sindel_from_ntype_tier+1);
+    buffer.append(";SGT=");
+    DDIGT::write_indel_state(static_cast<DDIGT::index_t>(rs.max_gt),buffer);
 
     {
+        static const int infoPrecision(2);
+
         //MQ and MQ0
         MapqTracker mapqTracker(siInfo.nisri[1].mapqTracker);
         mapqTracker.merge(siInfo.tisri[1].mapqTracker);
 
-        const StreamScoper ss(os);
-        os << std::fixed << std::setprecision(2);
-        os << ";MQ=" << mapqTracker.getRMS()
-           << ";MQ0=" << mapqTracker.zeroCount;
+        buffer.append(";MQ=");
+        buffer.appendFixed(mapqTracker.getRMS(), infoPrecision);
+        buffer.append(";MQ0=");
+        buffer.appendUnsigned(mapqTracker.zeroCount);
 
         if (siInfo.indelReportInfo.isRepeatUnit())
         {
-            os << ";RU=" << siInfo.indelReportInfo.repeatUnit
-               << ";RC=" << siInfo.indelReportInfo.refRepeatCount
-               << ";IC=" << siInfo.indelReportInfo.indelRepeatCount;
+            buffer.append(";RU=");
+            buffer.append(siInfo.indelReportInfo.repeatUnit);
+            buffer.append(";RC=");
+            buffer.appendUnsigned(siInfo.indelReportInfo.refRepeatCount);
+            buffer.append(";IC=");
+            buffer.appendUnsigned(siInfo.indelReportInfo.indelRepeatCount);
         }
-        os << ";IHP=" << siInfo.indelReportInfo.interruptedHomopolymerLength;
+        buffer.append(";IHP=");
+        buffer.appendUnsigned(siInfo.indelReportInfo.interruptedHomopolymerLength);
 
         if (smod.isEVS)
         {
-            os << ";" << opt.SomaticEVSVcfInfoTag << "=" << smod.EVS;
+            buffer.append(';');
+            buffer.append(opt.SomaticEVSVcfInfoTag);
+            buffer.append('=');
+            buffer.appendFixed(smod.EVS, infoPrecision);
         }
     }
 
     if (opt.isReportEVSFeatures)
     {
-        const StreamScoper ss(os);
-        os << std::setprecision(5);
-        os << ";EVSF=";
-        smod.features.writeValues(os);
-        os << ",";
-        smod.dfeatures.writeValues(os);
+        static const int evsFeaturePrecision(5);
+        buffer.append(";EVSF=");
+        smod.features.writeValues(buffer, evsFeaturePrecision);
+        buffer.append(',');
+        smod.dfeatures.writeValues(buffer, evsFeaturePrecision);
     }
 
     // vcf header does not include breakpoint fields, so don't let this be casually turned back on:
@@ -219,22 +239,23 @@ writeSomaticIndelVcfGrid(
 
     if (rs.is_overlap)
     {
-        os << ";OVERLAP";
+        buffer.append(";OVERLAP");
     }
 
 
     //FORMAT
-    os << sep << "DP:DP2:TAR:TIR:TOR:DP50:FDP50:SUBDP50:BCN50";
+    buffer.append(sep);
+    buffer.append("DP:DP2:TAR:TIR:TOR:DP50:FDP50:SUBDP50:BCN50");
 
     // write normal sample info:
-    os << sep;
-    write_vcf_isri_tiers(siInfo.nisri[0],siInfo.nisri[1], wasNormal,os);
+    buffer.append(sep);
+    write_vcf_isri_tiers(siInfo.nisri[0],siInfo.nisri[1], wasNormal,buffer);
 
     // write tumor sample info:
-    os << sep;
-    write_vcf_isri_tiers(siInfo.tisri[0],siInfo.tisri[1], wasTumor,os);
+    buffer.append(sep);
+    write_vcf_isri_tiers(siInfo.tisri[0],siInfo.tisri[1], wasTumor,buffer);
 
-    os << '\n';
+    buffer.append('\n');
 }
 
 
@@ -273,7 +294,8 @@ addIndelWindowData(
     assert(testPos(pos));
     for (const auto& indelInfo : _data[pos])
     {
-        writeSomaticIndelVcfGrid(_opt, _dopt, chromName, pos, indelInfo, wasNormal, wasTumor, maxChromDepth, *_osptr);
+        writeSomaticIndelVcfGrid(_opt, _dopt, chromName, pos, indelInfo, wasNormal, wasTumor, maxChromDepth, _recordBuffer);
+        _recordBuffer.flush(*_osptr);
     }
     _data.erase(pos);
 }
@@ -26,6 +26,7 @@
 #include "somatic_result_set.hh"
 #include "strelka_shared.hh"
 
+#include "blt_util/TextBuffer.hh"
 #include "starling_common/AlleleReportInfo.hh"
 #include "starling_common/starling_pos_processor_win_avg_set.hh"
 
@@ -99,4 +100,7 @@ private:
     const strelka_deriv_options& _dopt;
     std::ostream* _osptr;
     std::map<pos_t,std::vector<SomaticIndelVcfInfo>> _data;
+
+    /// reused to format each indel record
+    TextBuffer _recordBuffer;
 };
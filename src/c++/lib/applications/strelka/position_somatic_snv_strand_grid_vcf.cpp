@@ -25,14 +25,9 @@
 #include "somaticAlleleUtil.hh"
 #include "strelka_vcf_locus_info.hh"
 #include "somatic_call_shared.hh"
-#include "blt_util/io_util.hh"
 #include "blt_util/math_util.hh"
 
 
-#include <iomanip>
-#include <iostream>
-
-
 /// Calculate LOR feature for SNVs (log odds ratio for  T_REF T_ALT
 ///                               		                N_REF N_ALT)
 ///
@@ -228,16 +223,16 @@ write_vcf_sample_info(
     const strelka_deriv_options& /*dopt*/,
     const CleanedPileup& tier1_cpi,
     const CleanedPileup& tier2_cpi,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     //DP:FDP:SDP:SUBDP:AU:CU:GU:TU
-    os << tier1_cpi.n_calls()
-       << ':'
-       << tier1_cpi.n_unused_calls()
-       << ':'
-       << tier1_cpi.rawPileup().spanningDeletionReadCount
-       << ':'
-       << tier1_cpi.rawPileup().n_submapped;
+    buffer.appendUnsigned(tier1_cpi.n_calls());
+    buffer.append(':');
+    buffer.appendUnsigned(tier1_cpi.n_unused_calls());
+    buffer.append(':');
+    buffer.appendUnsigned(tier1_cpi.rawPileup().spanningDeletionReadCount);
+    buffer.append(':');
+    buffer.appendUnsigned(tier1_cpi.rawPileup().n_submapped);
 
 
     std::array<unsigned,N_BASE> tier1_base_counts;
@@ -247,9 +242,10 @@ write_vcf_sample_info(
 
     for (unsigned b(0); b<N_BASE; ++b)
     {
-        os << ':'
-           << tier1_base_counts[b] << ','
-           << tier2_base_counts[b];
+        buffer.append(':');
+        buffer.appendUnsigned(tier1_base_counts[b]);
+        buffer.append(',');
+        buffer.appendUnsigned(tier2_base_counts[b]);
     }
 }
 
@@ -267,7 +263,7 @@ write_vcf_somatic_snv_genotype_strand_grid(
     const CleanedPileup& t2_epd,
     const double normChromDepth,
     const double maxChromDepth,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     const snv_result_set& rs(sgt.rs);
 
@@ -355,95 +351,96 @@ write_vcf_somatic_snv_genotype_strand_grid(
 
     char ref_base = n1_epd.rawPileup().get_ref_base();
     //REF:
-    os << '\t' << ref_base
-       //ALT:
-       << "\t";
+    buffer.append('\t');
+    buffer.append(ref_base);
+    //ALT:
+    buffer.append('\t');
 
     DDIGT::write_alt_alleles(id_to_base(rs.normal_alt_id),
                              id_to_base(rs.tumor_alt_id),
                              ref_base,
-                             os);
+                             buffer);
 
     //QUAL:
-    os << "\t.";
+    buffer.append("\t.");
 
     //FILTER:
-    os << "\t";
-    smod.filters.write(os);
+    buffer.append('\t');
+    smod.filters.write(buffer);
 
     //INFO:
-    os << '\t'
-       << "SOMATIC"
-       << ";QSS=" << rs.qphred;
+    buffer.append('\t');
+    buffer.append("SOMATIC");
+    buffer.append(";QSS=");
+    buffer.appendInt(rs.qphred);
 
     if (is_write_nqss)
     {
-        os << ";NQSS=" << rs.nonsomatic_qphred;
+        buffer.append(";NQSS=");
+        buffer.appendInt(rs.nonsomatic_qphred);
     }
 
-    os << ";TQSS=" << (sgt.snv_tier+1)
-       << ";NT=" << NTYPE::label(rs.ntype)
-       << ";QSS_NT=" << rs.from_ntype_qphred
-       << ";TQSS_NT=" << (sgt.snv_from_ntype_tier+1);
-    os << ";SGT=";
+    buffer.append(";TQSS=");
+    buffer.appendInt(sgt.snv_tier+1);
+    buffer.append(";NT=");
+    buffer.append(NTYPE::label(rs.ntype));
+    buffer.append(";QSS_NT=");
+    buffer.appendInt(rs.from_ntype_qphred);
+    buffer.append(";TQSS_NT=");
+    buffer.appendInt(sgt.snv_from_ntype_tier+1);
+    buffer.append(";SGT=");
 
     DDIGT::write_snv_state(static_cast<DDIGT::index_t>(rs.max_gt),
                            ref_base,
                            id_to_base(rs.normal_alt_id),
                            id_to_base(rs.tumor_alt_id),
-                           os);
+                           buffer);
 
     {
-        const StreamScoper ss(os);
-        os << std::fixed << std::setprecision(2);
+        static const int infoPrecision(2);
 
         // m_mapq includes all calls, even from reads below the mapq threshold:
         MapqTracker mapqTracker(n1_epd.rawPileup().mapqTracker);
         mapqTracker.merge(t1_epd.rawPileup().mapqTracker);
-        os << ";DP=" << mapqTracker.count;
-        os << ";MQ=" << smod.features.get(SOMATIC_SNV_SCORING_FEATURES::RMSMappingQuality);
-        os << ";MQ0=" << mapqTracker.zeroCount;
-
-//        os << ";ALTPOS=";
-//        if (smod.features.test(SOMATIC_SNV_SCORING_FEATURES::altpos))
-//            os << (int)smod.features.get(SOMATIC_SNV_SCORING_FEATURES::altpos);
-//        else
-//            os << '.';
-
-//        os << ";ALTMAP=";
-//        if (smod.features.test(SOMATIC_SNV_SCORING_FEATURES::altmap))
-//            os << (int)smod.features.get(SOMATIC_SNV_SCORING_FEATURES::altmap);
-//        else
-//            os << '.';
-
-        os << ";ReadPosRankSum=" << smod.features.get(SOMATIC_SNV_SCORING_FEATURES::TumorSampleReadPosRankSum);
-        os << ";SNVSB=" << smod.features.get(SOMATIC_SNV_SCORING_FEATURES::TumorSampleStrandBias);
+        buffer.append(";DP=");
+        buffer.appendUnsigned(mapqTracker.count);
+        buffer.append(";MQ=");
+        buffer.appendFixed(smod.features.get(SOMATIC_SNV_SCORING_FEATURES::RMSMappingQuality), infoPrecision);
+        buffer.append(";MQ0=");
+        buffer.appendUnsigned(mapqTracker.zeroCount);
+
+        buffer.append(";ReadPosRankSum=");
+        buffer.appendFixed(smod.features.get(SOMATIC_SNV_SCORING_FEATURES::TumorSampleReadPosRankSum), infoPrecision);
+        buffer.append(";SNVSB=");
+        buffer.appendFixed(smod.features.get(SOMATIC_SNV_SCORING_FEATURES::TumorSampleStrandBias), infoPrecision);
 
         if (smod.isEVS)
         {
-            os << ";" << opt.SomaticEVSVcfInfoTag  << "=" << smod.EVS;
+            buffer.append(';');
+            buffer.append(opt.SomaticEVSVcfInfoTag);
+            buffer.append('=');
+            buffer.appendFixed(smod.EVS, infoPrecision);
         }
     }
 
     if (opt.isReportEVSFeatures)
     {
-        const StreamScoper ss(os);
-        os << std::setprecision(5);
-        os << ";EVSF=";
-        smod.features.writeValues(os);
-        os << ",";
-        smod.dfeatures.writeValues(os);
+        static const int evsFeaturePrecision(5);
+        buffer.append(";EVSF=");
+        smod.features.writeValues(buffer, evsFeaturePrecision);
+        buffer.append(',');
+        smod.dfeatures.writeValues(buffer, evsFeaturePrecision);
     }
 
     //FORMAT:
-    os << '\t'
-       << "DP:FDP:SDP:SUBDP:AU:CU:GU:TU";
+    buffer.append('\t');
+    buffer.append("DP:FDP:SDP:SUBDP:AU:CU:GU:TU");
 
     // normal sample info:
-    os << "\t";
-    write_vcf_sample_info(dopt,n1_epd,n2_epd,os);
+    buffer.append('\t');
+    write_vcf_sample_info(dopt,n1_epd,n2_epd,buffer);
 
     // tumor sample info:
-    os << "\t";
-    write_vcf_sample_info(dopt,t1_epd,t2_epd,os);
+    buffer.append('\t');
+    write_vcf_sample_info(dopt,t1_epd,t2_epd,buffer);
 }
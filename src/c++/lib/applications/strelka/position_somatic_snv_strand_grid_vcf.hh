@@ -28,6 +28,7 @@
 #pragma once
 
 #include "position_somatic_snv_strand_grid.hh"
+#include "blt_util/TextBuffer.hh"
 #include "starling_common/PileupCleaner.hh"
 
 
@@ -46,4 +47,4 @@ write_vcf_somatic_snv_genotype_strand_grid(
     const CleanedPileup& t2_epd,
     const double normChromDepth,
     const double maxChromDepth,
-    std::ostream& os);
+    TextBuffer& buffer);
@@ -35,7 +35,9 @@ std::ostream&
 operator<<(std::ostream& os, const result_set& rs)
 {
     os << "rs: ntype: " << NTYPE::label(rs.ntype) << " qphred: " << rs.qphred << " n_qphred " << rs.from_ntype_qphred << "\n";
-    os << " max_gt: ";
-    DDIGT::write_indel_state(static_cast<DDIGT::index_t>(rs.max_gt),os);
+    const char* normalLabel;
+    const char* tumorLabel;
+    DDIGT::get_indel_state_labels(static_cast<DDIGT::index_t>(rs.max_gt), normalLabel, tumorLabel);
+    os << " max_gt: " << normalLabel << "->" << tumorLabel;
     return os;
 }
@@ -23,8 +23,6 @@
 
 #include "strelka_digt_states.hh"
 
-#include <iostream>
-
 
 
 namespace DIGT_GRID
@@ -46,48 +44,59 @@ namespace DDIGT
 {
 
 void
-write_indel_state(const DDIGT::index_t dgt,
-                  std::ostream& os)
+get_indel_state_labels(
+    const DDIGT::index_t dgt,
+    const char*& normalLabel,
+    const char*& tumorLabel)
 {
     unsigned normal_gt;
     unsigned tumor_gt;
     get_digt_states(dgt,normal_gt,tumor_gt);
 
-    os << SOMATIC_DIGT::label(normal_gt);
-    os << "->";
+    normalLabel = SOMATIC_DIGT::label(normal_gt);
     if (tumor_gt == SOMATIC_STATE::NON_SOMATIC)
     {
-        os << SOMATIC_DIGT::label(normal_gt);
+        tumorLabel = SOMATIC_DIGT::label(normal_gt);
     }
     else
     {
         if (normal_gt == SOMATIC_DIGT::REF)
-            os << SOMATIC_DIGT::label(SOMATIC_DIGT::HET);   // ref->som is written as ref->het for backward compatibility
+            tumorLabel = SOMATIC_DIGT::label(SOMATIC_DIGT::HET);   // ref->som is written as ref->het for backward compatibility
         else
-            os << SOMATIC_DIGT::label(SOMATIC_DIGT::REF);   // het/hom->som is written as het/hom->ref for backward compatibility
+            tumorLabel = SOMATIC_DIGT::label(SOMATIC_DIGT::REF);   // het/hom->som is written as het/hom->ref for backward compatibility
     }
 }
 
+void
+write_indel_state(const DDIGT::index_t dgt,
+                  TextBuffer& buffer)
+{
+    const char* normalLabel;
+    const char* tumorLabel;
+    get_indel_state_labels(dgt, normalLabel, tumorLabel);
+
+    buffer.append(normalLabel);
+    buffer.append("->");
+    buffer.append(tumorLabel);
+}
+
 static
 void
 write_diploid_genotype(
     const char base1,
     const char base2,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
-    char diploid_genotype[3];
     if (base1 < base2)
     {
-        diploid_genotype[0] = base1;
-        diploid_genotype[1] = base2;
+        buffer.append(base1);
+        buffer.append(base2);
     }
     else
     {
-        diploid_genotype[1] = base1;
-        diploid_genotype[0] = base2;
+        buffer.append(base2);
+        buffer.append(base1);
     }
-    diploid_genotype[2] = 0;    // null
-    os << diploid_genotype;
 }
 
 void
@@ -95,7 +104,7 @@ write_snv_state(const DDIGT::index_t dgt,
                 const char ref_base,
                 const char normal_alt_base,
                 const char tumor_alt_base,
-                std::ostream& os)
+                TextBuffer& buffer)
 {
     unsigned normal_gt;
     unsigned tumor_gt;
@@ -104,28 +113,28 @@ write_snv_state(const DDIGT::index_t dgt,
     switch (normal_gt)
     {
     case SOMATIC_DIGT::REF:
-        write_diploid_genotype(ref_base, ref_base, os);
-        os << "->";
+        write_diploid_genotype(ref_base, ref_base, buffer);
+        buffer.append("->");
         if (tumor_gt == SOMATIC_STATE::NON_SOMATIC)
-            write_diploid_genotype(ref_base, ref_base, os);
+            write_diploid_genotype(ref_base, ref_base, buffer);
         else
-            write_diploid_genotype(ref_base, tumor_alt_base, os);
+            write_diploid_genotype(ref_base, tumor_alt_base, buffer);
         break;
     case SOMATIC_DIGT::HET:
-        write_diploid_genotype(ref_base, normal_alt_base, os);
-        os << "->";
+        write_diploid_genotype(ref_base, normal_alt_base, buffer);
+        buffer.append("->");
         if (tumor_gt == SOMATIC_STATE::NON_SOMATIC)
-            write_diploid_genotype(ref_base, normal_alt_base, os);
+            write_diploid_genotype(ref_base, normal_alt_base, buffer);
         else
-            write_diploid_genotype(ref_base, ref_base, os);
+            write_diploid_genotype(ref_base, ref_base, buffer);
         break;
     case SOMATIC_DIGT::HOM:
-        write_diploid_genotype(normal_alt_base, normal_alt_base, os);
-        os << "->";
+        write_diploid_genotype(normal_alt_base, normal_alt_base, buffer);
+        buffer.append("->");
         if (tumor_gt == SOMATIC_STATE::NON_SOMATIC)
-            write_diploid_genotype(normal_alt_base, normal_alt_base, os);
+            write_diploid_genotype(normal_alt_base, normal_alt_base, buffer);
         else
-            write_diploid_genotype(ref_base, ref_base, os);
+            write_diploid_genotype(ref_base, ref_base, buffer);
         break;
     }
 }
@@ -134,17 +143,17 @@ void
 write_alt_alleles(char normal_alt_base,
                   char tumor_alt_base,
                   char ref_base,
-                  std::ostream& os)
+                  TextBuffer& buffer)
 {
     if (tumor_alt_base != ref_base)
         // tumor: at least one non-ref call
-        os << tumor_alt_base;
+        buffer.append(tumor_alt_base);
     else if (normal_alt_base != ref_base)
         // tumor: all reference calls, normal: at least one non-ref call
-        os << normal_alt_base;
+        buffer.append(normal_alt_base);
     else
         // tumor: all ref calls, normal: all ref calls
-        os << ".";
+        buffer.append('.');
 }
 
 }
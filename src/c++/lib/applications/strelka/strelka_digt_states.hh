@@ -25,8 +25,8 @@
 #pragma once
 
 #include "blt_util/blt_types.hh"
+#include "blt_util/TextBuffer.hh"
 
-#include <iosfwd>
 #include <vector>
 
 
@@ -116,16 +116,23 @@ get_state(
     return normal_gt*SOMATIC_STATE::SIZE + tumor_gt;
 }
 
+/// get the normal and tumor genotype labels of the somatic indel state, as written "normal->tumor" in the SGT field
+void
+get_indel_state_labels(
+    const DDIGT::index_t dgt,
+    const char*& normalLabel,
+    const char*& tumorLabel);
+
 void
 write_indel_state(const DDIGT::index_t dgt,
-                  std::ostream& os);
+                  TextBuffer& buffer);
 
 void
 write_snv_state(const DDIGT::index_t dgt,
                 const char ref_base,
                 const char normal_alt_base,
                 const char tumor_alt_base,
-                std::ostream& os);
+                TextBuffer& buffer);
 
 inline
 void
@@ -142,7 +149,7 @@ void
 write_alt_alleles(char normal_alt_base,
                   char tumor_alt_base,
                   char ref_base,
-                  std::ostream& os);
+                  TextBuffer& buffer);
 }
 
 namespace DDIGT_GRID
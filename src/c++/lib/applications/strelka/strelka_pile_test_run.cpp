@@ -96,14 +96,17 @@ call(
     if (! (sgtg.is_output() || is_somatic_gvcf)) return;
 
     static const char chrom_name[] = "sim";
-    _os << chrom_name << '\t'
-        << pos << '\t'
-        << ".";
+    TextBuffer buffer;
+    buffer.append(chrom_name);
+    buffer.append('\t');
+    buffer.appendInt(pos);
+    buffer.append("\t.");
 
     write_vcf_somatic_snv_genotype_strand_grid(_opt, *(_dopt_ptr), sgtg, is_somatic_gvcf, norm_cpi,
-                                               tumor_cpi, norm_cpi, tumor_cpi, 0, 0, _os);
+                                               tumor_cpi, norm_cpi, tumor_cpi, 0, 0, buffer);
 
-    _os << "\n";
+    buffer.append('\n');
+    buffer.flush(_os);
 }
 
 
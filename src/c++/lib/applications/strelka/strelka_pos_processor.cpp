@@ -241,23 +241,23 @@ process_pos_snp_somatic(const pos_t pos)
                 sgtg.sn = *snp;
             }
         }
-        std::ostream& bos(*_streams.somatic_snv_osptr());
-
         // have to keep tier1 counts for filtration purposes:
 #ifdef SOMATIC_DEBUG
         write_snv_prefix_info_file(_chromName,output_pos,ref_base,normald,tumord,log_os);
         log_os << "\n";
 #endif
 
-        bos << _chromName << '\t'
-            << output_pos << '\t'
-            << ".";
+        _snvRecordBuffer.append(_chromName);
+        _snvRecordBuffer.append('\t');
+        _snvRecordBuffer.appendInt(output_pos);
+        _snvRecordBuffer.append("\t.");
 
         static const bool is_write_nqss(false);
         write_vcf_somatic_snv_genotype_strand_grid(_opt, _dopt, sgtg, is_write_nqss, *(normal_cpi_ptr[0]),
                                                    *(tumor_cpi_ptr[0]), *(normal_cpi_ptr[1]), *(tumor_cpi_ptr[1]),
-                                                   _normChromDepth, _maxChromDepth, bos);
-        bos << "\n";
+                                                   _normChromDepth, _maxChromDepth, _snvRecordBuffer);
+        _snvRecordBuffer.append('\n');
+        _snvRecordBuffer.flush(*_streams.somatic_snv_osptr());
 
         is_reported_event = true;
     }
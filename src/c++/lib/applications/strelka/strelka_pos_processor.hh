@@ -108,6 +108,9 @@ private:
     // enables delayed indel write:
     SomaticIndelVcfWriter _indelWriter;
 
+    /// reused to format each somatic SNV record
+    TextBuffer _snvRecordBuffer;
+
     unsigned _indelRegionIndexNormal;
     unsigned _indelRegionIndexTumor;
 
@@ -53,7 +53,8 @@ callRegion(
     starling_read_counts& readCounts,
     reference_contig_segment& ref,
     HtsMergeStreamer& streamData,
-    strelka_pos_processor& posProcessor)
+    strelka_pos_processor& posProcessor,
+    RunStatsManager& statsManager)
 {
     using namespace illumina::common;
 
@@ -61,6 +62,10 @@ callRegion(
     streamData.resetRegion(regionInfo.streamerRegion.c_str());
     setRefSegment(opt, regionInfo.regionChrom, regionInfo.refRegionRange, ref);
 
+    // time spent in the input stream loop which is not claimed by a downstream stage is attributed to read loading:
+    RunCallRegionScope regionScope(statsManager, regionInfo.regionRange.size());
+    RunStageScope stageScope(statsManager, RUN_STAGE::READ_LOADING);
+
     while (streamData.next())
     {
         const pos_t currentPos(streamData.getCurrentPos());
@@ -202,7 +207,12 @@ strelka_run(
                         noRequireNormalized);
         registerVcfList(opt.force_output_vcf, INPUT_TYPE::FORCED_GT_VARIANTS, referenceHeader, streamData);
 
-        registerVcfList(opt.noise_vcf, INPUT_TYPE::NOISE_VARIANTS, referenceHeader, streamData);
+        for (const std::string& noiseVcfFilename : opt.noise_vcf)
+        {
+            const vcf_streamer& vcfStream(streamData.registerVcf(noiseVcfFilename.c_str(), INPUT_TYPE::NOISE_VARIANTS));
+            vcfStream.validateBamHeaderChromSync(referenceHeader);
+            vcfStream.requireTextVcf("Noise VCF");
+        }
 
         if (! opt.callRegionsBedFilename.empty())
         {
@@ -229,19 +239,30 @@ strelka_run(
     {
         if (not opt.isUseCallRegions())
         {
-            callRegion(opt, regionInfo, readCounts, ref, streamData, posProcessor);
+            callRegion(opt, regionInfo, readCounts, ref, streamData, posProcessor, statsManager);
         }
         else
         {
             std::vector<known_pos_range2> subRegionRanges;
             getSubRegionsFromBedTrack(opt.callRegionsBedFilename, regionInfo.regionChrom, regionInfo.regionRange, subRegionRanges);
 
+            std::vector<AnalysisRegionInfo> subRegionInfoList;
+            std::vector<std::string> subRegionStreamerRegions;
             for (const auto& subRegionRange : subRegionRanges)
             {
-                AnalysisRegionInfo subRegionInfo;
+                subRegionInfoList.emplace_back();
+                AnalysisRegionInfo& subRegionInfo(subRegionInfoList.back());
                 getStrelkaAnalysisRegionInfo(regionInfo.regionChrom, subRegionRange.begin_pos(), subRegionRange.end_pos(),
                                              supplementalRegionBorderSize, subRegionInfo);
-                callRegion(opt, subRegionInfo, readCounts, ref, streamData, posProcessor);
+                subRegionStreamerRegions.push_back(subRegionInfo.streamerRegion);
+            }
+
+            // read alignments for all sub-regions in a single pass over the merged index chunks:
+            streamData.setAlignmentRegionPlan(subRegionStreamerRegions);
+
+            for (const auto& subRegionInfo : subRegionInfoList)
+            {
+                callRegion(opt, subRegionInfo, readCounts, ref, streamData, posProcessor, statsManager);
             }
         }
     }
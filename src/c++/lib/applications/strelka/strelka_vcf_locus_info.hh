@@ -24,13 +24,13 @@
 #pragma once
 
 #include "somaticVariantEmpiricalScoringFeatures.hh"
+#include "blt_util/TextBuffer.hh"
 #include "calibration/VariantScoringModelServer.hh"
 
 #include <cassert>
 
 #include <array>
 #include <bitset>
-#include <iosfwd>
 
 
 namespace SOMATIC_VARIANT_VCF_FILTERS
@@ -104,11 +104,11 @@ struct strelka_filter_keeper
 
     void
     write(
-        std::ostream& os) const
+        TextBuffer& buffer) const
     {
         if (_filters.none())
         {
-            os << "PASS";
+            buffer.append("PASS");
             return;
         }
 
@@ -119,13 +119,13 @@ struct strelka_filter_keeper
 
             if (is_sep)
             {
-                os << ";";
+                buffer.append(';');
             }
             else
             {
                 is_sep=true;
             }
-            os << SOMATIC_VARIANT_VCF_FILTERS::get_label(i);
+            buffer.append(SOMATIC_VARIANT_VCF_FILTERS::get_label(i));
         }
     }
 
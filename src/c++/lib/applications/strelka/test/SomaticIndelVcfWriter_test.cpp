@@ -0,0 +1,179 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "test_config.h"
+
+#include "SomaticIndelVcfWriter.hh"
+#include "somatic_call_shared.hh"
+#include "strelka_digt_states.hh"
+
+#include <fstream>
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( SomaticIndelVcfWriter_test )
+
+
+/// set sample support counts for both tiers of one sample
+static
+void
+setTestSampleReportInfo(
+    const unsigned refCount,
+    const unsigned indelCount,
+    std::array<AlleleSampleReportInfo,2>& isri)
+{
+    for (unsigned tierIndex(0); tierIndex<2; ++tierIndex)
+    {
+        AlleleSampleReportInfo& sampleInfo(isri[tierIndex]);
+        sampleInfo.n_confident_ref_reads = refCount + tierIndex;
+        sampleInfo.n_confident_indel_reads = indelCount + tierIndex;
+        sampleInfo.n_confident_alt_reads = 1;
+        sampleInfo.n_other_reads = 2 + tierIndex;
+        sampleInfo.tier1Depth = refCount + indelCount + 3 + tierIndex;
+        sampleInfo.n_confident_ref_reads_fwd = refCount/2;
+        sampleInfo.n_confident_ref_reads_rev = refCount - refCount/2;
+        sampleInfo.n_confident_indel_reads_fwd = indelCount/3;
+        sampleInfo.n_confident_indel_reads_rev = indelCount - indelCount/3;
+        for (unsigned readIndex(0); readIndex<(refCount + indelCount); ++readIndex)
+        {
+            sampleInfo.mapqTracker.add((readIndex % 5) == 0 ? 0 : 50);
+            sampleInfo.readpos_ranksum.add_observation((readIndex < refCount), 7 + (readIndex * 3) % 40);
+        }
+    }
+}
+
+
+
+/// fill a window with values averaging to a non-integral mean
+static
+void
+setTestWindow(
+    const int32_t baseValue,
+    window_average& win)
+{
+    for (int32_t i(0); i<7; ++i)
+    {
+        win.insert(baseValue + i);
+    }
+    win.insert_null();
+}
+
+
+
+/// format indel records covering filtered, passing, repeat and EVS scored output
+static
+void
+writeTestIndelRecords(
+    std::ostream& os)
+{
+    strelka_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000000;
+    opt.alignFileOpt.alignmentFilenames = { "normal.bam", "tumor.bam" };
+    opt.alignFileOpt.isAlignmentTumor = { false, true };
+    opt.sfilter.minPassedCallDepth = 20;
+
+    strelka_options evsOpt(opt);
+    evsOpt.somatic_indel_scoring_model_filename = std::string(SCORING_MODEL_PATH) + "/somaticIndelScoringModels.json";
+
+    const strelka_deriv_options dopt(opt);
+    const strelka_deriv_options evsDopt(evsOpt);
+
+    // somatic STR deletion in a normal sample with a homozygous reference genotype
+    SomaticIndelVcfInfo strInfo;
+    strInfo.sindel.sindel_tier = 0;
+    strInfo.sindel.sindel_from_ntype_tier = 1;
+    strInfo.sindel.rs.ntype = NTYPE::REF;
+    strInfo.sindel.rs.max_gt = DDIGT::get_state(SOMATIC_DIGT::REF, SOMATIC_STATE::SOMATIC);
+    strInfo.sindel.rs.qphred = 38;
+    strInfo.sindel.rs.from_ntype_qphred = 42;
+    strInfo.indelReportInfo.repeatUnit = "CA";
+    strInfo.indelReportInfo.repeatUnitLength = 2;
+    strInfo.indelReportInfo.refRepeatCount = 7;
+    strInfo.indelReportInfo.indelRepeatCount = 6;
+    strInfo.indelReportInfo.interruptedHomopolymerLength = 2;
+    strInfo.indelReportInfo.it = SimplifiedIndelReportType::DELETE;
+    strInfo.vcf_ref_seq = "TCA";
+    strInfo.vcf_indel_seq = "T";
+    setTestSampleReportInfo(28, 0, strInfo.nisri);
+    setTestSampleReportInfo(19, 9, strInfo.tisri);
+
+    // non-repeat insertion overlapping another call, filtered for depth and the normal genotype
+    SomaticIndelVcfInfo overlapInfo(strInfo);
+    overlapInfo.sindel.rs.ntype = NTYPE::HET;
+    overlapInfo.sindel.rs.max_gt = DDIGT::get_state(SOMATIC_DIGT::HET, SOMATIC_STATE::NON_SOMATIC);
+    overlapInfo.sindel.rs.from_ntype_qphred = 2;
+    overlapInfo.sindel.rs.is_overlap = true;
+    overlapInfo.indelReportInfo = AlleleReportInfo();
+    overlapInfo.indelReportInfo.interruptedHomopolymerLength = 1;
+    overlapInfo.indelReportInfo.it = SimplifiedIndelReportType::INSERT;
+    overlapInfo.vcf_ref_seq = "G";
+    overlapInfo.vcf_indel_seq = "GTTAC";
+    setTestSampleReportInfo(40, 2, overlapInfo.nisri);
+    setTestSampleReportInfo(10, 3, overlapInfo.tisri);
+
+    win_avg_set wasNormal(8);
+    win_avg_set wasTumor(8);
+    setTestWindow(30, wasNormal.ss_used_win);
+    setTestWindow(0, wasNormal.ss_filt_win);
+    setTestWindow(1, wasNormal.ss_submap_win);
+    setTestWindow(25, wasTumor.ss_used_win);
+    setTestWindow(3, wasTumor.ss_filt_win);
+    setTestWindow(0, wasTumor.ss_submap_win);
+
+    static const double maxChromDepth(30.);
+
+    SomaticIndelVcfWriter writer(opt, dopt, &os);
+    SomaticIndelVcfWriter evsWriter(evsOpt, evsDopt, &os);
+
+    auto writeRecords = [&](SomaticIndelVcfWriter& recordWriter)
+    {
+        recordWriter.cacheIndel(99, strInfo);
+        recordWriter.cacheIndel(99, overlapInfo);
+        recordWriter.addIndelWindowData("chr20", 99, wasNormal, wasTumor, maxChromDepth);
+    };
+
+    writeRecords(writer);
+    writeRecords(evsWriter);
+
+    opt.isReportEVSFeatures = true;
+    evsOpt.isReportEVSFeatures = true;
+    writeRecords(writer);
+    writeRecords(evsWriter);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_indelRecordGolden )
+{
+    std::ostringstream oss;
+    writeTestIndelRecords(oss);
+
+    const std::string goldenPath(std::string(TEST_DATA_PATH) + "/somatic_indel_record_test.vcf");
+    std::ifstream ifs(goldenPath);
+    BOOST_REQUIRE(ifs);
+    std::stringstream golden;
+    golden << ifs.rdbuf();
+
+    BOOST_REQUIRE_EQUAL(oss.str(), golden.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
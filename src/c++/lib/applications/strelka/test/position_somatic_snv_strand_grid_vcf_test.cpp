@@ -0,0 +1,191 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "test_config.h"
+
+#include "position_somatic_snv_strand_grid_vcf.hh"
+#include "somatic_call_shared.hh"
+#include "strelka_digt_states.hh"
+
+#include <fstream>
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( position_somatic_snv_strand_grid_vcf_test )
+
+
+/// add count basecalls of one base to a pileup, alternating between strands
+static
+void
+addTestBasecalls(
+    const BASE_ID::index_t baseId,
+    const unsigned count,
+    const bool isFiltered,
+    snp_pos_info& pi)
+{
+    for (unsigned callIndex(0); callIndex<count; ++callIndex)
+    {
+        const bool isFwdStrand((callIndex % 2) == 0);
+        pi.calls.emplace_back(baseId, 30 + (callIndex % 10), isFwdStrand, 0, 0, isFiltered, false, false);
+        pi.mapqTracker.add((callIndex % 7) == 0 ? 0 : 60);
+        if (baseId != base_to_id(pi.get_ref_base()))
+        {
+            pi.nonReferenceAlleleReadPositionInfo.push_back({static_cast<uint16_t>(5 + 3*callIndex), 100});
+        }
+        pi.read_pos_ranksum.add_observation((baseId == base_to_id(pi.get_ref_base())), 10 + callIndex);
+    }
+}
+
+
+
+/// pileups for one normal and one tumor sample, tier2 pileups include the tier2 basecalls
+struct TestSomaticPileups
+{
+    TestSomaticPileups(
+        const blt_options& opt,
+        const unsigned tumorAltCount)
+    {
+        for (auto* piPtr : { &normalPileup, &tumorPileup })
+        {
+            piPtr->set_ref_base('C');
+        }
+        addTestBasecalls(BASE_ID::C, 30, false, normalPileup);
+        addTestBasecalls(BASE_ID::T, 1, false, normalPileup);
+        addTestBasecalls(BASE_ID::C, 2, true, normalPileup);
+        normalPileup.tier2_calls.emplace_back(BASE_ID::T, 20, true, 0, 0, false, false, false);
+        normalPileup.spanningDeletionReadCount = 1;
+        normalPileup.n_submapped = 2;
+
+        addTestBasecalls(BASE_ID::C, 20, false, tumorPileup);
+        addTestBasecalls(BASE_ID::T, tumorAltCount, false, tumorPileup);
+        addTestBasecalls(BASE_ID::G, 1, false, tumorPileup);
+        addTestBasecalls(BASE_ID::T, 3, true, tumorPileup);
+        tumorPileup.tier2_calls.emplace_back(BASE_ID::C, 20, false, 0, 0, false, false, false);
+
+        const PileupCleaner cleaner(opt);
+        cleaner.CleanPileup(normalPileup, false, normal[0]);
+        cleaner.CleanPileup(tumorPileup, false, tumor[0]);
+        cleaner.CleanPileup(normalPileup, true, normal[1]);
+        cleaner.CleanPileup(tumorPileup, true, tumor[1]);
+    }
+
+    snp_pos_info normalPileup;
+    snp_pos_info tumorPileup;
+    CleanedPileup normal[2];
+    CleanedPileup tumor[2];
+};
+
+
+
+/// format SNV records covering filtered, passing and EVS scored output, each record is given
+/// the same CHROM/POS/ID prefix used by the strelka position processor
+static
+void
+writeTestSnvRecords(
+    TextBuffer& buffer)
+{
+    strelka_options opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000000;
+    opt.alignFileOpt.alignmentFilenames = { "normal.bam", "tumor.bam" };
+    opt.alignFileOpt.isAlignmentTumor = { false, true };
+    opt.sfilter.minPassedCallDepth = 20;
+
+    strelka_options evsOpt(opt);
+    evsOpt.somatic_snv_scoring_model_filename = std::string(SCORING_MODEL_PATH) + "/somaticSNVScoringModels.json";
+
+    const strelka_deriv_options dopt(opt);
+    const strelka_deriv_options evsDopt(evsOpt);
+
+    // somatic het call in a normal sample with a homozygous reference genotype
+    somatic_snv_genotype_grid sgt;
+    sgt.snv_tier = 1;
+    sgt.snv_from_ntype_tier = 0;
+    sgt.rs.ntype = NTYPE::REF;
+    sgt.rs.max_gt = DDIGT::get_state(SOMATIC_DIGT::REF, SOMATIC_STATE::SOMATIC);
+    sgt.rs.qphred = 45;
+    sgt.rs.from_ntype_qphred = 51;
+    sgt.rs.normal_alt_id = BASE_ID::T;
+    sgt.rs.tumor_alt_id = BASE_ID::T;
+    sgt.rs.nonsomatic_qphred = 3;
+    sgt.rs.strandBias = -2.345;
+
+    // a call which fails the QSS_ref filter and a non-matching normal alt allele
+    somatic_snv_genotype_grid sgtNonRef(sgt);
+    sgtNonRef.rs.ntype = NTYPE::HET;
+    sgtNonRef.rs.max_gt = DDIGT::get_state(SOMATIC_DIGT::HET, SOMATIC_STATE::NON_SOMATIC);
+    sgtNonRef.rs.from_ntype_qphred = 4;
+    sgtNonRef.rs.normal_alt_id = BASE_ID::G;
+    sgtNonRef.rs.strandBias = 0.004;
+
+    const TestSomaticPileups pileups(opt, 12);
+    const TestSomaticPileups lowDepthPileups(opt, 0);
+
+    static const double normChromDepth(35.5);
+    static const double maxChromDepth(30.);
+
+    unsigned recordIndex(0);
+    auto writeRecord = [&](
+                           const strelka_options& recordOpt,
+                           const strelka_deriv_options& recordDopt,
+                           const somatic_snv_genotype_grid& recordSgt,
+                           const bool isWriteNqss,
+                           const TestSomaticPileups& recordPileups)
+    {
+        buffer.append("chr20\t");
+        buffer.appendInt(1000 + recordIndex++);
+        buffer.append("\t.");
+        write_vcf_somatic_snv_genotype_strand_grid(recordOpt, recordDopt, recordSgt, isWriteNqss,
+                                                   recordPileups.normal[0], recordPileups.tumor[0],
+                                                   recordPileups.normal[1], recordPileups.tumor[1],
+                                                   normChromDepth, maxChromDepth, buffer);
+        buffer.append('\n');
+    };
+
+    writeRecord(opt, dopt, sgt, false, pileups);
+    writeRecord(opt, dopt, sgt, true, lowDepthPileups);
+    writeRecord(opt, dopt, sgtNonRef, false, pileups);
+    writeRecord(evsOpt, evsDopt, sgt, false, pileups);
+    writeRecord(evsOpt, evsDopt, sgtNonRef, true, lowDepthPileups);
+
+    opt.isReportEVSFeatures = true;
+    evsOpt.isReportEVSFeatures = true;
+    writeRecord(opt, dopt, sgt, true, pileups);
+    writeRecord(evsOpt, evsDopt, sgtNonRef, false, pileups);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_snvRecordGolden )
+{
+    TextBuffer buffer;
+    writeTestSnvRecords(buffer);
+
+    const std::string goldenPath(std::string(TEST_DATA_PATH) + "/somatic_snv_record_test.vcf");
+    std::ifstream ifs(goldenPath);
+    BOOST_REQUIRE(ifs);
+    std::stringstream golden;
+    golden << ifs.rdbuf();
+
+    BOOST_REQUIRE_EQUAL(buffer.str(), golden.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
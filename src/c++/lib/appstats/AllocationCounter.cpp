@@ -0,0 +1,63 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "AllocationCounter.hh"
+
+#include <atomic>
+
+
+/// count of calls to the replaced global allocation functions, split into one cache line per thread
+///
+/// Each thread is assigned its own counter slot so that allocations from worker threads do not contend on a
+/// shared counter. Slots are only shared (without error) if more than maxCounterSlots threads are started.
+struct alignas(64) AllocationCounterSlot
+{
+    std::atomic<uint64_t> count;
+};
+
+static const unsigned maxCounterSlots(256);
+static AllocationCounterSlot allocationCounterSlots[maxCounterSlots];
+static std::atomic<unsigned> nextCounterSlot(0);
+
+
+
+void
+addAllocationCount()
+{
+    static thread_local const unsigned slotIndex(
+        nextCounterSlot.fetch_add(1, std::memory_order_relaxed) % maxCounterSlots);
+    allocationCounterSlots[slotIndex].count.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+
+uint64_t
+getAllocationCount()
+{
+    uint64_t total(0);
+    for (const AllocationCounterSlot& slot : allocationCounterSlots)
+    {
+        total += slot.count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
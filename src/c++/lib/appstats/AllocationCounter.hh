@@ -0,0 +1,39 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include <cstdint>
+
+
+/// \return total number of calls to the global operator new (all forms) made by this process
+///
+/// Allocations are only counted in programs linking the allocation function replacements from the appstats
+/// allocationCounting object library, the count is always zero otherwise.
+///
+uint64_t
+getAllocationCount();
+
+/// add one allocation to the count of the calling thread, called from the replaced allocation functions
+void
+addAllocationCount();
@@ -0,0 +1,146 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "RegionCostProfiler.hh"
+#include "common/Exceptions.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+
+
+RegionCostProfiler::
+RegionCostProfiler(
+    const std::string& outputFile,
+    const unsigned windowSize)
+    : _windowSize(windowSize)
+{
+    if (outputFile.empty()) return;
+    _osPtr.reset(new std::ofstream(outputFile.c_str()));
+    if (! *_osPtr)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Can't open output file: " << outputFile << '\n';
+        BOOST_THROW_EXCEPTION(illumina::common::LogicException(oss.str()));
+    }
+
+    *_osPtr << std::setprecision(4);
+    *_osPtr << "#chrom\tbegin\tend\treads\tcandidateIndels\tactiveRegions\talignmentCells\twallSeconds\n";
+}
+
+
+
+RegionCostProfiler::
+~RegionCostProfiler()
+{
+}
+
+
+
+void
+RegionCostProfiler::
+startRegion(
+    const std::string& chromName,
+    const known_pos_range2& regionRange,
+    const RegionCostCounts& counts)
+{
+    if (! isEnabled()) return;
+    assert(! _isRegionStarted);
+
+    _isRegionStarted = true;
+    _chromName = chromName;
+    _regionRange = regionRange;
+    startWindow(regionRange.begin_pos(), counts);
+}
+
+
+
+void
+RegionCostProfiler::
+finishRegion(const RegionCostCounts& counts)
+{
+    if (! _isRegionStarted) return;
+    writeWindow(counts);
+    _isRegionStarted = false;
+}
+
+
+
+void
+RegionCostProfiler::
+updatePosition(
+    const pos_t pos,
+    const RegionCostCounts& counts)
+{
+    // positions past the end of the region (from read processing on the region border) are attributed to the
+    // last window:
+    assert(isWindowComplete(pos));
+
+    writeWindow(counts);
+
+    // skip any windows without processed positions, so that every written window reflects real work:
+    const pos_t windowBegin(_windowEnd + ((pos-_windowEnd)/_windowSize)*_windowSize);
+    startWindow(windowBegin, counts);
+}
+
+
+
+void
+RegionCostProfiler::
+startWindow(
+    const pos_t beginPos,
+    const RegionCostCounts& counts)
+{
+    _windowBegin = beginPos;
+    _windowEnd = _regionRange.end_pos();
+    if (_windowSize > 0)
+    {
+        _windowEnd = std::min(_windowEnd, static_cast<pos_t>(((beginPos/_windowSize)+1)*_windowSize));
+    }
+    _windowStartCounts = counts;
+    _windowStartTime = clock_t::now();
+}
+
+
+
+void
+RegionCostProfiler::
+writeWindow(const RegionCostCounts& counts)
+{
+    const std::chrono::duration<double> wall(clock_t::now()-_windowStartTime);
+    RegionCostCounts windowCounts(counts);
+    windowCounts.difference(_windowStartCounts);
+
+    *_osPtr << _chromName
+            << '\t' << _windowBegin
+            << '\t' << _windowEnd
+            << '\t' << windowCounts.reads
+            << '\t' << windowCounts.candidateIndels
+            << '\t' << windowCounts.activeRegions
+            << '\t' << windowCounts.alignmentCells
+            << '\t' << wall.count()
+            << '\n';
+}
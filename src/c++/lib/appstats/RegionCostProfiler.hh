@@ -0,0 +1,137 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "blt_util/blt_types.hh"
+#include "blt_util/known_pos_range2.hh"
+
+#include "boost/utility.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+
+/// cumulative counts of the events which drive processing cost
+struct RegionCostCounts
+{
+    void
+    difference(const RegionCostCounts& rhs)
+    {
+        reads -= rhs.reads;
+        candidateIndels -= rhs.candidateIndels;
+        activeRegions -= rhs.activeRegions;
+        alignmentCells -= rhs.alignmentCells;
+    }
+
+    /// Reads inserted into the position processor
+    uint64_t reads = 0;
+
+    /// Indels reaching candidate status
+    uint64_t candidateIndels = 0;
+
+    /// Active regions processed for haplotype discovery
+    uint64_t activeRegions = 0;
+
+    /// Dynamic programming matrix cells filled while aligning active region haplotypes
+    uint64_t alignmentCells = 0;
+};
+
+
+/// writes a per-region cost trace to help find the genomic loci which dominate run time
+///
+/// One record is written for each analysis region, or for each fixed size window of each analysis region if a
+/// window size is given. Each record is a tab-delimited BED-like line with the region coordinates followed by the
+/// RegionCostCounts accumulated in the region and its wall time.
+///
+/// Costs are attributed to a window as positions are processed, so the work of buffered processing stages is
+/// attributed to windows only approximately.
+///
+struct RegionCostProfiler : private boost::noncopyable
+{
+    /// \param outputFile trace file name, profiling is disabled if this is empty
+    /// \param windowSize if non-zero, split each region into windows of this size
+    RegionCostProfiler(
+        const std::string& outputFile,
+        const unsigned windowSize);
+
+    ~RegionCostProfiler();
+
+    bool
+    isEnabled() const
+    {
+        return static_cast<bool>(_osPtr);
+    }
+
+    /// start profiling a new analysis region, any previous region must be finished first
+    void
+    startRegion(
+        const std::string& chromName,
+        const known_pos_range2& regionRange,
+        const RegionCostCounts& counts);
+
+    /// \return true if processing has reached pos, which requires a call to updatePosition to close the current window
+    bool
+    isWindowComplete(const pos_t pos) const
+    {
+        return (_isRegionStarted && (pos >= _windowEnd) && (_windowEnd < _regionRange.end_pos()));
+    }
+
+    /// close the current window and start the window containing pos
+    ///
+    /// this should only be called when isWindowComplete(pos) is true
+    void
+    updatePosition(
+        const pos_t pos,
+        const RegionCostCounts& counts);
+
+    /// finish profiling the current region, there is no effect if no region has been started
+    void
+    finishRegion(const RegionCostCounts& counts);
+
+private:
+    typedef std::chrono::steady_clock clock_t;
+
+    void
+    startWindow(
+        const pos_t beginPos,
+        const RegionCostCounts& counts);
+
+    void
+    writeWindow(const RegionCostCounts& counts);
+
+    std::unique_ptr<std::ostream> _osPtr;
+    const unsigned _windowSize;
+
+    bool _isRegionStarted = false;
+    std::string _chromName;
+    known_pos_range2 _regionRange;
+
+    pos_t _windowBegin = 0;
+    pos_t _windowEnd = 0;
+    RegionCostCounts _windowStartCounts;
+    clock_t::time_point _windowStartTime;
+};
@@ -22,12 +22,143 @@
 ///
 
 #include "RunStats.hh"
+#include "blt_util/io_util.hh"
+#include "common/BinaryColumnIO.hh"
+#include "common/Exceptions.hh"
 
 #include "boost/archive/xml_iarchive.hpp"
 #include "boost/archive/xml_oarchive.hpp"
 
+#include <cmath>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+
+
+
+/// identifies the binary run stats file format, this cannot match the start of an xml file
+static const char runStatsFileMagic[8] = {'S','T','R','K','R','S','T','\0'};
+
+/// increment when the binary run stats file format changes
+static const uint32_t runStatsFileVersion(3);
+
+
+
+/// loads RunStatsData from xml written before the class was versioned, which has no class version attribute
+struct UnversionedRunStatsData
+{
+    explicit
+    UnversionedRunStatsData(RunStatsData& initData)
+        : data(initData)
+    {}
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned /* version */)
+    {
+        data.serialize(ar, 0);
+    }
+
+    RunStatsData& data;
+};
+
+BOOST_CLASS_IMPLEMENTATION(UnversionedRunStatsData, boost::serialization::object_serializable)
+
+
+
+/// \return true if the runStatsData element of the xml text has no class version attribute
+static
+bool
+isUnversionedXml(const std::string& xml)
+{
+    const std::string::size_type tagStart(xml.find("<runStatsData"));
+    if (tagStart == std::string::npos) return false;
+    const std::string::size_type tagEnd(xml.find('>', tagStart));
+    return (xml.substr(tagStart, tagEnd-tagStart).find("version=") == std::string::npos);
+}
+
+
+
+const unsigned RegionThroughputHistogram::maxBinCount;
+
+
+
+void
+RegionThroughputHistogram::
+addRegion(
+    const uint64_t regionSize,
+    const double wallSeconds)
+{
+    regionCount++;
+    regionBases += regionSize;
+
+    unsigned binIndex(maxBinCount-1);
+    if (wallSeconds > 0.)
+    {
+        const double basesPerSecond(regionSize/wallSeconds);
+        binIndex = ((basesPerSecond < 2.) ? 0 : static_cast<unsigned>(std::log2(basesPerSecond)));
+        binIndex = std::min(binIndex, (maxBinCount-1));
+    }
+    if (binCount.size() <= binIndex) binCount.resize(binIndex+1, 0);
+    binCount[binIndex]++;
+}
+
+
+
+void
+RegionThroughputHistogram::
+merge(const RegionThroughputHistogram& rhs)
+{
+    regionCount += rhs.regionCount;
+    regionBases += rhs.regionBases;
+    if (binCount.size() < rhs.binCount.size()) binCount.resize(rhs.binCount.size(), 0);
+    for (unsigned binIndex(0); binIndex < rhs.binCount.size(); ++binIndex)
+    {
+        binCount[binIndex] += rhs.binCount[binIndex];
+    }
+}
+
+
+
+void
+RegionThroughputHistogram::
+report(std::ostream& os) const
+{
+    os << "CallRegionCount\t" << regionCount << "\n";
+    os << "CallRegionBases\t" << regionBases << "\n";
+    os << "\n";
+    os << "CallRegionThroughputHistogram\n";
+    os << "MinBasesPerSecond\tRegionCount\n";
+    for (unsigned binIndex(0); binIndex < binCount.size(); ++binIndex)
+    {
+        if (binCount[binIndex] == 0) continue;
+        os << (binIndex == 0 ? 0 : (1ul << binIndex)) << "\t" << binCount[binIndex] << "\n";
+    }
+}
+
+
+
+void
+RunStatsData::
+merge(const RunStatsData& rhs)
+{
+    lifeTime.merge(rhs.lifeTime);
+    candidateIndels += rhs.candidateIndels;
+    nonCandidateIndels += rhs.nonCandidateIndels;
+    assert(stageWallTimes.size() == rhs.stageWallTimes.size());
+    assert(stageCpuTimes.size() == rhs.stageCpuTimes.size());
+    assert(stageSampleCounts.size() == rhs.stageSampleCounts.size());
+    for (unsigned stageIndex(0); stageIndex < stageWallTimes.size(); ++stageIndex)
+    {
+        stageWallTimes[stageIndex] += rhs.stageWallTimes[stageIndex];
+        stageCpuTimes[stageIndex] += rhs.stageCpuTimes[stageIndex];
+        stageSampleCounts[stageIndex] += rhs.stageSampleCounts[stageIndex];
+    }
+    regionThroughput.merge(rhs.regionThroughput);
+    peakBufferSizes.merge(rhs.peakBufferSizes);
+    allocationCount += rhs.allocationCount;
+}
 
 
 
@@ -41,6 +172,102 @@ report(std::ostream& os) const
     os << "\n";
     os << "CallRegionCandidateIndels\t" << candidateIndels << "\n";
     os << "CallRegionNonCandidateIndels\t" << nonCandidateIndels << "\n";
+    os << "\n";
+    os << "StageHours\tWall\tCpu\tSamples\n";
+    {
+        StreamScoper scoper(os);
+        os << std::fixed << std::setprecision(4);
+        for (unsigned stageIndex(0); stageIndex < stageWallTimes.size(); ++stageIndex)
+        {
+            os << RUN_STAGE::getLabel(static_cast<RUN_STAGE::index_t>(stageIndex))
+               << "\t" << (stageWallTimes[stageIndex]/3600.) << "h"
+               << "\t" << (stageCpuTimes[stageIndex]/3600.) << "h"
+               << "\t" << stageSampleCounts[stageIndex] << "\n";
+        }
+    }
+    os << "\n";
+    regionThroughput.report(os);
+    os << "\n";
+    os << "PeakReadBufferSize\t" << peakBufferSizes.readBuffer << "\n";
+    os << "PeakIndelBufferSize\t" << peakBufferSizes.indelBuffer << "\n";
+    os << "PeakBasecallBufferSpan\t" << peakBufferSizes.basecallBuffer << "\n";
+    os << "\n";
+    os << "HeapAllocations\t" << allocationCount << "\n";
+}
+
+
+
+void
+RunStatsData::
+writeBinary(std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    auto writeTimes = [&](const CpuTimes& times)
+    {
+        writeValue(os, times.wall);
+        writeValue(os, times.user);
+        writeValue(os, times.system);
+    };
+
+    writeTimes(lifeTime);
+    writeValue(os, static_cast<uint64_t>(candidateIndels));
+    writeValue(os, static_cast<uint64_t>(nonCandidateIndels));
+
+    writeColumn(os, stageWallTimes);
+    writeColumn(os, stageCpuTimes);
+    writeColumn(os, stageSampleCounts);
+
+    writeValue(os, regionThroughput.regionCount);
+    writeValue(os, regionThroughput.regionBases);
+    writeColumn(os, regionThroughput.binCount);
+
+    writeValue(os, peakBufferSizes.readBuffer);
+    writeValue(os, peakBufferSizes.indelBuffer);
+    writeValue(os, peakBufferSizes.basecallBuffer);
+
+    writeValue(os, allocationCount);
+}
+
+
+
+void
+RunStatsData::
+readBinary(std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    auto readTimes = [&](CpuTimes& times)
+    {
+        readValue(is, times.wall);
+        readValue(is, times.user);
+        readValue(is, times.system);
+    };
+
+    readTimes(lifeTime);
+    uint64_t val(0);
+    readValue(is, val);
+    candidateIndels = val;
+    readValue(is, val);
+    nonCandidateIndels = val;
+
+    readColumn(is, stageWallTimes);
+    if (stageWallTimes.size() != RUN_STAGE::SIZE) throwInvalidColumns("stageWallTimes");
+    readColumn(is, stageCpuTimes);
+    if (stageCpuTimes.size() != RUN_STAGE::SIZE) throwInvalidColumns("stageCpuTimes");
+    readColumn(is, stageSampleCounts);
+    if (stageSampleCounts.size() != RUN_STAGE::SIZE) throwInvalidColumns("stageSampleCounts");
+
+    readValue(is, regionThroughput.regionCount);
+    readValue(is, regionThroughput.regionBases);
+    readColumn(is, regionThroughput.binCount);
+    if (regionThroughput.binCount.size() > RegionThroughputHistogram::maxBinCount) throwInvalidColumns("regionThroughput");
+
+    readValue(is, peakBufferSizes.readBuffer);
+    readValue(is, peakBufferSizes.indelBuffer);
+    readValue(is, peakBufferSizes.basecallBuffer);
+
+    readValue(is, allocationCount);
 }
 
 
@@ -49,10 +276,53 @@ void
 RunStats::
 load(const char* filename)
 {
+    using namespace illumina::common;
+
     assert(nullptr != filename);
-    std::ifstream ifs(filename);
-    boost::archive::xml_iarchive ia(ifs);
-    ia >> BOOST_SERIALIZATION_NVP(runStatsData);
+    std::ifstream ifs(filename, std::ios::binary);
+    if (! ifs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to open run stats file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+
+    runStatsData = RunStatsData();
+
+    char magic[sizeof(runStatsFileMagic)];
+    ifs.read(magic, sizeof(magic));
+    if (ifs && (std::memcmp(magic, runStatsFileMagic, sizeof(magic)) == 0))
+    {
+        uint32_t version(0);
+        BinaryColumnIO::readValue(ifs, version);
+        if (version != runStatsFileVersion)
+        {
+            std::ostringstream oss;
+            oss << "ERROR: Unsupported run stats file format version '" << version << "' in file: '" << filename << "'\n";
+            BOOST_THROW_EXCEPTION(UnsupportedVersionException(oss.str()));
+        }
+        BinaryColumnIO::readFromFile(filename, [&]()
+        {
+            runStatsData.readBinary(ifs);
+        });
+    }
+    else
+    {
+        ifs.clear();
+        ifs.seekg(0);
+        std::stringstream xml;
+        xml << ifs.rdbuf();
+        boost::archive::xml_iarchive ia(xml);
+        if (isUnversionedXml(xml.str()))
+        {
+            UnversionedRunStatsData legacyData(runStatsData);
+            ia >> boost::serialization::make_nvp("runStatsData", legacyData);
+        }
+        else
+        {
+            ia >> BOOST_SERIALIZATION_NVP(runStatsData);
+        }
+    }
 }
 
 
@@ -78,6 +348,35 @@ save(const char* filename) const
 
 
 
+void
+RunStats::
+saveBinary(std::ostream& os) const
+{
+    os.write(runStatsFileMagic, sizeof(runStatsFileMagic));
+    BinaryColumnIO::writeValue(os, runStatsFileVersion);
+    runStatsData.writeBinary(os);
+}
+
+
+
+void
+RunStats::
+saveBinary(const char* filename) const
+{
+    assert(nullptr != filename);
+    std::ofstream ofs(filename, std::ios::binary);
+    saveBinary(ofs);
+    if (! ofs)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write run stats file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
+
+
+
 void
 RunStats::
 report(const char* filename) const
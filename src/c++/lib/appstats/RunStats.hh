@@ -27,7 +27,9 @@
 
 #include "boost/serialization/nvp.hpp"
 #include "boost/serialization/vector.hpp"
+#include "boost/serialization/version.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 
@@ -35,29 +37,166 @@
 #include <vector>
 
 
-struct RunStatsData
+/// major processing stages of the variant calling pipeline, used to attribute run time
+namespace RUN_STAGE
+{
+enum index_t
 {
-    RunStatsData() = default;
+    READ_LOADING,
+    REALIGNMENT,
+    PILEUP,
+    ACTIVE_REGION,
+    GENOTYPING,
+    SCORING,
+    OUTPUT,
+    /// any processing time not attributed to one of the stages above
+    OTHER,
+    SIZE
+};
 
-    void
-    merge(const RunStatsData& rhs)
+inline
+const char*
+getLabel(const index_t i)
+{
+    switch (i)
     {
-        lifeTime.merge(rhs.lifeTime);
-        candidateIndels += rhs.candidateIndels;
-        nonCandidateIndels += rhs.nonCandidateIndels;
+    case READ_LOADING:
+        return "ReadLoading";
+    case REALIGNMENT:
+        return "Realignment";
+    case PILEUP:
+        return "Pileup";
+    case ACTIVE_REGION:
+        return "ActiveRegion";
+    case GENOTYPING:
+        return "Genotyping";
+    case SCORING:
+        return "Scoring";
+    case OUTPUT:
+        return "Output";
+    case OTHER:
+        return "Other";
+    default:
+        assert(false && "Unknown run stage");
+        return nullptr;
     }
+}
+}
+
+
+/// histogram of region throughput, binned by log2(region bases per wall-clock second)
+struct RegionThroughputHistogram
+{
+    /// add a region of size regionSize processed in wallSeconds
+    void
+    addRegion(
+        const uint64_t regionSize,
+        const double wallSeconds);
+
+    void
+    merge(const RegionThroughputHistogram& rhs);
 
     void
     report(std::ostream& os) const;
 
     template<class Archive>
     void serialize(Archive& ar, const unsigned /* version */)
+    {
+        ar& BOOST_SERIALIZATION_NVP(regionCount);
+        ar& BOOST_SERIALIZATION_NVP(regionBases);
+        ar& BOOST_SERIALIZATION_NVP(binCount);
+    }
+
+    static const unsigned maxBinCount = 40;
+
+    /// Total number of regions
+    uint64_t regionCount = 0;
+
+    /// Total size of all regions
+    uint64_t regionBases = 0;
+
+    /// Number of regions in each throughput bin, where bin i counts regions processed at [2^i,2^(i+1)) bases per
+    /// second, except for bin 0 which counts all regions processed at less than 2 bases per second.
+    std::vector<uint64_t> binCount;
+};
+
+BOOST_CLASS_IMPLEMENTATION(RegionThroughputHistogram, boost::serialization::object_serializable)
+
+
+/// peak sizes observed for the principal position processing buffers
+struct PeakBufferSizes
+{
+    void
+    merge(const PeakBufferSizes& rhs)
+    {
+        readBuffer = std::max(readBuffer, rhs.readBuffer);
+        indelBuffer = std::max(indelBuffer, rhs.indelBuffer);
+        basecallBuffer = std::max(basecallBuffer, rhs.basecallBuffer);
+    }
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned /* version */)
+    {
+        ar& BOOST_SERIALIZATION_NVP(readBuffer);
+        ar& BOOST_SERIALIZATION_NVP(indelBuffer);
+        ar& BOOST_SERIALIZATION_NVP(basecallBuffer);
+    }
+
+    /// Maximum number of reads buffered for any one sample
+    uint64_t readBuffer = 0;
+
+    /// Maximum number of indels in the indel buffer
+    uint64_t indelBuffer = 0;
+
+    /// Maximum span of positions held in the basecall buffer for any one sample
+    uint64_t basecallBuffer = 0;
+};
+
+BOOST_CLASS_IMPLEMENTATION(PeakBufferSizes, boost::serialization::object_serializable)
+
+
+struct RunStatsData
+{
+    RunStatsData()
+        : stageWallTimes(RUN_STAGE::SIZE, 0.),
+          stageCpuTimes(RUN_STAGE::SIZE, 0.),
+          stageSampleCounts(RUN_STAGE::SIZE, 0)
+    {}
+
+    void
+    merge(const RunStatsData& rhs);
+
+    void
+    report(std::ostream& os) const;
+
+    /// version 0 is the unversioned format written before stage times, throughput and buffer sizes were added,
+    /// version 1 has no stage CPU times or sample counts
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned version)
     {
         ar& BOOST_SERIALIZATION_NVP(lifeTime);
         ar& BOOST_SERIALIZATION_NVP(candidateIndels);
         ar& BOOST_SERIALIZATION_NVP(nonCandidateIndels);
+        if (version > 0)
+        {
+            ar& BOOST_SERIALIZATION_NVP(stageWallTimes);
+            ar& BOOST_SERIALIZATION_NVP(regionThroughput);
+            ar& BOOST_SERIALIZATION_NVP(peakBufferSizes);
+            ar& BOOST_SERIALIZATION_NVP(allocationCount);
+        }
+        if (version > 1)
+        {
+            ar& BOOST_SERIALIZATION_NVP(stageCpuTimes);
+            ar& BOOST_SERIALIZATION_NVP(stageSampleCounts);
+        }
     }
 
+    void
+    writeBinary(std::ostream& os) const;
+
+    void
+    readBinary(std::istream& is);
+
     /// Total wall-time of each (single-thread) process, summed together
     CpuTimes lifeTime;
 
@@ -66,21 +205,61 @@ struct RunStatsData
 
     /// Total indels failing to reach candidate status in the report range and (if defined) call regions
     unsigned long nonCandidateIndels = 0;
+
+    /// Estimated wall-time spent in each RUN_STAGE in seconds, summed over all processes
+    ///
+    /// Stage times are estimated by sampling: The current stage of each process is sampled every millisecond, and
+    /// the wall and CPU time measured since the previous sample are added to the sampled stage. The stage times of
+    /// each process sum to its lifeTime, and the error of each stage time is on the order of the sampling period
+    /// times the square root of stageSampleCounts for the stage. A stage with no samples took a negligible fraction
+    /// of the run time, but its time is unknown.
+    std::vector<double> stageWallTimes;
+
+    /// Estimated process CPU time (user and system, over all threads) spent in each RUN_STAGE in seconds, summed
+    /// over all processes
+    ///
+    /// This is sampled with stageWallTimes. The CPU time of worker threads is attributed to the stage of the main
+    /// thread when it is sampled, which is the stage that started the work except for asynchronous tasks such as
+    /// realigned read file compression.
+    std::vector<double> stageCpuTimes;
+
+    /// Number of samples from which the time of each RUN_STAGE is estimated
+    std::vector<uint64_t> stageSampleCounts;
+
+    /// Throughput of each call region
+    RegionThroughputHistogram regionThroughput;
+
+    /// Maximum buffer sizes over all processes
+    PeakBufferSizes peakBufferSizes;
+
+    /// Total number of heap allocations, summed over all processes
+    uint64_t allocationCount = 0;
 };
 
-BOOST_CLASS_IMPLEMENTATION(RunStatsData, boost::serialization::object_serializable)
+BOOST_CLASS_VERSION(RunStatsData, 2)
 
 struct RunStats
 {
+    /// load stats from either the binary or xml format
     void
     load(const char* filename);
 
+    /// save stats in xml format
     void
     save(std::ostream& os) const;
 
+    /// save stats in xml format
     void
     save(const char* filename) const;
 
+    /// save stats in the compact binary format, which is faster to load and merge over many segments
+    void
+    saveBinary(std::ostream& os) const;
+
+    /// save stats in the compact binary format, which is faster to load and merge over many segments
+    void
+    saveBinary(const char* filename) const;
+
     void
     report(const char* filename) const;
 
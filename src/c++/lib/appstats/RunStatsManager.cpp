@@ -18,6 +18,7 @@
 //
 
 #include "RunStatsManager.hh"
+#include "AllocationCounter.hh"
 #include "common/Exceptions.hh"
 
 #include <fstream>
@@ -26,13 +27,21 @@
 
 
 
+/// period at which the current run stage is sampled
+static const std::chrono::milliseconds stageSamplePeriod(1);
+
+
+
 RunStatsManager::
 RunStatsManager(
     const std::string& outputFile)
-    : _osPtr(nullptr)
+    : _osPtr(nullptr),
+      _initAllocationCount(getAllocationCount()),
+      _stage(RUN_STAGE::OTHER),
+      _isStopSampler(false)
 {
     if (outputFile.empty()) return;
-    _osPtr = new std::ofstream(outputFile.c_str());
+    _osPtr = new std::ofstream(outputFile.c_str(), std::ios::binary);
     if (! *_osPtr)
     {
         std::ostringstream oss;
@@ -41,6 +50,9 @@ RunStatsManager(
     }
 
     lifeTime.resume();
+    _lastSampleWall = clock_t::now();
+    _lastSampleCpu = std::clock();
+    _samplerThread = std::thread(&RunStatsManager::runStageSampler, this);
 }
 
 
@@ -50,9 +62,51 @@ RunStatsManager::
 {
     if (_osPtr != nullptr)
     {
+        _isStopSampler = true;
+        _samplerThread.join();
+
+        // close the final sample interval:
+        sampleStage();
+
         lifeTime.stop();
-        runStats.runStatsData.lifeTime=lifeTime.getTimes();
-        runStats.save(*_osPtr);
+        RunStatsData& data(runStats.runStatsData);
+        data.lifeTime=lifeTime.getTimes();
+        data.allocationCount = (getAllocationCount()-_initAllocationCount);
+        runStats.saveBinary(*_osPtr);
         delete _osPtr;
     }
 }
+
+
+
+void
+RunStatsManager::
+runStageSampler()
+{
+    // the time since the previous sample is measured directly, so any delay in waking up does not bias the result:
+    while (! _isStopSampler)
+    {
+        std::this_thread::sleep_for(stageSamplePeriod);
+        sampleStage();
+    }
+}
+
+
+
+void
+RunStatsManager::
+sampleStage()
+{
+    const RUN_STAGE::index_t stage(_stage.load(std::memory_order_relaxed));
+    const clock_t::time_point wallNow(clock_t::now());
+    const std::clock_t cpuNow(std::clock());
+
+    RunStatsData& data(runStats.runStatsData);
+    const std::chrono::duration<double> wall(wallNow-_lastSampleWall);
+    data.stageWallTimes[stage] += wall.count();
+    data.stageCpuTimes[stage] += static_cast<double>(cpuNow-_lastSampleCpu)/CLOCKS_PER_SEC;
+    data.stageSampleCounts[stage]++;
+
+    _lastSampleWall = wallNow;
+    _lastSampleCpu = cpuNow;
+}
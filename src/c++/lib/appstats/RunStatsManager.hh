@@ -24,8 +24,12 @@
 
 #include "boost/utility.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <ctime>
 #include <iosfwd>
 #include <string>
+#include <thread>
 
 
 /// \brief Handles all messy real world interaction for the stats module, while the stats module itself just
@@ -52,13 +56,117 @@ struct RunStatsManager : private boost::noncopyable
         }
     }
 
+    /// switch the run stage to which subsequent processing time is attributed
+    ///
+    /// This only records the new stage, stage times are accumulated by a sampling thread as described for
+    /// RunStatsData::stageWallTimes, so that stages can be switched at every position without a timing cost.
+    /// Only the thread which owns this object may switch stages.
+    ///
+    /// \return the previous stage
+    RUN_STAGE::index_t
+    setStage(const RUN_STAGE::index_t stage)
+    {
+        const RUN_STAGE::index_t previousStage(_stage.load(std::memory_order_relaxed));
+        _stage.store(stage, std::memory_order_relaxed);
+        return previousStage;
+    }
+
+    /// record the size of one call region and its total processing time
+    void
+    addCallRegion(
+        const uint64_t regionSize,
+        const double wallSeconds)
+    {
+        runStats.runStatsData.regionThroughput.addRegion(regionSize, wallSeconds);
+    }
+
+    /// update peak buffer sizes, any size which is not known to the caller can be set to zero
+    void
+    updatePeakBufferSizes(
+        const uint64_t readBufferSize,
+        const uint64_t indelBufferSize,
+        const uint64_t basecallBufferSpan)
+    {
+        PeakBufferSizes& peak(runStats.runStatsData.peakBufferSizes);
+        if (readBufferSize > peak.readBuffer) peak.readBuffer = readBufferSize;
+        if (indelBufferSize > peak.indelBuffer) peak.indelBuffer = indelBufferSize;
+        if (basecallBufferSpan > peak.basecallBuffer) peak.basecallBuffer = basecallBufferSpan;
+    }
+
 private:
+    typedef std::chrono::steady_clock clock_t;
+
+    /// sample the current stage at a fixed period until the sampler is stopped
+    void
+    runStageSampler();
+
+    /// add the wall and process CPU time since the previous sample to the current stage
+    void
+    sampleStage();
+
     std::ostream* _osPtr;
 
     /// this object tracks its own lifetime from ctor-to-dtor here, this is used to approximate
     /// program lifetime when RunStatsManager is appropriately scoped
     TimeTracker lifeTime;
 
+    /// heap allocation count at construction
+    uint64_t _initAllocationCount;
+
+    std::atomic<RUN_STAGE::index_t> _stage;
+
+    std::thread _samplerThread;
+    std::atomic<bool> _isStopSampler;
+    clock_t::time_point _lastSampleWall;
+    std::clock_t _lastSampleCpu = 0;
+
     /// runStats is the primary stats data store
     RunStats runStats;
 };
+
+
+
+/// set the run stage for the lifetime of this object, restoring the previous stage when it goes out of scope
+struct RunStageScope : private boost::noncopyable
+{
+    RunStageScope(
+        RunStatsManager& statsManager,
+        const RUN_STAGE::index_t stage)
+        : _statsManager(statsManager),
+          _previousStage(statsManager.setStage(stage))
+    {}
+
+    ~RunStageScope()
+    {
+        _statsManager.setStage(_previousStage);
+    }
+
+private:
+    RunStatsManager& _statsManager;
+    const RUN_STAGE::index_t _previousStage;
+};
+
+
+
+/// record the wall time of one call region from construction to destruction
+struct RunCallRegionScope : private boost::noncopyable
+{
+    RunCallRegionScope(
+        RunStatsManager& statsManager,
+        const uint64_t regionSize)
+        : _statsManager(statsManager),
+          _regionSize(regionSize),
+          _start(std::chrono::steady_clock::now())
+    {}
+
+    ~RunCallRegionScope()
+    {
+        const std::chrono::duration<double> wall(std::chrono::steady_clock::now()-_start);
+        _statsManager.addCallRegion(_regionSize, wall.count());
+    }
+
+private:
+    RunStatsManager& _statsManager;
+    const uint64_t _regionSize;
+    const std::chrono::steady_clock::time_point _start;
+};
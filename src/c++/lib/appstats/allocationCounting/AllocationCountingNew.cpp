@@ -0,0 +1,118 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+/// \file
+/// \author Chris Saunders
+///
+/// Replacements for the global allocation functions which count each allocation for getAllocationCount()
+///
+/// These replace the allocation functions of the entire program, so they are built as a separate object library
+/// which is only linked into the application executables that report allocation counts, and not into the appstats
+/// library or unit tests.
+///
+
+#include "appstats/AllocationCounter.hh"
+
+#include <cstdlib>
+#include <new>
+
+
+
+/// malloc wrapper following the standard operator new contract, including new_handler retries
+static
+void*
+countedAllocate(std::size_t size)
+{
+    addAllocationCount();
+    if (size == 0) size = 1;
+    while (true)
+    {
+        void* ptr(std::malloc(size));
+        if (ptr != nullptr) return ptr;
+
+        const std::new_handler handler(std::get_new_handler());
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+
+
+static
+void*
+countedAllocateNoThrow(std::size_t size) noexcept
+{
+    try
+    {
+        return countedAllocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+
+
+void*
+operator new(std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocateNoThrow(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAllocateNoThrow(size);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,136 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "RegionCostProfiler.hh"
+
+#include "boost/filesystem.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( RegionCostProfiler_test )
+
+
+/// read the trace file, removing the wall time column so that records can be checked exactly
+static
+std::vector<std::string>
+readTraceRecords(const std::string& filename)
+{
+    std::vector<std::string> records;
+    std::ifstream ifs(filename);
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (line.empty() || (line[0] == '#')) continue;
+        records.push_back(line.substr(0, line.rfind('\t')));
+    }
+    return records;
+}
+
+
+static
+RegionCostCounts
+getCounts(
+    const uint64_t reads,
+    const uint64_t alignmentCells)
+{
+    RegionCostCounts counts;
+    counts.reads = reads;
+    counts.alignmentCells = alignmentCells;
+    return counts;
+}
+
+
+BOOST_AUTO_TEST_CASE( test_region_trace )
+{
+    namespace bf = boost::filesystem;
+    const bf::path tracePath(bf::temp_directory_path() / bf::unique_path("RegionCostProfiler_test_%%%%-%%%%.bed"));
+    {
+        RegionCostProfiler profiler(tracePath.string(), 0);
+        BOOST_REQUIRE(profiler.isEnabled());
+
+        // finishing before the first region has no effect:
+        profiler.finishRegion(getCounts(0,0));
+
+        profiler.startRegion("chr1", known_pos_range2(100, 200), getCounts(5,10));
+        BOOST_REQUIRE(! profiler.isWindowComplete(150));
+        BOOST_REQUIRE(! profiler.isWindowComplete(250));
+        profiler.finishRegion(getCounts(8,30));
+
+        profiler.startRegion("chr2", known_pos_range2(0, 50), getCounts(8,30));
+        profiler.finishRegion(getCounts(9,30));
+    }
+
+    const std::vector<std::string> records(readTraceRecords(tracePath.string()));
+    bf::remove(tracePath);
+
+    BOOST_REQUIRE_EQUAL(records.size(), 2u);
+    BOOST_REQUIRE_EQUAL(records[0], "chr1\t100\t200\t3\t0\t0\t20");
+    BOOST_REQUIRE_EQUAL(records[1], "chr2\t0\t50\t1\t0\t0\t0");
+}
+
+
+BOOST_AUTO_TEST_CASE( test_window_trace )
+{
+    namespace bf = boost::filesystem;
+    const bf::path tracePath(bf::temp_directory_path() / bf::unique_path("RegionCostProfiler_test_%%%%-%%%%.bed"));
+    {
+        RegionCostProfiler profiler(tracePath.string(), 100);
+
+        profiler.startRegion("chr1", known_pos_range2(150, 520), getCounts(0,0));
+        BOOST_REQUIRE(! profiler.isWindowComplete(199));
+        BOOST_REQUIRE(profiler.isWindowComplete(200));
+        profiler.updatePosition(200, getCounts(2,0));
+
+        // windows without any processed position are skipped:
+        BOOST_REQUIRE(profiler.isWindowComplete(430));
+        profiler.updatePosition(430, getCounts(5,0));
+        BOOST_REQUIRE(profiler.isWindowComplete(500));
+        profiler.updatePosition(500, getCounts(6,0));
+
+        // the final window extends to the end of the region and absorbs any positions past it:
+        BOOST_REQUIRE(! profiler.isWindowComplete(600));
+        profiler.finishRegion(getCounts(7,0));
+    }
+
+    const std::vector<std::string> records(readTraceRecords(tracePath.string()));
+    bf::remove(tracePath);
+
+    BOOST_REQUIRE_EQUAL(records.size(), 4u);
+    BOOST_REQUIRE_EQUAL(records[0], "chr1\t150\t200\t2\t0\t0\t0");
+    BOOST_REQUIRE_EQUAL(records[1], "chr1\t200\t300\t3\t0\t0\t0");
+    BOOST_REQUIRE_EQUAL(records[2], "chr1\t400\t500\t1\t0\t0\t0");
+    BOOST_REQUIRE_EQUAL(records[3], "chr1\t500\t520\t1\t0\t0\t0");
+}
+
+
+BOOST_AUTO_TEST_CASE( test_disabled )
+{
+    RegionCostProfiler profiler("", 100);
+    BOOST_REQUIRE(! profiler.isEnabled());
+    profiler.startRegion("chr1", known_pos_range2(0, 1000), getCounts(0,0));
+    BOOST_REQUIRE(! profiler.isWindowComplete(500));
+    profiler.finishRegion(getCounts(1,0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
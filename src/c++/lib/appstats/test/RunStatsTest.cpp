@@ -0,0 +1,259 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "RunStats.hh"
+#include "RunStatsManager.hh"
+
+#include "boost/filesystem.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( RunStats_test )
+
+
+static
+RunStatsData
+getTestData()
+{
+    RunStatsData data;
+    data.lifeTime.wall = 10;
+    data.lifeTime.user = 9;
+    data.candidateIndels = 5;
+    data.nonCandidateIndels = 7;
+    data.stageWallTimes[RUN_STAGE::REALIGNMENT] = 3;
+    data.stageWallTimes[RUN_STAGE::GENOTYPING] = 2;
+    data.stageCpuTimes[RUN_STAGE::REALIGNMENT] = 4;
+    data.stageSampleCounts[RUN_STAGE::REALIGNMENT] = 3000;
+    data.regionThroughput.addRegion(1000, 0.5);
+    data.regionThroughput.addRegion(1, 1.);
+    data.peakBufferSizes.readBuffer = 100;
+    data.peakBufferSizes.indelBuffer = 10;
+    data.allocationCount = 12345;
+    return data;
+}
+
+
+BOOST_AUTO_TEST_CASE( test_region_throughput_histogram )
+{
+    RegionThroughputHistogram hist;
+    hist.addRegion(1000, 0.5);
+    hist.addRegion(1, 1.);
+    hist.addRegion(100, 0.);
+
+    BOOST_REQUIRE_EQUAL(hist.regionCount, 3u);
+    BOOST_REQUIRE_EQUAL(hist.regionBases, 1101u);
+    BOOST_REQUIRE_EQUAL(hist.binCount.size(), RegionThroughputHistogram::maxBinCount);
+
+    // 2000 bases/sec is in bin 10, regions slower than 2 bases/sec go to bin 0 and instantaneous regions go to the
+    // top bin:
+    BOOST_REQUIRE_EQUAL(hist.binCount[10], 1u);
+    BOOST_REQUIRE_EQUAL(hist.binCount[0], 1u);
+    BOOST_REQUIRE_EQUAL(hist.binCount[RegionThroughputHistogram::maxBinCount-1], 1u);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_binary_round_trip )
+{
+    const RunStatsData data(getTestData());
+
+    std::stringstream ss;
+    data.writeBinary(ss);
+
+    RunStatsData data2;
+    data2.readBinary(ss);
+
+    BOOST_REQUIRE_EQUAL(data2.lifeTime.wall, data.lifeTime.wall);
+    BOOST_REQUIRE_EQUAL(data2.lifeTime.user, data.lifeTime.user);
+    BOOST_REQUIRE_EQUAL(data2.candidateIndels, data.candidateIndels);
+    BOOST_REQUIRE_EQUAL(data2.nonCandidateIndels, data.nonCandidateIndels);
+    BOOST_REQUIRE_EQUAL(data2.stageWallTimes.size(), data.stageWallTimes.size());
+    BOOST_REQUIRE_EQUAL(data2.stageWallTimes[RUN_STAGE::REALIGNMENT], 3.);
+    BOOST_REQUIRE_EQUAL(data2.stageWallTimes[RUN_STAGE::GENOTYPING], 2.);
+    BOOST_REQUIRE_EQUAL(data2.stageCpuTimes.size(), data.stageCpuTimes.size());
+    BOOST_REQUIRE_EQUAL(data2.stageCpuTimes[RUN_STAGE::REALIGNMENT], 4.);
+    BOOST_REQUIRE_EQUAL(data2.stageSampleCounts[RUN_STAGE::REALIGNMENT], 3000u);
+    BOOST_REQUIRE_EQUAL(data2.regionThroughput.regionCount, 2u);
+    BOOST_REQUIRE(data2.regionThroughput.binCount == data.regionThroughput.binCount);
+    BOOST_REQUIRE_EQUAL(data2.peakBufferSizes.readBuffer, 100u);
+    BOOST_REQUIRE_EQUAL(data2.peakBufferSizes.indelBuffer, 10u);
+    BOOST_REQUIRE_EQUAL(data2.allocationCount, 12345u);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_merge )
+{
+    RunStatsData data(getTestData());
+    RunStatsData data2(getTestData());
+    data2.peakBufferSizes.readBuffer = 50;
+    data2.peakBufferSizes.basecallBuffer = 20;
+
+    data.merge(data2);
+
+    BOOST_REQUIRE_EQUAL(data.lifeTime.wall, 20.);
+    BOOST_REQUIRE_EQUAL(data.candidateIndels, 10u);
+    BOOST_REQUIRE_EQUAL(data.stageWallTimes[RUN_STAGE::REALIGNMENT], 6.);
+    BOOST_REQUIRE_EQUAL(data.stageCpuTimes[RUN_STAGE::REALIGNMENT], 8.);
+    BOOST_REQUIRE_EQUAL(data.stageSampleCounts[RUN_STAGE::REALIGNMENT], 6000u);
+    BOOST_REQUIRE_EQUAL(data.regionThroughput.regionCount, 4u);
+    BOOST_REQUIRE_EQUAL(data.regionThroughput.binCount[0], 2u);
+    BOOST_REQUIRE_EQUAL(data.peakBufferSizes.readBuffer, 100u);
+    BOOST_REQUIRE_EQUAL(data.peakBufferSizes.basecallBuffer, 20u);
+    BOOST_REQUIRE_EQUAL(data.allocationCount, 24690u);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_xml_round_trip )
+{
+    namespace bf = boost::filesystem;
+    const bf::path statsPath(bf::temp_directory_path() / bf::unique_path("RunStats_test_%%%%-%%%%.xml"));
+
+    RunStats stats;
+    stats.runStatsData = getTestData();
+    stats.save(statsPath.string().c_str());
+
+    RunStats stats2;
+    stats2.load(statsPath.string().c_str());
+    bf::remove(statsPath);
+
+    const RunStatsData& data2(stats2.runStatsData);
+    BOOST_REQUIRE_EQUAL(data2.candidateIndels, 5u);
+    BOOST_REQUIRE_EQUAL(data2.stageWallTimes[RUN_STAGE::REALIGNMENT], 3.);
+    BOOST_REQUIRE_EQUAL(data2.stageCpuTimes[RUN_STAGE::REALIGNMENT], 4.);
+    BOOST_REQUIRE_EQUAL(data2.regionThroughput.regionCount, 2u);
+    BOOST_REQUIRE_EQUAL(data2.peakBufferSizes.readBuffer, 100u);
+    BOOST_REQUIRE_EQUAL(data2.allocationCount, 12345u);
+}
+
+
+
+/// busy-wait for the given wall time
+///
+/// \return the measured wall time
+static
+double
+spin(const double seconds)
+{
+    const auto startWall(std::chrono::steady_clock::now());
+    while (true)
+    {
+        const double wall(std::chrono::duration<double>(std::chrono::steady_clock::now()-startWall).count());
+        if (wall >= seconds) return wall;
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_stage_timing )
+{
+    namespace bf = boost::filesystem;
+    const bf::path statsPath(bf::temp_directory_path() / bf::unique_path("RunStats_test_%%%%-%%%%.bin"));
+
+    static const double stageSeconds(0.2);
+    double realignmentWall(0);
+    double genotypingWall(0);
+    {
+        RunStatsManager statsManager(statsPath.string());
+
+        // a stage entered once:
+        {
+            RunStageScope stageScope(statsManager, RUN_STAGE::REALIGNMENT);
+            realignmentWall += spin(stageSeconds);
+        }
+
+        // a stage entered many times for much less than the sampling period:
+        for (unsigned intervalIndex(0); intervalIndex < 2000; ++intervalIndex)
+        {
+            RunStageScope stageScope(statsManager, RUN_STAGE::GENOTYPING);
+            genotypingWall += spin(stageSeconds/2000);
+        }
+    }
+
+    RunStats stats;
+    stats.load(statsPath.string().c_str());
+    bf::remove(statsPath);
+
+    const RunStatsData& data(stats.runStatsData);
+    auto checkStage = [&](const RUN_STAGE::index_t stage, const double expectedWall)
+    {
+        // allow for a delayed sampling thread on a loaded host:
+        static const double tolerance(0.05);
+        BOOST_REQUIRE_GT(data.stageSampleCounts[stage], 0u);
+        BOOST_REQUIRE_GT(data.stageWallTimes[stage], (expectedWall*0.75-tolerance));
+        BOOST_REQUIRE_LT(data.stageWallTimes[stage], (expectedWall*1.25+tolerance));
+        BOOST_REQUIRE_GT(data.stageCpuTimes[stage], 0.);
+    };
+    checkStage(RUN_STAGE::REALIGNMENT, realignmentWall);
+    checkStage(RUN_STAGE::GENOTYPING, genotypingWall);
+    BOOST_REQUIRE_EQUAL(data.stageSampleCounts[RUN_STAGE::PILEUP], 0u);
+    BOOST_REQUIRE_EQUAL(data.stageWallTimes[RUN_STAGE::PILEUP], 0.);
+
+    // stage times partition the stats manager lifetime:
+    double totalStageWall(0);
+    for (const double stageWall : data.stageWallTimes)
+    {
+        totalStageWall += stageWall;
+    }
+    BOOST_REQUIRE_CLOSE(totalStageWall, data.lifeTime.wall, 5.);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_load_unversioned_xml )
+{
+    // run stats xml as written before the RunStatsData class was versioned:
+    static const char unversionedXml[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+        "<!DOCTYPE boost_serialization>\n"
+        "<boost_serialization signature=\"serialization::archive\" version=\"14\">\n"
+        "<runStatsData>\n"
+        "\t<lifeTime>\n"
+        "\t\t<wall>10</wall>\n"
+        "\t\t<user>9</user>\n"
+        "\t\t<system>1</system>\n"
+        "\t</lifeTime>\n"
+        "\t<candidateIndels>5</candidateIndels>\n"
+        "\t<nonCandidateIndels>7</nonCandidateIndels>\n"
+        "</runStatsData>\n"
+        "</boost_serialization>\n";
+
+    namespace bf = boost::filesystem;
+    const bf::path statsPath(bf::temp_directory_path() / bf::unique_path("RunStats_test_%%%%-%%%%.xml"));
+    {
+        std::ofstream ofs(statsPath.string());
+        ofs << unversionedXml;
+    }
+
+    RunStats stats;
+    stats.load(statsPath.string().c_str());
+    bf::remove(statsPath);
+
+    const RunStatsData& data(stats.runStatsData);
+    BOOST_REQUIRE_EQUAL(data.lifeTime.wall, 10.);
+    BOOST_REQUIRE_EQUAL(data.candidateIndels, 5u);
+    BOOST_REQUIRE_EQUAL(data.nonCandidateIndels, 7u);
+    BOOST_REQUIRE_EQUAL(data.stageWallTimes.size(), static_cast<unsigned>(RUN_STAGE::SIZE));
+    BOOST_REQUIRE_EQUAL(data.stageCpuTimes.size(), static_cast<unsigned>(RUN_STAGE::SIZE));
+    BOOST_REQUIRE_EQUAL(data.stageSampleCounts.size(), static_cast<unsigned>(RUN_STAGE::SIZE));
+    BOOST_REQUIRE_EQUAL(data.allocationCount, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
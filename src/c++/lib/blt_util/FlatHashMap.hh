@@ -0,0 +1,152 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+
+/// insert-only hash map using open addressing with linear probing in a single flat slot array
+///
+/// this is intended for high-volume accumulation of values over a modest number of distinct
+/// keys, where std::map lookups and node allocations would otherwise dominate. No element
+/// erasure is supported. Iteration order is unspecified, so clients requiring sorted
+/// output should transfer the contents to a sorted container once accumulation is complete.
+///
+/// KeyType must be default constructable and implement operator==
+///
+template <typename KeyType, typename ValType, typename Hash = std::hash<KeyType>>
+struct FlatHashMap
+{
+    explicit
+    FlatHashMap(
+        const unsigned minCapacity = 16)
+    {
+        unsigned capacity(1);
+        while (capacity < minCapacity) capacity *= 2;
+        _slots.resize(capacity);
+    }
+
+    /// return a reference to the value for key, the value is default-initialized if key is new
+    ValType&
+    getRef(
+        const KeyType& key)
+    {
+        const size_t hashVal(_hash(key));
+        Slot* slotPtr(&findSlot(key, hashVal));
+        if (! slotPtr->isOccupied)
+        {
+            if (((_size+1)*2) > _slots.size())
+            {
+                grow();
+                slotPtr = &findSlot(key, hashVal);
+            }
+            slotPtr->isOccupied = true;
+            slotPtr->hashVal = hashVal;
+            slotPtr->value.first = key;
+            _size++;
+        }
+        return slotPtr->value.second;
+    }
+
+    bool
+    empty() const
+    {
+        return (_size == 0);
+    }
+
+    unsigned
+    size() const
+    {
+        return _size;
+    }
+
+    void
+    clear()
+    {
+        const unsigned capacity(_slots.size());
+        _slots.clear();
+        _slots.resize(capacity);
+        _size = 0;
+    }
+
+    /// call func(key, value) for every key in the map, in unspecified order
+    template <typename Func>
+    void
+    forEach(Func func) const
+    {
+        for (const Slot& slot : _slots)
+        {
+            if (slot.isOccupied) func(slot.value.first, slot.value.second);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::pair<KeyType,ValType> value = std::pair<KeyType,ValType>();
+        size_t hashVal = 0;
+        bool isOccupied = false;
+    };
+
+    /// find the slot holding key or the empty slot where it should be inserted
+    Slot&
+    findSlot(
+        const KeyType& key,
+        const size_t hashVal)
+    {
+        const size_t mask(_slots.size()-1);
+        size_t index(hashVal & mask);
+        while (true)
+        {
+            Slot& slot(_slots[index]);
+            if (! slot.isOccupied) return slot;
+            if ((slot.hashVal == hashVal) && (slot.value.first == key)) return slot;
+            index = (index+1) & mask;
+        }
+    }
+
+    void
+    grow()
+    {
+        std::vector<Slot> oldSlots(_slots.size()*2);
+        _slots.swap(oldSlots);
+        const size_t mask(_slots.size()-1);
+        for (Slot& oldSlot : oldSlots)
+        {
+            if (! oldSlot.isOccupied) continue;
+            size_t index(oldSlot.hashVal & mask);
+            while (_slots[index].isOccupied)
+            {
+                index = (index+1) & mask;
+            }
+            _slots[index] = std::move(oldSlot);
+        }
+    }
+
+    Hash _hash;
+    std::vector<Slot> _slots;
+    unsigned _size = 0;
+};
@@ -100,6 +100,14 @@ struct RangeMap
         return _isEmpty;
     }
 
+    /// \return the span of keys from the lowest to the highest stored key, or zero if empty
+    KeyType
+    getKeySpan() const
+    {
+        if (_isEmpty) return KeyType(0);
+        return (_maxKey-_minKey+1);
+    }
+
     bool
     isKeyPresent(
         const KeyType& k) const
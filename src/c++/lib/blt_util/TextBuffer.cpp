@@ -0,0 +1,174 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#include "blt_util/TextBuffer.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <ostream>
+
+
+
+void
+TextBuffer::
+append(const char* s)
+{
+    _buffer.append(s, std::strlen(s));
+}
+
+
+
+void
+TextBuffer::
+appendInt(const int64_t val)
+{
+    if (val < 0)
+    {
+        _buffer.push_back('-');
+        // negate in unsigned space to handle the minimum value:
+        appendUnsigned(-static_cast<uint64_t>(val));
+    }
+    else
+    {
+        appendUnsigned(static_cast<uint64_t>(val));
+    }
+}
+
+
+
+void
+TextBuffer::
+appendUnsigned(uint64_t val)
+{
+    static const char digitPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    static const unsigned maxDigits(20);
+    char digits[maxDigits];
+    char* end(digits+maxDigits);
+    char* begin(end);
+    while (val >= 100)
+    {
+        const unsigned pairIndex(2*(val % 100));
+        val /= 100;
+        *(--begin) = digitPairs[pairIndex+1];
+        *(--begin) = digitPairs[pairIndex];
+    }
+    if (val >= 10)
+    {
+        const unsigned pairIndex(2*val);
+        *(--begin) = digitPairs[pairIndex+1];
+        *(--begin) = digitPairs[pairIndex];
+    }
+    else
+    {
+        *(--begin) = static_cast<char>('0' + val);
+    }
+    _buffer.append(begin, end-begin);
+}
+
+
+
+void
+TextBuffer::
+appendDouble(
+    const double val,
+    const int precision)
+{
+    // the general stream format is '%.<precision>g', which prints any integral value below 10^precision
+    // exactly as the equivalent integer. This case covers most high-volume values (depth, quality...)
+    static const double maxExactIntegralTable[] = { 1., 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+    static const int maxTablePrecision(9);
+    const double maxExactIntegral(maxExactIntegralTable[std::max(1, std::min(precision, maxTablePrecision))]);
+    if ((std::abs(val) < maxExactIntegral) && (val == std::trunc(val)))
+    {
+        // negative zero is printed as "-0":
+        if (not ((val == 0.) && std::signbit(val)))
+        {
+            appendInt(static_cast<int64_t>(val));
+            return;
+        }
+    }
+
+    appendFormat("%.*g", precision, val);
+}
+
+
+
+void
+TextBuffer::
+appendFixed(
+    const double val,
+    const int precision)
+{
+    appendFormat("%.*f", precision, val);
+}
+
+
+
+void
+TextBuffer::
+appendFormat(
+    const char* format,
+    const int precision,
+    const double val)
+{
+    char buff[64];
+    const int len(snprintf(buff, sizeof(buff), format, precision, val));
+    if (len < 0) return;
+    if (static_cast<std::size_t>(len) < sizeof(buff))
+    {
+        _buffer.append(buff, len);
+    }
+    else
+    {
+        // rare long result, e.g. very large values in fixed format:
+        const std::size_t startSize(_buffer.size());
+        _buffer.resize(startSize+len+1);
+        snprintf(&_buffer[startSize], len+1, format, precision, val);
+        _buffer.resize(startSize+len);
+    }
+}
+
+
+
+void
+TextBuffer::
+flush(std::ostream& os)
+{
+    if (_buffer.empty()) return;
+    os.write(_buffer.data(), _buffer.size());
+    _buffer.clear();
+}
@@ -0,0 +1,136 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include <cstdint>
+
+#include <iosfwd>
+#include <string>
+
+
+/// Reusable character buffer for fast formatting of high-volume text records
+///
+/// Values are appended directly to the buffer without iostream overhead, and the accumulated text
+/// is written to an output stream in large blocks. Numeric formatting matches the default
+/// std::ostream formatting for each value type, so record writers can be moved onto this buffer
+/// without changing their output.
+///
+struct TextBuffer
+{
+    /// \param flushSize buffer size at which isFlushReady() becomes true
+    explicit
+    TextBuffer(const std::size_t flushSize = 0x10000)
+        : _flushSize(flushSize)
+    {
+        _buffer.reserve(_flushSize + 0x400);
+    }
+
+    void
+    append(const char c)
+    {
+        _buffer.push_back(c);
+    }
+
+    void
+    append(const char* s);
+
+    void
+    append(const char* s, const std::size_t n)
+    {
+        _buffer.append(s, n);
+    }
+
+    void
+    append(const std::string& s)
+    {
+        _buffer.append(s);
+    }
+
+    /// append integer, formatted as 'os << val'
+    void
+    appendInt(const int64_t val);
+
+    /// append unsigned integer, formatted as 'os << val'
+    void
+    appendUnsigned(uint64_t val);
+
+    /// append floating-point value, formatted as 'os << std::setprecision(precision) << val' under default
+    /// stream flags
+    void
+    appendDouble(
+        const double val,
+        const int precision = 6);
+
+    /// append floating-point value, formatted as 'os << std::fixed << std::setprecision(precision) << val'
+    void
+    appendFixed(
+        const double val,
+        const int precision);
+
+    bool
+    empty() const
+    {
+        return _buffer.empty();
+    }
+
+    std::size_t
+    size() const
+    {
+        return _buffer.size();
+    }
+
+    const std::string&
+    str() const
+    {
+        return _buffer;
+    }
+
+    /// true when the buffer has accumulated enough text to be written out
+    bool
+    isFlushReady() const
+    {
+        return (_buffer.size() >= _flushSize);
+    }
+
+    void
+    clear()
+    {
+        _buffer.clear();
+    }
+
+    /// write all buffered text to os and clear the buffer
+    void
+    flush(std::ostream& os);
+
+private:
+    /// append a single floating-point value using a printf format with a precision argument
+    void
+    appendFormat(
+        const char* format,
+        const int precision,
+        const double val);
+
+    std::size_t _flushSize;
+    std::string _buffer;
+};
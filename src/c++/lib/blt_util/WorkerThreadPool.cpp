@@ -0,0 +1,172 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#include "blt_util/WorkerThreadPool.hh"
+
+#include <algorithm>
+#include <cassert>
+
+
+
+WorkerThreadPool::
+WorkerThreadPool(
+    const unsigned threadCount)
+    : _threadErrors(std::max(threadCount,1u))
+{
+    for (unsigned threadIndex(1); threadIndex < threadCount; ++threadIndex)
+    {
+        _threads.emplace_back(&WorkerThreadPool::workerLoop, this, threadIndex);
+    }
+}
+
+
+
+WorkerThreadPool::
+~WorkerThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isShutdown = true;
+    }
+    _batchStartCondition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+
+
+void
+WorkerThreadPool::
+run(
+    const unsigned taskCount,
+    const task_t& task)
+{
+    if (taskCount == 0) return;
+
+    // run small batches directly on the calling thread:
+    if (_threads.empty() || (taskCount == 1))
+    {
+        for (unsigned taskIndex(0); taskIndex < taskCount; ++taskIndex)
+        {
+            task(taskIndex, 0);
+        }
+        return;
+    }
+
+    _taskPtr = &task;
+    _taskCount = taskCount;
+    _nextTaskIndex.store(0);
+    for (auto& threadError : _threadErrors)
+    {
+        threadError.error = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _activeWorkerCount = _threads.size();
+        _batchIndex++;
+    }
+    _batchStartCondition.notify_all();
+
+    runBatchTasks(0);
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _batchEndCondition.wait(lock, [this] { return (_activeWorkerCount == 0); });
+    }
+    _taskPtr = nullptr;
+
+    const TaskError* firstErrorPtr(nullptr);
+    for (const auto& threadError : _threadErrors)
+    {
+        if (! threadError.error) continue;
+        if ((nullptr == firstErrorPtr) || (threadError.taskIndex < firstErrorPtr->taskIndex))
+        {
+            firstErrorPtr = &threadError;
+        }
+    }
+    if (nullptr != firstErrorPtr)
+    {
+        std::rethrow_exception(firstErrorPtr->error);
+    }
+}
+
+
+
+void
+WorkerThreadPool::
+workerLoop(
+    const unsigned threadIndex)
+{
+    unsigned lastBatchIndex(0);
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _batchStartCondition.wait(lock, [&] { return (_isShutdown || (_batchIndex != lastBatchIndex)); });
+            if (_isShutdown) return;
+            lastBatchIndex = _batchIndex;
+        }
+
+        runBatchTasks(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            assert(_activeWorkerCount > 0);
+            _activeWorkerCount--;
+            if (_activeWorkerCount > 0) continue;
+        }
+        _batchEndCondition.notify_one();
+    }
+}
+
+
+
+void
+WorkerThreadPool::
+runBatchTasks(
+    const unsigned threadIndex)
+{
+    TaskError& threadError(_threadErrors[threadIndex]);
+    while (true)
+    {
+        const unsigned taskIndex(_nextTaskIndex.fetch_add(1));
+        if (taskIndex >= _taskCount) return;
+
+        try
+        {
+            (*_taskPtr)(taskIndex, threadIndex);
+        }
+        catch (...)
+        {
+            // tasks are claimed in increasing order on each thread, so only the first error needs to be kept:
+            if (! threadError.error)
+            {
+                threadError.taskIndex = taskIndex;
+                threadError.error = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/// a fixed set of threads which repeatedly runs batches of independent tasks
+///
+/// This is intended for short parallel sections within an otherwise serial loop, where starting new threads for
+/// each section would cost more than the section itself. The calling thread runs tasks alongside the pool threads
+/// during each batch.
+///
+struct WorkerThreadPool
+{
+    /// \param threadCount total number of threads running each batch, including the calling thread
+    explicit
+    WorkerThreadPool(
+        const unsigned threadCount);
+
+    ~WorkerThreadPool();
+
+    WorkerThreadPool(const WorkerThreadPool&) = delete;
+    WorkerThreadPool& operator=(const WorkerThreadPool&) = delete;
+
+    unsigned
+    getThreadCount() const
+    {
+        return (_threads.size() + 1);
+    }
+
+    typedef std::function<void(unsigned taskIndex, unsigned threadIndex)> task_t;
+
+    /// run task(taskIndex, threadIndex) for each taskIndex in [0,taskCount), and return when all tasks are complete
+    ///
+    /// threadIndex is in [0,getThreadCount()) and identifies the thread running the task, so that tasks can use
+    /// per-thread working storage. If any tasks throw, the exception from the lowest task index is rethrown after
+    /// the whole batch has completed.
+    void
+    run(
+        const unsigned taskCount,
+        const task_t& task);
+
+private:
+    void
+    workerLoop(
+        const unsigned threadIndex);
+
+    void
+    runBatchTasks(
+        const unsigned threadIndex);
+
+    /// first exception observed by one thread in the current batch
+    struct TaskError
+    {
+        unsigned taskIndex = 0;
+        std::exception_ptr error;
+    };
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _batchStartCondition;
+    std::condition_variable _batchEndCondition;
+    unsigned _batchIndex = 0;
+    unsigned _activeWorkerCount = 0;
+    bool _isShutdown = false;
+
+    const task_t* _taskPtr = nullptr;
+    unsigned _taskCount = 0;
+    std::atomic<unsigned> _nextTaskIndex{0};
+    std::vector<TaskError> _threadErrors;
+};
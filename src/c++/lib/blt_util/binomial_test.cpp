@@ -23,24 +23,30 @@
 ///
 
 #include "blt_util/binomial_test.hh"
+#include "blt_util/exact_test_util.hh"
 #include "blt_util/stat_util.hh"
 
-#include <boost/math/distributions/binomial.hpp>
-#include <boost/math/distributions/complement.hpp>
+#include "boost/math/distributions/binomial.hpp"
+#include "boost/math/distributions/complement.hpp"
 
-using boost::math::binomial;
-using boost::math::cdf;
-using boost::math::complement;
+#include <cassert>
+#include <cfloat>
+#include <cmath>
 
 #include <algorithm>
+#include <limits>
 
 
 
+/// two-sided binomial exact probability, where summation may stop once the
+/// probability is known to exceed exit_pval
+static
 double
-get_binomial_twosided_exact_pval(
+getBinomialTwosidedExactPval(
     const double p,
     const unsigned n_success,
-    const unsigned n_trials)
+    const unsigned n_trials,
+    const double exit_pval)
 {
     assert((p>0.) && (p<1.));
     assert(n_success <= n_trials);
@@ -51,48 +57,50 @@ get_binomial_twosided_exact_pval(
         return 1;
     }
 
-    if (fabs(p - 0.5) < DBL_EPSILON)
+    const binomial_pmf dist(p, n_trials);
+    if (std::fabs(p - 0.5) < DBL_EPSILON)
     {
-        const unsigned n_failure(n_trials-n_success);
         const double obs_p((double)n_success/(double)n_trials);
 
         double exact_prob;
         if (obs_p <= p)
         {
-            exact_prob=cdf(binomial(n_trials,p),n_success);
+            exact_prob=sum_pmf_interval(dist, 0, n_success, exit_pval/2.);
         }
         else
         {
-            exact_prob=cdf(binomial(n_trials,1.-p),n_failure);
+            exact_prob=sum_pmf_interval(dist, n_success, n_trials, exit_pval/2.);
         }
 
         return std::min(1.0, 2.*exact_prob);
     }
     else
     {
-        // naive implementation -- this can be improved
-        // in two ways:
-        // * find upper / lower bound so we don't have to
-        //   evaluate the pdf for every single value
-        //   between 0 and n_trials
-        // * be smarter about additive error
-        binomial dist = binomial(n_trials, p);
-        double exact_prob = pdf(dist, n_success);
-        double result = 0;
-        for (unsigned j = 0; j <= n_trials; ++j)
+        // resolve near-ties with the boost pdf, as the original implementation compared every term this way:
+        const boost::math::binomial boostDist(n_trials, p);
+        double boostCutoff(-1.);
+        auto isTieIncluded = [&](const unsigned q)
         {
-            double pp = pdf(dist, j);
-            if (pp <= exact_prob)
-            {
-                result += pp;
-            }
-        }
-        return result;
+            if (boostCutoff < 0.) boostCutoff = pdf(boostDist, n_success);
+            return (pdf(boostDist, q) <= boostCutoff);
+        };
+        return sum_pmf_no_greater_than(dist, n_success, isTieIncluded, exit_pval);
     }
 }
 
 
 
+double
+get_binomial_twosided_exact_pval(
+    const double p,
+    const unsigned n_success,
+    const unsigned n_trials)
+{
+    return getBinomialTwosidedExactPval(p, n_success, n_trials, std::numeric_limits<double>::infinity());
+}
+
+
+
 bool
 is_reject_binomial_twosided_exact(
     const double alpha,
@@ -100,7 +108,7 @@ is_reject_binomial_twosided_exact(
     const unsigned n_success,
     const unsigned n_trials)
 {
-    return (get_binomial_twosided_exact_pval(p,n_success,n_trials)<alpha);
+    return (getBinomialTwosidedExactPval(p,n_success,n_trials,alpha)<alpha);
 }
 
 
@@ -150,19 +158,36 @@ is_reject_binomial_twosided(
 
 
 
+/// probability of n_success or more given B(n_trials,p), where summation may
+/// stop once the probability is known to exceed exit_pval
+static
 double
-get_binomial_gte_n_success_exact_pval(
+getBinomialGteNSuccessExactPval(
     const double p,
     const unsigned n_success,
-    const unsigned n_trials)
+    const unsigned n_trials,
+    const double exit_pval)
 {
     //although binomial probabilities of
     // 0 or 1 are possible, they don't have much meaning
     assert((p >= 0.) && (p <= 1.));
     assert(n_success <= n_trials);
     if (n_success==0) return 1;
+    if (p <= 0.) return 0;
+    if (p >= 1.) return 1;
+
+    return sum_pmf_interval(binomial_pmf(p, n_trials), n_success, n_trials, exit_pval);
+}
+
+
 
-    return cdf(complement(binomial(n_trials, p), n_success - 1));
+double
+get_binomial_gte_n_success_exact_pval(
+    const double p,
+    const unsigned n_success,
+    const unsigned n_trials)
+{
+    return getBinomialGteNSuccessExactPval(p, n_success, n_trials, std::numeric_limits<double>::infinity());
 }
 
 
@@ -176,11 +201,13 @@ is_reject_binomial_gte_n_success_exact(
 {
     assert(alpha >= 0);
 
-    const double observed_pval = get_binomial_gte_n_success_exact_pval(p, n_success, n_trials);
+    const double observed_pval = getBinomialGteNSuccessExactPval(p, n_success, n_trials, alpha);
 
     return (observed_pval <= alpha);
 }
 
+
+
 double
 min_count_binomial_gte_exact(
     const double alpha,
@@ -190,5 +217,31 @@ min_count_binomial_gte_exact(
     assert(alpha >= 0);
     assert((p >= 0.) && (p <= 1.));
 
-    return (1 + quantile(complement(binomial(n_trials, p), alpha)));
+    // for alpha > 0.5 the original boost quantile result is kept, its outward rounding can give one less than the
+    // search below:
+    if (alpha > 0.5)
+    {
+        return (1 + quantile(complement(boost::math::binomial(n_trials, p), alpha)));
+    }
+
+    if (p <= 0.) return 1;
+    if (p >= 1.) return (n_trials+1);
+
+    // P(X >= count) is non-increasing in count, so search for the minimum count which rejects the null,
+    // where a count of zero never rejects and a count of n_trials+1 always does:
+    unsigned minRejectCount(n_trials+1);
+    unsigned maxAcceptCount(0);
+    while ((maxAcceptCount+1) < minRejectCount)
+    {
+        const unsigned count(maxAcceptCount+(minRejectCount-maxAcceptCount)/2);
+        if (is_reject_binomial_gte_n_success_exact(alpha, p, count, n_trials))
+        {
+            minRejectCount = count;
+        }
+        else
+        {
+            maxAcceptCount = count;
+        }
+    }
+    return minRejectCount;
 }
@@ -36,11 +36,10 @@
 bool
 compat_realpath(std::string& path)
 {
-    errno=0;
+    // errno is not checked here because realpath may leave it set from internal symlink lookups even on success:
     const char* newpath(realpath(path.c_str(),nullptr));
-    if ((nullptr==newpath) || (errno!=0))
+    if (nullptr==newpath)
     {
-        if (nullptr!=newpath) free((void*)newpath);
         return false;
     }
     path = newpath;
@@ -28,6 +28,9 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <vector>
+
 
 /// base object for depth_buffers, do not call this directly
 struct depth_buffer_base
@@ -70,24 +73,74 @@ private:
 /// assumes that a narrow list of positions is maintained so that
 /// array based lookup optimizations can be used
 ///
-struct depth_buffer : public depth_buffer_base
+/// Depth ranges are added as a difference array ahead of a frontier position, which
+/// moves forward to the start of each new range. Adding a range starting at or after the
+/// frontier is O(1), and depth is only written out per-position once, as the frontier
+/// passes over it. Ranges starting before the frontier are still supported, but fall back
+/// to per-position updates over the part of the range behind the frontier.
+///
+struct depth_buffer
 {
+    void
+    clear()
+    {
+        _depth.clear();
+        _rangeEndCount.clear();
+        _isFrontier = false;
+        _frontierPos = 0;
+        _frontierDepth = 0;
+    }
+
     unsigned
     val(const pos_t pos) const
     {
-        return _val(pos);
+        if ((! _isFrontier) || (pos < _frontierPos)) return _depth.getConstRefDefault(pos,0);
+
+        unsigned depth(_frontierDepth);
+        for (pos_t i(_frontierPos+1); i<=pos; ++i)
+        {
+            if (depth == 0) break;
+            depth -= _rangeEndCount.getConstRefDefault(i,0);
+        }
+        return depth;
     }
 
+    /// increment range [pos,pos+posRange) by one
     void
-    inc(const pos_t pos)
+    inc(pos_t pos,
+        const unsigned posRange = 1)
     {
-        _inc(pos,1);
+        assert(posRange>=1);
+        const pos_t endPos(pos+posRange);
+
+        if (! _isFrontier)
+        {
+            _isFrontier = true;
+            _frontierPos = pos;
+            _frontierDepth = 0;
+        }
+        else if (pos > _frontierPos)
+        {
+            advanceFrontier(pos);
+        }
+
+        if (pos < _frontierPos)
+        {
+            const pos_t behindEndPos(std::min(endPos,_frontierPos));
+            for (; pos<behindEndPos; ++pos) _depth.getRef(pos)++;
+            if (endPos <= _frontierPos) return;
+        }
+
+        assert(pos == _frontierPos);
+        _frontierDepth++;
+        _rangeEndCount.getRef(endPos)++;
     }
 
     void
     clear_pos(const pos_t pos)
     {
-        _clear(pos);
+        if (_isFrontier && (pos >= _frontierPos)) advanceFrontier(pos+1);
+        if (_depth.isKeyPresent(pos)) _depth.erase(pos);
     }
 
     /// return true if buffered depth exceeds depth in [begin,end]
@@ -97,12 +150,92 @@ struct depth_buffer : public depth_buffer_base
                      const unsigned depth) const
     {
         assert(begin <= end);
-        for (pos_t i(begin); i<=end; ++i)
+        return isAnyRangeDepth(begin, end, [&](const unsigned posDepth)
+        {
+            return (posDepth >= depth);
+        });
+    }
+
+    /// add the depth of each position in [begin,end] to the corresponding element of rangeDepth
+    void
+    add_range_depth(
+        const pos_t begin,
+        const pos_t end,
+        std::vector<unsigned>& rangeDepth) const
+    {
+        assert(begin <= end);
+        assert(rangeDepth.size() == static_cast<size_t>(end-begin+1));
+        auto rangeIter(rangeDepth.begin());
+        isAnyRangeDepth(begin, end, [&](const unsigned posDepth)
+        {
+            *rangeIter += posDepth;
+            ++rangeIter;
+            return false;
+        });
+    }
+
+private:
+    /// write out depth for all positions up to newFrontierPos, and move the frontier there
+    void
+    advanceFrontier(const pos_t newFrontierPos)
+    {
+        assert(newFrontierPos > _frontierPos);
+        unsigned depth(_frontierDepth);
+        for (pos_t pos(_frontierPos); pos<newFrontierPos; ++pos)
+        {
+            // all ranges ahead of the frontier end by the time depth returns to zero,
+            // so any remaining zero-depth positions can be skipped:
+            if (depth == 0) break;
+            _depth.getRef(pos) = depth;
+            const pos_t nextPos(pos+1);
+            if (_rangeEndCount.isKeyPresent(nextPos))
+            {
+                depth -= _rangeEndCount.getConstRef(nextPos);
+                _rangeEndCount.erase(nextPos);
+            }
+        }
+        _frontierPos = newFrontierPos;
+        _frontierDepth = depth;
+    }
+
+    /// call func with the depth of each position in [begin,end] in order, stopping as soon as func returns true
+    ///
+    /// \return true if func returned true for any position
+    template <typename Func>
+    bool
+    isAnyRangeDepth(
+        pos_t pos,
+        const pos_t end,
+        Func func) const
+    {
+        const pos_t behindEndPos(_isFrontier ? std::min(end+1,_frontierPos) : (end+1));
+        for (; pos<behindEndPos; ++pos)
+        {
+            if (func(_depth.getConstRefDefault(pos,0))) return true;
+        }
+        if (pos > end) return false;
+
+        unsigned depth(_frontierDepth);
+        for (pos_t i(_frontierPos); i<=end; ++i)
         {
-            if (val(i) >= depth) return true;
+            if (i > _frontierPos) depth -= _rangeEndCount.getConstRefDefault(i,0);
+            if ((i >= pos) && func(depth)) return true;
         }
         return false;
     }
+
+    /// depth at positions behind the frontier
+    RangeMap<pos_t,unsigned> _depth;
+
+    /// count of ranges ending at each position ahead of the frontier, the range end is the first position not
+    /// covered by the range
+    RangeMap<pos_t,unsigned> _rangeEndCount;
+
+    bool _isFrontier = false;
+    pos_t _frontierPos = 0;
+
+    /// depth at the frontier position
+    unsigned _frontierDepth = 0;
 };
 
 
@@ -38,9 +38,9 @@ add_alignment_to_depth_buffer(
 
     for (const path_segment& ps : apath)
     {
-        if ( is_segment_align_match(ps.type) )
+        if ( is_segment_align_match(ps.type) && (ps.length > 0) )
         {
-            for (unsigned j(0); j<ps.length; ++j) db.inc(ref_head_pos+static_cast<pos_t>(j));
+            db.inc(ref_head_pos,ps.length);
         }
 
         if ( is_segment_type_ref_length(ps.type) ) ref_head_pos += ps.length;
@@ -0,0 +1,49 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#include "blt_util/exact_test_util.hh"
+
+#include "boost/math/special_functions/gamma.hpp"
+
+#include <vector>
+
+
+
+double
+log_factorial(const unsigned n)
+{
+    static thread_local std::vector<double> logFactorialTable;
+
+    if (n >= logFactorialTable.size())
+    {
+        static const unsigned minTableSize(1024);
+        const unsigned oldSize(logFactorialTable.size());
+        const unsigned newSize(std::max(n+1, std::max(minTableSize, 2*oldSize)));
+        logFactorialTable.resize(newSize);
+        for (unsigned i(oldSize); i<newSize; ++i)
+        {
+            logFactorialTable[i] = boost::math::lgamma(static_cast<double>(i)+1.);
+        }
+    }
+    return logFactorialTable[n];
+}
@@ -0,0 +1,344 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+/// Shared probability mass function kernels for the exact binomial and fisher tests
+///
+/// Tail probabilities are summed from a single log-factorial based pmf evaluation, with each following term
+/// found from the previous term by the pmf ratio. Summation always runs away from the distribution mode, so
+/// that it can stop as soon as the remaining terms can no longer change the sum.
+///
+
+#pragma once
+
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+
+
+/// \brief Natural log of n!
+///
+/// Values are read from a per-thread table, which is extended as required to cover \p n
+double
+log_factorial(const unsigned n);
+
+
+/// \brief Natural log of the binomial coefficient (n choose k)
+inline
+double
+log_choose(
+    const unsigned n,
+    const unsigned k)
+{
+    assert(k <= n);
+    return log_factorial(n) - log_factorial(k) - log_factorial(n-k);
+}
+
+
+
+/// \brief pmf of the binomial distribution B(n_trials,p), where 0 < p < 1
+struct binomial_pmf
+{
+    binomial_pmf(
+        const double p,
+        const unsigned n_trials)
+        : _n(n_trials),
+          _logP(std::log(p)),
+          _logQ(std::log1p(-p)),
+          _odds(p/(1.-p))
+    {
+        assert((p>0.) && (p<1.));
+        _mode = std::min(_n, static_cast<unsigned>(std::floor((_n+1)*p)));
+    }
+
+    unsigned support_begin() const
+    {
+        return 0;
+    }
+
+    unsigned support_end() const
+    {
+        return _n;
+    }
+
+    /// pmf is non-decreasing up to the mode and non-increasing after it
+    unsigned mode() const
+    {
+        return _mode;
+    }
+
+    double
+    log_pmf(const unsigned k) const
+    {
+        return log_choose(_n,k) + k*_logP + (_n-k)*_logQ;
+    }
+
+    /// ratio pmf(k+1)/pmf(k)
+    double
+    up_ratio(const unsigned k) const
+    {
+        return (static_cast<double>(_n-k)/(k+1))*_odds;
+    }
+
+    /// ratio pmf(k-1)/pmf(k)
+    double
+    down_ratio(const unsigned k) const
+    {
+        return (static_cast<double>(k)/(_n-k+1))/_odds;
+    }
+
+private:
+    unsigned _n;
+    unsigned _mode;
+    double _logP;
+    double _logQ;
+    double _odds;
+};
+
+
+
+/// \brief pmf of the hypergeometric distribution
+///
+/// This is the distribution of the number of defective elements obtained when drawing \p n_sample elements
+/// without replacement from an urn of \p n_total elements, of which \p n_defective are defective.
+struct hypergeometric_pmf
+{
+    hypergeometric_pmf(
+        const unsigned n_defective,
+        const unsigned n_sample,
+        const unsigned n_total)
+        : _r(n_defective),
+          _n(n_sample),
+          _N(n_total),
+          _begin(((_r+_n)>_N) ? (_r+_n-_N) : 0),
+          _end(std::min(_r,_n)),
+          _logNorm(log_choose(_N,_n))
+    {
+        assert((_r <= _N) && (_n <= _N));
+        const uint64_t mode((static_cast<uint64_t>(_n)+1)*(static_cast<uint64_t>(_r)+1)/(static_cast<uint64_t>(_N)+2));
+        _mode = std::max(_begin, std::min(_end, static_cast<unsigned>(mode)));
+    }
+
+    unsigned support_begin() const
+    {
+        return _begin;
+    }
+
+    unsigned support_end() const
+    {
+        return _end;
+    }
+
+    /// pmf is non-decreasing up to the mode and non-increasing after it
+    unsigned mode() const
+    {
+        return _mode;
+    }
+
+    double
+    log_pmf(const unsigned k) const
+    {
+        return log_choose(_r,k) + log_choose(_N-_r,_n-k) - _logNorm;
+    }
+
+    /// ratio pmf(k+1)/pmf(k)
+    double
+    up_ratio(const unsigned k) const
+    {
+        return (static_cast<double>(_r-k)*(_n-k))/(static_cast<double>(k+1)*(_N-_r-_n+k+1));
+    }
+
+    /// ratio pmf(k-1)/pmf(k)
+    double
+    down_ratio(const unsigned k) const
+    {
+        return (static_cast<double>(k)*(_N-_r-_n+k))/(static_cast<double>(_r-k+1)*(_n-k+1));
+    }
+
+private:
+    unsigned _r;
+    unsigned _n;
+    unsigned _N;
+    unsigned _begin;
+    unsigned _end;
+    unsigned _mode;
+    double _logNorm;
+};
+
+
+
+/// \brief Sum pmf terms from \p begin outward to \p end, inclusive
+///
+/// The summation direction must lead away from the distribution mode, so that terms are non-increasing. Summation
+/// stops once the remaining terms can no longer change the sum, which is bounded using the log-concavity of the
+/// binomial and hypergeometric distributions. Summation also stops as soon as the sum exceeds \p exit_sum, for
+/// tests which only need to know whether a tail probability is above a threshold.
+template <typename Pmf>
+double
+sum_pmf_outward(
+    const Pmf& pmf,
+    const unsigned begin,
+    const unsigned end,
+    const double exit_sum = std::numeric_limits<double>::infinity())
+{
+    const bool is_up(begin <= end);
+    assert((begin == end) || (is_up ? (begin >= pmf.mode()) : (begin <= pmf.mode())));
+
+    double term(std::exp(pmf.log_pmf(begin)));
+    double sum(term);
+    for (unsigned k(begin); k != end; )
+    {
+        if (sum > exit_sum) break;
+        const double ratio(is_up ? pmf.up_ratio(k) : pmf.down_ratio(k));
+        if (ratio < 1.)
+        {
+            // all remaining terms together are no more than term*ratio/(1-ratio):
+            if ((term*ratio) <= ((1.-ratio)*sum*(DBL_EPSILON/4.))) break;
+        }
+        term *= ratio;
+        sum += term;
+        if (is_up) k++;
+        else       k--;
+    }
+    return sum;
+}
+
+
+
+/// \brief Sum of the pmf over the interval [\p begin, \p end]
+///
+/// \param exit_sum Summation may stop as soon as the sum is known to exceed this value
+template <typename Pmf>
+double
+sum_pmf_interval(
+    const Pmf& pmf,
+    unsigned begin,
+    unsigned end,
+    const double exit_sum = std::numeric_limits<double>::infinity())
+{
+    begin = std::max(begin, pmf.support_begin());
+    end = std::min(end, pmf.support_end());
+    if (begin > end) return 0.;
+
+    const unsigned mode(pmf.mode());
+    if (end <= mode) return sum_pmf_outward(pmf, end, begin, exit_sum);
+    if (begin >= mode) return sum_pmf_outward(pmf, begin, end, exit_sum);
+
+    // the interval contains the mode, so sum the complement, which can always be summed outward:
+    double complement(0.);
+    if (begin > pmf.support_begin())
+    {
+        complement += sum_pmf_outward(pmf, begin-1, pmf.support_begin());
+    }
+    if (end < pmf.support_end())
+    {
+        complement += sum_pmf_outward(pmf, end+1, pmf.support_end());
+    }
+    return std::max(0., 1.-complement);
+}
+
+
+
+/// \brief Sum of all pmf terms no greater than pmf(\p k)
+///
+/// This is the p-value of a two-sided exact test. Terms other than \p k itself which are within rounding error of
+/// pmf(\p k) are included only if \p is_tie_included(q) is true for the term's position q, so that the caller can
+/// choose how ties are resolved.
+///
+/// \param exit_sum Summation may stop as soon as the sum is known to exceed this value
+template <typename Pmf, typename TieFunc>
+double
+sum_pmf_no_greater_than(
+    const Pmf& pmf,
+    const unsigned k,
+    const TieFunc& is_tie_included,
+    const double exit_sum = std::numeric_limits<double>::infinity())
+{
+    // relative error of log_pmf is far below this threshold for any supported count:
+    static const double log_tie_tolerance(1e-8);
+    const double log_cutoff(pmf.log_pmf(k));
+    auto is_below_cutoff = [&](const unsigned q)
+    {
+        return ((pmf.log_pmf(q)-log_cutoff) < -log_tie_tolerance);
+    };
+
+    // add term q if it is tied with the cutoff and the tie is included, return false if the term is above the cutoff
+    double sum(0.);
+    auto add_tie = [&](const unsigned q)
+    {
+        const double log_term(pmf.log_pmf(q));
+        if ((log_term-log_cutoff) > log_tie_tolerance) return false;
+        if ((q == k) || is_tie_included(q)) sum += std::exp(log_term);
+        return true;
+    };
+
+    const unsigned mode(pmf.mode());
+
+    // lower tail, [support_begin, mode] is non-decreasing so the terms below the cutoff are a prefix, which may be
+    // followed by tied terms:
+    unsigned tie_begin(pmf.support_begin());
+    if (is_below_cutoff(pmf.support_begin()))
+    {
+        unsigned lo(pmf.support_begin());
+        unsigned hi(mode+1);
+        while ((lo+1) < hi)
+        {
+            const unsigned mid(lo+(hi-lo)/2);
+            if (is_below_cutoff(mid)) lo = mid;
+            else                      hi = mid;
+        }
+        sum += sum_pmf_outward(pmf, lo, pmf.support_begin(), exit_sum);
+        tie_begin = hi;
+    }
+    for (unsigned q(tie_begin); q <= mode; ++q)
+    {
+        if (! add_tie(q)) break;
+    }
+
+    // upper tail, (mode, support_end] is non-increasing so the terms below the cutoff are a suffix, which may be
+    // preceded by tied terms:
+    if (mode < pmf.support_end())
+    {
+        unsigned tie_end(pmf.support_end());
+        if (is_below_cutoff(pmf.support_end()))
+        {
+            unsigned lo(mode);
+            unsigned hi(pmf.support_end());
+            while ((lo+1) < hi)
+            {
+                const unsigned mid(lo+(hi-lo)/2);
+                if (is_below_cutoff(mid)) hi = mid;
+                else                      lo = mid;
+            }
+            sum += sum_pmf_outward(pmf, hi, pmf.support_end(), exit_sum-sum);
+            tie_end = lo;
+        }
+        for (unsigned q(tie_end); q > mode; --q)
+        {
+            if (! add_tie(q)) break;
+        }
+    }
+    return std::min(1., sum);
+}
@@ -47,48 +47,94 @@ getMannWhitneyZScore(
 
 
 
-double
+void
 fastRanksum::
-getExpectedCategory2Value() const
+merge(
+    const fastRanksum& rhs,
+    const bool isFlipObservationCategories)
 {
-    double R2 = 0;
-    unsigned N2 = 0;
-
-    for (unsigned i=0; i<_obs.size(); i++)
+    if (rhs._obsBegin >= rhs._obsEnd) return;
+    if (rhs._obsEnd > _obs.size()) _obs.resize(rhs._obsEnd);
+    for (unsigned obsIndex(rhs._obsBegin); obsIndex < rhs._obsEnd; ++obsIndex)
     {
-        if (_obs[i].empty()) continue;
-        const unsigned c2 = _obs[i].c2;
-        R2 += i*c2;
-        N2 += c2;
+        _obs[obsIndex].merge(rhs._obs[obsIndex], isFlipObservationCategories);
     }
-
-    if (N2==0) return 0;
-    return R2/N2;
+    if (_obsBegin >= _obsEnd)
+    {
+        _obsBegin = rhs._obsBegin;
+        _obsEnd = rhs._obsEnd;
+    }
+    else
+    {
+        _obsBegin = std::min(_obsBegin, rhs._obsBegin);
+        _obsEnd = std::max(_obsEnd, rhs._obsEnd);
+    }
+    rebuildCounts();
 }
 
 
 
-double
+void
 fastRanksum::
-get_z_stat() const
+resize(const unsigned size)
 {
-    double R1 = 0;
-    double R2 = 0;
-    int N1 = 0;
-    int N2 = 0;
+    _obs.resize(size);
+    rebuildCounts();
+}
 
-    for (const auto& robs : _obs)
+
+
+void
+fastRanksum::
+rebuildCounts()
+{
+    const unsigned size(_obs.size());
+    _c1Tree.assign(size, 0);
+    _c2Tree.assign(size, 0);
+    _N1 = 0;
+    _N2 = 0;
+    _twiceU1 = 0;
+    _category2Sum = 0;
+
+    for (unsigned i=_obsBegin; i<_obsEnd; i++)
     {
+        const auto& robs(_obs[i]);
         if (robs.empty()) continue;
-        const int obs1 = robs.c1;
-        const int obs2 = robs.c2;
-        double rank_weight = (2*(N1+N2+1) + (obs1+obs2)-1)/2.0;
-        R1 += rank_weight*obs1;
-        R2 += rank_weight*obs2;
-        N1 += obs1;
-        N2 += obs2;
+
+        // each category 1 observation in this bin outranks all lower category 2 observations, and ties
+        // with the category 2 observations in the same bin:
+        _twiceU1 += static_cast<uint64_t>(robs.c1)*(2*_N2 + robs.c2);
+        _N1 += robs.c1;
+        _N2 += robs.c2;
+        _category2Sum += static_cast<uint64_t>(i)*robs.c2;
+
+        // build each tree in O(size) by pushing every node total to its parent:
+        _c1Tree[i] += robs.c1;
+        _c2Tree[i] += robs.c2;
     }
 
+    for (unsigned index(1); index <= size; ++index)
+    {
+        const unsigned parent(index + (index & (~index+1)));
+        if (parent > size) continue;
+        _c1Tree[parent-1] += _c1Tree[index-1];
+        _c2Tree[parent-1] += _c2Tree[index-1];
+    }
+}
+
+
+
+double
+fastRanksum::
+get_z_stat() const
+{
+    // rank sums follow from U1 and U1+U2 = N1*N2:
+    const double U1(_twiceU1/2.);
+    const double R1(U1 + (static_cast<double>(_N1)*(_N1+1))/2.);
+    const double R2((static_cast<double>(_N1)*_N2 - U1) + (static_cast<double>(_N2)*(_N2+1))/2.);
+    const int N1(_N1);
+    const int N2(_N2);
+
 #if 1
     // this performs the equivalent of the z-score computation on U, even though U, mean(U), var(U)
     // are not directly enumerated
@@ -103,7 +149,6 @@ get_z_stat() const
     }
 #else
     // for verification purposes, you can actually enumerate U and U stats to get the ?always same? answer here:
-    const double U1 = R1 - (N1*(N1+1))/2.;
     const double U2 = R2 - (N2*(N2+1))/2.;
     const double U = std::min(U1,U2);
 
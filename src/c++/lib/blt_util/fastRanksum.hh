@@ -23,8 +23,10 @@
 
 #pragma once
 
-#include <vector>
+#include <algorithm>
+#include <cstdint>
 #include <iosfwd>
+#include <vector>
 
 
 /// Calculates the Mann-Whitney rank-sum statistic from two populations with
@@ -33,6 +35,11 @@
 /// this is a variation on the original ranksum class which only accepts small unsigned
 /// observations for better performance.
 ///
+/// The U statistic of category 1 is updated as each observation is added, using prefix counts of
+/// each category held in a Fenwick tree over the observation values, so that get_z_stat() is O(1)
+/// and add_observation() is O(log(max observation)). The range of occupied histogram bins is tracked
+/// so that clear() only resets these bins while keeping the histogram storage for reuse.
+///
 struct fastRanksum
 {
     /// insert an observation, indicating membership in category 1 or 2
@@ -41,38 +48,111 @@ struct fastRanksum
         const bool isCategory1,
         const unsigned obs)
     {
-        if (obs >= _obs.size()) _obs.resize(obs+16);
-        _obs[obs].inc(isCategory1);
+        if (obs >= _obs.size()) resize(obs+16);
+        ranksumObs& robs(_obs[obs]);
+        if (isCategory1)
+        {
+            // the new observation outranks each lower category 2 observation, with ties counted as half:
+            _twiceU1 += 2*getCountBelow(_c2Tree, obs) + robs.c2;
+            addCount(_c1Tree, obs);
+            _N1++;
+        }
+        else
+        {
+            // each higher category 1 observation outranks the new observation, with ties counted as half:
+            _twiceU1 += 2*(_N1-getCountBelow(_c1Tree, obs+1)) + robs.c1;
+            addCount(_c2Tree, obs);
+            _N2++;
+            _category2Sum += obs;
+        }
+        robs.inc(isCategory1);
+
+        if (_obsBegin >= _obsEnd)
+        {
+            _obsBegin = obs;
+            _obsEnd = obs+1;
+        }
+        else
+        {
+            _obsBegin = std::min(_obsBegin, obs);
+            _obsEnd = std::max(_obsEnd, obs+1);
+        }
     }
 
     void
     merge(
         const fastRanksum& rhs,
-        const bool isFlipObservationCategories = false)
-    {
-        if (rhs._obs.size() > _obs.size()) _obs.resize(rhs._obs.size());
-        const unsigned obsCount(_obs.size());
-        for (unsigned obsIndex(0); obsIndex < obsCount; ++obsIndex)
-        {
-            _obs[obsIndex].merge(rhs._obs[obsIndex], isFlipObservationCategories);
-        }
-    }
+        const bool isFlipObservationCategories = false);
 
     /// \return z-score of the Mann-Whitney U statistic
     double get_z_stat() const;
 
     /// \return average value of category 2
-    double getExpectedCategory2Value() const;
+    double getExpectedCategory2Value() const
+    {
+        if (_N2==0) return 0;
+        return static_cast<double>(_category2Sum)/_N2;
+    }
 
     void
     clear()
     {
-        _obs.resize(0);
+        if (_obsBegin < _obsEnd)
+        {
+            std::fill(_obs.begin()+_obsBegin, _obs.begin()+_obsEnd, ranksumObs());
+
+            // tree nodes covering the occupied bins all lie at or above the first occupied bin:
+            std::fill(_c1Tree.begin()+_obsBegin, _c1Tree.end(), 0);
+            std::fill(_c2Tree.begin()+_obsBegin, _c2Tree.end(), 0);
+        }
+        _obsBegin = 0;
+        _obsEnd = 0;
+        _N1 = 0;
+        _N2 = 0;
+        _twiceU1 = 0;
+        _category2Sum = 0;
     }
 
 
 private:
 
+    /// resize the histogram to hold observations in [0,size), rebuilding all derived counts
+    void
+    resize(const unsigned size);
+
+    /// rebuild the Fenwick trees and U statistic from the histogram
+    void
+    rebuildCounts();
+
+    /// add one observation of value obs to a Fenwick tree
+    static
+    void
+    addCount(
+        std::vector<unsigned>& tree,
+        const unsigned obs)
+    {
+        const unsigned size(tree.size());
+        for (unsigned index(obs+1); index <= size; index += (index & (~index+1)))
+        {
+            tree[index-1]++;
+        }
+    }
+
+    /// \return count of observations less than obs in a Fenwick tree
+    static
+    unsigned
+    getCountBelow(
+        const std::vector<unsigned>& tree,
+        const unsigned obs)
+    {
+        unsigned count(0);
+        for (unsigned index(obs); index > 0; index -= (index & (~index+1)))
+        {
+            count += tree[index-1];
+        }
+        return count;
+    }
+
     struct ranksumObs
     {
         ranksumObs() :
@@ -118,4 +198,22 @@ private:
     };
 
     std::vector<ranksumObs> _obs;
+
+    /// Fenwick trees of the category 1 and 2 observation counts, with the same size as _obs
+    std::vector<unsigned> _c1Tree;
+    std::vector<unsigned> _c2Tree;
+
+    /// range of histogram bins which may be occupied, [_obsBegin,_obsEnd)
+    unsigned _obsBegin = 0;
+    unsigned _obsEnd = 0;
+
+    /// total observations of each category
+    unsigned _N1 = 0;
+    unsigned _N2 = 0;
+
+    /// twice the Mann-Whitney U statistic of category 1, so that ties can be counted exactly
+    uint64_t _twiceU1 = 0;
+
+    /// sum of all category 2 observation values
+    uint64_t _category2Sum = 0;
 };
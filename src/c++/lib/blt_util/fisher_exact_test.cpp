@@ -23,12 +23,11 @@
 ///
 
 #include "fisher_exact_test.hh"
+#include "blt_util/exact_test_util.hh"
+
+#include "boost/math/distributions/hypergeometric.hpp"
 
-#include <boost/math/distributions/hypergeometric.hpp>
-#include <algorithm>
 
-using namespace boost::math;
-using namespace std;
 
 double
 fisher_exact_test_pval_2x2(
@@ -48,36 +47,32 @@ fisher_exact_test_pval_2x2(
      */
 
     // http://mathworld.wolfram.com/FishersExactTest.html
-    unsigned N = a + b + c + d;  // total number of elements in urn
-    unsigned r = a + c;          // total number of defective elements
-    unsigned n = a + b;          // total number of elements we sampled
-    unsigned k = a;              // number of defective elements we got in our sample
+    const unsigned N = a + b + c + d;  // total number of elements in urn
+    const unsigned r = a + c;          // total number of defective elements
+    const unsigned n = a + b;          // total number of elements we sampled
+    const unsigned k = a;              // number of defective elements we got in our sample
 
-    unsigned max_for_k = min(r, n);   // maximum number of defective elements we can draw in a sample of size n
-    unsigned min_for_k = (unsigned )max(0, int(r + n - N)); // once we're out of good elements, the remaining ones
-    // are defective.
+    const hypergeometric_pmf hgd(r, n, N);
 
+    // for the one-tailed tests, we exclude tails of the distribution
+    // by changing the limits of summation
     if (type == FISHER_EXACT::LESS)
     {
-        max_for_k = a;
+        return sum_pmf_interval(hgd, hgd.support_begin(), k);
     }
-
-    if (type == FISHER_EXACT::GREATER)
+    else if (type == FISHER_EXACT::GREATER)
     {
-        min_for_k = a;
+        return sum_pmf_interval(hgd, k, hgd.support_end());
     }
 
-    hypergeometric_distribution<> hgd(r, n, N);
-
-    // for the two-tailed test, sum over both tails where p <= p_cutoff
-    // for the one-tailed tests, we have excluded tails of the distribution
-    // by changing the limits of summation above
-    double cutoff = ((type == FISHER_EXACT::TWOTAILED) ? pdf(hgd, k) : 1.0 );
-    double p = 0;
-    for (unsigned q = min_for_k; q <= max_for_k; ++q)
+    // for the two-tailed test, sum over both tails where p <= p_cutoff, resolving near-ties with the boost pdf as
+    // the original implementation compared every term this way:
+    const boost::math::hypergeometric_distribution<> boostHgd(r, n, N);
+    double boostCutoff(-1.);
+    auto isTieIncluded = [&](const unsigned q)
     {
-        double _p = pdf(hgd, q);
-        if (_p <= cutoff) p += _p;
-    }
-    return p;
+        if (boostCutoff < 0.) boostCutoff = pdf(boostHgd, k);
+        return (pdf(boostHgd, q) <= boostCutoff);
+    };
+    return sum_pmf_no_greater_than(hgd, k, isTieIncluded);
 }
@@ -38,7 +38,7 @@ enum class FISHER_EXACT : unsigned int
  *        C             a      b
  *        D             c      d
  *
- * We do a two-tailed test.
+ * We do a two-tailed test by default.
  */
 double
 fisher_exact_test_pval_2x2(
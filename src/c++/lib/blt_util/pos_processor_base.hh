@@ -43,6 +43,16 @@ struct pos_processor_base
         process_pos(stage_no,pos);
     }
 
+    /// \return true if the processor currently has no position dependent work to do
+    ///
+    /// While this is true every check_process_pos() call is a no-op, so the caller may advance over any
+    /// number of positions without signaling them.
+    bool
+    is_skip_process_pos() const
+    {
+        return _is_skip_process_pos;
+    }
+
     /// Execute position dependent logic associated with a particular stage
     /// in a positional processing pipeline.
     ///
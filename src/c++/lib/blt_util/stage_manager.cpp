@@ -167,10 +167,15 @@ reset()
     {
         if (_report_range.is_end_pos)
         {
-            pos_t final_pos(_report_range.end_pos);
-            for (pos_t i(_max_pos+1); i<final_pos; ++i)
+            const pos_t final_pos(_report_range.end_pos);
+            if (final_pos > (_max_pos+1))
             {
-                process_pos(i);
+                if (! _is_head_pos)
+                {
+                    _head_pos = _max_pos+1;
+                    _is_head_pos = true;
+                }
+                process_pos(final_pos-1);
             }
         }
     }
@@ -181,9 +186,14 @@ reset()
         //
         _min_pos=_report_range.begin_pos;
         const pos_t end(_report_range.end_pos);
-        for (pos_t i(_report_range.begin_pos); i<end; ++i)
+        if (end > _min_pos)
         {
-            process_pos(i);
+            if (! _is_head_pos)
+            {
+                _head_pos = _min_pos;
+                _is_head_pos = true;
+            }
+            process_pos(end-1);
         }
     }
     finish_process_pos();
@@ -207,7 +217,15 @@ handle_new_pos_value(const pos_t pos)
         {
             _min_pos = _report_range.begin_pos;
         }
-        for (pos_t i(_min_pos); i<=pos; ++i) process_pos(i);
+        if (pos >= _min_pos)
+        {
+            if (! _is_head_pos)
+            {
+                _head_pos = _min_pos;
+                _is_head_pos = true;
+            }
+            process_pos(pos);
+        }
         _is_first_pos_set = true;
     }
 
@@ -291,6 +309,7 @@ process_pos(const pos_t pos)
     {
         for (pos_t p(_head_pos); p<=pos; ++p)
         {
+            if (_ppb.is_skip_process_pos()) break;
             for (unsigned s(0); s<_stage_size; ++s)
             {
                 const pos_t stage_pos(p-static_cast<pos_t>(_stage_pos_ptr->operator[](s).first));
@@ -303,12 +322,15 @@ process_pos(const pos_t pos)
                 _ppb.check_process_pos(_stage_pos_ptr->operator[](s).second,stage_pos);
             }
         }
+        skip_minpos(pos);
         _is_any_minpos=get_is_any_minpos(_is_minpos,_stage_size);
     }
     else
     {
         for (pos_t p(_head_pos); p<=pos; ++p)
         {
+            // all stages of all remaining positions are no-ops for an empty pos processor, so jump to the end:
+            if (_ppb.is_skip_process_pos()) break;
             for (unsigned s(0); s<_stage_size; ++s)
             {
                 const pos_t stage_pos(p-static_cast<pos_t>(_stage_pos_ptr->operator[](s).first));
@@ -323,6 +345,20 @@ process_pos(const pos_t pos)
 
 
 
+void
+stage_manager::
+skip_minpos(const pos_t pos)
+{
+    for (unsigned s(0); s<_stage_size; ++s)
+    {
+        const pos_t stage_pos(pos-static_cast<pos_t>(_stage_pos_ptr->operator[](s).first));
+        if (stage_pos<_min_pos) break;
+        if ((_is_minpos[s] != 0) && (stage_pos>=_minpos[s])) _is_minpos[s]=0;
+    }
+}
+
+
+
 void
 stage_manager::
 finish_process_pos()
@@ -222,9 +222,19 @@ private:
     // signaling all stage processing steps to pos_process_base along
     // the way:
     //
+    //
+    // if the pos processor reports that it has no work to do, the
+    // remaining positions up to pos are skipped in a single step:
+    //
     void
     process_pos(const pos_t pos);
 
+    // update stage minimum position bookkeeping for positions up to
+    // pos which are skipped without signaling the pos processor
+    //
+    void
+    skip_minpos(const pos_t pos);
+
     // advances head position until all remaining stage processing is
     // complete based on the current head position value.
     //
@@ -0,0 +1,58 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/FlatHashMap.hh"
+
+#include <map>
+
+
+BOOST_AUTO_TEST_SUITE( test_FlatHashMap )
+
+BOOST_AUTO_TEST_CASE( test_FlatHashMap )
+{
+    FlatHashMap<int,unsigned> fhm(4);
+    std::map<int,unsigned> expected;
+
+    // use enough keys to force several capacity increases:
+    for (int index(0); index < 5000; ++index)
+    {
+        const int key((index * 37) % 1013);
+        fhm.getRef(key) += index;
+        expected[key] += index;
+    }
+
+    BOOST_REQUIRE_EQUAL(fhm.size(), expected.size());
+
+    std::map<int,unsigned> result;
+    fhm.forEach([&](const int key, const unsigned value)
+    {
+        BOOST_REQUIRE_EQUAL(result.count(key), 0u);
+        result[key] = value;
+    });
+    BOOST_REQUIRE(result == expected);
+
+    fhm.clear();
+    BOOST_REQUIRE(fhm.empty());
+    BOOST_REQUIRE_EQUAL(fhm.getRef(3), 0u);
+    BOOST_REQUIRE_EQUAL(fhm.size(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "TextBuffer.hh"
+
+#include <cstdint>
+
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( test_TextBuffer )
+
+
+BOOST_AUTO_TEST_CASE( test_TextBuffer_integers )
+{
+    const std::vector<int64_t> testValues = {0, 1, -1, 9, 10, 99, 100, -100, 101, 12345, -987654321,
+                                             std::numeric_limits<int32_t>::max(),
+                                             std::numeric_limits<int64_t>::max(),
+                                             std::numeric_limits<int64_t>::min()
+                                            };
+
+    TextBuffer buffer;
+    std::ostringstream oss;
+    for (const int64_t val : testValues)
+    {
+        buffer.appendInt(val);
+        buffer.append(',');
+        oss << val << ',';
+    }
+    buffer.appendUnsigned(std::numeric_limits<uint64_t>::max());
+    oss << std::numeric_limits<uint64_t>::max();
+
+    BOOST_REQUIRE_EQUAL(buffer.str(), oss.str());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_TextBuffer_doubles )
+{
+    std::vector<double> testValues = {0., -0., 1., -1., 0.5, 999999., 1000000., -999999., 1234567.,
+                                      0.1, 1e-5, 1e-300, 1e300, 123456.5, 3.14159265,
+                                      std::numeric_limits<double>::quiet_NaN(),
+                                      std::numeric_limits<double>::infinity()
+                                     };
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> dis(-2e6, 2e6);
+    for (unsigned i(0); i<1000; ++i)
+    {
+        const double val(dis(gen));
+        testValues.push_back(val);
+        testValues.push_back(std::round(val));
+    }
+
+    TextBuffer buffer;
+    std::ostringstream oss;
+    for (const double val : testValues)
+    {
+        buffer.appendDouble(val);
+        buffer.append(',');
+        oss << val << ',';
+    }
+    BOOST_REQUIRE_EQUAL(buffer.str(), oss.str());
+
+    buffer.clear();
+    std::ostringstream ossPrecision;
+    for (const double val : testValues)
+    {
+        for (const int precision : {1, 3, 5})
+        {
+            buffer.appendDouble(val, precision);
+            buffer.append(',');
+            ossPrecision << std::setprecision(precision) << val << ',';
+        }
+    }
+    BOOST_REQUIRE_EQUAL(buffer.str(), ossPrecision.str());
+
+    buffer.clear();
+    std::ostringstream ossFixed;
+    for (const double val : testValues)
+    {
+        for (const int precision : {0, 1, 3})
+        {
+            buffer.appendFixed(val, precision);
+            buffer.append(',');
+            ossFixed << std::fixed << std::setprecision(precision) << val << ',';
+        }
+    }
+    BOOST_REQUIRE_EQUAL(buffer.str(), ossFixed.str());
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_TextBuffer_flush )
+{
+    TextBuffer buffer(8);
+    buffer.append("abc");
+    buffer.append(std::string("def"));
+    BOOST_REQUIRE(not buffer.isFlushReady());
+    buffer.append("gh", 2);
+    BOOST_REQUIRE(buffer.isFlushReady());
+
+    std::ostringstream oss;
+    buffer.flush(oss);
+    BOOST_REQUIRE(buffer.empty());
+    BOOST_REQUIRE_EQUAL(oss.str(), "abcdefgh");
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "blt_util/WorkerThreadPool.hh"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( test_WorkerThreadPool )
+
+BOOST_AUTO_TEST_CASE( test_WorkerThreadPool_run )
+{
+    static const unsigned threadCount(4);
+    WorkerThreadPool pool(threadCount);
+    BOOST_REQUIRE_EQUAL(pool.getThreadCount(), threadCount);
+
+    // run several batches of varying size to check that the pool is correctly reused:
+    for (unsigned taskCount(0); taskCount < 50; ++taskCount)
+    {
+        std::vector<unsigned> taskRunCount(taskCount,0);
+        std::vector<unsigned> taskThreadIndex(taskCount,0);
+        pool.run(taskCount, [&](const unsigned taskIndex, const unsigned threadIndex)
+        {
+            taskRunCount[taskIndex]++;
+            taskThreadIndex[taskIndex] = threadIndex;
+        });
+
+        for (unsigned taskIndex(0); taskIndex < taskCount; ++taskIndex)
+        {
+            BOOST_REQUIRE_EQUAL(taskRunCount[taskIndex], 1u);
+            BOOST_REQUIRE_LT(taskThreadIndex[taskIndex], threadCount);
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_WorkerThreadPool_exception )
+{
+    WorkerThreadPool pool(3);
+
+    // the exception from the lowest task index should be rethrown after all other tasks complete:
+    static const unsigned taskCount(100);
+    std::vector<unsigned> taskRunCount(taskCount,0);
+    try
+    {
+        pool.run(taskCount, [&](const unsigned taskIndex, const unsigned)
+        {
+            taskRunCount[taskIndex]++;
+            if ((taskIndex % 10) == 7) throw std::runtime_error(std::to_string(taskIndex));
+        });
+        BOOST_FAIL("Expected exception from worker thread pool");
+    }
+    catch (const std::runtime_error& e)
+    {
+        BOOST_REQUIRE_EQUAL(std::string(e.what()), "7");
+    }
+
+    for (unsigned taskIndex(0); taskIndex < taskCount; ++taskIndex)
+    {
+        BOOST_REQUIRE_EQUAL(taskRunCount[taskIndex], 1u);
+    }
+
+    // check that the pool is still usable:
+    std::vector<unsigned> taskValue(taskCount,0);
+    pool.run(taskCount, [&](const unsigned taskIndex, const unsigned)
+    {
+        taskValue[taskIndex] = taskIndex;
+    });
+    for (unsigned taskIndex(0); taskIndex < taskCount; ++taskIndex)
+    {
+        BOOST_REQUIRE_EQUAL(taskValue[taskIndex], taskIndex);
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_WorkerThreadPool_serial )
+{
+    // a single thread pool runs all tasks in order on the calling thread:
+    WorkerThreadPool pool(1);
+    std::vector<unsigned> taskOrder;
+    pool.run(10, [&](const unsigned taskIndex, const unsigned threadIndex)
+    {
+        BOOST_REQUIRE_EQUAL(threadIndex, 0u);
+        taskOrder.push_back(taskIndex);
+    });
+    BOOST_REQUIRE_EQUAL(taskOrder.size(), 10u);
+    for (unsigned taskIndex(0); taskIndex < 10; ++taskIndex)
+    {
+        BOOST_REQUIRE_EQUAL(taskOrder[taskIndex], taskIndex);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -45,6 +45,15 @@ BOOST_AUTO_TEST_CASE( test_exact_binomial_pval )
 }
 
 
+BOOST_AUTO_TEST_CASE( test_exact_binomial_pval_ties )
+{
+    static const double tol(1e-8);
+
+    // P(X=0) and P(X=1) are equal for B(9,0.1), and both are at the mode. The two-tailed p-value keeps the original
+    // result, which excludes the tied P(X=0) term (R's binom.test includes it, giving 1):
+    BOOST_REQUIRE_CLOSE(get_binomial_twosided_exact_pval(0.1, 1, 9), 0.612579511, tol);
+}
+
 BOOST_AUTO_TEST_CASE( test_simple_binomial_test )
 {
     static const double alpha(0.01);
@@ -445,4 +454,13 @@ BOOST_AUTO_TEST_CASE( test_binomial_gte_min_count )
         BOOST_CHECK_EQUAL((unsigned )min_count_binomial_gte_exact(p_val, success_rate, trials), 1+exampledata[i][3]);
     }
 }
+
+BOOST_AUTO_TEST_CASE( test_binomial_gte_min_count_high_alpha )
+{
+    // for alpha > 0.5 the result of the original boost quantile implementation is kept, this can be one less than
+    // the R value, eg. 1 + qbinom(0.6, 10, 0.5, lower.tail = FALSE) is 6
+    BOOST_REQUIRE_EQUAL(min_count_binomial_gte_exact(0.6, 0.5, 10), 5.);
+    BOOST_REQUIRE_EQUAL(min_count_binomial_gte_exact(0.7, 0.5, 10), 4.);
+    BOOST_REQUIRE_EQUAL(min_count_binomial_gte_exact(0.9, 0.1, 100), 6.);
+}
 BOOST_AUTO_TEST_SUITE_END()
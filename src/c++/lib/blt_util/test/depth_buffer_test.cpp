@@ -89,6 +89,45 @@ BOOST_AUTO_TEST_CASE( test_depth_buffer_range )
     BOOST_REQUIRE(  db.is_range_ge_than(0,108,8));
 }
 
+BOOST_AUTO_TEST_CASE( test_depth_buffer_inc_range )
+{
+    // compare range insertion to single position insertion, including ranges added out of order:
+    static const unsigned rangeStart[] = { 100, 102, 102, 150, 101, 170, 130, 400 };
+    static const unsigned rangeSize[] = { 50, 3, 10, 30, 40, 1, 80, 5 };
+
+    depth_buffer db;
+    depth_buffer db_expect;
+    for (unsigned rangeIndex(0); rangeIndex<8; ++rangeIndex)
+    {
+        db.inc(rangeStart[rangeIndex], rangeSize[rangeIndex]);
+        for (unsigned i(0); i<rangeSize[rangeIndex]; ++i)
+        {
+            db_expect.inc(rangeStart[rangeIndex]+i);
+        }
+    }
+
+    // add_range_depth and single-position lookup each follow a different path over the buffer:
+    std::vector<unsigned> rangeDepth(351,1);
+    db.add_range_depth(90,440,rangeDepth);
+    for (unsigned i(90); i<=440; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(db.val(i),db_expect.val(i));
+        BOOST_REQUIRE_EQUAL(rangeDepth[i-90],db_expect.val(i)+1);
+    }
+    BOOST_REQUIRE_EQUAL(db.val(135),3u);
+    BOOST_REQUIRE(  db.is_range_ge_than(170,175,3));
+    BOOST_REQUIRE(! db.is_range_ge_than(171,175,3));
+
+    for (unsigned i(90); i<=140; ++i)
+    {
+        db.clear_pos(i);
+    }
+    BOOST_REQUIRE_EQUAL(db.val(140),0u);
+    BOOST_REQUIRE_EQUAL(db.val(141),2u);
+    BOOST_REQUIRE_EQUAL(db.val(402),1u);
+}
+
+
 BOOST_AUTO_TEST_CASE( test_depth_buffer_compressible_val )
 {
     depth_buffer_compressible db(get_db_compressible_test_pattern(8));
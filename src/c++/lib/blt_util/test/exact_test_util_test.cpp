@@ -0,0 +1,111 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "exact_test_util.hh"
+
+
+BOOST_AUTO_TEST_SUITE( exact_test_util )
+
+BOOST_AUTO_TEST_CASE( test_log_factorial )
+{
+    static const double tol(1e-10);
+
+    BOOST_REQUIRE_EQUAL(log_factorial(0), 0.);
+    BOOST_REQUIRE_EQUAL(log_factorial(1), 0.);
+    BOOST_REQUIRE_CLOSE(log_factorial(10), std::log(3628800.), tol);
+
+    // request a value well beyond the initial table size:
+    BOOST_REQUIRE_CLOSE(log_factorial(100000), std::lgamma(100001.), tol);
+    BOOST_REQUIRE_CLOSE(log_choose(50,20), std::log(47129212243960.), tol);
+}
+
+
+
+/// direct sum of the pmf over [begin,end]
+template <typename Pmf>
+static
+double
+directPmfSum(
+    const Pmf& pmf,
+    const unsigned begin,
+    const unsigned end)
+{
+    double sum(0);
+    for (unsigned k(begin); k<=end; ++k)
+    {
+        sum += std::exp(pmf.log_pmf(k));
+    }
+    return sum;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_sum_pmf_interval )
+{
+    static const double tol(1e-8);
+
+    const binomial_pmf bpmf(0.3, 40);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(bpmf, 0, 40), 1., tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(bpmf, 0, 5), directPmfSum(bpmf, 0, 5), tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(bpmf, 20, 40), directPmfSum(bpmf, 20, 40), tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(bpmf, 5, 20), directPmfSum(bpmf, 5, 20), tol);
+
+    const hypergeometric_pmf hpmf(30, 25, 80);
+    BOOST_REQUIRE_EQUAL(hpmf.support_begin(), 0u);
+    BOOST_REQUIRE_EQUAL(hpmf.support_end(), 25u);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(hpmf, 0, 25), 1., tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(hpmf, 0, 4), directPmfSum(hpmf, 0, 4), tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_interval(hpmf, 15, 25), directPmfSum(hpmf, 15, 25), tol);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_sum_pmf_early_exit )
+{
+    // summation can stop once the exit threshold is exceeded, but the partial sum must still exceed it:
+    const binomial_pmf bpmf(0.01, 1000);
+    const double fullSum(sum_pmf_interval(bpmf, 12, 1000));
+    const double exitSum(sum_pmf_interval(bpmf, 12, 1000, 0.1));
+    BOOST_REQUIRE_GT(fullSum, 0.1);
+    BOOST_REQUIRE_GT(exitSum, 0.1);
+    BOOST_REQUIRE_LE(exitSum, fullSum);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_sum_pmf_no_greater_than )
+{
+    static const double tol(1e-8);
+
+    auto isTieIncluded = [](const unsigned) { return true; };
+    auto isTieExcluded = [](const unsigned) { return false; };
+
+    // symmetric distribution with tied terms on either side of the mode, the tie predicate decides whether the
+    // tied term on the other side of the mode is included:
+    const hypergeometric_pmf hpmf(56, 108, 112);
+    BOOST_REQUIRE_CLOSE(sum_pmf_no_greater_than(hpmf, 53, isTieIncluded),
+                        directPmfSum(hpmf, 52, 53)+directPmfSum(hpmf, 55, 56), tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_no_greater_than(hpmf, 53, isTieExcluded),
+                        directPmfSum(hpmf, 52, 53)+directPmfSum(hpmf, 56, 56), tol);
+    BOOST_REQUIRE_CLOSE(sum_pmf_no_greater_than(hpmf, 54, isTieIncluded), 1., tol);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
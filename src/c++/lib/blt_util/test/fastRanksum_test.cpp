@@ -22,6 +22,9 @@
 #include "fastRanksum.hh"
 
 #include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
 
 
 BOOST_AUTO_TEST_SUITE( test_fastRanksum )
@@ -82,5 +85,108 @@ BOOST_AUTO_TEST_CASE( test_fastRanksum2 )
     }
 }
 
+BOOST_AUTO_TEST_CASE( test_fastRanksum_clear )
+{
+    // statistics should not be changed by observations added before clear():
+    fastRanksum r;
+    r.add_observation(true, 3);
+    r.add_observation(false, 200);
+    r.clear();
+    BOOST_REQUIRE_EQUAL(r.get_z_stat(), 0.);
+    BOOST_REQUIRE_EQUAL(r.getExpectedCategory2Value(), 0.);
+
+    fastRanksum r2;
+    for (unsigned obs(10); obs<20; ++obs)
+    {
+        r.add_observation(true, obs);
+        r2.add_observation(true, obs);
+    }
+    r.add_observation(false, 21);
+    r2.add_observation(false, 21);
+    r.add_observation(false, 22);
+    r2.add_observation(false, 22);
+
+    BOOST_REQUIRE_EQUAL(r.get_z_stat(), r2.get_z_stat());
+    BOOST_REQUIRE_EQUAL(r.getExpectedCategory2Value(), 21.5);
+}
+
+
+/// z-score of the Mann-Whitney U statistic enumerated over all observation pairs
+static
+double
+getPairwiseZStat(
+    const std::vector<std::pair<bool,unsigned>>& observations)
+{
+    double U1(0);
+    double N1(0);
+    double N2(0);
+    for (const auto& obs1 : observations)
+    {
+        if (! obs1.first)
+        {
+            N2++;
+            continue;
+        }
+        N1++;
+        for (const auto& obs2 : observations)
+        {
+            if (obs2.first) continue;
+            if (obs1.second > obs2.second) U1 += 1;
+            else if (obs1.second == obs2.second) U1 += 0.5;
+        }
+    }
+    const double U(std::min(U1, (N1*N2)-U1));
+    const double mean(N1*N2/2.0);
+    const double sd(std::sqrt(mean*(N1+N2+1)/6.0));
+    if (sd < 0.0001) return 0.;
+    return (U-mean)/sd;
+}
+
+
+BOOST_AUTO_TEST_CASE( test_fastRanksum_incremental )
+{
+    // the incrementally updated statistic should match full enumeration after each observation, including
+    // after histogram growth and clear():
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<unsigned> obsDist(0,40);
+    std::bernoulli_distribution categoryDist(0.3);
+
+    fastRanksum r;
+    for (unsigned trial(0); trial<3; ++trial)
+    {
+        std::vector<std::pair<bool,unsigned>> observations;
+        for (unsigned obsIndex(0); obsIndex<100; ++obsIndex)
+        {
+            const bool isCategory1(categoryDist(gen));
+            const unsigned obs(obsDist(gen)*(trial+1));
+            r.add_observation(isCategory1, obs);
+            observations.emplace_back(isCategory1, obs);
+
+            static const double tol(0.0001);
+            BOOST_REQUIRE_SMALL(std::abs(r.get_z_stat())-std::abs(getPairwiseZStat(observations)), tol);
+        }
+        r.clear();
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_fastRanksum_merge )
+{
+    fastRanksum r1;
+    fastRanksum r2;
+    fastRanksum r12;
+    for (unsigned obs(0); obs<20; ++obs)
+    {
+        r1.add_observation((obs%3)==0, obs);
+        r12.add_observation((obs%3)==0, obs);
+        r2.add_observation((obs%2)==0, 30-obs);
+        r12.add_observation((obs%2)==0, 30-obs);
+    }
+    r1.merge(r2, true);
+
+    BOOST_REQUIRE_EQUAL(r1.get_z_stat(), r12.get_z_stat());
+    BOOST_REQUIRE_EQUAL(r1.getExpectedCategory2Value(), r12.getExpectedCategory2Value());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -38,6 +38,14 @@ BOOST_AUTO_TEST_CASE( test_fisher_exact_pval )
     BOOST_CHECK_CLOSE(6.73038093956118699e-05, test_pval, 0.00000001);
 }
 
+BOOST_AUTO_TEST_CASE( test_fisher_exact_pval_ties )
+{
+    // the table probabilities of a=53 and a=55 are equal up to pdf rounding, the two-tailed p-value keeps the
+    // original result, which excludes a=55 (R's fisher.test includes it, giving 0.6181502603521)
+    const double test_pval = fisher_exact_test_pval_2x2(53, 55, 3, 1);
+    BOOST_CHECK_CLOSE(0.3682122489462, test_pval, 1e-8);
+}
+
 BOOST_AUTO_TEST_CASE( test_fisher_exact_examples )
 {
 // generate test data in R:
@@ -21,6 +21,8 @@
 
 #include "stage_manager.hh"
 
+#include <limits>
+
 //#define DEBUG_SM_TEST
 
 #ifdef DEBUG_SM_TEST
@@ -172,5 +174,62 @@ BOOST_AUTO_TEST_CASE( test_stage_manager_reset )
 }
 
 
+/// \brief pos_processor which reports that it is empty after the root stage reaches a given position
+///
+struct test_skip_pos_processor : public test_pos_processor
+{
+    explicit
+    test_skip_pos_processor(const pos_t initSkipPos)
+        : skipPos(initSkipPos)
+    {}
+
+    void
+    process_pos(const int stage_no,
+                const pos_t pos)
+    {
+        test_pos_processor::process_pos(stage_no,pos);
+        processCount++;
+        if ((stage_no == 0) && (pos >= skipPos)) _is_skip_process_pos=true;
+    }
+
+    void
+    resume()
+    {
+        _is_skip_process_pos=false;
+        skipPos=std::numeric_limits<pos_t>::max();
+    }
+
+    pos_t skipPos;
+    unsigned processCount = 0;
+};
+
+
+BOOST_AUTO_TEST_CASE( test_stage_manager_skip_empty )
+{
+    const stage_data sd(get_test_stage_data());
+    const pos_range report_range(0,200000);
+    test_skip_pos_processor tpp(40);
+
+    stage_manager sman(sd,report_range,tpp);
+
+    sman.handle_new_pos_value(40);
+    const unsigned initialCount(tpp.processCount);
+
+    // the gap to the next position should be crossed in one step once the processor is empty:
+    sman.handle_new_pos_value(100000);
+    BOOST_CHECK_EQUAL(tpp.processCount, initialCount);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[0],40);
+
+    // standard processing resumes when the processor has new data:
+    tpp.resume();
+    sman.handle_new_pos_value(100010);
+    BOOST_CHECK_EQUAL(tpp.processCount, initialCount+40);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[0],100010);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[1],100000);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[2],99980);
+    BOOST_CHECK_EQUAL(tpp.stage_pos[3],99990);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -68,5 +68,37 @@ BOOST_AUTO_TEST_CASE( test_window )
     BOOST_REQUIRE_CLOSE(wa.avg(), 2., tol);
 }
 
+
+BOOST_AUTO_TEST_CASE( test_window_insert_repeat )
+{
+    static const double tol(0.0001);
+
+    for (unsigned count(0); count<8; ++count)
+    {
+        window_average wa(3);
+        window_average wa_expect(3);
+        for (window_average* wp : { &wa, &wa_expect })
+        {
+            wp->insert(5);
+            wp->insert_null();
+        }
+
+        wa.insert_repeat(2,count);
+        for (unsigned i(0); i<count; ++i) wa_expect.insert(2);
+
+        // subsequent insertions must displace the same values in both windows:
+        for (int32_t x(10); x<14; ++x)
+        {
+            BOOST_REQUIRE_EQUAL(wa.size(),wa_expect.size());
+            if (wa.size() > 0)
+            {
+                BOOST_REQUIRE_CLOSE(wa.avg(), wa_expect.avg(), tol);
+            }
+            wa.insert(x);
+            wa_expect.insert(x);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <algorithm>
 #include <iosfwd>
 #include <vector>
 
@@ -64,6 +65,29 @@ struct window_average
         _head=(_head+1)%_full_size;
     }
 
+    /// insert x count times
+    ///
+    /// this is equivalent to repeated calls to insert(x), but if count covers the full
+    /// window the window is refilled directly
+    void
+    insert_repeat(
+        const int32_t x,
+        const uint32_t count)
+    {
+        if (count < _full_size)
+        {
+            for (uint32_t i(0); i<count; ++i) insert(x);
+            return;
+        }
+
+        std::fill(_buf.begin(),_buf.end(),x);
+        std::fill(_is_buf.begin(),_is_buf.end(),true);
+        _total = static_cast<int64_t>(x)*_full_size;
+        _size = _full_size;
+        _null_size = 0;
+        _head = (_head+count)%_full_size;
+    }
+
     // inserts an N/A value:
     void
     insert_null()
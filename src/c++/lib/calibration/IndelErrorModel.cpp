@@ -152,7 +152,7 @@ IndelErrorModel(
         //
         _isUseSampleSpecificErrorRates = false;
         _sampleErrorRates.resize(1);
-        auto& errorRates = getSampleSpecificIndelErrorRates();
+        auto& errorRates = _sampleErrorRates.front();
 
         if (modelName == "logLinear")
         {
@@ -182,7 +182,7 @@ IndelErrorModel(
             // samples
             _isUseSampleSpecificErrorRates = false;
             _sampleErrorRates.resize(1);
-            auto& errorRates = getSampleSpecificIndelErrorRates();
+            auto& errorRates = _sampleErrorRates.front();
             errorRates = defaultModelIter->second;
         }
         else
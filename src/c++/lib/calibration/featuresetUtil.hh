@@ -23,6 +23,7 @@
 #include "calibration/VariantScoringModelBase.hh"
 #include "calibration/VariantScoringModelMetadata.hh"
 #include "blt_util/PolymorphicObject.hh"
+#include "blt_util/TextBuffer.hh"
 
 #include "boost/dynamic_bitset.hpp"
 
@@ -136,18 +137,30 @@ struct VariantScoringFeatureKeeper
         return _isFeatureSet.test(featureIndex);
     }
 
+    /// write comma-separated values to text buffer, each formatted as 'os << std::setprecision(precision) << val'
     void
     writeValues(
-        std::ostream& os) const
+        TextBuffer& buffer,
+        const int precision) const
     {
         const unsigned featureSize(_featureSet.size());
         for (unsigned featureIndex(0); featureIndex<featureSize; ++featureIndex)
         {
-            if (featureIndex > 0) os << ',';
-            os << get(featureIndex);
+            if (featureIndex > 0) buffer.append(',');
+            buffer.appendDouble(get(featureIndex), precision);
         }
     }
 
+    /// write comma-separated values to os at the stream's precision
+    void
+    writeValues(
+        std::ostream& os) const
+    {
+        TextBuffer buffer(0);
+        writeValues(buffer, os.precision());
+        buffer.flush(os);
+    }
+
     void
     dump(
         std::ostream& os) const
@@ -0,0 +1,180 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+/// Minimal helpers for columnar binary file formats
+///
+/// Values are written in native byte order. Columns are written as a 64-bit element count followed by
+/// the packed element array, so that each column can be read back with a single stream read.
+///
+
+#pragma once
+
+#include "common/Exceptions.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <iosfwd>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace BinaryColumnIO
+{
+
+/// columns are read in chunks of at most this size
+static const size_t maxChunkBytes(1 << 20);
+
+inline
+void
+checkRead(std::istream& is)
+{
+    if (! is)
+    {
+        using namespace illumina::common;
+        BOOST_THROW_EXCEPTION(LogicException("ERROR: Unexpected end of binary file\n"));
+    }
+}
+
+/// Run \p readFunc to read from a binary file, adding \p filename to any error raised by the readers below
+template <typename ReadFunc>
+void
+readFromFile(
+    const std::string& filename,
+    ReadFunc readFunc)
+{
+    using namespace illumina::common;
+    try
+    {
+        readFunc();
+    }
+    catch (const LogicException& e)
+    {
+        std::ostringstream oss;
+        oss << e.getMessage() << "\tin binary file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+}
+
+inline
+void
+throwInvalidColumns(const char* sectionLabel)
+{
+    using namespace illumina::common;
+    std::ostringstream oss;
+    oss << "ERROR: Inconsistent column sizes in binary file section: '" << sectionLabel << "'\n";
+    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+}
+
+template <typename T>
+void
+writeValue(
+    std::ostream& os,
+    const T& value)
+{
+    static_assert(std::is_pod<T>::value, "Binary value type must be POD");
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void
+readValue(
+    std::istream& is,
+    T& value)
+{
+    static_assert(std::is_pod<T>::value, "Binary value type must be POD");
+    is.read(reinterpret_cast<char*>(&value), sizeof(T));
+    checkRead(is);
+}
+
+template <typename T>
+void
+writeColumn(
+    std::ostream& os,
+    const std::vector<T>& column)
+{
+    static_assert(std::is_pod<T>::value, "Binary column type must be POD");
+    const uint64_t size(column.size());
+    writeValue(os, size);
+    if (size == 0) return;
+    os.write(reinterpret_cast<const char*>(column.data()), sizeof(T)*size);
+}
+
+template <typename T>
+void
+readColumn(
+    std::istream& is,
+    std::vector<T>& column)
+{
+    static_assert(std::is_pod<T>::value, "Binary column type must be POD");
+    uint64_t size(0);
+    readValue(is, size);
+
+    // the size is not trusted to allocate the column up front, so that a corrupt size fails on the
+    // end of the file instead of on a huge allocation:
+    static const uint64_t chunkSize(std::max(static_cast<size_t>(1), maxChunkBytes/sizeof(T)));
+    column.clear();
+    while (column.size() < size)
+    {
+        const size_t chunkBegin(column.size());
+        const size_t chunkEnd(chunkBegin + std::min(chunkSize, size-chunkBegin));
+        column.resize(chunkEnd);
+        is.read(reinterpret_cast<char*>(column.data()+chunkBegin), sizeof(T)*(chunkEnd-chunkBegin));
+        checkRead(is);
+    }
+}
+
+inline
+void
+writeString(
+    std::ostream& os,
+    const std::string& str)
+{
+    const uint64_t size(str.size());
+    writeValue(os, size);
+    os.write(str.data(), size);
+}
+
+inline
+void
+readString(
+    std::istream& is,
+    std::string& str)
+{
+    uint64_t size(0);
+    readValue(is, size);
+
+    str.clear();
+    while (str.size() < size)
+    {
+        const size_t chunkBegin(str.size());
+        const size_t chunkEnd(chunkBegin + std::min(static_cast<uint64_t>(maxChunkBytes), size-chunkBegin));
+        str.resize(chunkEnd);
+        is.read(&str[chunkBegin], (chunkEnd-chunkBegin));
+        checkRead(is);
+    }
+}
+
+}
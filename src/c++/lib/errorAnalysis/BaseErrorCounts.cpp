@@ -22,13 +22,18 @@
 ///
 
 #include "BaseErrorCounts.hh"
+#include "common/BinaryColumnIO.hh"
+#include "SortedMapMerge.hh"
 #include "blt_util/IntegerLogCompressor.hh"
 #include "blt_util/math_util.hh"
+#include "common/Exceptions.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
 #include <iostream>
+#include <sstream>
 #include <set>
 
 
@@ -77,11 +82,11 @@ iterMap(
 
 
 
-template <typename K, typename V1, typename V2>
+template <typename M1, typename K, typename V2>
 static
 void
 mergeMapKeys(
-    const std::map<K,V1>& m1,
+    const M1& m1,
     std::map<K,V2>& m2,
     const unsigned scale = 1)
 {
@@ -153,24 +158,38 @@ operator<<(std::ostream& os, const StrandBaseCounts& sbc)
 
 void
 BaseErrorContextInputObservation::
-addRefCount(
-    const bool isFwdStrand,
-    const uint16_t qual)
+clear()
 {
-    StrandBaseCounts::qual_count_t& target(isFwdStrand ? ref[0] : ref[1]);
-    iterMap(target,qual);
+    if (empty()) return;
+
+    for (unsigned strandId(0); strandId<2; ++strandId)
+    {
+        std::fill(ref[strandId].begin()+minQual, ref[strandId].begin()+maxQual+1, 0);
+        std::fill(alt[strandId].begin()+minQual, alt[strandId].begin()+maxQual+1, 0);
+    }
+    minQual = qualLevelCount;
+    maxQual = 0;
 }
 
 
 
 void
 BaseErrorContextInputObservation::
-addAltCount(
-    const bool isFwdStrand,
-    const uint16_t qual)
+addCount(
+    const uint16_t qual,
+    qual_count_t& target)
 {
-    StrandBaseCounts::qual_count_t& target(isFwdStrand ? alt[0] : alt[1]);
-    iterMap(target,qual);
+    if (qual >= qualLevelCount)
+    {
+        using namespace illumina::common;
+
+        std::ostringstream oss;
+        oss << "Basecall quality " << qual << " exceeds the maximum supported value of " << (qualLevelCount-1);
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+    target[qual]++;
+    minQual = std::min(minQual, qual);
+    maxQual = std::max(maxQual, qual);
 }
 
 
@@ -201,20 +220,35 @@ BaseErrorContextObservationData::
 addObservation(
     const BaseErrorContextInputObservation& obs)
 {
+    obs.addRefQualCounts(refQuals);
     BaseErrorContextObservation compObs;
+    getCompressedObservation(obs, compObs);
+    iterMap(data,compObs);
+}
+
+
+
+void
+BaseErrorContextObservationData::
+getCompressedObservation(
+    const BaseErrorContextInputObservation& obs,
+    BaseErrorContextObservation& compObs)
+{
+    compObs.strand0.clear();
+    compObs.strand1.clear();
     for (unsigned strandId(0); strandId<2; ++strandId)
     {
-        mergeMapKeys(obs.ref[strandId], refQuals);
         auto& target(strandId==0 ? compObs.strand0 : compObs.strand1);
-        for (const auto& val : obs.ref[strandId])
+        for (unsigned qual(obs.minQual); qual<=obs.maxQual; ++qual)
         {
-            target.refCount += val.second;
+            target.refCount += obs.ref[strandId][qual];
+            const unsigned altCount(obs.alt[strandId][qual]);
+            if (altCount == 0) continue;
+            target.alt.emplace_back(qual, altCount);
         }
-        target.alt = obs.alt[strandId];
     }
 
     compObs.compressCounts();
-    iterMap(data,compObs);
 }
 
 
@@ -229,6 +263,158 @@ merge(const BaseErrorContextObservationData& in)
 
 
 
+void
+BaseErrorContextObservationData::
+merge(const std::vector<const BaseErrorContextObservationData*>& inputs)
+{
+    std::vector<const data_t*> inputData;
+    std::vector<const refQual_t*> inputRefQuals;
+    for (const auto* inputPtr : inputs)
+    {
+        inputData.push_back(&(inputPtr->data));
+        inputRefQuals.push_back(&(inputPtr->refQuals));
+    }
+    mergeSortedCountMaps(inputData, data);
+    mergeSortedCountMaps(inputRefQuals, refQuals);
+}
+
+
+
+void
+BaseErrorContextObservationData::
+writeBinary(std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    std::vector<uint16_t> refQualValue;
+    std::vector<uint64_t> refQualCount;
+    for (const auto& value : refQuals)
+    {
+        refQualValue.push_back(value.first);
+        refQualCount.push_back(value.second);
+    }
+    writeColumn(os, refQualValue);
+    writeColumn(os, refQualCount);
+
+    // each observation pattern is split into fixed size columns, the variable length alt quality
+    // counts for both strands of all patterns are concatenated into the final two columns:
+    const unsigned observationCount(data.size());
+    std::vector<uint32_t> observationTotal;
+    std::vector<uint32_t> strand0RefCount;
+    std::vector<uint32_t> strand1RefCount;
+    std::vector<uint32_t> strand0AltSize;
+    std::vector<uint32_t> strand1AltSize;
+    observationTotal.reserve(observationCount);
+    strand0RefCount.reserve(observationCount);
+    strand1RefCount.reserve(observationCount);
+    strand0AltSize.reserve(observationCount);
+    strand1AltSize.reserve(observationCount);
+
+    std::vector<uint16_t> altQual;
+    std::vector<uint32_t> altCount;
+    for (const auto& value : data)
+    {
+        const BaseErrorContextObservation& obs(value.first);
+        observationTotal.push_back(value.second);
+        strand0RefCount.push_back(obs.strand0.refCount);
+        strand1RefCount.push_back(obs.strand1.refCount);
+        strand0AltSize.push_back(obs.strand0.alt.size());
+        strand1AltSize.push_back(obs.strand1.alt.size());
+        for (const auto& alt : obs.strand0.alt)
+        {
+            altQual.push_back(alt.first);
+            altCount.push_back(alt.second);
+        }
+        for (const auto& alt : obs.strand1.alt)
+        {
+            altQual.push_back(alt.first);
+            altCount.push_back(alt.second);
+        }
+    }
+
+    writeColumn(os, observationTotal);
+    writeColumn(os, strand0RefCount);
+    writeColumn(os, strand1RefCount);
+    writeColumn(os, strand0AltSize);
+    writeColumn(os, strand1AltSize);
+    writeColumn(os, altQual);
+    writeColumn(os, altCount);
+}
+
+
+
+void
+BaseErrorContextObservationData::
+readBinary(std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    data.clear();
+    refQuals.clear();
+
+    std::vector<uint16_t> refQualValue;
+    std::vector<uint64_t> refQualCount;
+    readColumn(is, refQualValue);
+    readColumn(is, refQualCount);
+    if (refQualValue.size() != refQualCount.size()) throwInvalidColumns("base reference qualities");
+
+    const unsigned refQualSize(refQualValue.size());
+    for (unsigned refQualIndex(0); refQualIndex < refQualSize; ++refQualIndex)
+    {
+        refQuals.emplace_hint(refQuals.end(), refQualValue[refQualIndex], refQualCount[refQualIndex]);
+    }
+
+    std::vector<uint32_t> observationTotal;
+    std::vector<uint32_t> strand0RefCount;
+    std::vector<uint32_t> strand1RefCount;
+    std::vector<uint32_t> strand0AltSize;
+    std::vector<uint32_t> strand1AltSize;
+    std::vector<uint16_t> altQual;
+    std::vector<uint32_t> altCount;
+    readColumn(is, observationTotal);
+    readColumn(is, strand0RefCount);
+    readColumn(is, strand1RefCount);
+    readColumn(is, strand0AltSize);
+    readColumn(is, strand1AltSize);
+    readColumn(is, altQual);
+    readColumn(is, altCount);
+
+    const unsigned observationCount(observationTotal.size());
+    if ((strand0RefCount.size() != observationCount) ||
+        (strand1RefCount.size() != observationCount) ||
+        (strand0AltSize.size() != observationCount) ||
+        (strand1AltSize.size() != observationCount) ||
+        (altQual.size() != altCount.size()))
+    {
+        throwInvalidColumns("base observations");
+    }
+
+    const unsigned altTotal(altQual.size());
+    unsigned altIndex(0);
+    auto readAlts = [&](const unsigned altSize, StrandBaseCounts::qual_count_t& alt)
+    {
+        if ((altIndex + altSize) > altTotal) throwInvalidColumns("base observations");
+        for (unsigned altOffset(0); altOffset < altSize; ++altOffset, ++altIndex)
+        {
+            alt.emplace_back(altQual[altIndex], altCount[altIndex]);
+        }
+    };
+
+    for (unsigned observationIndex(0); observationIndex < observationCount; ++observationIndex)
+    {
+        BaseErrorContextObservation obs;
+        obs.strand0.refCount = strand0RefCount[observationIndex];
+        obs.strand1.refCount = strand1RefCount[observationIndex];
+        readAlts(strand0AltSize[observationIndex], obs.strand0.alt);
+        readAlts(strand1AltSize[observationIndex], obs.strand1.alt);
+        data.emplace_hint(data.end(), std::move(obs), observationTotal[observationIndex]);
+    }
+
+    if (altIndex != altTotal) throwInvalidColumns("base observations");
+}
+
+
+
 void
 BaseErrorContextObservationData::
 getExportData(BaseErrorContextObservationExportData& exportData) const
@@ -416,6 +602,57 @@ merge(
 
 
 
+void
+BaseErrorData::
+merge(
+    const std::vector<const BaseErrorData*>& inputs)
+{
+    std::vector<const BaseErrorContextObservationData*> inputErrors;
+    for (const auto* inputPtr : inputs)
+    {
+        inputErrors.push_back(&(inputPtr->error));
+        excludedRegionSkipped += inputPtr->excludedRegionSkipped;
+        depthSkipped += inputPtr->depthSkipped;
+        emptySkipped += inputPtr->emptySkipped;
+        noiseSkipped += inputPtr->noiseSkipped;
+    }
+    error.merge(inputErrors);
+}
+
+
+
+void
+BaseErrorData::
+writeBinary(
+    std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    writeValue(os, excludedRegionSkipped);
+    writeValue(os, depthSkipped);
+    writeValue(os, emptySkipped);
+    writeValue(os, noiseSkipped);
+    error.writeBinary(os);
+}
+
+
+
+void
+BaseErrorData::
+readBinary(
+    std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    readValue(is, excludedRegionSkipped);
+    readValue(is, depthSkipped);
+    readValue(is, emptySkipped);
+    readValue(is, noiseSkipped);
+    error.readBinary(is);
+}
+
+
+
 void
 BaseErrorData::
 dump(
@@ -487,6 +724,18 @@ addNoiseSkip(
 
 
 
+void
+BaseErrorCounts::
+mergeContext(
+    const BaseErrorContext& context,
+    const BaseErrorData& data)
+{
+    const auto iter(getContextIterator(context));
+    iter->second.merge(data);
+}
+
+
+
 void
 BaseErrorCounts::
 merge(
@@ -509,6 +758,68 @@ merge(
 
 
 
+void
+BaseErrorCounts::
+merge(
+    const std::vector<const BaseErrorCounts*>& inputs)
+{
+    std::vector<const data_t*> inputData;
+    for (const auto* inputPtr : inputs)
+    {
+        inputData.push_back(&(inputPtr->_data));
+    }
+    mergeSortedMaps(inputData, _data,
+                    [](const std::vector<const BaseErrorData*>& values, BaseErrorData& mergedValue)
+    {
+        mergedValue.merge(values);
+    });
+}
+
+
+
+void
+BaseErrorCounts::
+writeBinary(
+    std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    const uint64_t contextCount(_data.size());
+    writeValue(os, contextCount);
+    for (const auto& value : _data)
+    {
+        const uint32_t repeatCount(value.first.repeatCount);
+        writeValue(os, repeatCount);
+        value.second.writeBinary(os);
+    }
+}
+
+
+
+void
+BaseErrorCounts::
+readBinary(
+    std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    _data.clear();
+
+    uint64_t contextCount(0);
+    readValue(is, contextCount);
+    for (uint64_t contextIndex(0); contextIndex < contextCount; ++contextIndex)
+    {
+        uint32_t repeatCount(0);
+        readValue(is, repeatCount);
+        BaseErrorContext context;
+        context.repeatCount = repeatCount;
+        const auto iter(_data.emplace_hint(_data.end(), context, BaseErrorData()));
+        iter->second.readBinary(is);
+    }
+}
+
+
+
 void
 BaseErrorCounts::
 dump(
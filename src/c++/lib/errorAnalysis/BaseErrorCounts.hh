@@ -30,6 +30,7 @@
 #include <iosfwd>
 #include <map>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 
@@ -37,6 +38,13 @@ struct BaseErrorContext
 {
     BaseErrorContext() {}
 
+    bool
+    operator==(
+        const BaseErrorContext& rhs) const
+    {
+        return (repeatCount == rhs.repeatCount);
+    }
+
     bool
     operator<(
         const BaseErrorContext& rhs) const
@@ -82,7 +90,28 @@ struct StrandBaseCounts
     void
     compressCounts();
 
-    typedef std::map<uint16_t,unsigned> qual_count_t;
+    void
+    clear()
+    {
+        refCount = 0;
+        alt.clear();
+    }
+
+    /// alt counts are serialized as a std::map, to match the earlier boost serialization counts file format
+    template<class Archive>
+    void
+    serializeAlt(Archive& ar)
+    {
+        std::map<uint16_t,unsigned> altMap;
+        if (Archive::is_saving::value) altMap.insert(alt.begin(), alt.end());
+        ar& altMap;
+        if (Archive::is_loading::value) alt.assign(altMap.begin(), altMap.end());
+    }
+
+    /// alt basecall counts as (quality,count) pairs, sorted by quality
+    ///
+    /// a flat vector is used so that a reused observation can be refilled without allocation
+    typedef std::vector<std::pair<uint16_t,unsigned>> qual_count_t;
 
     unsigned refCount = 0;
     qual_count_t alt;
@@ -114,6 +143,13 @@ struct BaseErrorContextObservation
         return strand1;
     }
 
+    bool
+    operator==(
+        const BaseErrorContextObservation& rhs) const
+    {
+        return ((strand0 == rhs.strand0) && (strand1 == rhs.strand1));
+    }
+
     bool
     operator<(
         const BaseErrorContextObservation& rhs) const
@@ -130,9 +166,9 @@ struct BaseErrorContextObservation
     void serialize(Archive& ar, const unsigned /* version */)
     {
         ar& strand0.refCount;
-        ar& strand0.alt;
+        strand0.serializeAlt(ar);
         ar& strand1.refCount;
-        ar& strand1.alt;
+        strand1.serializeAlt(ar);
     }
 
 
@@ -149,22 +185,72 @@ BOOST_CLASS_IMPLEMENTATION(BaseErrorContextObservation, boost::serialization::ob
 struct BaseErrorContextObservationData;
 
 /// special version of struct only used for input from client code:
+/// per-site basecall counts, accumulated by strand and basecall quality
+///
+/// counts are stored in fixed-size arrays indexed by quality, so that filling in a site
+/// observation requires no allocation. The object can be reused for the next site after
+/// calling clear(), which only resets the range of qualities observed at the previous site.
 struct BaseErrorContextInputObservation
 {
+    /// all basecall qualities must be less than this value
+    static const unsigned qualLevelCount = 256;
+
     void
     addRefCount(
         const bool isFwdStrand,
-        const uint16_t qual);
+        const uint16_t qual)
+    {
+        addCount(qual, ref[isFwdStrand ? 0 : 1]);
+    }
 
     void
     addAltCount(
         const bool isFwdStrand,
-        const uint16_t qual);
+        const uint16_t qual)
+    {
+        addCount(qual, alt[isFwdStrand ? 0 : 1]);
+    }
+
+    bool
+    empty() const
+    {
+        return (minQual > maxQual);
+    }
+
+    /// add the reference basecall count at each quality, summed over both strands, to refQualCounts[qual]
+    ///
+    /// only qualities with a non-zero count are touched
+    template <typename RefQualCounts>
+    void
+    addRefQualCounts(
+        RefQualCounts& refQualCounts) const
+    {
+        for (unsigned qual(minQual); qual<=maxQual; ++qual)
+        {
+            const unsigned count(ref[0][qual]+ref[1][qual]);
+            if (count == 0) continue;
+            refQualCounts[qual] += count;
+        }
+    }
+
+    void
+    clear();
 
 private:
     friend BaseErrorContextObservationData;
-    std::array<StrandBaseCounts::qual_count_t,2> ref;
-    std::array<StrandBaseCounts::qual_count_t,2> alt;
+    typedef std::array<unsigned,qualLevelCount> qual_count_t;
+
+    void
+    addCount(
+        const uint16_t qual,
+        qual_count_t& target);
+
+    std::array<qual_count_t,2> ref = {};
+    std::array<qual_count_t,2> alt = {};
+
+    /// range of qualities with any non-zero count
+    uint16_t minQual = qualLevelCount;
+    uint16_t maxQual = 0;
 };
 
 
@@ -243,9 +329,47 @@ public:
     addObservation(
         const BaseErrorContextInputObservation& obs);
 
+    void
+    addRefQualCount(
+        const uint16_t qual,
+        const uint64_t count)
+    {
+        refQuals[qual] += count;
+    }
+
+    /// add count observations of a pattern which has already been compressed by getCompressedObservation
+    void
+    addCompressedObservation(
+        const BaseErrorContextObservation& compObs,
+        const unsigned count)
+    {
+        data[compObs] += count;
+    }
+
+    /// get the compressed observation pattern which addObservation uses to summarize obs
+    ///
+    /// \param[out] compObs compressed observation pattern, any existing content is replaced
+    static
+    void
+    getCompressedObservation(
+        const BaseErrorContextInputObservation& obs,
+        BaseErrorContextObservation& compObs);
+
     void
     merge(const BaseErrorContextObservationData& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const BaseErrorContextObservationData*>& inputs);
+
+    /// write in the columnar binary counts file format
+    void
+    writeBinary(std::ostream& os) const;
+
+    /// read from the columnar binary counts file format, replacing any existing data
+    void
+    readBinary(std::istream& is);
+
     const_iterator
     begin() const
     {
@@ -287,6 +411,16 @@ struct BaseErrorData
     void
     merge(const BaseErrorData& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const BaseErrorData*>& inputs);
+
+    void
+    writeBinary(std::ostream& os) const;
+
+    void
+    readBinary(std::istream& is);
+
     /// debug output
     void
     dump(std::ostream& os) const;
@@ -343,15 +477,33 @@ public:
     addNoiseSkip(
         const BaseErrorContext& context);
 
+    /// merge data into the counts for a single context
+    void
+    mergeContext(
+        const BaseErrorContext& context,
+        const BaseErrorData& data);
+
     void
     merge(const BaseErrorCounts& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const BaseErrorCounts*>& inputs);
+
     void
     clear()
     {
         _data.clear();
     }
 
+    /// write in the columnar binary counts file format
+    void
+    writeBinary(std::ostream& os) const;
+
+    /// read from the columnar binary counts file format, replacing any existing data
+    void
+    readBinary(std::istream& is);
+
     const_iterator
     begin() const
     {
@@ -0,0 +1,66 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "BaseErrorCountsAccumulator.hh"
+
+
+
+void
+BaseErrorCountsAccumulator::
+addSiteObservation(
+    const BaseErrorContext& context,
+    const BaseErrorContextInputObservation& siteObservation)
+{
+    ContextData& contextData(_data.getRef(context));
+    siteObservation.addRefQualCounts(contextData.refQualCounts);
+    BaseErrorContextObservationData::getCompressedObservation(siteObservation, _compObs);
+    contextData.observations.getRef(_compObs)++;
+}
+
+
+
+void
+BaseErrorCountsAccumulator::
+exportCounts(
+    BaseErrorCounts& counts) const
+{
+    _data.forEach([&](const BaseErrorContext& context, const ContextData& contextData)
+    {
+        BaseErrorData data;
+        for (unsigned qual(0); qual<contextData.refQualCounts.size(); ++qual)
+        {
+            const uint64_t count(contextData.refQualCounts[qual]);
+            if (count == 0) continue;
+            data.error.addRefQualCount(qual, count);
+        }
+        contextData.observations.forEach([&](const BaseErrorContextObservation& compObs, const unsigned count)
+        {
+            data.error.addCompressedObservation(compObs, count);
+        });
+        data.excludedRegionSkipped = contextData.excludedRegionSkipped;
+        data.depthSkipped = contextData.depthSkipped;
+        data.emptySkipped = contextData.emptySkipped;
+        data.noiseSkipped = contextData.noiseSkipped;
+        counts.mergeContext(context, data);
+    });
+}
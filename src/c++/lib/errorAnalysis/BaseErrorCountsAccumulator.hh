@@ -0,0 +1,144 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "BaseErrorCounts.hh"
+#include "blt_util/FlatHashMap.hh"
+
+#include "boost/functional/hash.hpp"
+
+#include <array>
+
+
+struct BaseErrorContextHash
+{
+    size_t
+    operator()(const BaseErrorContext& context) const
+    {
+        return boost::hash_value(context.repeatCount);
+    }
+};
+
+
+struct BaseErrorContextObservationHash
+{
+    size_t
+    operator()(const BaseErrorContextObservation& obs) const
+    {
+        size_t seed(0);
+        hashStrand(obs.getStrand0Counts(), seed);
+        hashStrand(obs.getStrand1Counts(), seed);
+        return seed;
+    }
+
+private:
+    static
+    void
+    hashStrand(
+        const StrandBaseCounts& sbc,
+        size_t& seed)
+    {
+        boost::hash_combine(seed, sbc.refCount);
+        for (const auto& val : sbc.alt)
+        {
+            boost::hash_combine(seed, val.first);
+            boost::hash_combine(seed, val.second);
+        }
+        boost::hash_combine(seed, sbc.alt.size());
+    }
+};
+
+
+/// accumulates base error counts with the same interface as BaseErrorCounts, but using flat hash tables
+/// and fixed-size quality arrays in place of sorted maps
+///
+/// this is meant for the per-site counting loop, where every pileup position adds one site observation.
+/// The accumulated counts are transferred into the sorted BaseErrorCounts representation once with
+/// exportCounts, which produces exactly the same result as adding each site observation to BaseErrorCounts
+/// directly.
+struct BaseErrorCountsAccumulator
+{
+    void
+    addSiteObservation(
+        const BaseErrorContext& context,
+        const BaseErrorContextInputObservation& siteObservation);
+
+    void
+    addExcludedRegionSkip(
+        const BaseErrorContext& context)
+    {
+        _data.getRef(context).excludedRegionSkipped++;
+    }
+
+    void
+    addDepthSkip(
+        const BaseErrorContext& context)
+    {
+        _data.getRef(context).depthSkipped++;
+    }
+
+    void
+    addEmptySkip(
+        const BaseErrorContext& context)
+    {
+        _data.getRef(context).emptySkipped++;
+    }
+
+    void
+    addNoiseSkip(
+        const BaseErrorContext& context)
+    {
+        _data.getRef(context).noiseSkipped++;
+    }
+
+    /// merge all accumulated counts into counts
+    void
+    exportCounts(
+        BaseErrorCounts& counts) const;
+
+    void
+    clear()
+    {
+        _data.clear();
+    }
+
+private:
+    struct ContextData
+    {
+        std::array<uint64_t,BaseErrorContextInputObservation::qualLevelCount> refQualCounts = {};
+
+        /// value is number of observations of each compressed observation pattern
+        FlatHashMap<BaseErrorContextObservation,unsigned,BaseErrorContextObservationHash> observations;
+
+        uint64_t excludedRegionSkipped = 0;
+        uint64_t depthSkipped = 0;
+        uint64_t emptySkipped = 0;
+        uint64_t noiseSkipped = 0;
+    };
+
+    FlatHashMap<BaseErrorContext,ContextData,BaseErrorContextHash> _data;
+
+    /// compressed site observation, reused between sites to avoid allocation
+    BaseErrorContextObservation _compObs;
+};
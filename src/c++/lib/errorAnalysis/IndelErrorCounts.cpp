@@ -22,13 +22,17 @@
 ///
 
 #include "IndelErrorCounts.hh"
+#include "common/BinaryColumnIO.hh"
+#include "SortedMapMerge.hh"
 #include "blt_util/IntegerLogCompressor.hh"
 #include "blt_util/math_util.hh"
 
+#include <array>
 #include <cassert>
 #include <cmath>
 
 #include <iostream>
+#include <sstream>
 
 
 
@@ -120,14 +124,23 @@ void
 IndelBackgroundObservationData::
 addObservation(
     const IndelBackgroundObservation& obs)
+{
+    iterMap(data,getCompressedObservation(obs));
+}
+
+
+
+IndelBackgroundObservation
+IndelBackgroundObservationData::
+getCompressedObservation(
+    const IndelBackgroundObservation& obs)
 {
     // 1D key doesn't need to be compressed as much:
     static const unsigned depthBitCount(6);
 
     IndelBackgroundObservation compObs = obs;
     compObs.depth = compressInt(compObs.depth,depthBitCount);
-
-    iterMap(data,compObs);
+    return compObs;
 }
 
 
@@ -141,6 +154,90 @@ merge(const IndelBackgroundObservationData& in)
 
 
 
+void
+IndelBackgroundObservationData::
+merge(const std::vector<const IndelBackgroundObservationData*>& inputs)
+{
+    std::vector<const data_t*> inputData;
+    for (const auto* inputPtr : inputs)
+    {
+        inputData.push_back(&(inputPtr->data));
+    }
+    mergeSortedCountMaps(inputData, data);
+}
+
+
+
+static
+GENOTYPE_STATUS::genotype_t
+getGenotypeStatus(const uint8_t status)
+{
+    if (status >= GENOTYPE_STATUS::SIZE)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Invalid genotype status value in binary counts file: '" << static_cast<unsigned>(status) << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
+    return static_cast<GENOTYPE_STATUS::genotype_t>(status);
+}
+
+
+
+void
+IndelBackgroundObservationData::
+writeBinary(std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    std::vector<uint32_t> observationTotal;
+    std::vector<uint32_t> depth;
+    std::vector<uint8_t> status;
+    for (const auto& value : data)
+    {
+        observationTotal.push_back(value.second);
+        depth.push_back(value.first.depth);
+        status.push_back(value.first.backgroundStatus);
+    }
+    writeColumn(os, observationTotal);
+    writeColumn(os, depth);
+    writeColumn(os, status);
+}
+
+
+
+void
+IndelBackgroundObservationData::
+readBinary(std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    data.clear();
+
+    std::vector<uint32_t> observationTotal;
+    std::vector<uint32_t> depth;
+    std::vector<uint8_t> status;
+    readColumn(is, observationTotal);
+    readColumn(is, depth);
+    readColumn(is, status);
+
+    const unsigned observationCount(observationTotal.size());
+    if ((depth.size() != observationCount) || (status.size() != observationCount))
+    {
+        throwInvalidColumns("indel background observations");
+    }
+
+    for (unsigned observationIndex(0); observationIndex < observationCount; ++observationIndex)
+    {
+        IndelBackgroundObservation obs;
+        obs.depth = depth[observationIndex];
+        obs.backgroundStatus = getGenotypeStatus(status[observationIndex]);
+        data.emplace_hint(data.end(), obs, observationTotal[observationIndex]);
+    }
+}
+
+
+
 void
 IndelBackgroundObservationData::
 dump(
@@ -175,6 +272,16 @@ void
 IndelErrorContextObservationData::
 addObservation(
     const IndelErrorContextObservation& obs)
+{
+    iterMap(data,getCompressedObservation(obs));
+}
+
+
+
+IndelErrorContextObservation
+IndelErrorContextObservationData::
+getCompressedObservation(
+    const IndelErrorContextObservation& obs)
 {
     static const unsigned bitCount(5);
 
@@ -184,7 +291,7 @@ addObservation(
     {
         signalCount = compressInt(signalCount,bitCount);
     }
-    iterMap(data,compObs);
+    return compObs;
 }
 
 
@@ -198,6 +305,104 @@ merge(const IndelErrorContextObservationData& in)
 
 
 
+void
+IndelErrorContextObservationData::
+merge(const std::vector<const IndelErrorContextObservationData*>& inputs)
+{
+    std::vector<const data_t*> inputData;
+    for (const auto* inputPtr : inputs)
+    {
+        inputData.push_back(&(inputPtr->data));
+    }
+    mergeSortedCountMaps(inputData, data);
+}
+
+
+
+void
+IndelErrorContextObservationData::
+writeBinary(std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    const unsigned observationCount(data.size());
+    std::vector<uint32_t> observationTotal;
+    std::vector<uint32_t> refCount;
+    std::vector<uint8_t> status;
+    std::array<std::vector<uint32_t>,INDEL_SIGNAL_TYPE::SIZE> signalCounts;
+    observationTotal.reserve(observationCount);
+    refCount.reserve(observationCount);
+    status.reserve(observationCount);
+    for (auto& signalCount : signalCounts)
+    {
+        signalCount.reserve(observationCount);
+    }
+
+    for (const auto& value : data)
+    {
+        observationTotal.push_back(value.second);
+        refCount.push_back(value.first.refCount);
+        status.push_back(value.first.variantStatus);
+        for (unsigned signalIndex(0); signalIndex<INDEL_SIGNAL_TYPE::SIZE; ++signalIndex)
+        {
+            signalCounts[signalIndex].push_back(value.first.signalCounts[signalIndex]);
+        }
+    }
+
+    writeColumn(os, observationTotal);
+    writeColumn(os, refCount);
+    writeColumn(os, status);
+    for (const auto& signalCount : signalCounts)
+    {
+        writeColumn(os, signalCount);
+    }
+}
+
+
+
+void
+IndelErrorContextObservationData::
+readBinary(std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    data.clear();
+
+    std::vector<uint32_t> observationTotal;
+    std::vector<uint32_t> refCount;
+    std::vector<uint8_t> status;
+    std::array<std::vector<uint32_t>,INDEL_SIGNAL_TYPE::SIZE> signalCounts;
+    readColumn(is, observationTotal);
+    readColumn(is, refCount);
+    readColumn(is, status);
+    for (auto& signalCount : signalCounts)
+    {
+        readColumn(is, signalCount);
+    }
+
+    const unsigned observationCount(observationTotal.size());
+    bool isValid((refCount.size() == observationCount) && (status.size() == observationCount));
+    for (const auto& signalCount : signalCounts)
+    {
+        if (signalCount.size() != observationCount) isValid = false;
+    }
+    if (not isValid) throwInvalidColumns("indel error observations");
+
+    for (unsigned observationIndex(0); observationIndex < observationCount; ++observationIndex)
+    {
+        IndelErrorContextObservation obs;
+        obs.refCount = refCount[observationIndex];
+        obs.variantStatus = getGenotypeStatus(status[observationIndex]);
+        for (unsigned signalIndex(0); signalIndex<INDEL_SIGNAL_TYPE::SIZE; ++signalIndex)
+        {
+            obs.signalCounts[signalIndex] = signalCounts[signalIndex][observationIndex];
+        }
+        data.emplace_hint(data.end(), obs, observationTotal[observationIndex]);
+    }
+}
+
+
+
 void
 IndelErrorContextObservationData::
 dump(
@@ -333,6 +538,61 @@ merge(
 
 
 
+void
+IndelErrorData::
+merge(
+    const std::vector<const IndelErrorData*>& inputs)
+{
+    std::vector<const IndelBackgroundObservationData*> inputBackground;
+    std::vector<const IndelErrorContextObservationData*> inputError;
+    for (const auto* inputPtr : inputs)
+    {
+        inputBackground.push_back(&(inputPtr->background));
+        inputError.push_back(&(inputPtr->error));
+        depthSupport.merge(inputPtr->depthSupport);
+        excludedRegionSkipped += inputPtr->excludedRegionSkipped;
+        depthSkipped += inputPtr->depthSkipped;
+    }
+    background.merge(inputBackground);
+    error.merge(inputError);
+}
+
+
+
+void
+IndelErrorData::
+writeBinary(
+    std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    writeValue(os, depthSupport.depth);
+    writeValue(os, depthSupport.supportCount);
+    writeValue(os, excludedRegionSkipped);
+    writeValue(os, depthSkipped);
+    background.writeBinary(os);
+    error.writeBinary(os);
+}
+
+
+
+void
+IndelErrorData::
+readBinary(
+    std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    readValue(is, depthSupport.depth);
+    readValue(is, depthSupport.supportCount);
+    readValue(is, excludedRegionSkipped);
+    readValue(is, depthSkipped);
+    background.readBinary(is);
+    error.readBinary(is);
+}
+
+
+
 void
 IndelErrorData::
 dump(
@@ -397,6 +657,18 @@ addDepthSkip(
 
 
 
+void
+IndelErrorCounts::
+mergeContext(
+    const IndelErrorContext& context,
+    const IndelErrorData& data)
+{
+    const auto iter(getContextIterator(context));
+    iter->second.merge(data);
+}
+
+
+
 void
 IndelErrorCounts::
 merge(
@@ -419,6 +691,71 @@ merge(
 
 
 
+void
+IndelErrorCounts::
+merge(
+    const std::vector<const IndelErrorCounts*>& inputs)
+{
+    std::vector<const data_t*> inputData;
+    for (const auto* inputPtr : inputs)
+    {
+        inputData.push_back(&(inputPtr->_data));
+    }
+    mergeSortedMaps(inputData, _data,
+                    [](const std::vector<const IndelErrorData*>& values, IndelErrorData& mergedValue)
+    {
+        mergedValue.merge(values);
+    });
+}
+
+
+
+void
+IndelErrorCounts::
+writeBinary(
+    std::ostream& os) const
+{
+    using namespace BinaryColumnIO;
+
+    const uint64_t contextCount(_data.size());
+    writeValue(os, contextCount);
+    for (const auto& value : _data)
+    {
+        const uint32_t repeatPatternSize(value.first.getRepeatPatternSize());
+        const uint32_t repeatCount(value.first.getRepeatCount());
+        writeValue(os, repeatPatternSize);
+        writeValue(os, repeatCount);
+        value.second.writeBinary(os);
+    }
+}
+
+
+
+void
+IndelErrorCounts::
+readBinary(
+    std::istream& is)
+{
+    using namespace BinaryColumnIO;
+
+    _data.clear();
+
+    uint64_t contextCount(0);
+    readValue(is, contextCount);
+    for (uint64_t contextIndex(0); contextIndex < contextCount; ++contextIndex)
+    {
+        uint32_t repeatPatternSize(0);
+        uint32_t repeatCount(0);
+        readValue(is, repeatPatternSize);
+        readValue(is, repeatCount);
+        const IndelErrorContext context(repeatPatternSize, repeatCount);
+        const auto iter(_data.emplace_hint(_data.end(), context, IndelErrorData()));
+        iter->second.readBinary(is);
+    }
+}
+
+
+
 void
 IndelErrorCounts::
 dump(
@@ -134,6 +134,11 @@ struct IndelErrorContext
         : repeatPatternSize(initRepeatingPatternSize), repeatCount(initRepeatCount)
     {}
 
+    bool operator==(const IndelErrorContext& rhs) const
+    {
+        return ((repeatPatternSize == rhs.repeatPatternSize) && (repeatCount == rhs.repeatCount));
+    }
+
     bool operator<(const IndelErrorContext& rhs) const
     {
         if (repeatPatternSize < rhs.repeatPatternSize)
@@ -185,6 +190,13 @@ struct IndelBackgroundObservation
         backgroundStatus = assignStatus(knownVariantOlap);
     }
 
+    bool
+    operator==(
+        const IndelBackgroundObservation& rhs) const
+    {
+        return ((depth == rhs.depth) && (backgroundStatus == rhs.backgroundStatus));
+    }
+
     bool
     operator<(
         const IndelBackgroundObservation& rhs) const
@@ -223,9 +235,36 @@ public:
     addObservation(
         const IndelBackgroundObservation& obs);
 
+    /// add count observations of a pattern which has already been compressed by getCompressedObservation
+    void
+    addCompressedObservation(
+        const IndelBackgroundObservation& compObs,
+        const unsigned count)
+    {
+        data[compObs] += count;
+    }
+
+    /// get the compressed observation pattern which addObservation uses to summarize obs
+    static
+    IndelBackgroundObservation
+    getCompressedObservation(
+        const IndelBackgroundObservation& obs);
+
     void
     merge(const IndelBackgroundObservationData& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const IndelBackgroundObservationData*>& inputs);
+
+    /// write in the columnar binary counts file format
+    void
+    writeBinary(std::ostream& os) const;
+
+    /// read from the columnar binary counts file format, replacing any existing data
+    void
+    readBinary(std::istream& is);
+
     const_iterator
     begin() const
     {
@@ -310,6 +349,15 @@ struct IndelErrorContextObservation
         return (refCount+totalSignalCount());
     }
 
+    bool
+    operator==(
+        const IndelErrorContextObservation& rhs) const
+    {
+        return ((refCount == rhs.refCount) &&
+                (signalCounts == rhs.signalCounts) &&
+                (variantStatus == rhs.variantStatus));
+    }
+
     bool
     operator<(
         const IndelErrorContextObservation& rhs) const
@@ -355,9 +403,36 @@ public:
     addObservation(
         const IndelErrorContextObservation& obs);
 
+    /// add count observations of a pattern which has already been compressed by getCompressedObservation
+    void
+    addCompressedObservation(
+        const IndelErrorContextObservation& compObs,
+        const unsigned count)
+    {
+        data[compObs] += count;
+    }
+
+    /// get the compressed observation pattern which addObservation uses to summarize obs
+    static
+    IndelErrorContextObservation
+    getCompressedObservation(
+        const IndelErrorContextObservation& obs);
+
     void
     merge(const IndelErrorContextObservationData& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const IndelErrorContextObservationData*>& inputs);
+
+    /// write in the columnar binary counts file format
+    void
+    writeBinary(std::ostream& os) const;
+
+    /// read from the columnar binary counts file format, replacing any existing data
+    void
+    readBinary(std::istream& is);
+
     const_iterator
     begin() const
     {
@@ -421,6 +496,18 @@ struct IndelErrorData
     void
     merge(const IndelErrorData& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const IndelErrorData*>& inputs);
+
+    /// write in the columnar binary counts file format
+    void
+    writeBinary(std::ostream& os) const;
+
+    /// read from the columnar binary counts file format, replacing any existing data
+    void
+    readBinary(std::istream& is);
+
     /// debug output
     void
     dump(std::ostream& os) const;
@@ -472,9 +559,27 @@ public:
     addDepthSkip(
         const IndelErrorContext& context);
 
+    /// merge data into the counts for a single context
+    void
+    mergeContext(
+        const IndelErrorContext& context,
+        const IndelErrorData& data);
+
     void
     merge(const IndelErrorCounts& in);
 
+    /// merge all inputs into this object in a single k-way merge
+    void
+    merge(const std::vector<const IndelErrorCounts*>& inputs);
+
+    /// write in the columnar binary counts file format
+    void
+    writeBinary(std::ostream& os) const;
+
+    /// read from the columnar binary counts file format, replacing any existing data
+    void
+    readBinary(std::istream& is);
+
     void
     clear()
     {
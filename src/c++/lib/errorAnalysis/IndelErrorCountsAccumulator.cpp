@@ -0,0 +1,75 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#include "IndelErrorCountsAccumulator.hh"
+
+
+
+void
+IndelErrorCountsAccumulator::
+addError(
+    const IndelErrorContext& context,
+    const IndelErrorContextObservation& errorObservation,
+    const unsigned depth)
+{
+    ContextData& contextData(_data.getRef(context));
+    contextData.error.getRef(IndelErrorContextObservationData::getCompressedObservation(errorObservation))++;
+    contextData.depthSupport.merge(IndelDepthSupportTotal(depth,errorObservation.totalCount()));
+}
+
+
+
+void
+IndelErrorCountsAccumulator::
+addBackground(
+    const IndelErrorContext& context,
+    const IndelBackgroundObservation& backgroundObservation)
+{
+    ContextData& contextData(_data.getRef(context));
+    contextData.background.getRef(IndelBackgroundObservationData::getCompressedObservation(backgroundObservation))++;
+}
+
+
+
+void
+IndelErrorCountsAccumulator::
+exportCounts(
+    IndelErrorCounts& counts) const
+{
+    _data.forEach([&](const IndelErrorContext& context, const ContextData& contextData)
+    {
+        IndelErrorData data;
+        contextData.background.forEach([&](const IndelBackgroundObservation& compObs, const unsigned count)
+        {
+            data.background.addCompressedObservation(compObs, count);
+        });
+        contextData.error.forEach([&](const IndelErrorContextObservation& compObs, const unsigned count)
+        {
+            data.error.addCompressedObservation(compObs, count);
+        });
+        data.depthSupport = contextData.depthSupport;
+        data.excludedRegionSkipped = contextData.excludedRegionSkipped;
+        data.depthSkipped = contextData.depthSkipped;
+        counts.mergeContext(context, data);
+    });
+}
@@ -0,0 +1,132 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "IndelErrorCounts.hh"
+#include "blt_util/FlatHashMap.hh"
+
+#include "boost/functional/hash.hpp"
+
+
+struct IndelErrorContextHash
+{
+    size_t
+    operator()(const IndelErrorContext& context) const
+    {
+        size_t seed(0);
+        boost::hash_combine(seed, context.getRepeatPatternSize());
+        boost::hash_combine(seed, context.getRepeatCount());
+        return seed;
+    }
+};
+
+
+struct IndelBackgroundObservationHash
+{
+    size_t
+    operator()(const IndelBackgroundObservation& obs) const
+    {
+        size_t seed(0);
+        boost::hash_combine(seed, obs.depth);
+        boost::hash_combine(seed, static_cast<int>(obs.backgroundStatus));
+        return seed;
+    }
+};
+
+
+struct IndelErrorContextObservationHash
+{
+    size_t
+    operator()(const IndelErrorContextObservation& obs) const
+    {
+        size_t seed(0);
+        boost::hash_combine(seed, obs.refCount);
+        boost::hash_combine(seed, static_cast<int>(obs.variantStatus));
+        for (const unsigned signalCount : obs.signalCounts)
+        {
+            boost::hash_combine(seed, signalCount);
+        }
+        return seed;
+    }
+};
+
+
+/// accumulates indel error counts with the same interface as IndelErrorCounts, but using flat hash tables
+/// in place of sorted maps
+///
+/// the accumulated counts are transferred into the sorted IndelErrorCounts representation once with
+/// exportCounts, which produces exactly the same result as adding each observation to IndelErrorCounts
+/// directly.
+struct IndelErrorCountsAccumulator
+{
+    void
+    addError(
+        const IndelErrorContext& context,
+        const IndelErrorContextObservation& errorObservation,
+        const unsigned depth);
+
+    void
+    addBackground(
+        const IndelErrorContext& context,
+        const IndelBackgroundObservation& backgroundObservation);
+
+    void
+    addExcludedRegionSkip(
+        const IndelErrorContext& context)
+    {
+        _data.getRef(context).excludedRegionSkipped++;
+    }
+
+    void
+    addDepthSkip(
+        const IndelErrorContext& context)
+    {
+        _data.getRef(context).depthSkipped++;
+    }
+
+    /// merge all accumulated counts into counts
+    void
+    exportCounts(
+        IndelErrorCounts& counts) const;
+
+    void
+    clear()
+    {
+        _data.clear();
+    }
+
+private:
+    struct ContextData
+    {
+        /// values are the number of observations of each compressed observation pattern
+        FlatHashMap<IndelBackgroundObservation,unsigned,IndelBackgroundObservationHash> background;
+        FlatHashMap<IndelErrorContextObservation,unsigned,IndelErrorContextObservationHash> error;
+
+        IndelDepthSupportTotal depthSupport;
+        uint64_t excludedRegionSkipped = 0;
+        uint64_t depthSkipped = 0;
+    };
+
+    FlatHashMap<IndelErrorContext,ContextData,IndelErrorContextHash> _data;
+};
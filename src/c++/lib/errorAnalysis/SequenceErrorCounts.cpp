@@ -22,50 +22,96 @@
 ///
 
 #include "SequenceErrorCounts.hh"
+#include "common/BinaryColumnIO.hh"
 #include "common/Exceptions.hh"
 #include "boost/archive/binary_iarchive.hpp"
-#include "boost/archive/binary_oarchive.hpp"
 
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 
 
+/// identifies the columnar binary counts file format, this cannot match the start of a boost binary archive
+static const char countsFileMagic[8] = {'S','T','R','K','S','E','C','\0'};
+
+/// increment when the counts file format changes
+static const uint32_t countsFileVersion(1);
+
+
+
+static
+void
+checkSampleNames(
+    const std::string& sampleName1,
+    const std::string& sampleName2)
+{
+    if (sampleName1.empty() || sampleName2.empty()) return;
+    if (sampleName1 == sampleName2) return;
+
+    using namespace illumina::common;
+    std::ostringstream oss;
+    oss << "ERROR: Attempted to merge SequenceErrorCounts with different sample names: '" << sampleName1 << "' and '" << sampleName2 << "'\n";
+    BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+}
+
+
+
 void
 SequenceErrorCounts::
 merge(
     const SequenceErrorCounts& in)
 {
-    if (!_sampleName.empty() && !in._sampleName.empty())
-    {
-        if (_sampleName != in._sampleName)
-        {
-            using namespace illumina::common;
-            std::ostringstream oss;
-            oss << "ERROR: Attempted to merge SequenceErrorCounts with different sample names: '" << _sampleName << "' and '" << in._sampleName << "'\n";
-            BOOST_THROW_EXCEPTION(LogicException(oss.str()));
-        }
-    }
+    checkSampleNames(_sampleName, in._sampleName);
     _sampleName = in._sampleName;
     _bases.merge(in._bases);
     _indels.merge(in._indels);
 }
 
 
+
+void
+SequenceErrorCounts::
+merge(
+    const std::vector<const SequenceErrorCounts*>& inputs)
+{
+    std::vector<const BaseErrorCounts*> inputBases;
+    std::vector<const IndelErrorCounts*> inputIndels;
+    for (const auto* inputPtr : inputs)
+    {
+        checkSampleNames(_sampleName, inputPtr->_sampleName);
+        if (_sampleName.empty()) _sampleName = inputPtr->_sampleName;
+        inputBases.push_back(&(inputPtr->_bases));
+        inputIndels.push_back(&(inputPtr->_indels));
+    }
+    _bases.merge(inputBases);
+    _indels.merge(inputIndels);
+}
+
+
 void
 SequenceErrorCounts::
 save(
     const char* filename) const
 {
-    using namespace boost::archive;
+    using namespace BinaryColumnIO;
 
     assert(nullptr != filename);
     std::ofstream ofs(filename, std::ios::binary);
-    binary_oarchive oa(ofs);
 
-    oa << _sampleName;
-    oa << _bases;
-    oa << _indels;
+    ofs.write(countsFileMagic, sizeof(countsFileMagic));
+    writeValue(ofs, countsFileVersion);
+    writeString(ofs, _sampleName);
+    _bases.writeBinary(ofs);
+    _indels.writeBinary(ofs);
+
+    if (! ofs)
+    {
+        using namespace illumina::common;
+        std::ostringstream oss;
+        oss << "ERROR: Failed to write counts file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
 }
 
 
@@ -75,17 +121,52 @@ SequenceErrorCounts::
 load(
     const char* filename)
 {
-    using namespace boost::archive;
+    using namespace illumina::common;
 
     clear();
 
     assert(nullptr != filename);
     std::ifstream ifs(filename, std::ios::binary);
-    binary_iarchive ia(ifs);
+    if (! ifs)
+    {
+        std::ostringstream oss;
+        oss << "ERROR: Failed to open counts file: '" << filename << "'\n";
+        BOOST_THROW_EXCEPTION(LogicException(oss.str()));
+    }
 
-    ia >> _sampleName;
-    ia >> _bases;
-    ia >> _indels;
+    char magic[sizeof(countsFileMagic)];
+    ifs.read(magic, sizeof(magic));
+    if (ifs && (std::memcmp(magic, countsFileMagic, sizeof(magic)) == 0))
+    {
+        using namespace BinaryColumnIO;
+
+        uint32_t version(0);
+        readValue(ifs, version);
+        if (version != countsFileVersion)
+        {
+            std::ostringstream oss;
+            oss << "ERROR: Unsupported counts file format version '" << version << "' in file: '" << filename << "'\n";
+            BOOST_THROW_EXCEPTION(UnsupportedVersionException(oss.str()));
+        }
+
+        readFromFile(filename, [&]()
+        {
+            readString(ifs, _sampleName);
+            _bases.readBinary(ifs);
+            _indels.readBinary(ifs);
+        });
+    }
+    else
+    {
+        // fall back to the earlier boost serialization format:
+        ifs.clear();
+        ifs.seekg(0);
+        boost::archive::binary_iarchive ia(ifs);
+
+        ia >> _sampleName;
+        ia >> _bases;
+        ia >> _indels;
+    }
 }
 
 
@@ -70,6 +70,13 @@ struct SequenceErrorCounts
     void
     merge(const SequenceErrorCounts& in);
 
+    /// merge all inputs into this object
+    ///
+    /// The sorted counts of all inputs are combined in a single k-way merge, which is much faster than
+    /// merging each input in turn when the input count is high.
+    void
+    merge(const std::vector<const SequenceErrorCounts*>& inputs);
+
     void
     clear()
     {
@@ -82,9 +89,12 @@ struct SequenceErrorCounts
     {
         _sampleName = sampleName;
     }
+    /// save counts in the current columnar binary counts file format
     void
     save(const char* filename) const;
 
+    /// load counts from any supported counts file format version, or from the earlier boost
+    /// serialization format
     void
     load(const char* filename);
 
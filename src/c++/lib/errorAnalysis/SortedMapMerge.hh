@@ -0,0 +1,113 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+///
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+
+/// k-way merge of sorted maps
+///
+/// All input maps are traversed together in key order using a heap of input iterators. For each
+/// distinct key, the values from all inputs containing the key are passed to \p mergeValues,
+/// which combines them into the value of the output entry. The output map is built in key order
+/// so that every output node is inserted in constant time.
+///
+/// \param[in] mergeValues functor with signature void(const std::vector<const V*>& values, V& mergedValue)
+/// \param[in,out] output merged map, any existing content is merged as one more input
+///
+template <typename K, typename V, typename MergeValues>
+void
+mergeSortedMaps(
+    const std::vector<const std::map<K,V>*>& inputs,
+    std::map<K,V>& output,
+    MergeValues mergeValues)
+{
+    std::map<K,V> current;
+    current.swap(output);
+
+    typedef typename std::map<K,V>::const_iterator iter_t;
+    typedef std::pair<iter_t,iter_t> range_t;
+    auto isHeadKeyGreater = [](const range_t& a, const range_t& b)
+    {
+        return (b.first->first < a.first->first);
+    };
+
+    std::vector<range_t> heap;
+    for (const auto* inputPtr : inputs)
+    {
+        if (inputPtr->empty()) continue;
+        heap.emplace_back(inputPtr->begin(), inputPtr->end());
+    }
+    if (not current.empty())
+    {
+        heap.emplace_back(current.begin(), current.end());
+    }
+    std::make_heap(heap.begin(), heap.end(), isHeadKeyGreater);
+
+    std::vector<const V*> keyValues;
+    while (not heap.empty())
+    {
+        const K& key(heap.front().first->first);
+        keyValues.clear();
+        while ((not heap.empty()) && (not (key < heap.front().first->first)))
+        {
+            std::pop_heap(heap.begin(), heap.end(), isHeadKeyGreater);
+            range_t& range(heap.back());
+            keyValues.push_back(&(range.first->second));
+            ++range.first;
+            if (range.first == range.second)
+            {
+                heap.pop_back();
+            }
+            else
+            {
+                std::push_heap(heap.begin(), heap.end(), isHeadKeyGreater);
+            }
+        }
+
+        const auto outputIter(output.emplace_hint(output.end(), key, V()));
+        mergeValues(keyValues, outputIter->second);
+    }
+}
+
+
+/// k-way merge of sorted maps where the values of each key are summed
+template <typename K, typename V>
+void
+mergeSortedCountMaps(
+    const std::vector<const std::map<K,V>*>& inputs,
+    std::map<K,V>& output)
+{
+    mergeSortedMaps(inputs, output,
+                    [](const std::vector<const V*>& values, V& mergedValue)
+    {
+        for (const V* value : values)
+        {
+            mergedValue += *value;
+        }
+    });
+}
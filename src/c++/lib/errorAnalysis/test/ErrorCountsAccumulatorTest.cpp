@@ -0,0 +1,148 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "BaseErrorCountsAccumulator.hh"
+#include "IndelErrorCountsAccumulator.hh"
+
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( ErrorCountsAccumulator_test )
+
+
+/// simple deterministic pseudo-random sequence for generating test observations
+struct TestSequence
+{
+    unsigned
+    next(const unsigned range)
+    {
+        state = (state * 1103515245u) + 12345u;
+        return ((state >> 16) % range);
+    }
+
+    unsigned state = 1;
+};
+
+
+BOOST_AUTO_TEST_CASE( test_base_accumulator_matches_counts )
+{
+    TestSequence seq;
+    BaseErrorCounts counts;
+    BaseErrorCountsAccumulator accumulator;
+
+    // reuse one input observation to test that clear() fully resets it:
+    BaseErrorContextInputObservation reusedObs;
+    for (unsigned siteIndex(0); siteIndex < 2000; ++siteIndex)
+    {
+        BaseErrorContext context;
+        context.repeatCount = 1 + seq.next(3);
+
+        BaseErrorContextInputObservation obs;
+        reusedObs.clear();
+        const unsigned readCount(seq.next(40));
+        for (unsigned readIndex(0); readIndex < readCount; ++readIndex)
+        {
+            const bool isFwdStrand(seq.next(2) == 0);
+            const uint16_t qual(25 + seq.next(20));
+            if (seq.next(20) == 0)
+            {
+                obs.addAltCount(isFwdStrand, qual);
+                reusedObs.addAltCount(isFwdStrand, qual);
+            }
+            else
+            {
+                obs.addRefCount(isFwdStrand, qual);
+                reusedObs.addRefCount(isFwdStrand, qual);
+            }
+        }
+
+        counts.addSiteObservation(context, obs);
+        accumulator.addSiteObservation(context, reusedObs);
+
+        if (seq.next(10) == 0)
+        {
+            counts.addDepthSkip(context);
+            accumulator.addDepthSkip(context);
+        }
+        if (seq.next(15) == 0)
+        {
+            counts.addNoiseSkip(context);
+            accumulator.addNoiseSkip(context);
+        }
+    }
+
+    BaseErrorCounts accumulatedCounts;
+    accumulator.exportCounts(accumulatedCounts);
+
+    std::ostringstream expected, result;
+    counts.writeBinary(expected);
+    accumulatedCounts.writeBinary(result);
+    BOOST_REQUIRE_EQUAL(result.str(), expected.str());
+}
+
+
+BOOST_AUTO_TEST_CASE( test_indel_accumulator_matches_counts )
+{
+    TestSequence seq;
+    IndelErrorCounts counts;
+    IndelErrorCountsAccumulator accumulator;
+
+    for (unsigned siteIndex(0); siteIndex < 2000; ++siteIndex)
+    {
+        const IndelErrorContext context(1 + seq.next(2), 1 + seq.next(8));
+        const unsigned depth(seq.next(100));
+
+        if (seq.next(4) == 0)
+        {
+            IndelErrorContextObservation errorObs;
+            errorObs.refCount = seq.next(60);
+            errorObs.signalCounts[seq.next(INDEL_SIGNAL_TYPE::SIZE)] = 1 + seq.next(10);
+            errorObs.variantStatus = (seq.next(5) == 0) ? GENOTYPE_STATUS::HET : GENOTYPE_STATUS::UNKNOWN;
+            counts.addError(context, errorObs, depth);
+            accumulator.addError(context, errorObs, depth);
+        }
+        else
+        {
+            IndelBackgroundObservation backgroundObs;
+            backgroundObs.depth = depth;
+            backgroundObs.backgroundStatus = (seq.next(5) == 0) ? GENOTYPE_STATUS::HOMALT : GENOTYPE_STATUS::UNKNOWN;
+            counts.addBackground(context, backgroundObs);
+            accumulator.addBackground(context, backgroundObs);
+        }
+
+        if (seq.next(10) == 0)
+        {
+            counts.addExcludedRegionSkip(context);
+            accumulator.addExcludedRegionSkip(context);
+        }
+    }
+
+    IndelErrorCounts accumulatedCounts;
+    accumulator.exportCounts(accumulatedCounts);
+
+    std::ostringstream expected, result;
+    counts.writeBinary(expected);
+    accumulatedCounts.writeBinary(result);
+    BOOST_REQUIRE_EQUAL(result.str(), expected.str());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,222 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "boost/test/unit_test.hpp"
+
+#include "SequenceErrorCounts.hh"
+#include "common/Exceptions.hh"
+
+#include "boost/archive/binary_oarchive.hpp"
+#include "boost/filesystem.hpp"
+
+#include <fstream>
+#include <sstream>
+
+
+BOOST_AUTO_TEST_SUITE( SequenceErrorCounts_test )
+
+
+/// create a counts object with a mix of observations determined by the seed
+static
+void
+addTestCounts(
+    const unsigned seed,
+    SequenceErrorCounts& counts)
+{
+    counts.setSampleName("sample");
+
+    for (unsigned siteIndex(0); siteIndex < 20; ++siteIndex)
+    {
+        BaseErrorContext context;
+        context.repeatCount = 1 + ((seed + siteIndex) % 3);
+
+        BaseErrorContextInputObservation obs;
+        for (unsigned readIndex(0); readIndex < (5 + (siteIndex % 4)); ++readIndex)
+        {
+            obs.addRefCount((readIndex % 2) == 0, 30 + (readIndex % 2) * 10);
+        }
+        if (((seed + siteIndex) % 5) == 0)
+        {
+            obs.addAltCount(true, 20 + seed);
+        }
+        counts.getBaseCounts().addSiteObservation(context, obs);
+        if ((siteIndex % 7) == 0)
+        {
+            counts.getBaseCounts().addDepthSkip(context);
+        }
+    }
+
+    for (unsigned indelIndex(0); indelIndex < 10; ++indelIndex)
+    {
+        const IndelErrorContext context(1 + (indelIndex % 2), 1 + ((seed + indelIndex) % 4));
+
+        IndelErrorContextObservation errorObs;
+        errorObs.refCount = 10 + ((seed * indelIndex) % 6);
+        errorObs.signalCounts[INDEL_SIGNAL_TYPE::DELETE_1] = (indelIndex % 3);
+        errorObs.variantStatus = GENOTYPE_STATUS::UNKNOWN;
+        counts.getIndelCounts().addError(context, errorObs, 12 + seed);
+
+        IndelBackgroundObservation backgroundObs;
+        backgroundObs.depth = 20 + ((seed + indelIndex) % 5);
+        backgroundObs.backgroundStatus = ((indelIndex % 4) == 0) ? GENOTYPE_STATUS::HET : GENOTYPE_STATUS::UNKNOWN;
+        counts.getIndelCounts().addBackground(context, backgroundObs);
+        if ((indelIndex % 3) == 0)
+        {
+            counts.getIndelCounts().addExcludedRegionSkip(context);
+        }
+    }
+}
+
+
+/// get a string representation of all counts data for comparison
+static
+std::string
+getBinaryCounts(
+    const SequenceErrorCounts& counts)
+{
+    std::ostringstream oss;
+    counts.getBaseCounts().writeBinary(oss);
+    counts.getIndelCounts().writeBinary(oss);
+    return oss.str();
+}
+
+
+BOOST_AUTO_TEST_CASE( test_kway_merge_matches_pairwise_merge )
+{
+    static const unsigned inputCount(5);
+    std::vector<SequenceErrorCounts> inputs(inputCount);
+    std::vector<const SequenceErrorCounts*> inputPtrs;
+    for (unsigned inputIndex(0); inputIndex < inputCount; ++inputIndex)
+    {
+        addTestCounts(inputIndex, inputs[inputIndex]);
+        inputPtrs.push_back(&inputs[inputIndex]);
+    }
+
+    SequenceErrorCounts pairwiseCounts;
+    for (const auto& input : inputs)
+    {
+        pairwiseCounts.merge(input);
+    }
+
+    SequenceErrorCounts kwayCounts;
+    kwayCounts.merge(inputPtrs);
+    BOOST_REQUIRE_EQUAL(kwayCounts.getSampleName(), "sample");
+    BOOST_REQUIRE_EQUAL(getBinaryCounts(kwayCounts), getBinaryCounts(pairwiseCounts));
+
+    // existing counts should be included in the k-way merge:
+    SequenceErrorCounts partialCounts(inputs[0]);
+    inputPtrs.erase(inputPtrs.begin());
+    partialCounts.merge(inputPtrs);
+    BOOST_REQUIRE_EQUAL(getBinaryCounts(partialCounts), getBinaryCounts(pairwiseCounts));
+}
+
+
+BOOST_AUTO_TEST_CASE( test_save_load )
+{
+    namespace bf = boost::filesystem;
+    const bf::path countsPath(bf::temp_directory_path() / bf::unique_path("SequenceErrorCounts_test_%%%%-%%%%.bin"));
+
+    SequenceErrorCounts counts;
+    addTestCounts(3, counts);
+    counts.save(countsPath.string().c_str());
+
+    SequenceErrorCounts loadedCounts;
+    loadedCounts.load(countsPath.string().c_str());
+    bf::remove(countsPath);
+
+    BOOST_REQUIRE_EQUAL(loadedCounts.getSampleName(), "sample");
+    BOOST_REQUIRE_EQUAL(getBinaryCounts(loadedCounts), getBinaryCounts(counts));
+}
+
+
+BOOST_AUTO_TEST_CASE( test_load_legacy_format )
+{
+    namespace bf = boost::filesystem;
+    const bf::path countsPath(bf::temp_directory_path() / bf::unique_path("SequenceErrorCounts_test_%%%%-%%%%.bin"));
+
+    SequenceErrorCounts counts;
+    addTestCounts(2, counts);
+    {
+        // write counts in the earlier boost serialization format:
+        std::ofstream ofs(countsPath.string().c_str(), std::ios::binary);
+        boost::archive::binary_oarchive oa(ofs);
+        const std::string sampleName(counts.getSampleName());
+        oa << sampleName;
+        oa << counts.getBaseCounts();
+        oa << counts.getIndelCounts();
+    }
+
+    SequenceErrorCounts loadedCounts;
+    loadedCounts.load(countsPath.string().c_str());
+    bf::remove(countsPath);
+
+    BOOST_REQUIRE_EQUAL(loadedCounts.getSampleName(), "sample");
+    BOOST_REQUIRE_EQUAL(getBinaryCounts(loadedCounts), getBinaryCounts(counts));
+}
+
+
+BOOST_AUTO_TEST_CASE( test_load_truncated )
+{
+    namespace bf = boost::filesystem;
+    const bf::path countsPath(bf::temp_directory_path() / bf::unique_path("SequenceErrorCounts_test_%%%%-%%%%.bin"));
+
+    SequenceErrorCounts counts;
+    addTestCounts(1, counts);
+    counts.save(countsPath.string().c_str());
+    bf::resize_file(countsPath, bf::file_size(countsPath) / 2);
+
+    SequenceErrorCounts loadedCounts;
+    BOOST_REQUIRE_THROW(loadedCounts.load(countsPath.string().c_str()), std::exception);
+    bf::remove(countsPath);
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_load_corrupt_size )
+{
+    namespace bf = boost::filesystem;
+    const bf::path countsPath(bf::temp_directory_path() / bf::unique_path("SequenceErrorCounts_test_%%%%-%%%%.bin"));
+
+    SequenceErrorCounts counts;
+    addTestCounts(1, counts);
+    counts.save(countsPath.string().c_str());
+    {
+        // overwrite the sample name size, which follows the 8 byte file magic and 4 byte version:
+        std::fstream fs(countsPath.string().c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        fs.seekp(12);
+        const uint64_t corruptSize(static_cast<uint64_t>(1) << 60);
+        fs.write(reinterpret_cast<const char*>(&corruptSize), sizeof(corruptSize));
+    }
+
+    SequenceErrorCounts loadedCounts;
+    bool isThrown(false);
+    try
+    {
+        loadedCounts.load(countsPath.string().c_str());
+    }
+    catch (const illumina::common::LogicException& e)
+    {
+        isThrown = true;
+        BOOST_REQUIRE(e.getMessage().find(countsPath.string()) != std::string::npos);
+    }
+    bf::remove(countsPath);
+    BOOST_REQUIRE(isThrown);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
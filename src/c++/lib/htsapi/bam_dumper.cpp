@@ -34,7 +34,8 @@
 
 bam_dumper::
 bam_dumper(const char* filename,
-           const bam_hdr_t& header)
+           const bam_hdr_t& header,
+           const unsigned threadCount)
     : _hdr(&header),
       _stream_name(filename)
 {
@@ -49,6 +50,16 @@ bam_dumper(const char* filename,
         throw blt_exception(oss.str().c_str());
     }
 
+    if (threadCount > 1)
+    {
+        if (hts_set_threads(_hfp, threadCount) != 0)
+        {
+            std::ostringstream oss;
+            oss << "Failed to start " << threadCount << " compression threads for SAM/BAM/CRAM file: '" << filename << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+    }
+
     const int retval = sam_hdr_write(_hfp,_hdr);
     if (retval != 0)
     {
@@ -30,9 +30,11 @@
 
 struct bam_dumper
 {
+    /// \param threadCount number of threads used for BGZF compression of the output
     bam_dumper(
         const char* filename,
-        const bam_hdr_t& header);
+        const bam_hdr_t& header,
+        const unsigned threadCount = 1);
 
     ~bam_dumper();
 
@@ -29,6 +29,7 @@
 #include <cassert>
 #include <cstdlib>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -102,6 +103,7 @@ bam_streamer(
 bam_streamer::
 ~bam_streamer()
 {
+    _clearRegionPlan();
     if (nullptr != _hitr) hts_itr_destroy(_hitr);
     if (nullptr != _hidx) hts_idx_destroy(_hidx);
     if (nullptr != _hdr) bam_hdr_destroy(_hdr);
@@ -205,6 +207,9 @@ resetRegion(
     int beginPos,
     int endPos)
 {
+    if (_resetPlanRegion(referenceContigId, beginPos, endPos)) return;
+    _clearRegionPlan();
+
     if (nullptr != _hitr) hts_itr_destroy(_hitr);
 
     _load_index();
@@ -232,6 +237,241 @@ resetRegion(
 
 
 
+bool
+bam_streamer::
+getIndexReadCounts(
+    const int referenceContigId,
+    uint64_t& mappedCount,
+    uint64_t& unmappedCount)
+{
+    mappedCount=0;
+    unmappedCount=0;
+
+    // CRAI indexes do not store per-contig read counts:
+    if (hts_get_format(_hfp)->format != bam) return false;
+
+    _load_index();
+
+    return (hts_idx_get_stat(_hidx, referenceContigId, &mappedCount, &unmappedCount) >= 0);
+}
+
+
+
+void
+bam_streamer::
+setRegionPlan(const std::vector<std::string>& regions)
+{
+    _clearRegionPlan();
+
+    // a single region gains nothing from the plan:
+    if (regions.size() < 2) return;
+
+    // index chunk merging is only valid for BAM, CRAM iterators do not expose a chunk list:
+    if (hts_get_format(_hfp)->format != bam) return;
+
+    _load_index();
+
+    int32_t referenceContigId(-1);
+    for (const std::string& region : regions)
+    {
+        int32_t regionContigId, beginPos, endPos;
+        parse_bam_region_from_hdr(_hdr, region.c_str(), regionContigId, beginPos, endPos);
+
+        if (_plan.ranges.empty())
+        {
+            referenceContigId = regionContigId;
+        }
+        else if ((regionContigId != referenceContigId) || (beginPos < _plan.ranges.back().first))
+        {
+            std::ostringstream oss;
+            oss << "Region plan for BAM file '" << name() << "' is not sorted on a single contig at region: '"
+                << region << "'";
+            throw blt_exception(oss.str().c_str());
+        }
+        _plan.ranges.emplace_back(beginPos, endPos);
+    }
+
+    // find the union of all index chunks required by the planned regions:
+    std::vector<hts_pair64_t> chunks;
+    int planEndPos(0);
+    for (const auto& range : _plan.ranges)
+    {
+        hts_itr_t* rangeItr(sam_itr_queryi(_hidx, referenceContigId, range.first, range.second));
+        if (nullptr == rangeItr)
+        {
+            std::ostringstream oss;
+            oss << "Failed to fetch region: #" << referenceContigId << ":" << range.first << "-" << range.second
+                << " specified for BAM file: " << name();
+            throw blt_exception(oss.str().c_str());
+        }
+        chunks.insert(chunks.end(), rangeItr->off, rangeItr->off + rangeItr->n_off);
+        hts_itr_destroy(rangeItr);
+        planEndPos = std::max(planEndPos, range.second);
+    }
+
+    std::sort(chunks.begin(), chunks.end(),
+              [](const hts_pair64_t& a, const hts_pair64_t& b) { return (a.u < b.u); });
+
+    unsigned mergedChunkCount(0);
+    for (const auto& chunk : chunks)
+    {
+        if ((mergedChunkCount > 0) && (chunk.u <= chunks[mergedChunkCount-1].v))
+        {
+            auto& lastChunk(chunks[mergedChunkCount-1]);
+            lastChunk.v = std::max(lastChunk.v, chunk.v);
+        }
+        else
+        {
+            chunks[mergedChunkCount++] = chunk;
+        }
+    }
+
+    // create an iterator over the full plan span, and replace its chunk list with the merged region chunks:
+    hts_itr_t* planItr(sam_itr_queryi(_hidx, referenceContigId, _plan.ranges.front().first, planEndPos));
+    if (nullptr == planItr)
+    {
+        std::ostringstream oss;
+        oss << "Failed to create region plan iterator for BAM file: " << name();
+        throw blt_exception(oss.str().c_str());
+    }
+
+    free(planItr->off);
+    planItr->off = nullptr;
+    planItr->n_off = mergedChunkCount;
+    planItr->i = -1;
+    planItr->curr_off = 0;
+    planItr->finished = (mergedChunkCount == 0);
+    if (mergedChunkCount > 0)
+    {
+        planItr->off = static_cast<hts_pair64_t*>(malloc(mergedChunkCount*sizeof(hts_pair64_t)));
+        std::copy(chunks.begin(), chunks.begin() + mergedChunkCount, planItr->off);
+    }
+
+    _plan.isActive = true;
+    _plan.referenceContigId = referenceContigId;
+    _plan.hitr = planItr;
+}
+
+
+
+bool
+bam_streamer::
+_resetPlanRegion(
+    int referenceContigId,
+    int beginPos,
+    int endPos)
+{
+    if (not _plan.isActive) return false;
+    if (referenceContigId != _plan.referenceContigId) return false;
+
+    // find the requested range, plan ranges can only be visited in order:
+    const int rangeCount(_plan.ranges.size());
+    int rangeIndex(_plan.rangeIndex+1);
+    for (; rangeIndex < rangeCount; ++rangeIndex)
+    {
+        if (_plan.ranges[rangeIndex] == std::make_pair(beginPos, endPos)) break;
+    }
+    if (rangeIndex >= rangeCount) return false;
+
+    _plan.rangeIndex = rangeIndex;
+
+    // remove all carryover records which can't intersect this or any subsequent range:
+    auto& carryover(_plan.carryover);
+    carryover.erase(std::remove_if(carryover.begin(), carryover.end(),
+                                   [&](const PlanRecord& pr) { return (pr.endPos <= beginPos); }),
+                    carryover.end());
+    _plan.carryoverIndex = 0;
+
+    if (nullptr != _hitr)
+    {
+        hts_itr_destroy(_hitr);
+        _hitr = nullptr;
+    }
+
+    _is_region = true;
+    _region.clear();
+
+    _is_record_set = false;
+    _record_no = 0;
+    return true;
+}
+
+
+
+void
+bam_streamer::
+_clearRegionPlan()
+{
+    if (nullptr != _plan.hitr) hts_itr_destroy(_plan.hitr);
+    _plan = RegionPlan();
+}
+
+
+
+int
+bam_streamer::
+_nextPlanRecord()
+{
+    // the plan iterator is not used until the first planned region is requested:
+    if (_plan.rangeIndex < 0) return -1;
+
+    const auto& range(_plan.ranges[_plan.rangeIndex]);
+    const unsigned nextRangeIndex(_plan.rangeIndex+1);
+    const bool isNextRange(nextRangeIndex < _plan.ranges.size());
+
+    auto& carryover(_plan.carryover);
+    while (_plan.carryoverIndex < carryover.size())
+    {
+        const PlanRecord& pr(carryover[_plan.carryoverIndex++]);
+        if ((pr.endPos > range.first) && (pr.beginPos < range.second))
+        {
+            _brec = pr.record;
+            return 0;
+        }
+    }
+
+    PlanRecord& lookahead(_plan.lookahead);
+    while (true)
+    {
+        if (not _plan.isLookahead)
+        {
+            const int ret = sam_itr_next(_hfp, _plan.hitr, lookahead.record._bp);
+            if (ret < -1)
+            {
+                std::ostringstream oss;
+                oss << "ERROR: Unknown htslib error value in sam_itr_next '" << ret << "' while attempting to read BAM file:\n";
+                report_state(oss);
+                throw blt_exception(oss.str().c_str());
+            }
+            if (ret < 0) return ret;
+
+            lookahead.beginPos = _plan.hitr->curr_beg;
+            lookahead.endPos = _plan.hitr->curr_end;
+            _plan.isLookahead = true;
+        }
+
+        // the lookahead record and all which follow it are beyond the current range:
+        if (lookahead.beginPos >= range.second) return -1;
+
+        _plan.isLookahead = false;
+
+        // skip records which fall in the gap between planned ranges, these
+        // cannot intersect a subsequent range either:
+        if (lookahead.endPos <= range.first) continue;
+
+        if (isNextRange && (lookahead.endPos > _plan.ranges[nextRangeIndex].first))
+        {
+            carryover.push_back(lookahead);
+            _plan.carryoverIndex = carryover.size();
+        }
+
+        std::swap(_brec._bp, lookahead.record._bp);
+        return 0;
+    }
+}
+
+
+
 bool
 bam_streamer::
 next()
@@ -239,7 +479,11 @@ next()
     if (nullptr == _hfp) return false;
 
     int ret;
-    if (nullptr == _hitr)
+    if (_plan.isActive)
+    {
+        ret = _nextPlanRecord();
+    }
+    else if (nullptr == _hitr)
     {
 
         ret = sam_read1(_hfp,_hdr, _brec._bp);
@@ -29,6 +29,7 @@
 #include "boost/utility.hpp"
 
 #include <string>
+#include <vector>
 
 
 /// Stream bam records from CRAM/BAM/SAM files. For CRAM/BAM
@@ -75,6 +76,33 @@ struct bam_streamer : public boost::noncopyable
         int beginPos,
         int endPos);
 
+    /// \brief Setup a single-pass iteration plan over a sorted list of regions on one contig
+    ///
+    /// After the plan is set, each resetRegion() call to the next region(s) in the plan is served from
+    /// one index iterator over the merged index chunks of all planned regions, instead of a new index query.
+    /// In this mode each BGZF block shared by neighboring regions is read and decompressed only once,
+    /// and the records returned for each region are the same as those returned by a standard region query.
+    ///
+    /// Any resetRegion() call which does not follow the plan reverts the stream to standard region queries.
+    /// Plans are only supported for BAM input, for all other formats this call has no effect.
+    ///
+    /// \param regions htslib-style region strings, all on the same contig, sorted by begin position
+    void
+    setRegionPlan(const std::vector<std::string>& regions);
+
+    /// \brief Get the mapped and unmapped read counts of one contig from the alignment file index
+    ///
+    /// These counts are stored as metadata in BAI/CSI indexes, so no alignment records are read. CRAI indexes
+    /// do not contain these counts.
+    ///
+    /// \param referenceContigId htslib zero-indexed contig id
+    /// \return false if the index does not provide read counts for this contig
+    bool
+    getIndexReadCounts(
+        int referenceContigId,
+        uint64_t& mappedCount,
+        uint64_t& unmappedCount);
+
     bool next();
 
     const bam_record* get_record_ptr() const
@@ -110,6 +138,45 @@ struct bam_streamer : public boost::noncopyable
 private:
     void _load_index();
 
+    /// \return true if the requested region can be served from the current region plan
+    bool
+    _resetPlanRegion(
+        int referenceContigId,
+        int beginPos,
+        int endPos);
+
+    void _clearRegionPlan();
+
+    /// next() implementation when a region plan is active
+    int _nextPlanRecord();
+
+    /// a record read from the region plan iterator, with its reference span as computed by htslib
+    struct PlanRecord
+    {
+        bam_record record;
+        int beginPos = 0;
+        int endPos = 0;
+    };
+
+    /// all state required to iterate through a sequence of regions with a single index iterator
+    struct RegionPlan
+    {
+        bool isActive = false;
+        int referenceContigId = -1;
+        std::vector<std::pair<int,int>> ranges;
+        /// index of the current range, -1 before the first planned range is requested
+        int rangeIndex = -1;
+        hts_itr_t* hitr = nullptr;
+
+        /// the first record beyond the current range, if it has already been read from the iterator
+        bool isLookahead = false;
+        PlanRecord lookahead;
+
+        /// records from previous ranges which also overlap a subsequent range
+        std::vector<PlanRecord> carryover;
+        unsigned carryoverIndex = 0;
+    };
+
     bool _is_record_set;
     htsFile* _hfp;
     bam_hdr_t* _hdr;
@@ -122,4 +189,6 @@ private:
     std::string _stream_name;
     bool _is_region;
     std::string _region;
+
+    RegionPlan _plan;
 };
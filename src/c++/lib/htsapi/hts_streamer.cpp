@@ -47,7 +47,10 @@ hts_streamer(
     _hfp(nullptr),
     _tidx(nullptr),
     _titr(nullptr),
-    _kstr(kinit)
+    _kstr(kinit),
+    _isBcf(false),
+    _bcfIdx(nullptr),
+    _bcfHeader(nullptr)
 {
     if (nullptr == filename)
     {
@@ -66,6 +69,17 @@ hts_streamer(
         exit(EXIT_FAILURE);
     }
 
+    _isBcf = (hts_get_format(_hfp)->format == bcf);
+    if (_isBcf)
+    {
+        _bcfHeader = bcf_hdr_read(_hfp);
+        if (nullptr == _bcfHeader)
+        {
+            log_os << "ERROR: Failed to load header for BCF file: '" << filename << "'\n";
+            exit(EXIT_FAILURE);
+        }
+    }
+
     _load_index();
 
     // read only a region of HTS file:
@@ -82,6 +96,8 @@ hts_streamer::
 {
     if (nullptr != _titr) tbx_itr_destroy(_titr);
     if (nullptr != _tidx) tbx_destroy(_tidx);
+    if (nullptr != _bcfIdx) hts_idx_destroy(_bcfIdx);
+    if (nullptr != _bcfHeader) bcf_hdr_destroy(_bcfHeader);
     if (nullptr != _hfp) hts_close(_hfp);
     if (nullptr != _kstr.s) free(_kstr.s);
 }
@@ -95,7 +111,14 @@ resetRegion(
 {
     if (nullptr != _titr) tbx_itr_destroy(_titr);
 
-    _titr = tbx_itr_querys(_tidx, region);
+    if (_isBcf)
+    {
+        _titr = bcf_itr_querys(_bcfIdx, _bcfHeader, region);
+    }
+    else
+    {
+        _titr = tbx_itr_querys(_tidx, region);
+    }
     _is_stream_end = (nullptr == _titr);
 }
 
@@ -105,6 +128,19 @@ void
 hts_streamer::
 _load_index()
 {
+    if (_isBcf)
+    {
+        if (nullptr != _bcfIdx) return;
+
+        _bcfIdx = bcf_index_load(name());
+        if (nullptr == _bcfIdx)
+        {
+            log_os << "ERROR: Failed to load index for BCF file: '" << name() << "'\n";
+            exit(EXIT_FAILURE);
+        }
+        return;
+    }
+
     if (nullptr != _tidx) return;
 
     _tidx = tbx_index_load(name());
@@ -56,6 +56,13 @@ struct hts_streamer : private boost::noncopyable
         return _record_no;
     }
 
+    /// \return true if the input file is in binary BCF format
+    bool
+    isBcf() const
+    {
+        return _isBcf;
+    }
+
     /// \brief set new region for indexed file
     ///
     /// \param region htslib-style region string in format: "chromName:beginPos-endPos", cannot be nullptr
@@ -77,4 +84,10 @@ protected:
     tbx_t* _tidx;
     hts_itr_t* _titr;
     kstring_t _kstr;
+
+    /// BCF input is indexed directly by CSI rather than tabix, and requires the
+    /// BCF header to resolve region contig names:
+    bool _isBcf;
+    hts_idx_t* _bcfIdx;
+    bcf_hdr_t* _bcfHeader;
 };
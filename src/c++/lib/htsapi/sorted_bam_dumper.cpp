@@ -0,0 +1,135 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#include "htsapi/sorted_bam_dumper.hh"
+
+#include "blt_util/log.hh"
+
+#include <cstdlib>
+
+#include <iostream>
+
+
+
+sorted_bam_dumper::
+sorted_bam_dumper(
+    const char* filename,
+    const bam_hdr_t& header,
+    const unsigned threadCount)
+    : _bamd(filename, header, threadCount),
+      _bufferTid(UNSET_TID),
+      _isSortBound(false),
+      _sortBoundTid(-1),
+      _sortBoundPos(-1)
+{}
+
+
+
+sorted_bam_dumper::
+~sorted_bam_dumper()
+{
+    try
+    {
+        flush();
+    }
+    catch (const std::exception& e)
+    {
+        log_os << "ERROR: " << e.what() << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+
+
+/// compare reference sequence ids in BAM sort order, where unmapped (-1) follows all mapped sequences
+static
+bool
+isTidLess(
+    const int32_t tid1,
+    const int32_t tid2)
+{
+    return (static_cast<uint32_t>(tid1) < static_cast<uint32_t>(tid2));
+}
+
+
+
+bool
+sorted_bam_dumper::
+put_record(const bam1_t* brec)
+{
+    const int32_t tid(brec->core.tid);
+    const int32_t pos(brec->core.pos);
+
+    const bool isSortedTid((_bufferTid == UNSET_TID) || (not isTidLess(tid, _bufferTid)));
+    const bool isSortedPos((not _isSortBound) || (tid != _sortBoundTid) || (pos >= _sortBoundPos));
+    if (not (isSortedTid && isSortedPos))
+    {
+        log_os << "WARNING: skipping realigned record which cannot be written in sorted order to BAM file: '"
+               << name() << "' read: " << bam_get_qname(brec) << "\n";
+        return false;
+    }
+
+    if ((not _buffer.empty()) && (tid != _bufferTid))
+    {
+        flush();
+    }
+    _bufferTid = tid;
+
+    auto iter(_buffer.emplace_hint(_buffer.end(), pos, bam_record()));
+    bam_copy1(iter->second.get_data(), brec);
+    return true;
+}
+
+
+
+void
+sorted_bam_dumper::
+release(const int32_t pos)
+{
+    write_records(_buffer.upper_bound(pos));
+}
+
+
+
+void
+sorted_bam_dumper::
+flush()
+{
+    write_records(_buffer.end());
+}
+
+
+
+void
+sorted_bam_dumper::
+write_records(const buffer_t::iterator end)
+{
+    for (auto iter(_buffer.begin()); iter != end; ++iter)
+    {
+        _bamd.put_record(iter->second.get_data());
+        _isSortBound = true;
+        _sortBoundTid = _bufferTid;
+        _sortBoundPos = iter->first;
+    }
+    _buffer.erase(_buffer.begin(), end);
+}
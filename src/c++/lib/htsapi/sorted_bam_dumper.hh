@@ -0,0 +1,101 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "htsapi/bam_dumper.hh"
+#include "htsapi/bam_record.hh"
+
+#include "boost/utility.hpp"
+
+#include <map>
+
+
+/// Writes BAM records in coordinate order when records are provided in approximately sorted order
+///
+/// Records are held in a small reorder buffer until the client indicates that no further records
+/// will be provided at or below a given position, at which point they are written to the output
+/// file. All buffered records are expected to be on the same reference sequence, any record provided
+/// on a new sequence first causes the buffer to be flushed.
+///
+/// Any record which can no longer be written in sorted order (because it is positioned before a record
+/// already written) is skipped with a warning, so that the output is always coordinate sorted.
+///
+struct sorted_bam_dumper : private boost::noncopyable
+{
+    /// \param threadCount number of threads used for BGZF compression of the output
+    sorted_bam_dumper(
+        const char* filename,
+        const bam_hdr_t& header,
+        const unsigned threadCount = 1);
+
+    ~sorted_bam_dumper();
+
+    /// buffer a copy of brec for sorted output
+    ///
+    /// \return false if the record was skipped because it could not be written in sorted order
+    bool
+    put_record(const bam1_t* brec);
+
+    /// write all buffered records with position less than or equal to pos
+    ///
+    /// the client asserts that no further records will be provided at or below pos
+    void
+    release(const int32_t pos);
+
+    /// write all buffered records
+    void
+    flush();
+
+    /// number of records currently buffered
+    unsigned
+    size() const
+    {
+        return _buffer.size();
+    }
+
+    const char* name() const
+    {
+        return _bamd.name();
+    }
+
+private:
+    typedef std::multimap<int32_t,bam_record> buffer_t;
+
+    /// write buffered records up to (but not including) end
+    void
+    write_records(const buffer_t::iterator end);
+
+    bam_dumper _bamd;
+
+    static const int32_t UNSET_TID = -2;
+
+    /// reference sequence id of all records in the buffer, and the lowest id which can still be written
+    int32_t _bufferTid;
+    buffer_t _buffer;
+
+    /// the output is sorted through this reference sequence id and position:
+    bool _isSortBound;
+    int32_t _sortBoundTid;
+    int32_t _sortBoundPos;
+};
@@ -62,6 +62,65 @@ BOOST_AUTO_TEST_CASE( test_bam_streamer_bam_read )
 }
 
 
+BOOST_AUTO_TEST_CASE( test_bam_streamer_region_plan )
+{
+    const std::string testBamPath(std::string(TEST_DATA_PATH) + "/alignment_test.bam");
+
+    const std::vector<std::string> regions = {"chrA:1-3", "chrA:6-6", "chrA:9-10"};
+    const std::vector<unsigned> expectedCounts = {1, 2, 1};
+
+    // iterate through regions with standard index queries:
+    bam_streamer stream(testBamPath.c_str(), nullptr);
+    for (unsigned regionIndex(0); regionIndex < regions.size(); ++regionIndex)
+    {
+        stream.resetRegion(regions[regionIndex].c_str());
+        checkStream(stream, expectedCounts[regionIndex]);
+    }
+
+    // iterate through the same regions with a region plan, including a read which is returned for two regions:
+    stream.setRegionPlan(regions);
+    for (unsigned regionIndex(0); regionIndex < regions.size(); ++regionIndex)
+    {
+        stream.resetRegion(regions[regionIndex].c_str());
+        checkStream(stream, expectedCounts[regionIndex]);
+    }
+
+    // skip a planned region:
+    stream.setRegionPlan(regions);
+    stream.resetRegion(regions[0].c_str());
+    checkStream(stream, expectedCounts[0]);
+    stream.resetRegion(regions[2].c_str());
+    checkStream(stream, expectedCounts[2]);
+
+    // leave the plan for an unplanned region:
+    stream.resetRegion("chrB");
+    checkStream(stream, 2);
+}
+
+
+BOOST_AUTO_TEST_CASE( test_bam_streamer_index_read_counts )
+{
+    const std::string testBamPath(std::string(TEST_DATA_PATH) + "/alignment_test.bam");
+    const std::string testCramPath(std::string(TEST_DATA_PATH) + "/alignment_test.cram");
+    const std::string testRefPath(std::string(TEST_DATA_PATH) + "/alignment_test.fasta");
+
+    uint64_t mappedCount(0), unmappedCount(0);
+    {
+        bam_streamer stream(testBamPath.c_str(), nullptr);
+        const int32_t chromBId(stream.target_name_to_id("chrB"));
+        BOOST_REQUIRE(stream.getIndexReadCounts(chromBId, mappedCount, unmappedCount));
+        BOOST_REQUIRE_EQUAL(mappedCount, 2u);
+        BOOST_REQUIRE_EQUAL(unmappedCount, 0u);
+    }
+
+    // CRAI indexes do not provide read counts:
+    {
+        bam_streamer stream(testCramPath.c_str(), testRefPath.c_str());
+        BOOST_REQUIRE(! stream.getIndexReadCounts(0, mappedCount, unmappedCount));
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE( test_bam_streamer_cram_read )
 {
     const std::string testCramPath(std::string(TEST_DATA_PATH) + "/alignment_test.cram");
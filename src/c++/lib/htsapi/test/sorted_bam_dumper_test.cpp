@@ -0,0 +1,98 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+#include "test_config.h"
+
+#include "htsapi/bam_streamer.hh"
+#include "htsapi/sorted_bam_dumper.hh"
+
+#include "boost/filesystem.hpp"
+#include "boost/test/unit_test.hpp"
+
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE( test_sorted_bam_dumper )
+
+
+BOOST_AUTO_TEST_CASE( test_sorted_bam_dumper_reorder )
+{
+    namespace bf = boost::filesystem;
+
+    const std::string testBamPath(std::string(TEST_DATA_PATH) + "/alignment_test.bam");
+    bam_streamer stream(testBamPath.c_str(), nullptr);
+    BOOST_REQUIRE(stream.next());
+    bam_record templateRead(*(stream.get_record_ptr()));
+
+    const bf::path outputPath(bf::temp_directory_path() / bf::unique_path("sorted_bam_dumper_test_%%%%-%%%%.bam"));
+
+    {
+        sorted_bam_dumper bamd(outputPath.string().c_str(), stream.get_header());
+
+        auto putRead = [&](const int32_t tid, const int32_t pos)
+        {
+            bam1_t& br(*templateRead.get_data());
+            br.core.tid = tid;
+            br.core.pos = pos;
+            return bamd.put_record(&br);
+        };
+
+        BOOST_REQUIRE(putRead(0,10));
+        BOOST_REQUIRE(putRead(0,5));
+        BOOST_REQUIRE(putRead(0,7));
+        BOOST_REQUIRE_EQUAL(bamd.size(), 3u);
+
+        bamd.release(6);
+        BOOST_REQUIRE_EQUAL(bamd.size(), 2u);
+
+        // a record after the last written position can still be sorted:
+        BOOST_REQUIRE(putRead(0,6));
+
+        // a record before the last written position is skipped:
+        BOOST_REQUIRE(not putRead(0,4));
+
+        bamd.release(20);
+        BOOST_REQUIRE_EQUAL(bamd.size(), 0u);
+
+        BOOST_REQUIRE(putRead(0,30));
+
+        // a record on the next reference sequence flushes the previous sequence:
+        BOOST_REQUIRE(putRead(1,2));
+        BOOST_REQUIRE_EQUAL(bamd.size(), 1u);
+
+        BOOST_REQUIRE(not putRead(0,40));
+    }
+
+    std::vector<std::pair<int,int>> observed;
+    {
+        bam_streamer outputStream(outputPath.string().c_str(), nullptr);
+        while (outputStream.next())
+        {
+            const bam_record& read(*(outputStream.get_record_ptr()));
+            observed.emplace_back(read.target_id(), read.pos()-1);
+        }
+    }
+    bf::remove(outputPath);
+
+    const std::vector<std::pair<int,int>> expected = {{0,5},{0,6},{0,7},{0,10},{0,30},{1,2}};
+    BOOST_REQUIRE(observed == expected);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
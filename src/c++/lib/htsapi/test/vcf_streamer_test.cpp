@@ -21,6 +21,7 @@
 
 #include "htsapi/vcf_streamer.hh"
 
+#include "blt_util/blt_exception.hh"
 #include "common/Exceptions.hh"
 
 #include "boost/test/unit_test.hpp"
@@ -248,5 +249,52 @@ BOOST_AUTO_TEST_CASE( test_vcf_streamer_region )
 }
 
 
+BOOST_AUTO_TEST_CASE( test_vcf_streamer_bcf )
+{
+    // check that BCF input produces the same records as the equivalent text VCF:
+    const std::string bcfPath(std::string(TEST_DATA_PATH) + "/vcf_streamer_test.bcf");
+    static const bool isRequireNormalized(false);
+
+    for (const char* region : {"chr1:750000-822000", "chr10"})
+    {
+        vcf_streamer vcfs(getTestpath(), region, isRequireNormalized);
+        vcf_streamer bcfs(bcfPath.c_str(), region, isRequireNormalized);
+
+        BOOST_REQUIRE( ! vcfs.isBcf() );
+        BOOST_REQUIRE( bcfs.isBcf() );
+
+        unsigned recordCount(0);
+        while (true)
+        {
+            const bool isVcfRecord(vcfs.next());
+            BOOST_REQUIRE_EQUAL(isVcfRecord, bcfs.next());
+            if (not isVcfRecord) break;
+
+            const vcf_record& vcfRecord(*vcfs.get_record_ptr());
+            const vcf_record& bcfRecord(*bcfs.get_record_ptr());
+            BOOST_REQUIRE_EQUAL(vcfRecord.chrom, bcfRecord.chrom);
+            BOOST_REQUIRE_EQUAL(vcfRecord.pos, bcfRecord.pos);
+            BOOST_REQUIRE_EQUAL(vcfRecord.ref, bcfRecord.ref);
+            BOOST_REQUIRE(vcfRecord.alt == bcfRecord.alt);
+            BOOST_REQUIRE(bcfRecord.line == nullptr);
+            recordCount++;
+        }
+        BOOST_REQUIRE(recordCount > 0);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( test_vcf_streamer_bcf_read_error )
+{
+    // check that a read error in the middle of a BCF file is not treated as the end of the stream, the records of this
+    // file are stored in a separate BGZF block from the header, and the record block is truncated:
+    const std::string bcfPath(std::string(TEST_DATA_PATH) + "/vcf_streamer_test_truncated.bcf");
+    static const bool isRequireNormalized(false);
+
+    vcf_streamer bcfs(bcfPath.c_str(), "chr1:750000-822000", isRequireNormalized);
+    BOOST_REQUIRE_THROW(bcfs.next(), blt_exception);
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
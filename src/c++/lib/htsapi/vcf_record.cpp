@@ -122,6 +122,39 @@ set(const char* s)
     return (wordindex >= maxword);
 }
 
+
+
+bool
+vcf_record::
+set(
+    const bcf_hdr_t* header,
+    bcf1_t& record)
+{
+    assert(nullptr != header);
+
+    clear();
+
+    // unpack only up through the allele strings:
+    if (bcf_unpack(&record, BCF_UN_STR) < 0) return false;
+    if ((record.rid < 0) || (record.n_allele < 1)) return false;
+
+    chrom = bcf_hdr_id2name(header, record.rid);
+    pos = (record.pos + 1);
+
+    ref = record.d.allele[0];
+    stoupper(ref);
+
+    // a '.' ALT value is represented in BCF as a record with only the REF allele:
+    const unsigned alleleCount(record.n_allele);
+    for (unsigned alleleIndex(1); alleleIndex < alleleCount; ++alleleIndex)
+    {
+        alt.emplace_back(record.d.allele[alleleIndex]);
+        stoupper(alt.back());
+    }
+
+    return true;
+}
+
 bool
 vcf_record::
 is_normalized() const
@@ -24,6 +24,7 @@
 #pragma once
 
 #include "blt_util/seq_util.hh"
+#include "htsapi/tabix_util.hh"
 
 #include <iosfwd>
 #include <string>
@@ -40,6 +41,14 @@ struct vcf_record
     /// set the vcf record from record string s, return false on error
     bool set(const char* s);
 
+    /// set the vcf record from a BCF record, return false on error
+    ///
+    /// Fields are decoded directly from the binary record, so \p line is left unset for this case.
+    bool
+    set(
+        const bcf_hdr_t* header,
+        bcf1_t& record);
+
     void clear()
     {
         chrom.clear();
@@ -111,6 +120,8 @@ struct vcf_record
     int pos = 0;
     std::string ref;
     std::vector<std::string> alt;
+
+    /// the full text of the record, this is only available for text VCF input
     const char* line = nullptr;
 };
 
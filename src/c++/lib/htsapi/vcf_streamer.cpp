@@ -80,15 +80,20 @@ vcf_streamer(
     const bool isRequireNormalized) :
     hts_streamer(filename,region),
     _hdr(nullptr),
-    _isRequireNormalized(isRequireNormalized)
+    _isRequireNormalized(isRequireNormalized),
+    _bcfRecord(nullptr)
 {
-    //
-    // note with the switch to samtools 1.X vcf/bcf still involve predominantly separate
-    // apis -- no bcf support added here, but a shared function has been chosen where possible
-    // ... for_instance hts_open/bcf_hdr_read should work with both vcf and bcf
-    //
+    if (isBcf())
+    {
+        // the BCF header has already been read to resolve index regions:
+        _hdr = _bcfHeader;
+        _bcfRecord = bcf_init();
+    }
+    else
+    {
+        _hdr = bcf_hdr_read(_hfp);
+    }
 
-    _hdr = bcf_hdr_read(_hfp);
     if (nullptr == _hdr)
     {
         log_os << "ERROR: Failed to load header for VCF file: '" << filename << "'\n";
@@ -102,29 +107,55 @@ vcf_streamer(
 vcf_streamer::
 ~vcf_streamer()
 {
-    if (nullptr != _hdr) bcf_hdr_destroy(_hdr);
+    if (nullptr != _bcfRecord) bcf_destroy(_bcfRecord);
+
+    // the BCF header is owned by the base class:
+    if ((nullptr != _hdr) && (not isBcf())) bcf_hdr_destroy(_hdr);
 }
 
 
 
-bool
+void
 vcf_streamer::
-next()
+throwReadError(
+    const char* functionName,
+    const int ret) const
 {
-    if (_is_stream_end || (nullptr==_hfp) || (nullptr==_titr)) return false;
+    std::ostringstream oss;
+    oss << "ERROR: Unknown htslib error value in " << functionName << " '" << ret
+        << "' while attempting to read VCF/BCF file:\n";
+    report_state(oss);
+    throw blt_exception(oss.str().c_str());
+}
 
-    while (true)
+
+
+bool
+vcf_streamer::
+readNextRecord()
+{
+    if (isBcf())
     {
-        if (tbx_itr_next(_hfp, _tidx, _titr, &_kstr) < 0)
-        {
-            _is_stream_end=true;
-        }
-        else
+        const int ret(bcf_itr_next(_hfp, _titr, _bcfRecord));
+        if (ret < -1) throwReadError("bcf_itr_next", ret);
+        if (ret < 0) return false;
+
+        _record_no++;
+
+        if (! _vcfrec.set(_hdr, *_bcfRecord))
         {
-            _is_stream_end=(nullptr == _kstr.s);
+            log_os << "ERROR: Can't parse bcf record number " << _record_no << " in file: '" << name() << "'\n";
+            exit(EXIT_FAILURE);
         }
-        _is_record_set=(! _is_stream_end);
-        if (! _is_record_set) break;
+        return true;
+    }
+
+    while (true)
+    {
+        const int ret(tbx_itr_next(_hfp, _tidx, _titr, &_kstr));
+        if (ret < -1) throwReadError("tbx_itr_next", ret);
+        if (ret < 0) return false;
+        if (nullptr == _kstr.s) return false;
 
         // filter out header for whole file access case:
         if (_kstr.s[0] == '#') continue;
@@ -136,6 +167,23 @@ next()
             log_os << "ERROR: Can't parse vcf record: '" << _kstr.s << "'\n";
             exit(EXIT_FAILURE);
         }
+        return true;
+    }
+}
+
+
+
+bool
+vcf_streamer::
+next()
+{
+    if (_is_stream_end || (nullptr==_hfp) || (nullptr==_titr)) return false;
+
+    while (true)
+    {
+        _is_stream_end=(! readNextRecord());
+        _is_record_set=(! _is_stream_end);
+        if (! _is_record_set) break;
 
         if (_vcfrec.isSimpleVariantLocus())
         {
@@ -196,3 +244,18 @@ validateBamHeaderChromSync(
 {
     check_bam_bcf_header_compatability(name(), _hdr, header);
 }
+
+
+
+void
+vcf_streamer::
+requireTextVcf(
+    const char* inputLabel) const
+{
+    if (not isBcf()) return;
+
+    std::ostringstream oss;
+    oss << "ERROR: " << inputLabel << " must be provided in VCF format, BCF input is not supported for this file: '"
+        << name() << "'\n";
+    BOOST_THROW_EXCEPTION(illumina::common::LogicException(oss.str()));
+}
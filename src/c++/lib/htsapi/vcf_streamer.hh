@@ -31,6 +31,8 @@
 
 struct vcf_streamer : public hts_streamer
 {
+    /// Input may be either bgzip-compressed text VCF with a tabix index, or BCF with a CSI index.
+    ///
     /// \param[in] isRequireNormalized if true an exception is thrown for any input variant records which are not
     ///                                left shifted
     vcf_streamer(
@@ -59,6 +61,13 @@ struct vcf_streamer : public hts_streamer
     validateBamHeaderChromSync(
         const bam_hdr_t& header) const;
 
+    /// throw if the input is BCF, for clients which parse fields from the text line of each record
+    ///
+    /// \param[in] inputLabel description of the input file used in the error message
+    void
+    requireTextVcf(
+        const char* inputLabel) const;
+
     unsigned
     getSampleCount() const
     {
@@ -75,8 +84,26 @@ struct vcf_streamer : public hts_streamer
     }
 
 private:
+    /// throw for an htslib read function return value indicating an error
+    void
+    throwReadError(
+        const char* functionName,
+        const int ret) const;
+
+    /// read the next text or BCF record into _vcfrec
+    ///
+    /// htslib record iterators return -1 at the end of the stream, any lower value is a read error and is thrown
+    /// rather than being treated as the end of the stream.
+    ///
+    /// \return false at the end of the stream
+    bool
+    readNextRecord();
+
     bcf_hdr_t* _hdr;
     unsigned _sampleCount;
     vcf_record _vcfrec;
     bool _isRequireNormalized;
+
+    /// record buffer used for BCF input only
+    bcf1_t* _bcfRecord;
 };
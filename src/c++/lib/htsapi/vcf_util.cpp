@@ -199,24 +199,37 @@ void
 VcfGenotypeUtil::
 writeGenotype(
     const VcfGenotype& vcfGt,
-    std::ostream& os)
+    TextBuffer& buffer)
 {
     if (vcfGt.isUnknown())
     {
-        os << '.';
+        buffer.append('.');
     }
     else
     {
         if (vcfGt.getPloidy() > 0)
         {
-            os << static_cast<int>(vcfGt.getAllele0Index());
+            buffer.appendUnsigned(vcfGt.getAllele0Index());
         }
         if (vcfGt.getPloidy() > 1)
         {
-            os << (vcfGt.getIsPhased() ? '|' : '/');
-            os << static_cast<int>(vcfGt.getAllele1Index());
+            buffer.append(vcfGt.getIsPhased() ? '|' : '/');
+            buffer.appendUnsigned(vcfGt.getAllele1Index());
         }
         assert (vcfGt.getPloidy() <= 2);
     }
 }
 
+
+
+void
+VcfGenotypeUtil::
+writeGenotype(
+    const VcfGenotype& vcfGt,
+    std::ostream& os)
+{
+    TextBuffer buffer(0);
+    writeGenotype(vcfGt, buffer);
+    buffer.flush(os);
+}
+
@@ -26,6 +26,8 @@
 
 #pragma once
 
+#include "blt_util/TextBuffer.hh"
+
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -458,6 +460,12 @@ struct VcfGenotypeUtil
         const uint8_t allele1Index,
         std::ostream& os);
 
+    static
+    void
+    writeGenotype(
+        const VcfGenotype& vcfGt,
+        TextBuffer& buffer);
+
     static
     void
     writeGenotype(
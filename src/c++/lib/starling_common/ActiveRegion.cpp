@@ -262,8 +262,9 @@ void ActiveRegion::doNotUseHaplotyping()
 
     assert(_posRange.end_pos > _posRange.begin_pos);
 
-    auto it(_indelBuffer.positionIterator(_posRange.begin_pos));
-    const auto it_end(_indelBuffer.positionIterator(_posRange.end_pos));
+    const auto indelBuffer(_indelBuffer.lock());
+    auto it(indelBuffer->positionIterator(_posRange.begin_pos));
+    const auto it_end(indelBuffer->positionIterator(_posRange.end_pos));
 
     for (; it!=it_end; ++it)
     {
@@ -532,6 +533,7 @@ void ActiveRegion::convertToPrimitiveAlleles(
     // There are cases that the active region was not triggered at the right position.
     // E.g. ref: GTCGAT, AR: TCGAT, Hap: T[ATAT]CGAT. In this case, T->TATAT should be left-shifted.
     //
+    _alignmentCellCount += (static_cast<uint64_t>(haploptypeSeq.size())*reference.size());
     _aligner.align(haploptypeSeq.cbegin(),haploptypeSeq.cend(),reference.cbegin(),reference.cend(),result);
 
     const ALIGNPATH::path_t& alignPath = result.align.apath;
@@ -635,15 +637,16 @@ void ActiveRegion::convertToPrimitiveAlleles(
 
         if (indelKeyPtr)
         {
+            const auto indelBuffer(_indelBuffer.lock());
             for (const auto alignId : alignIdList)
             {
                 const auto& alignInfo(_readBuffer.getAlignInfo(alignId));
                 IndelObservationData indelObservationData;
                 indelObservationData.iat = alignInfo.indelAlignType;
                 indelObservationData.id = alignId;
-                _indelBuffer.addIndelObservation(alignInfo.sampleIndex, {*indelKeyPtr, indelObservationData});
+                indelBuffer->addIndelObservation(alignInfo.sampleIndex, {*indelKeyPtr, indelObservationData});
             }
-            IndelData* indelDataPtr(_indelBuffer.getIndelDataPtr(*indelKeyPtr));
+            IndelData* indelDataPtr(indelBuffer->getIndelDataPtr(*indelKeyPtr));
             assert((indelDataPtr != nullptr) && "Missing indelData");
 
             // Allow this indel to become a candidate (subject to other tests):
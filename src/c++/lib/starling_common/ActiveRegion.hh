@@ -32,6 +32,7 @@
 #include "options/IterativeAssemblerOptions.hh"
 #include "starling_common/starling_types.hh"
 
+#include <cstdint>
 #include <map>
 #include <set>
 #include <string>
@@ -66,7 +67,7 @@ public:
     /// \param sampleIndex sample index
     /// \param aligner aligner for aligning haplotypes to the reference
     /// \param readBuffer read buffer
-    /// \param indelBuffer indel buffer
+    /// \param indelBuffer indel buffer, which may be shared with active regions of other samples
     /// \param candidateSnvBuffer candidate SNV buffer
     /// \return active region object
     ActiveRegion(const pos_range& posRange,
@@ -75,10 +76,11 @@ public:
                  const unsigned sampleIndex,
                  const GlobalAligner<int>& aligner,
                  const ActiveRegionReadBuffer& readBuffer,
-                 IndelBuffer& indelBuffer,
+                 SharedIndelBuffer& indelBuffer,
                  CandidateSnvBuffer& candidateSnvBuffer):
         _posRange(posRange), _ref(ref), _maxIndelSize(maxIndelSize), _sampleIndex(sampleIndex),
-        _aligner(aligner), _readBuffer(readBuffer), _indelBuffer(indelBuffer), _candidateSnvBuffer(candidateSnvBuffer)
+        _aligner(aligner), _readBuffer(readBuffer), _indelBuffer(indelBuffer),
+        _candidateSnvBuffer(candidateSnvBuffer)
     {
     }
 
@@ -105,6 +107,12 @@ public:
     /// Determine indel candidacy and register polymorphic sites to relax MMDF.
     void processHaplotypes();
 
+    /// \return number of dynamic programming matrix cells filled while aligning haplotypes of this region
+    uint64_t getAlignmentCellCount() const
+    {
+        return _alignmentCellCount;
+    }
+
     /// Mark a read soft-clipped
     /// \param alignId align id
     void setSoftClipped(const align_id_t alignId)
@@ -120,11 +128,13 @@ private:
     const GlobalAligner<int> _aligner;
 
     const ActiveRegionReadBuffer& _readBuffer;
-    IndelBuffer& _indelBuffer;
+    SharedIndelBuffer& _indelBuffer;
     CandidateSnvBuffer& _candidateSnvBuffer;
 
     std::set<align_id_t> _alignIdSoftClipped;
 
+    uint64_t _alignmentCellCount = 0;
+
     /// Select the top haplotypes and convert these into primitive alleles
     ///
     /// \param[in] totalNumHaplotypingReads Total number of reads eligible for the haplotype generation process
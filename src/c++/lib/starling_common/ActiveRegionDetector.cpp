@@ -58,6 +58,8 @@ ActiveRegionDetector::processActiveRegion()
     if (not _activeRegions.empty())
     {
         _activeRegions.front().processHaplotypes();
+        _processedActiveRegionCount++;
+        _alignmentCellCount += _activeRegions.front().getAlignmentCellCount();
         _activeRegions.pop_front();
     }
 }
@@ -64,12 +64,13 @@ public:
 
     /// Creates an object that reads variant information and creates active regions
     /// \param ref reference segment
-    /// \param indelBuffer indel buffer
+    /// \param indelBuffer indel buffer, detectors for different samples sharing one indelBuffer may run concurrently
+    /// \param candidateSnvBuffer candidate SNV buffer, detectors for different samples only update their own sample
     /// \param maxIndelSize maximum indel size
     /// \param sampleIndex sample Id
     ActiveRegionDetector(
         const reference_contig_segment& ref,
-        IndelBuffer& indelBuffer,
+        SharedIndelBuffer& indelBuffer,
         CandidateSnvBuffer& candidateSnvBuffer,
         unsigned maxIndelSize,
         unsigned sampleIndex) :
@@ -113,11 +114,23 @@ public:
 
     void clearUpToPos(const pos_t pos);
 
+    /// \return total number of active regions processed by this detector
+    uint64_t getProcessedActiveRegionCount() const
+    {
+        return _processedActiveRegionCount;
+    }
+
+    /// \return total number of alignment matrix cells filled for haplotypes of all processed active regions
+    uint64_t getAlignmentCellCount() const
+    {
+        return _alignmentCellCount;
+    }
+
 private:
     const reference_contig_segment& _ref;
     ActiveRegionReadBuffer _readBuffer;
 
-    IndelBuffer& _indelBuffer;
+    SharedIndelBuffer& _indelBuffer;
     CandidateSnvBuffer& _candidateSnvBuffer;
 
     const unsigned _maxIndelSize;
@@ -143,6 +156,9 @@ private:
     // aligner to be used in active regions
     GlobalAligner<int> _aligner;
 
+    uint64_t _processedActiveRegionCount = 0;
+    uint64_t _alignmentCellCount = 0;
+
     RangeMap<pos_t, ActiveRegionId> _posToActiveRegionIdMap;
 
     void setPosToActiveRegionIdMap(pos_range activeRegionRange);
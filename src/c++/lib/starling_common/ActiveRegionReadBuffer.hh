@@ -90,7 +90,7 @@ public:
     /// \param indelBuffer indel buffer
     ActiveRegionReadBuffer(
         const reference_contig_segment& ref,
-        IndelBuffer& indelBuffer)
+        SharedIndelBuffer& indelBuffer)
         :
         _ref(ref),
         _refRepeatFinder(ref, MaxRepeatUnitLength, MaxBufferSize, MinRepeatSpan),
@@ -223,7 +223,7 @@ private:
     const reference_contig_segment& _ref;
     ReferenceRepeatFinder _refRepeatFinder;
 
-    IndelBuffer& _indelBuffer;
+    SharedIndelBuffer& _indelBuffer;
 
     pos_range _readBufferRange;
 
@@ -0,0 +1,133 @@
+//
+// Strelka - Small Variant Caller
+// Copyright (c) 2009-2017 Illumina, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+
+/// \file
+/// \author Chris Saunders
+///
+
+#pragma once
+
+#include "CandidateAlignment.hh"
+#include "blt_util/pos_range.hh"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+/// warnings accumulated during the candidate alignment search
+struct mca_warnings
+{
+    bool origin_skip = false;
+    bool max_toggle_depth = false;
+};
+
+
+/// non-candidate indels evaluated for a read, and whether each is usable by the read
+typedef std::vector<std::pair<IndelKey,bool>> indel_usability_t;
+
+
+/// \brief Shares candidate alignment search results between reads with identical input alignments
+///
+/// The candidate alignment search for a read depends on the read only through its input alignment (including the
+/// inserted sequence of any input alignment insertions) and the usability of non-candidate indels, which is
+/// specific to the reads supporting each such indel. At high depth many reads starting at the same position
+/// share the same input alignment, so the search result for the first read can be reused for the others after
+/// checking that every non-candidate indel encountered by the search has the same usability for the new read.
+///
+/// All entries are discarded whenever the content of the indel buffer changes.
+///
+struct CandidateAlignmentCache
+{
+    struct Key
+    {
+        bool
+        operator<(const Key& rhs) const
+        {
+            if (sampleId < rhs.sampleId) return true;
+            if (sampleId != rhs.sampleId) return false;
+            if (realignBufferRange.begin_pos < rhs.realignBufferRange.begin_pos) return true;
+            if (realignBufferRange.begin_pos != rhs.realignBufferRange.begin_pos) return false;
+            if (realignBufferRange.end_pos < rhs.realignBufferRange.end_pos) return true;
+            if (realignBufferRange.end_pos != rhs.realignBufferRange.end_pos) return false;
+            return (inputAlignment < rhs.inputAlignment);
+        }
+
+        unsigned sampleId = 0;
+        known_pos_range realignBufferRange = known_pos_range(0,0);
+
+        /// the (normalized) input alignment of the read, with the keys of all indels in the input alignment set
+        CandidateAlignment inputAlignment;
+    };
+
+    struct Value
+    {
+        std::set<CandidateAlignment> candidateAlignments;
+        mca_warnings warn;
+
+        /// each non-candidate indel evaluated by the search, and whether it was usable by the searched read
+        indel_usability_t nonCandidateIndelUsability;
+    };
+
+    /// \return cached search result for key, or nullptr if no result is cached
+    const Value*
+    find(
+        const Key& key,
+        const uint64_t indelBufferVersion)
+    {
+        updateIndelBufferVersion(indelBufferVersion);
+        const auto iter(_cache.find(key));
+        return ((iter == _cache.end()) ? nullptr : &(iter->second));
+    }
+
+    /// add a search result to the cache, replacing any previous result for key
+    ///
+    /// \return the cached search result
+    const Value&
+    insert(
+        const Key& key,
+        Value&& value,
+        const uint64_t indelBufferVersion)
+    {
+        updateIndelBufferVersion(indelBufferVersion);
+        Value& cachedValue(_cache[key]);
+        cachedValue = std::move(value);
+        return cachedValue;
+    }
+
+    void
+    clear()
+    {
+        _cache.clear();
+    }
+
+private:
+    void
+    updateIndelBufferVersion(const uint64_t indelBufferVersion)
+    {
+        if (indelBufferVersion == _indelBufferVersion) return;
+        _cache.clear();
+        _indelBufferVersion = indelBufferVersion;
+    }
+
+    std::map<Key,Value> _cache;
+    uint64_t _indelBufferVersion = 0;
+};
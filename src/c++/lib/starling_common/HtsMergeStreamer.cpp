@@ -129,6 +129,18 @@ resetRegion(const std::string& region)
 
 
 
+void
+HtsMergeStreamer::
+setAlignmentRegionPlan(const std::vector<std::string>& regions)
+{
+    for (auto& bamStreamer : _data._bam)
+    {
+        bamStreamer->setRegionPlan(regions);
+    }
+}
+
+
+
 bool
 HtsMergeStreamer::
 next()
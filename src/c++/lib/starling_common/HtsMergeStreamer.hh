@@ -145,6 +145,15 @@ struct HtsMergeStreamer
     void
     resetRegion(const std::string& region);
 
+    /// Provide the sequence of regions which will be requested by subsequent resetRegion calls
+    ///
+    /// This allows alignment file streams to read through all planned regions with a single index iterator,
+    /// see bam_streamer::setRegionPlan for details. Records returned for each region are unchanged.
+    ///
+    /// \param[in] regions samtools-formatted genomic region strings, all on one contig, sorted by begin position
+    void
+    setAlignmentRegionPlan(const std::vector<std::string>& regions);
+
 
     /// Advances to the next HTS record in the merged stream
     ///
@@ -108,6 +108,7 @@ addIndelObservation(
     {
         const auto retval = _indelBuffer.insert(std::make_pair(obs.key,IndelData(getSampleCount(), obs.key)));
         indelIter = retval.first;
+        _contentVersion++;
     }
 
     IndelData& indelData(getIndelData(indelIter));
@@ -252,15 +253,19 @@ isCandidateIndelImplTest(
 
 
 
-void
+bool
 IndelBuffer::
 isCandidateIndelImpl(
     const IndelKey& indelKey,
     const IndelData& indelData) const
 {
+    // the test only depends on indel data which is fixed while realignment threads are running, so concurrent
+    // evaluations for the same indel always store the same state:
     const bool is_candidate(isCandidateIndelImplTest(indelKey, indelData));
-    indelData.status.is_candidate_indel = is_candidate;
-    indelData.status.is_candidate_indel_cached = true;
+    indelData.status.candidateState.store(
+        (is_candidate ? IndelData::status_t::CANDIDATE : IndelData::status_t::NONCANDIDATE),
+        std::memory_order_relaxed);
+    return is_candidate;
 }
 
 
@@ -282,7 +287,9 @@ clearIndelsAtPosition(const pos_t pos)
 {
     const iterator i_begin(positionIterator(pos));
     const iterator i_end(positionIterator(pos + 1));
+    if (i_begin == i_end) return;
     _indelBuffer.erase(i_begin,i_end);
+    _contentVersion++;
 }
 
 
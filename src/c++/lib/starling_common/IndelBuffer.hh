@@ -29,6 +29,8 @@
 #include "starling_common/min_count_binom_gte_cache.hh"
 #include "starling_common/starling_base_shared.hh"
 
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 
@@ -155,11 +157,12 @@ struct IndelBuffer
         const IndelKey& indelKey,
         const IndelData& indelData) const
     {
-        if (! indelData.status.is_candidate_indel_cached)
+        const uint8_t candidateState(indelData.status.candidateState.load(std::memory_order_relaxed));
+        if (candidateState != IndelData::status_t::UNKNOWN)
         {
-            isCandidateIndelImpl(indelKey, indelData);
+            return (candidateState == IndelData::status_t::CANDIDATE);
         }
-        return indelData.status.is_candidate_indel;
+        return isCandidateIndelImpl(indelKey, indelData);
     }
 
     /// this version is less efficient than if you have indel_data
@@ -182,6 +185,17 @@ struct IndelBuffer
     clearIndels()
     {
         _indelBuffer.clear();
+        _contentVersion++;
+    }
+
+    /// \return a value which changes whenever an indel is added to or removed from the buffer
+    ///
+    /// Candidacy is fixed once it has been computed for an indel, so this can be used to detect any change in the
+    /// set of indels available to realignment.
+    uint64_t
+    getContentVersion() const
+    {
+        return _contentVersion;
     }
 
     bool
@@ -190,6 +204,13 @@ struct IndelBuffer
         return _indelBuffer.empty();
     }
 
+    /// \return total indels buffered
+    unsigned
+    size() const
+    {
+        return _indelBuffer.size();
+    }
+
     // debug dumpers:
     void
     dumpPosition(
@@ -243,7 +264,7 @@ private:
         const IndelData& indelData) const;
 
 
-    void
+    bool
     isCandidateIndelImpl(
         const IndelKey& indelKey,
         const IndelData& indelData) const;
@@ -286,6 +307,7 @@ private:
     double _maxCandidateDepth = -1.0;
     indelSampleData_t _indelSampleData;
     indel_buffer_data_t _indelBuffer;
+    uint64_t _contentVersion = 0;
 };
 
 
@@ -310,3 +332,57 @@ getIndelData(const IndelBuffer::const_iterator i)
     return (i->second);
 }
 
+
+
+
+/// Provides locked access to an IndelBuffer which is updated by several threads
+///
+/// Clients which may run concurrently, such as the active region detectors of different samples, hold this
+/// object instead of the IndelBuffer itself, so that every access they make goes through the same mutex.
+///
+struct SharedIndelBuffer
+{
+    explicit
+    SharedIndelBuffer(IndelBuffer& indelBuffer)
+        : _indelBuffer(indelBuffer)
+    {}
+
+    /// access to the indel buffer, the buffer mutex is held for the lifetime of this object
+    struct LockedAccess
+    {
+        IndelBuffer&
+        operator*() const
+        {
+            return _indelBuffer;
+        }
+
+        IndelBuffer*
+        operator->() const
+        {
+            return &_indelBuffer;
+        }
+
+    private:
+        friend struct SharedIndelBuffer;
+
+        LockedAccess(
+            IndelBuffer& indelBuffer,
+            std::mutex& indelBufferMutex)
+            : _indelBuffer(indelBuffer)
+            , _lock(indelBufferMutex)
+        {}
+
+        IndelBuffer& _indelBuffer;
+        std::unique_lock<std::mutex> _lock;
+    };
+
+    LockedAccess
+    lock()
+    {
+        return LockedAccess(_indelBuffer, _indelBufferMutex);
+    }
+
+private:
+    IndelBuffer& _indelBuffer;
+    std::mutex _indelBufferMutex;
+};
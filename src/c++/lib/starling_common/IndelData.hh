@@ -31,6 +31,7 @@
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_types.hh"
 
+#include <atomic>
 #include <cassert>
 
 #include <iosfwd>
@@ -353,10 +354,31 @@ private:
     friend std::ostream& operator<<(std::ostream& os, const IndelData& indelData);
 public:
 // ------------- data ------------------
+    /// candidate status may be computed concurrently by several realignment threads, so the cached
+    /// result and its validity are held in a single atomic value
     struct status_t
     {
-        bool is_candidate_indel_cached = false;
-        bool is_candidate_indel = false;
+        enum candidate_state_t : uint8_t
+        {
+            UNKNOWN,
+            NONCANDIDATE,
+            CANDIDATE
+        };
+
+        status_t() = default;
+
+        status_t(const status_t& rhs)
+            : candidateState(rhs.candidateState.load(std::memory_order_relaxed))
+        {}
+
+        status_t&
+        operator=(const status_t& rhs)
+        {
+            candidateState.store(rhs.candidateState.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        std::atomic<uint8_t> candidateState{UNKNOWN};
     };
 
     /// If true, allele is suggested from a source other than the aligned sequencing data, and
@@ -110,10 +110,12 @@ struct SupportingReadCountGroup
     }
 
     void
-    incrementAlleleCount(const unsigned alleleIndex)
+    incrementAlleleCount(
+        const unsigned alleleIndex,
+        const unsigned count = 1)
     {
         assert((alleleIndex) < _confidentAlleleCount.size());
-        _confidentAlleleCount[alleleIndex]++;
+        _confidentAlleleCount[alleleIndex] += count;
     }
 
     // number of ambiguous support reads
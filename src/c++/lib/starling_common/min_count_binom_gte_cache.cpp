@@ -148,8 +148,9 @@ isRejectNull(
         }
     }
 
-    /// TODO I'm sure there's a faster test encapsulating the line below into a single isRejectNull predicate
-    return (n_success>=min_count_binomial_gte_exact(_alpha,p,n));
+    // equivalent to (n_success>=min_count_binomial_gte_exact(_alpha,p,n)), but the direct test can stop summing the
+    // tail probability as soon as it exceeds alpha:
+    return is_reject_binomial_gte_n_success_exact(_alpha,p,n_success,n);
 }
 
 
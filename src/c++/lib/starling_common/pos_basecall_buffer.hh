@@ -165,6 +165,13 @@ struct pos_basecall_buffer
         return _pdata.empty();
     }
 
+    /// \return the span of positions from the lowest to the highest buffered position
+    pos_t
+    getPositionSpan() const
+    {
+        return _pdata.getKeySpan();
+    }
+
     void
     dump(std::ostream& os) const;
 
@@ -123,7 +123,17 @@ get_starling_base_option_parser(
     po::options_description other_opt("other-options");
     other_opt.add_options()
     ("stats-file", po::value(&opt.segmentStatsFilename),
-     "Write runtime stats to file")
+     "Write runtime stats to file (in binary format, use MergeRunStats to convert to xml and summarize)")
+    ("region-profile-file", po::value(&opt.regionProfileFilename),
+     "Write a BED-like trace of reads, candidate indels, active regions, alignment matrix cells and wall time for each analysis region to file")
+    ("region-profile-window-size", po::value(&opt.regionProfileWindowSize)->default_value(opt.regionProfileWindowSize),
+     "If non-zero, split each analysis region of the region profile into windows of this size")
+    ("realigned-read-file-threads", po::value(&opt.realignedReadFileThreadCount)->default_value(opt.realignedReadFileThreadCount),
+     "Number of threads used to compress each realigned read file")
+    ("realignment-threads", po::value(&opt.realignmentThreadCount)->default_value(opt.realignmentThreadCount),
+     "Number of threads used to realign the reads starting at each position. Results are unaffected by this value.")
+    ("sample-threads", po::value(&opt.sampleThreadCount)->default_value(opt.sampleThreadCount),
+     "Number of threads used to run active region detection and pileup for different samples concurrently. Results are unaffected by this value.")
     ("report-evs-features", po::value(&opt.isReportEVSFeatures)->zero_tokens(),
      "Report empirical variant scoring (EVS) training features in VCF output")
     ("indel-error-models-file", po::value<std::vector<std::string>>(&opt.indelErrorModelFilenames),
@@ -288,6 +298,16 @@ finalize_starling_base_options(
         opt.is_max_input_depth=true;
     }
 
+    if (opt.realignmentThreadCount == 0)
+    {
+        pinfo.usage("realignment-threads must be greater than 0");
+    }
+
+    if (opt.sampleThreadCount == 0)
+    {
+        pinfo.usage("sample-threads must be greater than 0");
+    }
+
     for (const auto& indelErrorModelFilename : opt.indelErrorModelFilenames)
     {
         checkOptionalFile(pinfo, indelErrorModelFilename, "indel error models");
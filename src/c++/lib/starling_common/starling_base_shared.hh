@@ -157,6 +157,20 @@ struct starling_base_options : public blt_options
 
     std::string realignedReadFilenamePrefix;
 
+    /// number of threads used to compress each realigned read file
+    unsigned realignedReadFileThreadCount = 1;
+
+    /// number of threads used to realign the reads starting at each position
+    ///
+    /// results do not depend on the thread count
+    unsigned realignmentThreadCount = 1;
+
+    /// number of threads used to run the per-sample stages of each position (active region detection and pileup)
+    /// for different samples concurrently
+    ///
+    /// results do not depend on the thread count
+    unsigned sampleThreadCount = 1;
+
     double indel_nonsite_match_prob = 0.25;
 
     //------------------------------------------------------
@@ -193,6 +207,12 @@ struct starling_base_options : public blt_options
     /// Stores runtime stats
     std::string segmentStatsFilename;
 
+    /// If non-empty, write a trace of processing cost per region to this file
+    std::string regionProfileFilename;
+
+    /// If non-zero, the region cost trace is split into windows of this size
+    unsigned regionProfileWindowSize = 0;
+
     bool
     isMaxBufferedReads() const
     {
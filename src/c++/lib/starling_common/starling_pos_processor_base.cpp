@@ -239,17 +239,23 @@ starling_pos_processor_base(
     , _ref(ref)
     , _streams(fileStreams)
     , _statsManager(statsManager)
-    , _rmi(STARLING_INIT_LARGEST_READ_SIZE)
     , _largest_indel_ref_span(opt.maxIndelSize)
     , _largest_total_indel_ref_span_per_read(_largest_indel_ref_span)
     , _sample(sampleCount)
     , _pileupCleaner(opt)
     , _indelBuffer(opt,dopt,ref)
+    , _activeRegionIndelBuffer(_indelBuffer)
     , _candidateSnvBuffer(sampleCount)
     , _activeRegionDetector(sampleCount)
+    , _sampleThreadPool(std::min(opt.sampleThreadCount, sampleCount))
+    , _realignmentThreadPool(opt.realignmentThreadCount)
+    , _candidateAlignmentCache(_realignmentThreadPool.getThreadCount())
+    , _regionCostProfiler(opt.regionProfileFilename, opt.regionProfileWindowSize)
 {
     assert(sampleCount != 0);
 
+    _rmi.resize(_sampleThreadPool.getThreadCount(), read_mismatch_info(STARLING_INIT_LARGEST_READ_SIZE));
+
     for (auto& sampleVal : _sample)
     {
         sampleVal.reset(new sample_info(_opt, ref, &_ric));
@@ -288,8 +294,15 @@ resetActiveRegionDetector()
 {
     for (unsigned sampleIndex(0); sampleIndex<getSampleCount(); ++sampleIndex)
     {
+        // retain the cost counts of the detector being replaced:
+        if (_activeRegionDetector[sampleIndex])
+        {
+            _regionCostCounts.activeRegions += _activeRegionDetector[sampleIndex]->getProcessedActiveRegionCount();
+            _regionCostCounts.alignmentCells += _activeRegionDetector[sampleIndex]->getAlignmentCellCount();
+        }
         _activeRegionDetector[sampleIndex].reset(
-            new ActiveRegionDetector(_ref, _indelBuffer, _candidateSnvBuffer, _opt.maxIndelSize, sampleIndex)
+            new ActiveRegionDetector(_ref, _activeRegionIndelBuffer, _candidateSnvBuffer,
+                                     _opt.maxIndelSize, sampleIndex)
         );
     }
 }
@@ -317,7 +330,10 @@ update_largest_read_size(const unsigned rs)
     if (rs>STRELKA_MAX_READ_SIZE) return false;
 
     if (rs<=get_largest_read_size()) return true;
-    _rmi.resize(rs);
+    for (auto& rmi : _rmi)
+    {
+        rmi.resize(rs);
+    }
     update_stageman();
     return true;
 }
@@ -363,8 +379,26 @@ reset()
     {
         _stagemanPtr->reset();
     }
+    flush_reads();
     for (unsigned sampleIndex(0); sampleIndex<getSampleCount(); ++sampleIndex)
         _activeRegionDetector[sampleIndex]->clear();
+
+    _regionCostProfiler.finishRegion(getRegionCostCounts());
+}
+
+
+
+RegionCostCounts
+starling_pos_processor_base::
+getRegionCostCounts() const
+{
+    RegionCostCounts counts(_regionCostCounts);
+    for (const auto& detector : _activeRegionDetector)
+    {
+        counts.activeRegions += detector->getProcessedActiveRegionCount();
+        counts.alignmentCells += detector->getAlignmentCellCount();
+    }
+    return counts;
 }
 
 
@@ -400,6 +434,8 @@ resetRegionBase(
     {
         sampleVal->resetRegion();
     }
+
+    _regionCostProfiler.startRegion(_chromName, _reportRange, getRegionCostCounts());
 }
 
 
@@ -524,9 +560,12 @@ is_estimated_depth_range_ge_than(
     const auto& est2(sample(sample_no).estdepth_buff_tier2);
 
     assert(begin <= end);
-    for (pos_t i(begin); i<=end; ++i)
+    std::vector<unsigned> rangeDepth(end-begin+1,0);
+    est1.add_range_depth(begin,end,rangeDepth);
+    est2.add_range_depth(begin,end,rangeDepth);
+    for (const unsigned posDepth : rangeDepth)
     {
-        if ((est1.val(i)+est2.val(i)) >= depth) return true;
+        if (posDepth >= depth) return true;
     }
     return false;
 }
@@ -590,7 +629,7 @@ insert_read(
     }
 
     // insert the read:
-    retval.reset(rbuff.add_read_alignment(br,al,maplev));
+    retval.reset(rbuff.add_read_alignment(br,al,maplev,_ref));
 
     // must initialize initial read_segments "by-hand":
     //
@@ -598,6 +637,8 @@ insert_read(
     //
     if (retval)
     {
+        _regionCostCounts.reads++;
+
         const starling_read* sread_ptr(rbuff.get_read(*retval));
         assert(nullptr!=sread_ptr);
 
@@ -674,7 +715,7 @@ init_read_segment(
     {
         const unsigned total_indel_ref_span_per_read =
             addAlignmentIndelsToPosProcessor(_opt.maxIndelSize, _ref,
-                                             al, bseq, *this, iat, rseg.getReadIndex(), sampleIndex, rseg.get_segment_edge_pin(),
+                                             al, bseq, rseg.baseIds(), *this, iat, rseg.getReadIndex(), sampleIndex, rseg.get_segment_edge_pin(),
                                              rseg.map_qual() == 0);
 
         update_largest_total_indel_ref_span_per_read(total_indel_ref_span_per_read);
@@ -747,6 +788,14 @@ align_pos(const pos_t pos)
 {
     known_pos_range realign_buffer_range(get_realignment_range(pos, _stagemanPtr->get_stage_data()));
 
+    // only reads starting at the same position can share a candidate alignment search result:
+    for (auto& candidateAlignmentCache : _candidateAlignmentCache)
+    {
+        candidateAlignmentCache.clear();
+    }
+
+    // find all read segments to realign at this position:
+    _realignmentTaskCount = 0;
     const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
@@ -756,30 +805,53 @@ align_pos(const pos_t pos)
         {
             r=ri.get_ptr();
             if (nullptr == r.first) break;
-            read_segment& rseg(r.first->get_segment(r.second));
+            const read_segment& rseg(r.first->get_segment(r.second));
             if (not (_opt.is_realign_submapped_reads || rseg.is_tier1or2_mapping())) continue;
 
-            try
-            {
-                realignAndScoreRead(_opt, _dopt, sif.sampleOptions, _ref, realign_buffer_range, sampleIndex,
-                                    _candidateSnvBuffer, rseg,
-                                    getIndelBuffer());
-            }
-            catch (...)
-            {
-                log_os << "ERROR: Exception caught in align_pos() while realigning segment: "
-                       << static_cast<int>(r.second) << " of read: " << (*r.first) << "\n";
-                throw;
-            }
-            // check that read has not been realigned too far to the left:
-            if (rseg.is_realigned)
+            if (_realignmentTaskCount == _realignmentTasks.size()) _realignmentTasks.emplace_back();
+            RealignmentTask& task(_realignmentTasks[_realignmentTaskCount++]);
+            task.sampleIndex = sampleIndex;
+            task.readPtr = r.first;
+            task.segmentId = r.second;
+        }
+    }
+
+    // realign each read segment against the current indel buffer contents. The indel buffer is only read here, so
+    // the read segments can be realigned concurrently:
+    const IndelBuffer& indelBuffer(getIndelBuffer());
+    _realignmentThreadPool.run(_realignmentTaskCount, [&](const unsigned taskIndex, const unsigned threadIndex)
+    {
+        RealignmentTask& task(_realignmentTasks[taskIndex]);
+        read_segment& rseg(task.readPtr->get_segment(task.segmentId));
+        try
+        {
+            realignAndScoreRead(_opt, _dopt, sample(task.sampleIndex).sampleOptions, _ref, realign_buffer_range,
+                                task.sampleIndex, _candidateSnvBuffer, rseg, indelBuffer,
+                                _candidateAlignmentCache[threadIndex], task.indelScoreUpdates);
+        }
+        catch (...)
+        {
+            log_os << "ERROR: Exception caught in align_pos() while realigning segment: "
+                   << static_cast<int>(task.segmentId) << " of read: " << (*task.readPtr) << "\n";
+            throw;
+        }
+    });
+
+    // merge indel scores into the indel buffer in read order:
+    for (unsigned taskIndex(0); taskIndex<_realignmentTaskCount; ++taskIndex)
+    {
+        const RealignmentTask& task(_realignmentTasks[taskIndex]);
+        task.indelScoreUpdates.apply(getIndelBuffer());
+
+        // check that read has not been realigned too far to the left:
+        read_segment& rseg(task.readPtr->get_segment(task.segmentId));
+        if (rseg.is_realigned)
+        {
+            if (! _stagemanPtr->is_new_pos_value_valid(rseg.realignment.pos,STAGE::POST_ALIGN))
             {
-                if (! _stagemanPtr->is_new_pos_value_valid(rseg.realignment.pos,STAGE::POST_ALIGN))
-                {
-                    log_os << "WARNING: read realigned outside bounds of realignment stage buffer. Skipping...\n"
-                           << "\tread: " << rseg.key() << "\n";
-                    rseg.is_invalid_realignment=true;
-                }
+                log_os << "WARNING: read realigned outside bounds of realignment stage buffer. Skipping...\n"
+                       << "\tread: " << rseg.key() << "\n";
+                rseg.is_invalid_realignment=true;
             }
         }
     }
@@ -792,6 +864,9 @@ starling_pos_processor_base::
 set_head_pos(const pos_t pos)
 {
     _stagemanPtr->validate_new_pos_value(pos,STAGE::READ_BUFFER);
+
+    // position processing time is attributed to RUN_STAGE::OTHER unless a more specific stage is set below:
+    RunStageScope stageScope(_statsManager, RUN_STAGE::OTHER);
     _stagemanPtr->handle_new_pos_value(pos);
 }
 
@@ -817,25 +892,50 @@ process_pos(const int stage_no,
         initializeSplicedReadSegmentsAtPos(pos);
         if (is_active_region_detector_enabled())
         {
-            for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+            RunStageScope stageScope(_statsManager, RUN_STAGE::ACTIVE_REGION);
+            _sampleThreadPool.run(sampleCount, [&](const unsigned sampleIndex, const unsigned)
             {
                 _getActiveRegionDetector(sampleIndex).updateEndPosition(pos);
-            }
+            });
         }
     }
     else if (stage_no==STAGE::READ_BUFFER)
     {
-        align_pos(pos);
-        pileup_pos_reads(pos);
-        write_reads(pos);
+        // region cost windows advance with the read buffer stage, which is the first stage to process reads:
+        if (_regionCostProfiler.isWindowComplete(pos))
+        {
+            _regionCostProfiler.updatePosition(pos, getRegionCostCounts());
+        }
+
+        {
+            RunStageScope stageScope(_statsManager, RUN_STAGE::REALIGNMENT);
+            align_pos(pos);
+        }
+        {
+            RunStageScope stageScope(_statsManager, RUN_STAGE::PILEUP);
+            pileup_pos_reads(pos);
+        }
+        {
+            RunStageScope stageScope(_statsManager, RUN_STAGE::OUTPUT);
+            write_reads(pos);
+        }
 
         if (is_active_region_detector_enabled())
         {
+            RunStageScope stageScope(_statsManager, RUN_STAGE::ACTIVE_REGION);
             for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
             {
                 _getActiveRegionDetector(sampleIndex).clearReadBuffer(pos);
             }
         }
+
+        // all buffers are close to their largest extent for this position after pileup:
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            const sample_info& sif(sample(sampleIndex));
+            _statsManager.updatePeakBufferSizes(sif.readBuffer.size(), getIndelBuffer().size(),
+                                                sif.basecallBuffer.getPositionSpan());
+        }
     }
     else if (stage_no==STAGE::POST_ALIGN)
     {
@@ -892,11 +992,13 @@ process_pos(const int stage_no,
 
         if (isPosReportable or isPosPrecedingReportable)
         {
+            RunStageScope stageScope(_statsManager, RUN_STAGE::GENOTYPING);
             process_pos_variants(pos, isPosPrecedingReportable);
         }
 
         if (is_active_region_detector_enabled())
         {
+            RunStageScope stageScope(_statsManager, RUN_STAGE::ACTIVE_REGION);
             for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
             {
                 _getActiveRegionDetector(sampleIndex).clearUpToPos(pos);
@@ -904,6 +1006,8 @@ process_pos(const int stage_no,
             }
         }
 
+        release_reads(pos);
+
         // everything else:
         post_align_clear_pos(pos);
     }
@@ -1099,9 +1203,9 @@ write_reads(const pos_t pos)
     const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
     {
-        bam_dumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
+        sorted_bam_dumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
         if (nullptr == bamd_ptr) continue;
-        bam_dumper& bamd(*bamd_ptr);
+        sorted_bam_dumper& bamd(*bamd_ptr);
 
         read_segment_iter ri(sample(sampleIndex).readBuffer.get_pos_read_segment_iter(pos));
         read_segment_iter::ret_val r;
@@ -1123,10 +1227,40 @@ write_reads(const pos_t pos)
 
 void
 starling_pos_processor_base::
-pileup_pos_reads(const pos_t pos)
+release_reads(const pos_t pos)
 {
     const unsigned sampleCount(getSampleCount());
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        sorted_bam_dumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
+        if (nullptr == bamd_ptr) continue;
+        bamd_ptr->release(pos);
+    }
+}
+
+
+
+void
+starling_pos_processor_base::
+flush_reads()
+{
+    const unsigned sampleCount(getSampleCount());
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        sorted_bam_dumper* bamd_ptr(_streams.realign_bam_ptr(sampleIndex));
+        if (nullptr == bamd_ptr) continue;
+        bamd_ptr->flush();
+    }
+}
+
+
+
+void
+starling_pos_processor_base::
+pileup_pos_reads(const pos_t pos)
+{
+    // each sample pileup is independent, so samples can be processed concurrently:
+    _sampleThreadPool.run(getSampleCount(), [&](const unsigned sampleIndex, const unsigned threadIndex)
     {
         read_segment_iter ri(sample(sampleIndex).readBuffer.get_pos_read_segment_iter(pos));
         read_segment_iter::ret_val r;
@@ -1135,10 +1269,10 @@ pileup_pos_reads(const pos_t pos)
             r=ri.get_ptr();
             if (nullptr==r.first) break;
             const read_segment& rseg(r.first->get_segment(r.second));
-            pileup_read_segment(rseg, sampleIndex);
+            pileup_read_segment(rseg, sampleIndex, _rmi[threadIndex]);
             ri.next();
         }
-    }
+    });
 }
 
 
@@ -1147,7 +1281,8 @@ void
 starling_pos_processor_base::
 pileup_read_segment(
     const read_segment& rseg,
-    const unsigned sampleIndex)
+    const unsigned sampleIndex,
+    read_mismatch_info& rmi)
 {
     // get the best alignment for the read:
     const alignment* best_al_ptr(&(rseg.getInputAlignment()));
@@ -1189,6 +1324,7 @@ pileup_read_segment(
 
     const unsigned read_size(rseg.read_size());
     const bam_seq bseq(rseg.get_bam_read());
+    const uint8_t* baseIds(rseg.baseIds());
     const uint8_t* qual(rseg.qual());
 
     // these values are only required for special RNA scoring features:
@@ -1268,13 +1404,13 @@ pileup_read_segment(
     if ((! is_submapped) && _opt.is_max_win_mismatch)
     {
         const rc_segment_bam_seq ref_bseq(_ref);
-        create_mismatch_filter_map(_opt,best_al,ref_bseq,bseq,read_begin,read_end, _candidateSnvBuffer, _rmi);
+        create_mismatch_filter_map(_opt,best_al,ref_bseq,bseq,read_begin,read_end, _candidateSnvBuffer, rmi);
         if (_opt.tier2.is_tier2_mismatch_density_filter_count)
         {
             const int max_pass(_opt.tier2.tier2_mismatch_density_filter_count);
             for (unsigned i(0); i<read_size; ++i)
             {
-                _rmi[i].tier2_mismatch_filter_map = (max_pass < _rmi[i].mismatch_count);
+                rmi[i].tier2_mismatch_filter_map = (max_pass < rmi[i].mismatch_count);
             }
         }
     }
@@ -1316,8 +1452,7 @@ pileup_read_segment(
 
                 _stagemanPtr->validate_new_pos_value(ref_pos,STAGE::get_pileup_stage_no(_opt));
 
-                const uint8_t call_code(bseq.get_code(read_pos));
-                const uint8_t call_id(bam_seq_code_to_id(call_code));
+                const uint8_t call_id(baseIds[read_pos]);
 
                 uint8_t qscore(qual[read_pos]);
                 if (is_mapq_adjust)
@@ -1336,18 +1471,18 @@ pileup_read_segment(
                 bool is_tier_specific_filter( false );
                 if (! is_submapped)
                 {
-                    bool is_call_filter((call_code == BAM_BASE::ANY) ||
+                    bool is_call_filter((call_id == BASE_ID::ANY) ||
                                         (qscore < _opt.min_qscore));
 
                     bool is_tier2_call_filter(is_call_filter);
                     if (! is_call_filter && _opt.is_max_win_mismatch)
                     {
-                        is_call_filter = _rmi[read_pos].mismatch_filter_map;
+                        is_call_filter = rmi[read_pos].mismatch_filter_map;
                         if (! _opt.tier2.is_tier2_no_mismatch_density_filter)
                         {
                             if (_opt.tier2.is_tier2_mismatch_density_filter_count)
                             {
-                                is_tier2_call_filter = _rmi[read_pos].tier2_mismatch_filter_map;
+                                is_tier2_call_filter = rmi[read_pos].tier2_mismatch_filter_map;
                             }
                             else
                             {
@@ -1360,7 +1495,7 @@ pileup_read_segment(
 
                     if (_opt.is_max_win_mismatch)
                     {
-                        is_neighbor_mismatch=(_rmi[read_pos].mismatch_count_ns>0);
+                        is_neighbor_mismatch=(rmi[read_pos].mismatch_count_ns>0);
                     }
                 }
 
@@ -1482,6 +1617,7 @@ process_pos_stats(
 
             const bool isCandidate(getIndelBuffer().isCandidateIndel(indelKey, indelData));
             _statsManager.addCallRegionIndel(isCandidate);
+            if (isCandidate) _regionCostCounts.candidateIndels++;
         }
     }
 }
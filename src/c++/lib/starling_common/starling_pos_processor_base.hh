@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include "appstats/RegionCostProfiler.hh"
 #include "appstats/RunStatsManager.hh"
 #include "blt_common/map_level.hh"
 #include "blt_util/depth_buffer.hh"
@@ -32,6 +33,7 @@
 #include "blt_util/RegionTracker.hh"
 #include "blt_util/stage_manager.hh"
 #include "blt_util/window_util.hh"
+#include "blt_util/WorkerThreadPool.hh"
 #include "starling_common/indel_set.hh"
 #include "starling_common/IndelBuffer.hh"
 #include "starling_common/PileupCleaner.hh"
@@ -39,9 +41,11 @@
 #include "starling_common/read_mismatch_info.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_pos_processor_win_avg_set.hh"
+#include "starling_common/starling_read_align_score_indels.hh"
 #include "starling_common/starling_read_buffer.hh"
 #include "starling_common/starling_streams_base.hh"
 #include "starling_common/ActiveRegionDetector.hh"
+#include "starling_common/CandidateAlignmentCache.hh"
 
 
 #include "boost/utility.hpp"
@@ -251,7 +255,13 @@ protected:
             if (_is_last_pos && (pos>(_last_insert_pos+1)))
             {
                 const unsigned rep(std::min(static_cast<pos_t>(_max_winsize),(pos-(_last_insert_pos+1))));
-                for (unsigned i(0); i<rep; ++i) insert_impl(0,0,0,0);
+                for (auto& win : _wav)
+                {
+                    win.ss_used_win.insert_repeat(0,rep);
+                    win.ss_filt_win.insert_repeat(0,rep);
+                    win.ss_spandel_win.insert_repeat(0,rep);
+                    win.ss_submap_win.insert_repeat(0,rep);
+                }
             }
             _last_insert_pos=pos;
             _is_last_pos=true;
@@ -487,14 +497,28 @@ private:
     pileup_pos_reads(const pos_t pos);
 
     /// Add a single read segment into the the basecall pileup
+    ///
+    /// \param rmi working storage for the read mismatch density filter
     void
     pileup_read_segment(
         const read_segment& rseg,
-        const unsigned sampleIndex);
+        const unsigned sampleIndex,
+        read_mismatch_info& rmi);
 
+    /// buffer realigned reads at pos for sorted output to the realigned read files
     void
     write_reads(const pos_t pos);
 
+    /// write all buffered realigned reads positioned at or before pos
+    ///
+    /// this is called at the end of the post-alignment stage, after which no read can be realigned to pos
+    void
+    release_reads(const pos_t pos);
+
+    /// write all buffered realigned reads
+    void
+    flush_reads();
+
     /// maintain stats for depth, etc...
     void
     process_pos_stats(
@@ -544,7 +568,7 @@ protected:
     unsigned
     get_largest_read_size() const
     {
-        return _rmi.size();
+        return _rmi.front().size();
     }
 
 private:
@@ -629,7 +653,8 @@ protected:
     RunStatsManager& _statsManager;
 
     // read-length data structure used to compute mismatch density filter:
-    read_mismatch_info _rmi;
+    // one instance is used per sample thread
+    std::vector<read_mismatch_info> _rmi;
 
     /// Largest delete length observed for any one indel (but not greater than max_delete_size)
     unsigned _largest_indel_ref_span;
@@ -658,7 +683,44 @@ protected:
     PileupCleaner _pileupCleaner;
 
 private:
+    /// \return cumulative cost counts for the region cost profile
+    RegionCostCounts
+    getRegionCostCounts() const;
+
     IndelBuffer _indelBuffer;
+
+    /// locked access to _indelBuffer for the active region detectors of different samples
+    SharedIndelBuffer _activeRegionIndelBuffer;
+
     CandidateSnvBuffer _candidateSnvBuffer;
     std::vector<std::unique_ptr<ActiveRegionDetector>> _activeRegionDetector;
+
+    /// runs the per-sample stages of each position, this only starts additional threads if more than one sample
+    /// thread is requested
+    WorkerThreadPool _sampleThreadPool;
+
+    /// a read segment realigned at the current position
+    struct RealignmentTask
+    {
+        unsigned sampleIndex = 0;
+        starling_read* readPtr = nullptr;
+        seg_id_t segmentId = 0;
+        ReadIndelScoreUpdates indelScoreUpdates;
+    };
+
+    /// realignment tasks for the current position, only the first _realignmentTaskCount entries are used so that
+    /// storage is reused between positions
+    std::vector<RealignmentTask> _realignmentTasks;
+    unsigned _realignmentTaskCount = 0;
+
+    /// runs realignment tasks, this only starts additional threads if more than one realignment thread is requested
+    WorkerThreadPool _realignmentThreadPool;
+
+    /// shares candidate alignment searches between reads during realignment, one cache is used per realignment thread
+    std::vector<CandidateAlignmentCache> _candidateAlignmentCache;
+
+    RegionCostProfiler _regionCostProfiler;
+
+    /// cost counts accumulated outside of the current set of active region detectors
+    RegionCostCounts _regionCostCounts;
 };
@@ -303,6 +303,7 @@ addAlignmentIndelsToPosProcessor(
     const reference_contig_segment& ref,
     const alignment& al,
     const bam_seq_base& read_seq,
+    const uint8_t* readBaseIds,
     starling_pos_processor_base& posProcessor,
     const INDEL_ALIGN_TYPE::index_t iat,
     const align_id_t id,
@@ -468,7 +469,7 @@ addAlignmentIndelsToPosProcessor(
                 const pos_t ref_pos(ref_head_pos + static_cast<pos_t>(j));
                 pos_t read_pos = read_offset + j;
 
-                char base_char = read_seq.get_char(read_pos);
+                const char base_char(id_to_base(readBaseIds[read_pos]));
 
                 if (ref.get_base(ref_pos) != base_char)
                 {
@@ -31,6 +31,7 @@
 /// Extract indel information from various alignment types and store
 /// this information in the starling_pos_processor indel buffer.
 ///
+/// \param readBaseIds read_seq decoded into BASE_ID values
 /// \param edge_pin are the beginning or end of this read segment pinned?
 ///
 /// assumes that path is already validated for read_seq!!!
@@ -41,6 +42,7 @@ addAlignmentIndelsToPosProcessor(
     const reference_contig_segment& ref,
     const alignment& al,
     const bam_seq_base& read_seq,
+    const uint8_t* readBaseIds,
     starling_pos_processor_base& posProcessor,
     const INDEL_ALIGN_TYPE::index_t iat,
     const align_id_t id,
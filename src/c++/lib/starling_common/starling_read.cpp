@@ -28,6 +28,7 @@
 #include "starling_read_util.hh"
 
 #include "blt_util/log.hh"
+#include "blt_util/seq_util.hh"
 #include "common/Exceptions.hh"
 #include "htsapi/align_path_bam_util.hh"
 #include "starling_common/starling_read.hh"
@@ -41,12 +42,49 @@ starling_read(
     const bam_record& br,
     const alignment& inputAlignment,
     const MAPLEVEL::index_t inputAlignmentMapLevel,
-    const align_id_t readIndex)
+    const align_id_t readIndex,
+    const reference_contig_segment& ref)
     : _inputAlignmentMapLevel(inputAlignmentMapLevel),
       _readIndex(readIndex),
       _read_rec(br),
       _full_read(_read_rec.read_size(), 0, *this, inputAlignment)
 {
+    {
+        const bam_seq bseq(_read_rec.get_bam_read());
+        const unsigned readSize(bseq.size());
+        _readBaseIds.resize(readSize);
+        bool isRefCode(false);
+        for (unsigned readPos(0); readPos<readSize; ++readPos)
+        {
+            const uint8_t code(bseq.get_code(readPos));
+            if (code == BAM_BASE::REF) isRefCode = true;
+            _readBaseIds[readPos] = bam_seq_code_to_id(code);
+        }
+
+        if (isRefCode)
+        {
+            // '=' basecalls match the reference base at their aligned position:
+            using namespace ALIGNPATH;
+
+            pos_t readPos(0);
+            pos_t refPos(inputAlignment.pos);
+            for (const path_segment& ps : inputAlignment.path)
+            {
+                if (is_segment_align_match(ps.type))
+                {
+                    for (unsigned segmentOffset(0); segmentOffset<ps.length; ++segmentOffset)
+                    {
+                        const pos_t segmentReadPos(readPos+segmentOffset);
+                        if (bseq.get_code(segmentReadPos) != BAM_BASE::REF) continue;
+                        _readBaseIds[segmentReadPos] = base_to_id(ref.get_base(refPos+segmentOffset));
+                    }
+                }
+                if (is_segment_type_read_length(ps.type)) readPos += ps.length;
+                if (is_segment_type_ref_length(ps.type)) refPos += ps.length;
+            }
+        }
+    }
+
     const seg_id_t exonCount(apath_exon_count(inputAlignment.path));
     if (exonCount <= 1) return;
 
@@ -176,7 +214,7 @@ update_full_segment()
 
 void
 starling_read::
-write_bam(bam_dumper& bamd)
+write_bam(sorted_bam_dumper& bamd)
 {
     if (isSpliced()) update_full_segment();
 
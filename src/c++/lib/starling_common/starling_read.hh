@@ -24,7 +24,8 @@
 #pragma once
 
 #include "blt_common/map_level.hh"
-#include "htsapi/bam_dumper.hh"
+#include "blt_util/reference_contig_segment.hh"
+#include "htsapi/sorted_bam_dumper.hh"
 #include "starling_common/starling_read_key.hh"
 #include "starling_common/starling_read_segment.hh"
 
@@ -44,6 +45,7 @@ struct starling_read : private boost::noncopyable
     /// \param br a representation of the read's htslib BAM record
     /// \param inputAlignment read alignment proposed by a mapper or other external tool
     /// \param inputAlignmentMapLevel mapping confidence classification for the input mapping
+    /// \param ref reference used to decode any BAM '=' basecalls
     ///
     /// This ctor handles segment setup for spliced reads.
     ///
@@ -54,12 +56,13 @@ struct starling_read : private boost::noncopyable
         const bam_record& br,
         const alignment& inputAlignment,
         const MAPLEVEL::index_t inputAlignmentMapLevel,
-        const align_id_t readIndex);
+        const align_id_t readIndex,
+        const reference_contig_segment& ref);
 
     // This is not const because we update the BAM record with the best
     // alignment if the read has been realigned:
     void
-    write_bam(bam_dumper& bamd);
+    write_bam(sorted_bam_dumper& bamd);
 
     bool
     is_fwd_strand() const
@@ -165,6 +168,15 @@ private:
     /// Internal alignment index created and used only within Strelka
     const align_id_t _readIndex;
     bam_record _read_rec;
+
+    /// Read sequence decoded into BASE_ID values, one byte per basecall
+    ///
+    /// A,C,G,T are given by their 2-bit base index and BASE_ID::ANY flags an N basecall. This is decoded
+    /// once when the read is created so that pileup and realignment loops do not repeatedly decode the
+    /// 4-bit BAM sequence. BAM '=' basecalls are decoded to the reference base at their input alignment
+    /// position, or to BASE_ID::ANY if they are not aligned to the reference.
+    std::vector<uint8_t> _readBaseIds;
+
     read_segment _full_read;
 
     /// Store details of each exon if the read is spliced
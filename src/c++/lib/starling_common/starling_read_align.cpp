@@ -28,15 +28,21 @@
 #include "starling_read_align_score_indels.hh"
 
 #include "blt_util/blt_exception.hh"
+#include "blt_util/FlatHashMap.hh"
 #include "blt_util/log.hh"
 #include "blt_util/pos_range.hh"
 #include "starling_common/indel_util.hh"
 #include "ActiveRegionDetector.hh"
 
+#include "boost/functional/hash.hpp"
+
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 
+#include <algorithm>
+
 #include <iostream>
 #include <sstream>
 
@@ -44,24 +50,181 @@
 //#define DEBUG_ALIGN
 
 
-/// information associated with each candidate indel intersecting an alignment
-struct starling_align_indel_info
+/// A set of indices into the indel list of a candidate alignment search
+struct IndelIndexBits
 {
-    bool is_present = false; ///< candidate indel is present in the alignment already
-    bool is_remove_only = false; ///< candidate indel can be toggled off during search but not added
+    bool
+    test(const unsigned index) const
+    {
+        const unsigned wordIndex(index/wordBitCount);
+        if (wordIndex >= _words.size()) return false;
+        return ((_words[wordIndex] >> (index%wordBitCount)) & 1u);
+    }
+
+    void
+    set(
+        const unsigned index,
+        const bool value)
+    {
+        const unsigned wordIndex(index/wordBitCount);
+        if (wordIndex >= _words.size()) _words.resize(wordIndex+1, 0);
+        const uint64_t mask(static_cast<uint64_t>(1) << (index%wordBitCount));
+        if (value)
+        {
+            _words[wordIndex] |= mask;
+        }
+        else
+        {
+            _words[wordIndex] &= ~mask;
+        }
+    }
+
+    void
+    clear()
+    {
+        _words.clear();
+    }
+
+    /// \return true if the two sets contain the same indices
+    bool
+    operator==(const IndelIndexBits& rhs) const
+    {
+        const unsigned size(std::max(_words.size(), rhs._words.size()));
+        for (unsigned wordIndex(0); wordIndex<size; ++wordIndex)
+        {
+            if (getWord(wordIndex) != rhs.getWord(wordIndex)) return false;
+        }
+        return true;
+    }
+
+    /// \return a hash of the set contents which is consistent with operator==
+    size_t
+    hash() const
+    {
+        size_t seed(0);
+        for (unsigned wordIndex(0); wordIndex<_words.size(); ++wordIndex)
+        {
+            if (_words[wordIndex] == 0) continue;
+            boost::hash_combine(seed, wordIndex);
+            boost::hash_combine(seed, _words[wordIndex]);
+        }
+        return seed;
+    }
+
+private:
+    uint64_t
+    getWord(const unsigned wordIndex) const
+    {
+        return ((wordIndex < _words.size()) ? _words[wordIndex] : 0);
+    }
+
+    static const unsigned wordBitCount = 64;
+    std::vector<uint64_t> _words;
 };
 
 
-static
-std::ostream&
-operator<<(std::ostream& os, const starling_align_indel_info& ii)
+
+/// The state of one branch of the candidate alignment search
+///
+/// Indels are referred to by their index in the search's list of discovered indels.
+///
+struct CandidateAlignmentSearchBranch
 {
-    os << "is_present: " << ii.is_present << " is_remove_only: " << ii.is_remove_only;
-    return os;
-}
+    /// the order in which indels are toggled on this branch
+    std::vector<unsigned> indelOrder;
+
+    /// indels which intersect or are adjacent to an alignment on this branch and are usable by the read
+    IndelIndexBits isKnown;
 
+    /// known indels which are present in the alignment
+    IndelIndexBits isPresent;
 
-typedef std::map<IndelKey,starling_align_indel_info> starling_align_indel_status;
+    /// known indels which can be toggled off during search but not added
+    IndelIndexBits isRemoveOnly;
+
+    unsigned depth = 0;
+    unsigned toggleDepth = 0;
+    known_pos_range readRange = known_pos_range(0,0);
+    int maxReadIndelToggle = 0;
+    CandidateAlignment cal;
+};
+
+
+
+/// Working storage for the candidate alignment search of one read
+///
+/// All storage is retained between searches so that steady-state searches run without allocation, other than
+/// for the candidate alignments which are returned.
+///
+struct CandidateAlignmentSearchWorkspace
+{
+    void
+    clear()
+    {
+        indels.clear();
+        sortedIndelIndex.clear();
+        branchCount = 0;
+        leafCount = 0;
+        leafIndex.clear();
+    }
+
+    /// push a new branch onto the search stack
+    CandidateAlignmentSearchBranch&
+    pushBranch()
+    {
+        if (branchCount == branches.size()) branches.emplace_back();
+        return branches[branchCount++];
+    }
+
+    struct DiscoveredIndel
+    {
+        const IndelKey* keyPtr;
+        bool isUsable;
+    };
+
+    /// all indels discovered during the search, with keys referring to the indel buffer
+    std::vector<DiscoveredIndel> indels;
+
+    /// indices of the discovered indels in IndelKey sort order
+    std::vector<unsigned> sortedIndelIndex;
+
+    /// stack of branches waiting to be searched
+    std::vector<CandidateAlignmentSearchBranch> branches;
+    unsigned branchCount = 0;
+
+    /// the branch currently being searched
+    CandidateAlignmentSearchBranch branch;
+
+    /// sorted keys of the indels present in a new alignment
+    std::vector<IndelKey> currentIndels;
+
+    /// temporary storage for indel order updates
+    std::vector<unsigned> indelOrderBuffer;
+
+    /// Each completed search branch produces a candidate alignment which is fully determined by its alignment and
+    /// present indel set, except that the input alignment keeps its own edge indel keys.
+    struct Leaf
+    {
+        bool
+        operator==(const Leaf& rhs) const
+        {
+            return ((isInputAlignment == rhs.isInputAlignment) and
+                    (al == rhs.al) and
+                    (isPresent == rhs.isPresent));
+        }
+
+        bool isInputAlignment = false;
+        alignment al;
+        IndelIndexBits isPresent;
+    };
+
+    /// leaves of the current search used to skip duplicate candidate alignments
+    std::vector<Leaf> leaves;
+    unsigned leafCount = 0;
+
+    /// index+1 of the first leaf for each leaf hash value
+    FlatHashMap<size_t,unsigned> leafIndex;
+};
 
 
 
@@ -143,19 +306,6 @@ check_for_candidate_indel_overlap(
 }
 
 
-static
-void
-dump_indel_status(const starling_align_indel_status& ismap,
-                  std::ostream& os)
-{
-    for (const auto& is : ismap)
-    {
-        os << is.first << "status: " << is.second << "\n";
-    }
-}
-
-
-
 /// is an indel either a candidate indel or in at least one of the
 /// discovery alignments for this read?
 ///
@@ -179,8 +329,53 @@ is_usable_indel(
 
 
 
+/// \return index of the indel at \p indelIter in the search's discovered indel list, adding it if it is new
+///
+/// \param[in,out] nonCandidateIndelUsability all non-candidate indels tested for usability are appended here
+///
+static
+unsigned
+getDiscoveredIndelIndex(
+    const align_id_t read_id,
+    const IndelBuffer& indelBuffer,
+    const IndelBuffer::const_iterator indelIter,
+    const unsigned sampleId,
+    CandidateAlignmentSearchWorkspace& workspace,
+    indel_usability_t& nonCandidateIndelUsability)
+{
+    const IndelKey& indelKey(indelIter->first);
+    auto& indels(workspace.indels);
+    const unsigned indelCount(indels.size());
+    for (unsigned indelIndex(0); indelIndex<indelCount; ++indelIndex)
+    {
+        if (indels[indelIndex].keyPtr == &indelKey) return indelIndex;
+    }
+
+    const IndelData& indelData(getIndelData(indelIter));
+    const bool isUsable(is_usable_indel(indelBuffer, indelKey, indelData, read_id, sampleId));
+    if (not indelBuffer.isCandidateIndel(indelKey, indelData))
+    {
+        nonCandidateIndelUsability.emplace_back(indelKey, isUsable);
+    }
+    indels.push_back({&indelKey, isUsable});
+
+    auto& sortedIndelIndex(workspace.sortedIndelIndex);
+    const auto sortedIter(std::upper_bound(sortedIndelIndex.begin(), sortedIndelIndex.end(), indelKey,
+                                           [&](const IndelKey& key, const unsigned index)
+    {
+        return (key < *(indels[index].keyPtr));
+    }));
+    sortedIndelIndex.insert(sortedIter, indelCount);
+    return indelCount;
+}
+
+
+
 /// find all indels in the indel_buffer which intersect a range (and
-/// meet candidacy/usability requirements)
+/// meet candidacy/usability requirements) and add them to the search branch
+///
+/// \param[in,out] nonCandidateIndelUsability all non-candidate indels tested for usability are appended here
+///
 static
 void
 add_indels_in_range(
@@ -188,8 +383,9 @@ add_indels_in_range(
     const IndelBuffer& indelBuffer,
     const known_pos_range& pr,
     const unsigned sampleId,
-    starling_align_indel_status& indel_status_map,
-    std::vector<IndelKey>& indel_order)
+    CandidateAlignmentSearchWorkspace& workspace,
+    CandidateAlignmentSearchBranch& branch,
+    indel_usability_t& nonCandidateIndelUsability)
 {
     const auto indelIterPair(indelBuffer.rangeIterator(pr.begin_pos, pr.end_pos));
 #ifdef DEBUG_ALIGN
@@ -198,13 +394,7 @@ add_indels_in_range(
     for (auto indelIter(indelIterPair.first); indelIter!=indelIterPair.second; ++indelIter)
     {
         const IndelKey& indelKey(indelIter->first);
-        // check if read intersects with indel and indel is usable by this read:
-#ifdef DEBUG_ALIGN
-        std::cerr << "VARMIT INDEL CANDIDATE " << ik;
-        std::cerr << "Intersect?: " << is_range_intersect_indel_breakpoints(pr,ik) << "\n";
-        std::cerr << "Usable?: " <<  is_usable_indel(indelBuffer,ik,get_indel_data(i),read_id) << "\n";
-        std::cerr << "Count: " << indel_status_map.count(ik) << "\n";
-#endif
+
         // check if the indel is not intersecting or adjacent -- if neither we don't need to
         // worry about the indel at all:
         if (! is_range_adjacent_indel_breakpoints(pr,indelKey)) continue;
@@ -212,28 +402,21 @@ add_indels_in_range(
         // if true, this means the indel is adjacent but not intersecting:
         const bool is_remove_only(! is_range_intersect_indel_breakpoints(pr,indelKey));
 
-#ifdef DEBUG_ALIGN
-        std::cerr << "is_remove_only " << is_remove_only << "\n";
-#endif
+        const unsigned indelIndex(getDiscoveredIndelIndex(read_id, indelBuffer, indelIter, sampleId, workspace,
+                                                          nonCandidateIndelUsability));
 
         // if indel is already present, it may be possible to promote this indel from
         // adjacent to an intersection:
-        if (indel_status_map.count(indelKey))
+        if (branch.isKnown.test(indelIndex))
         {
-            if ((! is_remove_only) && indel_status_map[indelKey].is_remove_only)
-            {
-                indel_status_map[indelKey].is_remove_only = false;
-            }
+            if (! is_remove_only) branch.isRemoveOnly.set(indelIndex, false);
         }
-        else
+        else if (workspace.indels[indelIndex].isUsable)
         {
-            const IndelData& indelData(getIndelData(indelIter));
-            if (is_usable_indel(indelBuffer, indelKey, indelData, read_id, sampleId))
-            {
-                indel_status_map[indelKey].is_present = false;
-                indel_status_map[indelKey].is_remove_only = is_remove_only;
-                indel_order.push_back(indelKey);
-            }
+            branch.isKnown.set(indelIndex, true);
+            branch.isPresent.set(indelIndex, false);
+            branch.isRemoveOnly.set(indelIndex, is_remove_only);
+            branch.indelOrder.push_back(indelIndex);
         }
     }
 }
@@ -261,15 +444,19 @@ add_path_segment(
 /// value -- indel sets should be pre-filtered for cases where an indel
 /// crosses the start pos, so this is treated as an error condition:
 ///
+/// \param[in] indels indels in the alignment, in IndelKey sort order
+/// \param[out] cal the new alignment, any previous contents are replaced
+///
 /// see unit tests
 static
-CandidateAlignment
+void
 make_start_pos_alignment(
     const pos_t ref_start_pos,
     const pos_t read_start_pos,
     const bool is_fwd_strand,
     const unsigned read_length,
-    const indel_set_t& indels)
+    const std::vector<IndelKey>& indels,
+    CandidateAlignment& cal)
 {
     using namespace ALIGNPATH;
 
@@ -281,9 +468,11 @@ make_start_pos_alignment(
     // (but not a leading deletion)
     const bool is_leading_read(read_start_pos!=0);
 
-    CandidateAlignment cal;
     cal.al.pos=ref_start_pos;
     cal.al.is_fwd_strand=is_fwd_strand;
+    cal.al.path.clear();
+    cal.leading_indel_key = IndelKey();
+    cal.trailing_indel_key = IndelKey();
 
     pos_t ref_head_pos(ref_start_pos);
     pos_t read_head_pos(read_start_pos);
@@ -430,8 +619,6 @@ make_start_pos_alignment(
     {
         apath.push_back(path_segment(MATCH,(read_length-read_head_pos)));
     }
-
-    return cal;
 }
 
 
@@ -439,11 +626,13 @@ make_start_pos_alignment(
 /// when the current indel set included, and then use the
 /// make_start_pos_alignment routine.
 ///
+/// \param[in] indels indels in the alignment, in IndelKey sort order
+///
 /// see unit tests
 static
 void
 get_end_pin_start_pos(
-    const indel_set_t& indels,
+    const std::vector<IndelKey>& indels,
     const unsigned read_length,
     const pos_t ref_end_pos,
     const pos_t read_end_pos,
@@ -462,13 +651,9 @@ get_end_pin_start_pos(
 
     bool is_first(true);
 
-    // having trouble with normal reverse_iterator for this data
-    // structure, so reversal is done by hand:
-    indel_set_t::const_iterator i(indels.end()),i_begin(indels.begin());
-    while (i!=i_begin)
+    for (auto indelIter(indels.crbegin()); indelIter!=indels.crend(); ++indelIter)
     {
-        --i;
-        const IndelKey& indelKey(*i);
+        const IndelKey& indelKey(*indelIter);
 
         // check that indel actually intersects the read:
         if (indelKey.pos > ref_end_pos) continue;
@@ -558,43 +743,32 @@ get_end_pin_start_pos(
 /// to prevent incomplete search, we must put new non-present remove_only indels at the end of the list:
 static
 void
-sort_remove_only_indels_last(const starling_align_indel_status& indel_status_map,
-                             std::vector<IndelKey>& indel_order,
-                             const unsigned current_depth = 0)
+sort_remove_only_indels_last(
+    CandidateAlignmentSearchBranch& branch,
+    std::vector<unsigned>& indelOrderBuffer,
+    const unsigned current_depth = 0)
 {
-    typedef std::vector<IndelKey>::const_iterator siter;
-    const siter i_begin(indel_order.begin());
-    const siter i_new(i_begin+current_depth);
-    const siter i_end(indel_order.end());
-
-    std::vector<IndelKey> indel_order2;
-    for (siter i(i_begin); i!=i_new; ++i)
+    std::vector<unsigned>& indelOrder(branch.indelOrder);
+    auto isSearchFirst = [&](const unsigned indelIndex)
     {
-        indel_order2.push_back(*i);
-    }
-    for (siter i(i_new); i!=i_end; ++i)
+        return (branch.isPresent.test(indelIndex) || (! branch.isRemoveOnly.test(indelIndex)));
+    };
+
+    indelOrderBuffer.clear();
+    const unsigned orderSize(indelOrder.size());
+    for (unsigned orderIndex(current_depth); orderIndex<orderSize; ++orderIndex)
     {
-        const starling_align_indel_info& sai(indel_status_map.find(*i)->second);
-        if (  (sai.is_present || (! sai.is_remove_only))) indel_order2.push_back(*i);
+        if (isSearchFirst(indelOrder[orderIndex])) indelOrderBuffer.push_back(indelOrder[orderIndex]);
     }
-    for (siter i(i_new); i!=i_end; ++i)
+    for (unsigned orderIndex(current_depth); orderIndex<orderSize; ++orderIndex)
     {
-        const starling_align_indel_info& sai(indel_status_map.find(*i)->second);
-        if (! (sai.is_present || (! sai.is_remove_only))) indel_order2.push_back(*i);
+        if (! isSearchFirst(indelOrder[orderIndex])) indelOrderBuffer.push_back(indelOrder[orderIndex]);
     }
-    indel_order.swap(indel_order2);
+    std::copy(indelOrderBuffer.begin(), indelOrderBuffer.end(), indelOrder.begin()+current_depth);
 }
 
 
 
-struct mca_warnings
-{
-    bool origin_skip = false;
-    bool max_toggle_depth = false;
-};
-
-
-
 static
 void
 add_pin_exception_info(
@@ -605,7 +779,7 @@ add_pin_exception_info(
     const pos_t ref_start_pos,
     const pos_t read_start_pos,
     const IndelKey& cindel,
-    const indel_set_t& current_indels)
+    const std::vector<IndelKey>& current_indels)
 {
     log_os << "\nException caught while building " << label << "-pinned alignment candidate at depth: " << depth << "\n"
            << "\tcal: " << cal
@@ -624,15 +798,16 @@ add_pin_exception_info(
 static
 void
 addKeysToCandidateAlignment(
-    const starling_align_indel_status& indel_status_map,
+    const CandidateAlignmentSearchWorkspace& workspace,
+    const CandidateAlignmentSearchBranch& branch,
     CandidateAlignment& cal)
 {
     const auto cal_strict_pr(getStrictAlignmentRange(cal.al));
     indel_set_t calIndels;
-    for (const auto& indelVal : indel_status_map)
+    for (const unsigned indelIndex : workspace.sortedIndelIndex)
     {
-        if (not indelVal.second.is_present) continue;
-        const IndelKey& indelKey(indelVal.first);
+        if (not branch.isPresent.test(indelIndex)) continue;
+        const IndelKey& indelKey(*(workspace.indels[indelIndex].keyPtr));
         if (not is_range_intersect_indel_breakpoints(cal_strict_pr, indelKey)) continue;
         calIndels.insert(indelKey);
     }
@@ -644,8 +819,54 @@ addKeysToCandidateAlignment(
 
 
 
-/// Recursively build potential alignment paths and push them into the
-/// candidate alignment set:
+/// \return true if the completed search branch produces a candidate alignment which has not been found earlier in
+/// the same search
+static
+bool
+isNewSearchLeaf(
+    const CandidateAlignmentSearchBranch& branch,
+    CandidateAlignmentSearchWorkspace& workspace)
+{
+    const bool isInputAlignment(branch.toggleDepth == 0);
+
+    size_t leafHash(branch.isPresent.hash());
+    boost::hash_combine(leafHash, isInputAlignment);
+    boost::hash_combine(leafHash, branch.cal.al.pos);
+    for (const auto& ps : branch.cal.al.path)
+    {
+        boost::hash_combine(leafHash, static_cast<int>(ps.type));
+        boost::hash_combine(leafHash, ps.length);
+    }
+
+    auto& leaves(workspace.leaves);
+    unsigned& leafIndex(workspace.leafIndex.getRef(leafHash));
+    if (leafIndex != 0)
+    {
+        const CandidateAlignmentSearchWorkspace::Leaf& leaf(leaves[leafIndex-1]);
+        if ((leaf.isInputAlignment == isInputAlignment) &&
+            (leaf.al == branch.cal.al) &&
+            (leaf.isPresent == branch.isPresent)) return false;
+
+        // a hash collision with a different leaf is treated as new, so that it can still be found
+        // in the candidate alignment set
+        return true;
+    }
+
+    if (workspace.leafCount == leaves.size()) leaves.emplace_back();
+    CandidateAlignmentSearchWorkspace::Leaf& leaf(leaves[workspace.leafCount++]);
+    leaf.isInputAlignment = isInputAlignment;
+    leaf.al = branch.cal.al;
+    leaf.isPresent = branch.isPresent;
+    leafIndex = workspace.leafCount;
+    return true;
+}
+
+
+
+/// Build potential alignment paths and push them into the candidate alignment set
+///
+/// Each search branch may toggle its next indel to create up to two new branches, this is run from an explicit
+/// stack of branches in the search workspace, starting from the branch(es) already on the stack.
 ///
 static
 void
@@ -659,299 +880,316 @@ candidate_alignment_search(
     const known_pos_range& realign_buffer_range,
     std::set<CandidateAlignment>& cal_set,
     mca_warnings& warn,
-    starling_align_indel_status indel_status_map,
-    std::vector<IndelKey> indel_order,
-    const unsigned depth,
-    const unsigned toggle_depth,
-    known_pos_range read_range,
-    int max_read_indel_toggle,
-    const CandidateAlignment& cal)
+    indel_usability_t& nonCandidateIndelUsability,
+    CandidateAlignmentSearchWorkspace& workspace)
 {
-#ifdef DEBUG_ALIGN
-    std::cerr << "VARMIT starting MCA depth: " << depth << "\n";
-    std::cerr << "\twith cal: " << cal;
-#endif
+    CandidateAlignmentSearchBranch& branch(workspace.branch);
 
-    // first step is to check for new indel overlaps and extend the
-    // indel_status_map as necessary:
-    //
-    // note that we search for new indels in the range expanded from
-    // the last alignment, but include an additional base from the
-    // previous range so that we correctly overlap all potential new
-    // indels.
-    //
-    bool is_new_indels(toggle_depth==0);
+    while (workspace.branchCount > 0)
     {
-        const unsigned start_ism_size(indel_status_map.size());
-        const known_pos_range pr(get_soft_clip_alignment_range(cal.al));
+        workspace.branchCount--;
+        std::swap(branch, workspace.branches[workspace.branchCount]);
 
-        // check to make sure we don't realign outside of the realign buffer:
-        if (! realign_buffer_range.is_superset_of(pr)) return;
+        const CandidateAlignment& cal(branch.cal);
 
-        if (pr.begin_pos < read_range.begin_pos)
-        {
-            add_indels_in_range(read_id, indelBuffer, known_pos_range(pr.begin_pos, read_range.begin_pos + 1), sampleId,
-                                indel_status_map, indel_order);
-            read_range.begin_pos = pr.begin_pos;
-        }
-        if (pr.end_pos > read_range.end_pos)
+#ifdef DEBUG_ALIGN
+        std::cerr << "VARMIT starting MCA depth: " << branch.depth << "\n";
+        std::cerr << "\twith cal: " << cal;
+#endif
+
+        // first step is to check for new indel overlaps and extend the
+        // branch's indel set as necessary:
+        //
+        // note that we search for new indels in the range expanded from
+        // the last alignment, but include an additional base from the
+        // previous range so that we correctly overlap all potential new
+        // indels.
+        //
+        bool is_new_indels(branch.toggleDepth==0);
         {
-            add_indels_in_range(read_id, indelBuffer, known_pos_range(read_range.end_pos - 1, pr.end_pos), sampleId,
-                                indel_status_map, indel_order);
-            read_range.end_pos = pr.end_pos;
+            const unsigned start_indel_count(branch.indelOrder.size());
+            const known_pos_range pr(get_soft_clip_alignment_range(cal.al));
+
+            // check to make sure we don't realign outside of the realign buffer:
+            if (! realign_buffer_range.is_superset_of(pr)) continue;
+
+            known_pos_range& read_range(branch.readRange);
+            if (pr.begin_pos < read_range.begin_pos)
+            {
+                add_indels_in_range(read_id, indelBuffer, known_pos_range(pr.begin_pos, read_range.begin_pos + 1),
+                                    sampleId, workspace, branch, nonCandidateIndelUsability);
+                read_range.begin_pos = pr.begin_pos;
+            }
+            if (pr.end_pos > read_range.end_pos)
+            {
+                add_indels_in_range(read_id, indelBuffer, known_pos_range(read_range.end_pos - 1, pr.end_pos),
+                                    sampleId, workspace, branch, nonCandidateIndelUsability);
+                read_range.end_pos = pr.end_pos;
+            }
+
+            if (! is_new_indels)
+            {
+                is_new_indels=(start_indel_count!=branch.indelOrder.size());
+            }
+
+            if (is_new_indels)
+            {
+                sort_remove_only_indels_last(branch, workspace.indelOrderBuffer, start_indel_count);
+            }
         }
 
-        if (! is_new_indels)
+        const unsigned indelCount(branch.indelOrder.size());
+
+        // next check for branch termination:
+        if (branch.depth == indelCount)
         {
-            is_new_indels=(start_ism_size!=indel_status_map.size());
+            if (isNewSearchLeaf(branch, workspace))
+            {
+                CandidateAlignment calWithKeys(cal);
+                addKeysToCandidateAlignment(workspace, branch, calWithKeys);
+                cal_set.insert(std::move(calWithKeys));
+            }
+            continue;
         }
 
         if (is_new_indels)
         {
-            sort_remove_only_indels_last(indel_status_map,indel_order,start_ism_size);
-        }
-    }
+            // Check for very high candidate indel density. If found, indel
+            // search toggling is turned down to the minimum level which still
+            // allows simple calls (distance 1 from input alignment). The intention
+            // is to allow basic indel calling to proceed in practical time
+            // through regions with very high numbers of candidate indels.
+            //
+            // TODO: Note the expression for indel density doesn't account for
+            // a possibly large number of indels intersected by a large
+            // deletion in a read. This works well enough for now, but if the
+            // max indel size is ever run around the order of 10k or more this
+            // might start to spuriously engage the filter.
+            //
+            const double max_indels(read_length*opt.max_candidate_indel_density);
+            if (indelCount>max_indels)
+            {
+                branch.maxReadIndelToggle=1;
+            }
+            else
+            {
+                branch.maxReadIndelToggle=opt.max_read_indel_toggle;
+            }
 
-    // next check for recursive termination:
-    if (depth == indel_order.size())
-    {
-        CandidateAlignment calWithKeys(cal);
-        addKeysToCandidateAlignment(indel_status_map, calWithKeys);
-        cal_set.insert(std::move(calWithKeys));
-        return;
-    }
+            // a new stronger complexity limit on search based on total candidate indels crossing the read:
+            //
+            {
+                const int max_toggle(dopt.sal.get_max_toggle(indelCount));
+                branch.maxReadIndelToggle=std::min(branch.maxReadIndelToggle,max_toggle);
+            }
+        }
 
-    if (is_new_indels)
-    {
-        // Check for very high candidate indel density. If found, indel
-        // search toggling is turned down to the minimum level which still
-        // allows simple calls (distance 1 from input alignment). The intention
-        // is to allow basic indel calling to proceed in practical time
-        // through regions with very high numbers of candidate indels.
-        //
-        // TODO: Note the expression for indel density doesn't account for
-        // a possibly large number of indels intersected by a large
-        // deletion in a read. This works well enough for now, but if the
-        // max indel size is ever run around the order of 10k or more this
-        // might start to spuriously engage the filter.
+        // check whether toggling the input alignment already exceeds the maximum
+        // number of toggles made to the exemplar alignment (this is
+        // here to prevent a combinatorial blowup)
         //
-        const double max_indels(read_length*opt.max_candidate_indel_density);
-        if (indel_status_map.size()>max_indels)
-        {
-            max_read_indel_toggle=1;
-        }
-        else
+        if (static_cast<int>(branch.toggleDepth)>branch.maxReadIndelToggle)
         {
-            max_read_indel_toggle=opt.max_read_indel_toggle;
+            warn.max_toggle_depth=true;
+            continue;
         }
 
-        // a new stronger complexity limit on search based on total candidate indels crossing the read:
+        // each search step creates (up to) 3 branches:
+        //  1) is the current state of the active indel
+        //  2) is the alternate state of the active indel with the alignment's start position pinned
+        //  3) is the alternate state of the active indel with the alignment's end position pinned
+        //
+        // toggle will not be invoked for unusable indels (but those are
+        // already filtered out of the list)
+        //
+        // start or end position may be skipped if a deletion spans one or
+        // both of these points
+        //
+        // edge-indels can only be pinned on one side
+        //
+        // branches are pushed in reverse order, so that they are searched in the order listed above.
         //
+        const unsigned depth(branch.depth);
+        const unsigned cindelIndex(branch.indelOrder[depth]);
+        const IndelKey& cindel(*(workspace.indels[cindelIndex].keyPtr));
+        const bool is_cindel_on(branch.isPresent.test(cindelIndex));
+
+        bool isToggleAllowed(true);
+        if (! is_cindel_on)
         {
-            const int max_toggle(dopt.sal.get_max_toggle(indel_status_map.size()));
-            max_read_indel_toggle=std::min(max_read_indel_toggle,max_toggle);
+            // check whether this is a remove only indel:
+            if (branch.isRemoveOnly.test(cindelIndex))
+            {
+                isToggleAllowed = false;
+            }
+            else
+            {
+                // check whether this indel would interfere with an indel that's
+                // already been toggled on:
+                //
+                for (unsigned orderIndex(0); orderIndex<depth; ++orderIndex)
+                {
+                    const unsigned indelIndex(branch.indelOrder[orderIndex]);
+                    if (branch.isPresent.test(indelIndex) &&
+                        is_indel_conflict(*(workspace.indels[indelIndex].keyPtr),cindel))
+                    {
+                        isToggleAllowed = false;
+                        break;
+                    }
+                }
+            }
         }
-    }
-
-    // check whether toggling the input alignment already exceeds the maximum
-    // number of toggles made to the exemplar alignment (this is
-    // here to prevent a combinatorial blowup)
-    //
-    if (static_cast<int>(toggle_depth)>max_read_indel_toggle)
-    {
-        warn.max_toggle_depth=true;
-        return;
-    }
-
-    // each recursive step invokes (up to) 3 paths:
-    //  1) is the current state of the active indel
-    //  2) is the alternate state of the active indel with the alignment's start position pinned
-    //  3) is the alternate state of the active indel with the alignment's end position pinned
-    //
-    // toggle will not be invoked for unusable indels (but those are
-    // already filtered out of the list)
-    //
-    // ??? -- no longer true??? -- toggle will not be invoked if they
-    // lead to indel conflicts with a previous indel
-    //
-    // start or end position may be skipped if a deletion spans one or
-    // both of these points
-    //
-    // edge-indels can only be pinned on one side
-    //
-    const IndelKey& cindel(indel_order[depth]);
-    const bool is_cindel_on(indel_status_map[cindel].is_present);
 
-    // alignment 1) --> unchanged case:
-    try
-    {
-        candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId, realign_buffer_range,
-                                   cal_set,
-                                   warn, indel_status_map,
-                                   indel_order, depth + 1, toggle_depth, read_range, max_read_indel_toggle, cal);
-    }
-    catch (...)
-    {
-        log_os << "\nException caught while building default alignment candidate at depth: " << depth << "\n"
-               << "\tcal: " << cal
-               << "this_indel: " << cindel;
-        throw;
-    }
-
-    if (! is_cindel_on)
-    {
-        // check whether this is a remove only indel:
-        if (indel_status_map[cindel].is_remove_only) return;
-
-        // check whether this indel would interfere with an indel that's
-        // already been toggled on:
+        // check whether toggling this indel would exceed the maximum
+        // number of toggles made to the exemplar alignment (this is
+        // here to prevent a combinatorial blowup)
         //
-        for (unsigned i(0); i<depth; ++i)
+        if (isToggleAllowed && (static_cast<int>(branch.toggleDepth+1)>branch.maxReadIndelToggle))
         {
-            const IndelKey& indelKey(indel_order[i]);
-            if (indel_status_map[indelKey].is_present && is_indel_conflict(indelKey,cindel)) return;
+            warn.max_toggle_depth=true;
+            isToggleAllowed = false;
         }
-    }
 
-    // check whether toggling this indel would exceed the maximum
-    // number of toggles made to the exemplar alignment (this is
-    // here to prevent a combinatorial blowup)
-    //
-    if (static_cast<int>(toggle_depth+1)>max_read_indel_toggle)
-    {
-        warn.max_toggle_depth=true;
-        return;
-    }
-
-    // changed cases:
-    indel_status_map[cindel].is_present=(! is_cindel_on);
+        if (isToggleAllowed)
+        {
+            // changed cases, toggle the indel for the duration of new branch construction:
+            branch.isPresent.set(cindelIndex, (! is_cindel_on));
 
-    // extract only those indels that are present in the next
-    // alignment:
-    //
-    indel_set_t current_indels;
-    for (const auto& is : indel_status_map)
-    {
-        if (is.second.is_present) current_indels.insert(is.first);
-    }
+            // extract only those indels that are present in the next
+            // alignment:
+            //
+            std::vector<IndelKey>& current_indels(workspace.currentIndels);
+            current_indels.clear();
+            for (const unsigned indelIndex : workspace.sortedIndelIndex)
+            {
+                if (branch.isPresent.test(indelIndex)) current_indels.push_back(*(workspace.indels[indelIndex].keyPtr));
+            }
 
-    // a pin on either end of the alignment is not possible/sensible
-    // if:
-    //
-    // A) a deletion is being added which spans the pin site
-    // B) an edge insertion/breakpoint is being removed from the pinned side
+            auto pushToggledBranch = [&]() -> CandidateAlignmentSearchBranch&
+            {
+                CandidateAlignmentSearchBranch& newBranch(workspace.pushBranch());
+                newBranch = branch;
+                newBranch.depth++;
+                newBranch.toggleDepth++;
+                return newBranch;
+            };
+
+            // a pin on either end of the alignment is not possible/sensible
+            // if:
+            //
+            // A) a deletion is being added which spans the pin site
+            // B) an edge insertion/breakpoint is being removed from the pinned side
 
-    // alignment 2) -- insert or delete indel and pin the start position
-    //
-    // test for conditions where the start pin is not possible:
-    //
-    {
-        const pos_t ref_start_pos(cal.al.pos);
+            // alignment 3) -- insert or delete indel and pin the end position
+            //
+            // this is unnecessary for an equal-length swap
+            //
+            if (not ((cindel.type==INDEL::INDEL) && (cindel.delete_length()==cindel.insert_length())))
+            {
+                const pos_t ref_end_pos(cal.al.pos+apath_ref_length(cal.al.path));
 
-        const bool is_start_pos_delete_span(cindel.open_pos_range().is_pos_intersect(ref_start_pos));
-        const bool is_start_pos_indel_span(is_cindel_on && (cindel == cal.leading_indel_key));
-        const bool is_start_pin_valid(! (is_start_pos_delete_span || is_start_pos_indel_span));
+                // end pin is not possible when
+                // (1) an indel deletes through the end-pin position
+                // (2) we try to remove a trailing indel [TODO seems like same rule should be in place for adding a trailing indel]
+                const bool is_end_pos_delete_span(cindel.open_pos_range().is_pos_intersect(ref_end_pos-1));
+                const bool is_end_pos_indel_span(is_cindel_on && (cindel == cal.trailing_indel_key));
+                const bool is_end_pin_valid(! (is_end_pos_delete_span || is_end_pos_indel_span));
 
 #ifdef DEBUG_ALIGN
-        std::cerr << "VARMIT toggling MCA depth: " << depth << "\n";
-        std::cerr << "VARMIT current indel: " << cindel;
-        std::cerr << "VARMIT current indel on?: " << is_cindel_on << "\n";
-        std::cerr << "VARMIT start-pin valid?: " << is_start_pin_valid << "\n";
+                std::cerr << "VARMIT toggling MCA depth: " << depth << "\n";
+                std::cerr << "VARMIT current indel: " << cindel;
+                std::cerr << "VARMIT current indel on?: " << is_cindel_on << "\n";
+                std::cerr << "VARMIT end-pin valid?: " << is_end_pin_valid << "\n";
 #endif
 
-        if (is_start_pin_valid)
-        {
-            const pos_t read_start_pos(unalignedPrefixSize(cal.al.path));
-            CandidateAlignment start_cal;
-            try
-            {
-                start_cal = make_start_pos_alignment(ref_start_pos,
+                if (is_end_pin_valid)
+                {
+                    // work backwards from end_pos to get start_pos and
+                    // read_start_pos when the current indel set included,
+                    // and then used the make_start_pos_alignment routine.
+                    const pos_t read_end_pos(read_length-+unalignedSuffixSize(cal.al.path));
+                    pos_t ref_start_pos(0);
+                    pos_t read_start_pos(0);
+                    get_end_pin_start_pos(current_indels,read_length,
+                                          ref_end_pos,read_end_pos,
+                                          ref_start_pos,read_start_pos);
+
+                    // guard against low-frequency circular chromosome event:
+                    if (ref_start_pos<0)
+                    {
+                        warn.origin_skip=true;
+                    }
+                    else
+                    {
+                        CandidateAlignmentSearchBranch& endPinBranch(pushToggledBranch());
+                        try
+                        {
+                            make_start_pos_alignment(ref_start_pos,
                                                      read_start_pos,
                                                      cal.al.is_fwd_strand,
                                                      read_length,
-                                                     current_indels);
-
-                candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId,
-                                           realign_buffer_range, cal_set,
-                                           warn, indel_status_map,
-                                           indel_order, depth + 1, toggle_depth + 1, read_range, max_read_indel_toggle,
-                                           start_cal);
-            }
-            catch (...)
-            {
-                add_pin_exception_info("start",depth,cal,start_cal,ref_start_pos,read_start_pos,cindel,current_indels);
-                throw;
+                                                     current_indels,
+                                                     endPinBranch.cal);
+                        }
+                        catch (...)
+                        {
+                            add_pin_exception_info("end",depth,cal,endPinBranch.cal,ref_start_pos,read_start_pos,cindel,
+                                                   current_indels);
+                            log_os << "ref_end_pos: " << ref_end_pos << "\n"
+                                   << "read_end_pos: " << read_end_pos << "\n";
+                            throw;
+                        }
+                    }
+                }
             }
-        }
-    }
 
-    // check whether this is an equal-length swap, in which case alignment 3 is unnecessary:
-    if ((cindel.type==INDEL::INDEL) && (cindel.delete_length()==cindel.insert_length())) return;
-
-    // alignment 3) -- insert or delete indel and pin the end position
-    //
-    // test for conditions where end-pin is not possible:
-    //
-    {
-        const pos_t ref_end_pos(cal.al.pos+apath_ref_length(cal.al.path));
+            // alignment 2) -- insert or delete indel and pin the start position
+            //
+            // test for conditions where the start pin is not possible:
+            //
+            {
+                const pos_t ref_start_pos(cal.al.pos);
 
-        // end pin is not possible when
-        // (1) an indel deletes through the end-pin position
-        // (2) we try to remove a trailing indel [TODO seems like same rule should be in place for adding a trailing indel]
-        const bool is_end_pos_delete_span(cindel.open_pos_range().is_pos_intersect(ref_end_pos-1));
-        const bool is_end_pos_indel_span(is_cindel_on && (cindel == cal.trailing_indel_key));
-        const bool is_end_pin_valid(! (is_end_pos_delete_span || is_end_pos_indel_span));
+                const bool is_start_pos_delete_span(cindel.open_pos_range().is_pos_intersect(ref_start_pos));
+                const bool is_start_pos_indel_span(is_cindel_on && (cindel == cal.leading_indel_key));
+                const bool is_start_pin_valid(! (is_start_pos_delete_span || is_start_pos_indel_span));
 
 #ifdef DEBUG_ALIGN
-        std::cerr << "VARMIT toggling MCA depth: " << depth << "\n";
-        std::cerr << "VARMIT current indel: " << cindel;
-        std::cerr << "VARMIT current indel on?: " << is_cindel_on << "\n";
-        std::cerr << "VARMIT end-pin valid?: " << is_end_pin_valid << "\n";
+                std::cerr << "VARMIT toggling MCA depth: " << depth << "\n";
+                std::cerr << "VARMIT current indel: " << cindel;
+                std::cerr << "VARMIT current indel on?: " << is_cindel_on << "\n";
+                std::cerr << "VARMIT start-pin valid?: " << is_start_pin_valid << "\n";
 #endif
 
-        if (is_end_pin_valid)
-        {
-            // work backwards from end_pos to get start_pos and
-            // read_start_pos when the current indel set included,
-            // and then used the make_start_pos_alignment routine.
-            const pos_t read_end_pos(read_length-+unalignedSuffixSize(cal.al.path));
-            pos_t ref_start_pos(0);
-            pos_t read_start_pos(0);
-            get_end_pin_start_pos(current_indels,read_length,
-                                  ref_end_pos,read_end_pos,
-                                  ref_start_pos,read_start_pos);
-
-            // guard against low-frequency circular chromosome event:
-            if (ref_start_pos<0)
-            {
-                warn.origin_skip=true;
-            }
-            else
-            {
-                CandidateAlignment start_cal;
-                try
-                {
-                    start_cal = make_start_pos_alignment(ref_start_pos,
-                                                         read_start_pos,
-                                                         cal.al.is_fwd_strand,
-                                                         read_length,
-                                                         current_indels);
-
-                    candidate_alignment_search(opt, dopt, read_id, read_length, indelBuffer, sampleId,
-                                               realign_buffer_range, cal_set,
-                                               warn, indel_status_map,
-                                               indel_order, depth + 1, toggle_depth + 1, read_range,
-                                               max_read_indel_toggle, start_cal);
-                }
-                catch (...)
+                if (is_start_pin_valid)
                 {
-                    add_pin_exception_info("end",depth,cal,start_cal,ref_start_pos,read_start_pos,cindel,current_indels);
-                    log_os << "ref_end_pos: " << ref_end_pos << "\n"
-                           << "read_end_pos: " << read_end_pos << "\n";
-                    throw;
+                    const pos_t read_start_pos(unalignedPrefixSize(cal.al.path));
+                    CandidateAlignmentSearchBranch& startPinBranch(pushToggledBranch());
+                    try
+                    {
+                        make_start_pos_alignment(ref_start_pos,
+                                                 read_start_pos,
+                                                 cal.al.is_fwd_strand,
+                                                 read_length,
+                                                 current_indels,
+                                                 startPinBranch.cal);
+                    }
+                    catch (...)
+                    {
+                        add_pin_exception_info("start",depth,cal,startPinBranch.cal,ref_start_pos,read_start_pos,cindel,
+                                               current_indels);
+                        throw;
+                    }
                 }
             }
+
+            branch.isPresent.set(cindelIndex, is_cindel_on);
         }
+
+        // alignment 1) --> unchanged case:
+        CandidateAlignmentSearchBranch& unchangedBranch(workspace.pushBranch());
+        unchangedBranch = branch;
+        unchangedBranch.depth++;
     }
 }
 
@@ -1218,7 +1456,7 @@ scoreCandidateAlignments(
     const starling_base_options& opt,
     const reference_contig_segment& ref,
     read_segment& readSegment,
-    IndelBuffer& indelBuffer,
+    const IndelBuffer& indelBuffer,
     const unsigned sampleIndex,
     const CandidateSnvBuffer& candidateSnvBuffer,
     const std::set<CandidateAlignment>& candAlignments,
@@ -1244,12 +1482,13 @@ scoreCandidateAlignments(
     const std::pair<bool,bool> edge_pin(readSegment.get_segment_edge_pin());
     const bool is_pinned(edge_pin.first || edge_pin.second);
 
+    CandidateAlignmentScorer candAlignmentScorer(opt, indelBuffer, sampleIndex, candidateSnvBuffer, readSegment, ref);
+
     const auto cal_set_begin(candAlignments.cbegin()), cal_set_end(candAlignments.cend());
     for (auto cal_iter(cal_set_begin); cal_iter!=cal_set_end; ++cal_iter)
     {
         const CandidateAlignment& ical(*cal_iter);
-        const double path_lnp(
-            scoreCandidateAlignment(opt, indelBuffer, sampleIndex, candidateSnvBuffer, readSegment, ical, ref));
+        const double path_lnp(candAlignmentScorer.scoreCandidateAlignment(ical));
 
         candAlignmentScores.push_back(path_lnp);
 
@@ -1403,8 +1642,7 @@ scoreCandidateAlignments(
         }
 
         // score candidate alignment:
-        const double path_lnp(scoreCandidateAlignment(opt, indelBuffer, sampleIndex, candidateSnvBuffer, readSegment,
-                                                      softClippedCandidateAlignment, ref));
+        const double path_lnp(candAlignmentScorer.scoreCandidateAlignment(softClippedCandidateAlignment));
 
         if (path_lnp >= smooth_path_lnp)
         {
@@ -1435,13 +1673,14 @@ scoreCandidateAlignmentsAndIndels(
     const starling_sample_options& sample_opt,
     const reference_contig_segment& ref,
     read_segment& rseg,
-    IndelBuffer& indelBuffer,
+    const IndelBuffer& indelBuffer,
     const unsigned sampleId,
     const CandidateSnvBuffer& candidateSnvBuffer,
-    std::set<CandidateAlignment>& candAlignments,
+    const std::set<CandidateAlignment>& candAlignments,
     const bool is_incomplete_search,
     const bool isTestSoftClippedInputAligned,
-    const alignment& softClippedInputAlignment)
+    const alignment& softClippedInputAlignment,
+    ReadIndelScoreUpdates& indelScoreUpdates)
 {
     assert(! candAlignments.empty());
 
@@ -1485,7 +1724,7 @@ scoreCandidateAlignmentsAndIndels(
     try
     {
         score_indels(opt, dopt, sample_opt, rseg, indelBuffer, sampleId, candAlignments, is_incomplete_search,
-                     candAlignmentScores, maxCandAlignmentScore, maxCandAlignmentPtr);
+                     candAlignmentScores, maxCandAlignmentScore, maxCandAlignmentPtr, indelScoreUpdates);
     }
     catch (...)
     {
@@ -1496,8 +1735,40 @@ scoreCandidateAlignmentsAndIndels(
 
 
 
+/// \return true if every non-candidate indel in nonCandidateIndelUsability has the same usability for this read
 static
-void
+bool
+isSameIndelUsability(
+    const indel_usability_t& nonCandidateIndelUsability,
+    const IndelBuffer& indelBuffer,
+    const align_id_t read_id,
+    const unsigned sampleId)
+{
+    for (const auto& indelUsability : nonCandidateIndelUsability)
+    {
+        const IndelKey& indelKey(indelUsability.first);
+        const IndelData* indelDataPtr(indelBuffer.getIndelDataPtr(indelKey));
+        assert(nullptr != indelDataPtr);
+        if (is_usable_indel(indelBuffer, indelKey, *indelDataPtr, read_id, sampleId) != indelUsability.second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/// \brief Get the set of candidate alignments for a read
+///
+/// The search result is retrieved from candidateAlignmentCache if a read with the same input alignment has already
+/// been searched under identical conditions, otherwise the new search result is added to the cache.
+///
+/// \return the candidate alignment search result, which remains valid until the next update of
+///          candidateAlignmentCache
+///
+static
+const CandidateAlignmentCache::Value&
 getCandidateAlignments(
     const starling_base_options& opt,
     const starling_base_deriv_options& dopt,
@@ -1506,24 +1777,54 @@ getCandidateAlignments(
     const unsigned sampleId,
     const alignment& inputAlignment,
     const known_pos_range realign_buffer_range,
-    mca_warnings& warn,
-    std::set<CandidateAlignment>& cal_set)
+    CandidateAlignmentCache& candidateAlignmentCache)
 {
     const unsigned read_length(rseg.read_size());
 
-    starling_align_indel_status indel_status_map;
-    std::vector<IndelKey> indel_order;
-
     CandidateAlignment cal;
     getCandidateAlignment(inputAlignment, rseg, cal);
 
+    indel_set_t candidateAlignmentIndels;
+    getAlignmentIndels(cal, rseg, opt.maxIndelSize, candidateAlignmentIndels);
+
+    CandidateAlignmentCache::Key cacheKey;
+    cacheKey.sampleId = sampleId;
+    cacheKey.realignBufferRange = realign_buffer_range;
+    cacheKey.inputAlignment = cal;
+    cacheKey.inputAlignment.setIndels(candidateAlignmentIndels);
+
+    const uint64_t indelBufferVersion(indelBuffer.getContentVersion());
+    {
+        const CandidateAlignmentCache::Value* cachedValuePtr(candidateAlignmentCache.find(cacheKey, indelBufferVersion));
+        if ((nullptr != cachedValuePtr) &&
+            isSameIndelUsability(cachedValuePtr->nonCandidateIndelUsability, indelBuffer, rseg.getReadIndex(), sampleId))
+        {
+            return *cachedValuePtr;
+        }
+    }
+
+    CandidateAlignmentCache::Value searchValue;
+    std::set<CandidateAlignment>& cal_set(searchValue.candidateAlignments);
+    mca_warnings& warn(searchValue.warn);
+    indel_usability_t& nonCandidateIndelUsability(searchValue.nonCandidateIndelUsability);
+
+    // search working storage is reused by all searches on the same thread:
+    static thread_local CandidateAlignmentSearchWorkspace searchWorkspace;
+    searchWorkspace.clear();
+    CandidateAlignmentSearchBranch& startBranch(searchWorkspace.pushBranch());
+    startBranch.indelOrder.clear();
+    startBranch.isKnown.clear();
+    startBranch.isPresent.clear();
+    startBranch.isRemoveOnly.clear();
+
 #ifdef DEBUG_ALIGN
     std::cerr << "VARMIT starting search from input alignment: " << cal;
 #endif
 
     // Get indel set and indel order for the input alignment:
     const known_pos_range exemplar_pr(get_soft_clip_alignment_range(cal.al));
-    add_indels_in_range(rseg.getReadIndex(), indelBuffer, exemplar_pr, sampleId, indel_status_map, indel_order);
+    add_indels_in_range(rseg.getReadIndex(), indelBuffer, exemplar_pr, sampleId, searchWorkspace, startBranch,
+                        nonCandidateIndelUsability);
 
 #ifdef DEBUG_ALIGN
     std::cerr << "VARMIT exemplar alignment range: " << exemplar_pr << "\n";
@@ -1533,54 +1834,55 @@ getCandidateAlignments(
     // alignment.
     //
     {
-        indel_set_t candidateAlignmentIndels;
-        getAlignmentIndels(cal, rseg, opt.maxIndelSize, candidateAlignmentIndels);
-
         for (const IndelKey& indelKey : candidateAlignmentIndels)
         {
-            if (indel_status_map.find(indelKey)==indel_status_map.end())
+            bool isFound(false);
+            for (const unsigned indelIndex : startBranch.indelOrder)
+            {
+                if (*(searchWorkspace.indels[indelIndex].keyPtr) == indelKey)
+                {
+                    startBranch.isPresent.set(indelIndex, true);
+                    isFound = true;
+                    break;
+                }
+            }
+
+            if (not isFound)
             {
                 std::ostringstream oss;
                 oss << "ERROR: Exemplar alignment contains indel not found in the overlap indel set\n"
                     << "\tIndel: " << indelKey
                     << "Exemplar overlap set:\n";
-                dump_indel_status(indel_status_map,oss);
+                for (const unsigned indelIndex : startBranch.indelOrder)
+                {
+                    oss << *(searchWorkspace.indels[indelIndex].keyPtr)
+                        << "status: is_remove_only: " << startBranch.isRemoveOnly.test(indelIndex) << "\n";
+                }
                 throw blt_exception(oss.str().c_str());
             }
-            indel_status_map[indelKey].is_present = true;
         }
     }
 
     // to prevent incompatible alignments, we must put all indels present in the exemplar first in the order list:
     //
     {
-        indel_order.clear();
-        for (const auto& val : indel_status_map)
+        std::vector<unsigned>& indelOrder(startBranch.indelOrder);
+        indelOrder.clear();
+        for (const unsigned indelIndex : searchWorkspace.sortedIndelIndex)
         {
-            if (val.second.is_present) indel_order.push_back(val.first);
+            if (startBranch.isPresent.test(indelIndex)) indelOrder.push_back(indelIndex);
         }
-        for (const auto& val : indel_status_map)
+        for (const unsigned indelIndex : searchWorkspace.sortedIndelIndex)
         {
-            if (! val.second.is_present) indel_order.push_back(val.first);
+            if (startBranch.isKnown.test(indelIndex) && (not startBranch.isPresent.test(indelIndex)))
+            {
+                indelOrder.push_back(indelIndex);
+            }
         }
     }
 
     // to prevent truncated search, we must put all non-present remove-only indels last in the order list:
-    sort_remove_only_indels_last(indel_status_map,indel_order);
-
-#ifdef DEBUG_ALIGN
-    std::cerr << "VARMIT exemplar starting indel_status_map:\n";
-    dump_indel_status(indel_status_map,std::cerr);
-
-    {
-        std::cerr << "VARMIT exemplar starting indel_order:\n";
-        const unsigned foo(indel_order.size());
-        for (unsigned j(0); j<foo; ++j)
-        {
-            std::cerr << "no: " << j << " " << indel_order[j] << "\n";
-        }
-    }
-#endif
+    sort_remove_only_indels_last(startBranch, searchWorkspace.indelOrderBuffer);
 
     // to handle soft-clip and hard-clip in the genomic alignment, we take the
     // soft and hard clip portion off of the alignment before entering
@@ -1611,19 +1913,20 @@ getCandidateAlignments(
         cal_read_length-=(sc_lead+sc_trail);
     }
 
-    // launch recursive re-alignment routine starting from the current exemplar alignment:
-    static const unsigned start_depth(0);
-    static const unsigned start_toggle_depth(0);
-    candidate_alignment_search(opt, dopt, rseg.getReadIndex(), cal_read_length, indelBuffer, sampleId, realign_buffer_range, cal_set,
-                               warn, indel_status_map,
-                               indel_order, start_depth, start_toggle_depth, exemplar_pr, opt.max_read_indel_toggle,
-                               cal);
+    // launch the re-alignment search starting from the current exemplar alignment:
+    startBranch.depth = 0;
+    startBranch.toggleDepth = 0;
+    startBranch.readRange = exemplar_pr;
+    startBranch.maxReadIndelToggle = opt.max_read_indel_toggle;
+    startBranch.cal = cal;
+    candidate_alignment_search(opt, dopt, rseg.getReadIndex(), cal_read_length, indelBuffer, sampleId,
+                               realign_buffer_range, cal_set, warn, nonCandidateIndelUsability, searchWorkspace);
 
     if (is_input_alignment_clipped)
     {
         // un soft-clip candidate alignments:
-        std::set<CandidateAlignment> cal_set2(cal_set);
-        cal_set.clear();
+        std::set<CandidateAlignment> cal_set2;
+        cal_set2.swap(cal_set);
         for (CandidateAlignment ical : cal_set2)
         {
             apath_clip_adder(ical.al.path,
@@ -1637,17 +1940,21 @@ getCandidateAlignments(
 
     {
         // clear out-of-range alignment candidates:
-        std::set<CandidateAlignment> cal_set2(cal_set);
-        cal_set.clear();
-        for (const CandidateAlignment& ical : cal_set2)
+        for (auto calIter(cal_set.begin()); calIter != cal_set.end();)
         {
             // check that the alignment is within realign bounds
-            if (is_alignment_spanned_by_range(realign_buffer_range,ical.al))
+            if (is_alignment_spanned_by_range(realign_buffer_range,calIter->al))
+            {
+                ++calIter;
+            }
+            else
             {
-                cal_set.insert(ical);
+                calIter = cal_set.erase(calIter);
             }
         }
     }
+
+    return candidateAlignmentCache.insert(cacheKey, std::move(searchValue), indelBufferVersion);
 }
 
 
@@ -1689,8 +1996,12 @@ realignAndScoreRead(
     const unsigned sampleId,
     const CandidateSnvBuffer& candidateSnvBuffer,
     read_segment& rseg,
-    IndelBuffer& indelBuffer)
+    const IndelBuffer& indelBuffer,
+    CandidateAlignmentCache& candidateAlignmentCache,
+    ReadIndelScoreUpdates& indelScoreUpdates)
 {
+    indelScoreUpdates.clear();
+
     if (! rseg.is_valid())
     {
         log_os << "ERROR: invalid alignment path associated with read segment:\n" << rseg;
@@ -1742,11 +2053,13 @@ realignAndScoreRead(
     // interpreted as "indel not present" rather than "reference", so
     // that all indels can be visited even if some conflict.
     //
-    std::set<CandidateAlignment> cal_set;
-    mca_warnings warn;
-
-    getCandidateAlignments(opt, dopt, rseg, indelBuffer, sampleId, normalizedInputAlignment,
-                           realign_buffer_range, warn, cal_set);
+    // note the search result is owned by candidateAlignmentCache, scoring below must not change the set of
+    // buffered indels:
+    const CandidateAlignmentCache::Value& searchValue(
+        getCandidateAlignments(opt, dopt, rseg, indelBuffer, sampleId, normalizedInputAlignment,
+                               realign_buffer_range, candidateAlignmentCache));
+    const std::set<CandidateAlignment>& cal_set(searchValue.candidateAlignments);
+    const mca_warnings& warn(searchValue.warn);
 
     if ( cal_set.empty() )
     {
@@ -1780,5 +2093,5 @@ realignAndScoreRead(
     const bool isTestSoftClippedInputAligned(opt.isRetainOptimalSoftClipping && isSoftClippedInputAlignment);
     scoreCandidateAlignmentsAndIndels(opt, dopt, sample_opt, ref,
                                       rseg, indelBuffer, sampleId, candidateSnvBuffer, cal_set, is_incomplete_search,
-                                      isTestSoftClippedInputAligned, softClippedInputAlignment);
+                                      isTestSoftClippedInputAligned, softClippedInputAlignment, indelScoreUpdates);
 }
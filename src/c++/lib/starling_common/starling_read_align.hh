@@ -24,8 +24,10 @@
 #pragma once
 
 
+#include "starling_common/CandidateAlignmentCache.hh"
 #include "starling_common/IndelBuffer.hh"
 #include "starling_common/starling_read.hh"
+#include "starling_common/starling_read_align_score_indels.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "CandidateSnvBuffer.hh"
 
@@ -45,6 +47,13 @@
 /// \param realign_buffer_range The range (in reference coordinates) in which the read is allowed to realign
 ///          (due to buffering constraints)
 ///
+/// \param candidateAlignmentCache Shares candidate alignment search results between reads, this only needs to be
+///          retained over the reads starting at one position
+///
+/// \param[out] indelScoreUpdates Indel scoring results for this read, which the caller must apply to indelBuffer.
+///          indelBuffer is not modified here so that different reads can be realigned concurrently, provided that
+///          each thread uses its own candidateAlignmentCache.
+///
 void
 realignAndScoreRead(
     const starling_base_options& opt,
@@ -55,4 +64,6 @@ realignAndScoreRead(
     const unsigned sampleId,
     const CandidateSnvBuffer& candidateSnvBuffer,
     read_segment& rseg,
-    IndelBuffer& indelBuffer);
+    const IndelBuffer& indelBuffer,
+    CandidateAlignmentCache& candidateAlignmentCache,
+    ReadIndelScoreUpdates& indelScoreUpdates);
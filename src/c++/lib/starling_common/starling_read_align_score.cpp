@@ -30,11 +30,17 @@
 #include "blt_util/align_path_util.hh"
 
 #include <cassert>
+#include <cmath>
 
+#include <limits>
 #include <sstream>
 
 
 
+static const double lnthird(-std::log(3.));
+
+
+
 //#define DEBUG_SCORE
 
 
@@ -116,8 +122,6 @@ scoreInsertSegment(const starling_base_options& /*opt*/,
                    const pos_t ref_head_pos,
                    double& lnp)
 {
-    static const double lnthird(-std::log(3.));
-
     for (unsigned i(0); i<seg_length; ++i)
     {
         const pos_t readPos(static_cast<pos_t>(read_offset+i));
@@ -152,8 +156,6 @@ scoreMatchSegment(const starling_base_options& opt,
                   const CandidateSnvBuffer& candidateSnvBuffer,
                   double& lnp)
 {
-    static const double lnthird(-std::log(3.));
-
     for (unsigned i(0); i<seg_length; ++i)
     {
         const pos_t readPos(static_cast<pos_t>(read_offset+i));
@@ -499,3 +501,234 @@ scoreCandidateAlignment(
 #endif
     return alignmentLogProb;
 }
+
+
+
+/// basecall log-likelihood units per nat in the scorer's fixed point sums
+static const double fixedScoreScale(static_cast<double>(1ull << 36));
+
+
+
+CandidateAlignmentScorer::
+CandidateAlignmentScorer(
+    const starling_base_options& opt,
+    const IndelBuffer& indelBuffer,
+    const unsigned sampleIndex,
+    const CandidateSnvBuffer& candidateSnvBuffer,
+    const read_segment& readSegment,
+    const reference_contig_segment& ref)
+    : _opt(opt),
+      _indelBuffer(indelBuffer),
+      _sampleIndex(sampleIndex),
+      _candidateSnvBuffer(candidateSnvBuffer),
+      _ref(ref),
+      _readBaseIds(readSegment.baseIds())
+{
+    const uint8_t* qual(readSegment.qual());
+    const unsigned readSize(readSegment.read_size());
+    _matchScore.resize(readSize);
+    _mismatchScore.resize(readSize);
+    for (unsigned readPos(0); readPos<readSize; ++readPos)
+    {
+        // unknown basecalls are not scored:
+        if (_readBaseIds[readPos] == BASE_ID::ANY) continue;
+        const uint8_t qscore(qual[readPos]);
+        _matchScore[readPos] = getFixedScore(qphred_to_ln_comp_error_prob(qscore));
+        _mismatchScore[readPos] = getFixedScore(qphred_to_ln_error_prob(qscore)+lnthird);
+    }
+}
+
+
+
+CandidateAlignmentScorer::BasecallScore
+CandidateAlignmentScorer::
+getFixedScore(const double logLhood)
+{
+    BasecallScore score;
+    if (std::isinf(logLhood))
+    {
+        score.zeroLhoodCount = 1;
+    }
+    else
+    {
+        score.logLhood = std::llround(logLhood*fixedScoreScale);
+    }
+    return score;
+}
+
+
+
+bool
+CandidateAlignmentScorer::
+isReferenceBasecall(
+    const pos_t readPos,
+    const pos_t refPos) const
+{
+    const char readBase(id_to_base(_readBaseIds[readPos]));
+    if (readBase == _ref.get_base(refPos)) return true;
+
+    // Don't penalize for the mismatch if it is a SNV found in an active region
+    return (_opt.is_short_haplotyping_enabled and
+            _candidateSnvBuffer.isCandidateSnv(_sampleIndex, refPos, readBase));
+}
+
+
+
+const std::vector<CandidateAlignmentScorer::BasecallScore>&
+CandidateAlignmentScorer::
+getDiagonalPrefixScore(const pos_t refOffset)
+{
+    for (const DiagonalPrefixScore& diagonal : _diagonals)
+    {
+        if (diagonal.refOffset == refOffset) return diagonal.prefixScore;
+    }
+
+    _diagonals.emplace_back();
+    DiagonalPrefixScore& diagonal(_diagonals.back());
+    diagonal.refOffset = refOffset;
+
+    const unsigned readSize(_matchScore.size());
+    std::vector<BasecallScore>& prefixScore(diagonal.prefixScore);
+    prefixScore.resize(readSize+1);
+    for (unsigned readPos(0); readPos<readSize; ++readPos)
+    {
+        prefixScore[readPos+1] = prefixScore[readPos];
+        if (_readBaseIds[readPos] == BASE_ID::ANY) continue;
+        const pos_t refPos(static_cast<pos_t>(readPos)+refOffset);
+        prefixScore[readPos+1] +=
+            (isReferenceBasecall(readPos, refPos) ? _matchScore[readPos] : _mismatchScore[readPos]);
+    }
+    return prefixScore;
+}
+
+
+
+void
+CandidateAlignmentScorer::
+addInsertSegmentScore(
+    const unsigned segmentLength,
+    const unsigned readOffset,
+    const bam_seq_base& insertSeq,
+    const pos_t insertSeqHeadPos,
+    BasecallScore& score) const
+{
+    for (unsigned i(0); i<segmentLength; ++i)
+    {
+        const pos_t readPos(static_cast<pos_t>(readOffset+i));
+        const uint8_t readBaseId(_readBaseIds[readPos]);
+        if (readBaseId == BASE_ID::ANY) continue;
+        const bool isRef(id_to_base(readBaseId) == insertSeq.get_char(insertSeqHeadPos+static_cast<pos_t>(i)));
+        score += (isRef ? _matchScore[readPos] : _mismatchScore[readPos]);
+    }
+}
+
+
+
+double
+CandidateAlignmentScorer::
+scoreCandidateAlignment(
+    const CandidateAlignment& cal)
+{
+    using namespace ALIGNPATH;
+
+    static const BasecallScore unalignedBasecallScore(getFixedScore(std::log(0.25)));
+    static const BasecallScore nonCandidateIndelScore(getFixedScore(std::log(1e-5)));
+
+    BasecallScore alignmentScore;
+
+    const path_t& path(cal.al.path);
+
+    unsigned read_offset(0);
+    pos_t ref_head_pos(cal.al.pos);
+
+    const std::pair<unsigned,unsigned> ends(get_match_edge_segments(path));
+    const unsigned aps(path.size());
+    unsigned path_index(0);
+
+    while (path_index<aps)
+    {
+        const bool is_swap_start(is_segment_swap_start(path,path_index));
+
+        unsigned n_seg(1); // number of path segments consumed
+        const path_segment& ps(path[path_index]);
+
+        IndelKey indelKey(IndelKey::noIndel());
+
+        if       (is_swap_start)
+        {
+            const swap_info sinfo(path,path_index);
+            n_seg=sinfo.n_seg;
+
+            indelKey = getMatchingIndelKey(cal,ref_head_pos,sinfo.delete_length,sinfo.insert_length,
+                                           ends,path_index);
+            assert(not indelKey.is_breakpoint());
+
+            const string_bam_seq insert_bseq(indelKey.insertSequence);
+            pos_t insert_seq_head_pos(0);
+            if (path_index<ends.first)
+            {
+                insert_seq_head_pos=static_cast<int>(insert_bseq.size())-static_cast<int>(ps.length);
+            }
+            addInsertSegmentScore(sinfo.insert_length, read_offset, insert_bseq, insert_seq_head_pos,
+                                  alignmentScore);
+        }
+        else if (is_segment_align_match(ps.type))
+        {
+            const std::vector<BasecallScore>& prefixScore(getDiagonalPrefixScore(ref_head_pos-read_offset));
+            alignmentScore += prefixScore[read_offset+ps.length];
+            alignmentScore -= prefixScore[read_offset];
+        }
+        else if (ps.type==INSERT)
+        {
+            indelKey = getMatchingIndelKey(cal,ref_head_pos,0,ps.length,
+                                           ends,path_index);
+
+            const string_bam_seq insert_bseq(getInsertSeq(indelKey,_indelBuffer,cal));
+            pos_t insert_seq_head_pos(0);
+            if (path_index<ends.first)
+            {
+                insert_seq_head_pos=static_cast<int>(insert_bseq.size())-static_cast<int>(ps.length);
+            }
+            addInsertSegmentScore(ps.length, read_offset, insert_bseq, insert_seq_head_pos, alignmentScore);
+        }
+        else if (ps.type==DELETE)
+        {
+            indelKey = getMatchingIndelKey(cal,ref_head_pos,ps.length,0,
+                                           ends,path_index);
+        }
+        else if (ps.type==SOFT_CLIP)
+        {
+            // see the soft-clip penalty in scoreCandidateAlignment
+            alignmentScore.logLhood += (ps.length*unalignedBasecallScore.logLhood);
+        }
+        else if ((ps.type==SKIP) || (ps.type==HARD_CLIP))
+        {
+            // do nothing
+        }
+        else
+        {
+            std::ostringstream oss;
+            oss << "Can't handle cigar code: " << segment_type_to_cigar_code(ps.type) << "\n";
+            throw blt_exception(oss.str().c_str());
+        }
+
+        // penalize non-candidate indels:
+        if (indelKey.type != INDEL::NONE)
+        {
+            const auto* indelDataPtr(_indelBuffer.getIndelDataPtr(indelKey));
+            assert(indelDataPtr != nullptr);
+            if (not _indelBuffer.isCandidateIndel(indelKey, *indelDataPtr))
+            {
+                alignmentScore += nonCandidateIndelScore;
+            }
+        }
+
+        for (unsigned i(0); i<n_seg; ++i)
+        {
+            increment_path(path,path_index,read_offset,ref_head_pos);
+        }
+    }
+
+    if (alignmentScore.zeroLhoodCount > 0) return -std::numeric_limits<double>::infinity();
+    return (alignmentScore.logLhood/fixedScoreScale);
+}
@@ -30,6 +30,10 @@
 #include "starling_common/starling_base_shared.hh"
 #include "CandidateSnvBuffer.hh"
 
+#include <cstdint>
+
+#include <vector>
+
 /// \return Score of candidate alignment \p cal for read segment \p rseg
 ///
 /// The score is essentially `P(read | haplotype)`, where read=rseg and haplotype=ref+candidate alignment. This
@@ -38,6 +42,9 @@
 /// that the read is scored against. It is also an approximation because we're only considering a single alignment
 /// of the read to the target haplotype.
 ///
+/// This function scores each basecall of the read in turn, CandidateAlignmentScorer should be used to score
+/// multiple candidate alignments of the same read.
+///
 double
 scoreCandidateAlignment(
     const starling_base_options& opt,
@@ -48,3 +55,100 @@ scoreCandidateAlignment(
     const CandidateAlignment& cal,
     const reference_contig_segment& ref);
 
+
+
+
+/// \brief Scores any number of candidate alignments for one read segment
+///
+/// The candidate alignments of a read usually differ by only a few indels, so their match segments fall on a
+/// small number of alignment diagonals (offsets between read and reference positions). The scorer caches a
+/// prefix sum of the basecall log-likelihoods along each diagonal used by the read, so that each match segment
+/// is scored in constant time and each candidate alignment in time proportional to its number of path segments.
+///
+/// Scores are summed in fixed point, so alignments made from the same basecall terms score exactly the same no
+/// matter how the terms are split into path segments. Results match scoreCandidateAlignment to within the fixed
+/// point resolution.
+///
+struct CandidateAlignmentScorer
+{
+    CandidateAlignmentScorer(
+        const starling_base_options& opt,
+        const IndelBuffer& indelBuffer,
+        const unsigned sampleIndex,
+        const CandidateSnvBuffer& candidateSnvBuffer,
+        const read_segment& readSegment,
+        const reference_contig_segment& ref);
+
+    /// \return Score of candidate alignment \p cal for the read segment, as defined for scoreCandidateAlignment
+    double
+    scoreCandidateAlignment(const CandidateAlignment& cal);
+
+private:
+
+    /// A sum of basecall log-likelihoods in fixed point
+    ///
+    /// Zero-likelihood basecalls (from Q0 matches) are counted separately, so that a negative infinity term
+    /// can be summed and subtracted like any other.
+    struct BasecallScore
+    {
+        void
+        operator+=(const BasecallScore& rhs)
+        {
+            logLhood += rhs.logLhood;
+            zeroLhoodCount += rhs.zeroLhoodCount;
+        }
+
+        void
+        operator-=(const BasecallScore& rhs)
+        {
+            logLhood -= rhs.logLhood;
+            zeroLhoodCount -= rhs.zeroLhoodCount;
+        }
+
+        int64_t logLhood = 0;
+        int zeroLhoodCount = 0;
+    };
+
+    static
+    BasecallScore
+    getFixedScore(const double logLhood);
+
+    /// \return Basecall score prefix sums for all read positions aligned to reference position (readPos+refOffset)
+    const std::vector<BasecallScore>&
+    getDiagonalPrefixScore(const pos_t refOffset);
+
+    /// \return True if the basecall at \p readPos supports the reference base at \p refPos
+    bool
+    isReferenceBasecall(
+        const pos_t readPos,
+        const pos_t refPos) const;
+
+    void
+    addInsertSegmentScore(
+        const unsigned segmentLength,
+        const unsigned readOffset,
+        const bam_seq_base& insertSeq,
+        const pos_t insertSeqHeadPos,
+        BasecallScore& score) const;
+
+    struct DiagonalPrefixScore
+    {
+        pos_t refOffset;
+        std::vector<BasecallScore> prefixScore;
+    };
+
+    const starling_base_options& _opt;
+    const IndelBuffer& _indelBuffer;
+    const unsigned _sampleIndex;
+    const CandidateSnvBuffer& _candidateSnvBuffer;
+    const reference_contig_segment& _ref;
+
+    /// read segment sequence as BASE_ID values
+    const uint8_t* _readBaseIds;
+
+    /// basecall scores for each read position when the basecall matches or mismatches the aligned base
+    std::vector<BasecallScore> _matchScore;
+    std::vector<BasecallScore> _mismatchScore;
+
+    std::vector<DiagonalPrefixScore> _diagonals;
+};
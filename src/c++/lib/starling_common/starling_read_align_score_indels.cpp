@@ -450,22 +450,52 @@ late_indel_normalization_filter(
 
 
 
+void
+ReadIndelScoreUpdates::
+apply(IndelBuffer& indelBuffer) const
+{
+    for (const IndelKey& indelKey : subOverlapIndels)
+    {
+        IndelData* indelDataPtr(indelBuffer.getIndelDataPtr(indelKey));
+        assert(nullptr != indelDataPtr);
+        IndelSampleData& indelSampleData(indelDataPtr->getSampleData(sampleIndex));
+        if (isTier1Read) indelSampleData.suboverlap_tier1_read_ids.insert(readIndex);
+        else             indelSampleData.suboverlap_tier2_read_ids.insert(readIndex);
+    }
+
+    for (const auto& indelScore : readPathScores)
+    {
+        IndelData* indelDataPtr(indelBuffer.getIndelDataPtr(indelScore.first));
+        assert(nullptr != indelDataPtr);
+        IndelSampleData& indelSampleData(indelDataPtr->getSampleData(sampleIndex));
+        indelSampleData.read_path_lnp[readIndex] = indelScore.second;
+    }
+}
+
+
+
 void
 score_indels(
     const starling_base_options& opt,
     const starling_base_deriv_options&,
     const starling_sample_options& sample_opt,
     const read_segment& rseg,
-    IndelBuffer& indelBuffer,
+    const IndelBuffer& indelBuffer,
     const unsigned sampleIndex,
     const std::set<CandidateAlignment>& candAlignments,
     const bool is_incomplete_search,
     const std::vector<double>& candAlignmentScores,
     double maxCandAlignmentScore,
-    const CandidateAlignment* maxCandAlignmentPtr)
+    const CandidateAlignment* maxCandAlignmentPtr,
+    ReadIndelScoreUpdates& indelScoreUpdates)
 {
     static const bool is_safe_mode(true);
 
+    indelScoreUpdates.clear();
+    indelScoreUpdates.sampleIndex = sampleIndex;
+    indelScoreUpdates.readIndex = rseg.getReadIndex();
+    indelScoreUpdates.isTier1Read = rseg.is_tier1_mapping();
+
     // (1) score candidate alignments -- already done before calling this function
     //
     // (2) find the highest scoring alignment with each indel present
@@ -612,11 +642,7 @@ score_indels(
                 {
                     if (bpo>0)
                     {
-                        const bool is_tier1_read(rseg.is_tier1_mapping());
-                        IndelSampleData& indelSampleData(getIndelData(indelIter).getSampleData(sampleIndex));
-
-                        if (is_tier1_read) indelSampleData.suboverlap_tier1_read_ids.insert(rseg.getReadIndex());
-                        else               indelSampleData.suboverlap_tier2_read_ids.insert(rseg.getReadIndex());
+                        indelScoreUpdates.subOverlapIndels.push_back(evaluationIndel);
                     }
                     continue;
                 }
@@ -1059,16 +1085,7 @@ score_indels(
 #endif
             }
 
-            {
-                IndelData* evaluationIndelDataPtr(indelBuffer.getIndelDataPtr(evaluationIndel));
-                assert(nullptr != evaluationIndelDataPtr);
-                IndelSampleData& evaluationIndelSampleData(evaluationIndelDataPtr->getSampleData(sampleIndex));
-                evaluationIndelSampleData.read_path_lnp[rseg.getReadIndex()] = rps;
-            }
-
-#ifdef DEBUG_ALIGN
-            log_os << "VARMIT: modified indel data: " << *(evaluationIndelDataPtr);
-#endif
+            indelScoreUpdates.readPathScores.emplace_back(evaluationIndel, rps);
         }
     }
 }
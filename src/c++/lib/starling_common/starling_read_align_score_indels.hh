@@ -31,25 +31,60 @@
 #include "starling_common/starling_base_shared.hh"
 
 #include <set>
+#include <utility>
 #include <vector>
 
 
 typedef std::map<IndelKey,bool> indel_status_map_t;
 
 
+/// Indel buffer updates produced by scoring the indels of one read segment
+///
+/// Indel scoring only reads from the indel buffer, so that read segments can be scored concurrently. The
+/// updates from each read segment are applied afterwards in a fixed read order.
+///
+struct ReadIndelScoreUpdates
+{
+    void
+    clear()
+    {
+        subOverlapIndels.clear();
+        readPathScores.clear();
+    }
+
+    /// write all updates to the indel buffer
+    void
+    apply(IndelBuffer& indelBuffer) const;
+
+    unsigned sampleIndex = 0;
+    align_id_t readIndex = 0;
+    bool isTier1Read = false;
+
+    /// indels with insufficient breakpoint overlap in the read's best alignment supporting the indel
+    std::vector<IndelKey> subOverlapIndels;
+
+    /// indel evaluation scores for the read
+    std::vector<std::pair<IndelKey,ReadPathScores>> readPathScores;
+};
+
+
 /// use the most likely alignment for each indel state for every indel
 /// in indel_status_map to generate data needed in indel calling:
 ///
+/// \param[out] indelScoreUpdates updates to apply to the indel buffer for this read segment, existing contents are
+///                                cleared
+///
 void
 score_indels(
     const starling_base_options& opt,
     const starling_base_deriv_options& dopt,
     const starling_sample_options& sample_opt,
     const read_segment& rseg,
-    IndelBuffer& indelBuffer,
+    const IndelBuffer& indelBuffer,
     const unsigned sampleIndex,
     const std::set<CandidateAlignment>& candAlignments,
     const bool is_incomplete_search,
     const std::vector<double>& candAlignmentScores,
     double maxCandAlignmentScore,
-    const CandidateAlignment* maxCandAlignmentPtr);
+    const CandidateAlignment* maxCandAlignmentPtr,
+    ReadIndelScoreUpdates& indelScoreUpdates);
@@ -49,12 +49,13 @@ starling_read_buffer::
 add_read_alignment(
     const bam_record& br,
     const alignment& inputAlignment,
-    const MAPLEVEL::index_t maplev)
+    const MAPLEVEL::index_t maplev,
+    const reference_contig_segment& ref)
 {
     assert(! br.is_unmapped());
 
     const align_id_t readIndex(getNextReadIndex());
-    _read_data[readIndex] = new starling_read(br, inputAlignment, maplev, readIndex);
+    _read_data[readIndex] = new starling_read(br, inputAlignment, maplev, readIndex, ref);
     starling_read& sread(*(_read_data[readIndex]));
 
     if (sread.isSpliced())
@@ -87,7 +87,8 @@ struct starling_read_buffer : private boost::noncopyable
     add_read_alignment(
         const bam_record& br,
         const alignment& inputAlignment,
-        const MAPLEVEL::index_t maplev);
+        const MAPLEVEL::index_t maplev,
+        const reference_contig_segment& ref);
 
     /// adjust read segment's buffer position to new_buffer_pos,
     /// and change buffer pos:
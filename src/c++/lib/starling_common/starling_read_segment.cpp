@@ -72,6 +72,15 @@ qual() const
 
 
 
+const uint8_t*
+read_segment::
+baseIds() const
+{
+    return _sread._readBaseIds.data()+_offset;
+}
+
+
+
 align_id_t
 read_segment::
 getReadIndex() const
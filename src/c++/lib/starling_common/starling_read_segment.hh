@@ -93,6 +93,11 @@ struct read_segment
     bam_seq get_bam_read() const;
     const uint8_t* qual() const;
 
+    /// read segment sequence as BASE_ID values, where BASE_ID::ANY marks an N basecall
+    ///
+    /// this provides the same sequence as get_bam_read(), pre-decoded to one byte per basecall
+    const uint8_t* baseIds() const;
+
     /// are there any alignments without indels above max_indel_size?
     bool
     is_any_nonovermax(const unsigned max_indel_size) const;
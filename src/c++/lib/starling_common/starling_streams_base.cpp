@@ -111,9 +111,10 @@ open_ofstream(const prog_info& pinfo,
 
 
 
-std::unique_ptr<bam_dumper>
+std::unique_ptr<sorted_bam_dumper>
 starling_streams_base::
 initialize_realign_bam(
+    const starling_base_options& opt,
     const std::string& filename,
     const bam_hdr_t& header)
 {
@@ -122,7 +123,8 @@ initialize_realign_bam(
     //fp->header = bam_header_dup((const bam_header_t*)aux);
     //fos << "@PG\tID:" << pinfo.name() << "\tVN:" << pinfo.version() << "\tCL:" << cmdline << "\n";
 
-    return std::unique_ptr<bam_dumper>(new bam_dumper(filename.c_str(),header));
+    return std::unique_ptr<sorted_bam_dumper>(
+               new sorted_bam_dumper(filename.c_str(),header,opt.realignedReadFileThreadCount));
 }
 
 
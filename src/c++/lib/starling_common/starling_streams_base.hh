@@ -25,7 +25,7 @@
 
 #include "blt_util/prog_info.hh"
 #include "htsapi/bam_util.hh"
-#include "htsapi/bam_dumper.hh"
+#include "htsapi/sorted_bam_dumper.hh"
 #include "starling_common/starling_base_shared.hh"
 #include "starling_common/starling_types.hh"
 
@@ -41,7 +41,7 @@ struct starling_streams_base
     starling_streams_base(
         const unsigned sampleCount);
 
-    bam_dumper*
+    sorted_bam_dumper*
     realign_bam_ptr(const unsigned sampleIndex) const
     {
         return _realign_bam_ptr[sampleIndex].get();
@@ -54,8 +54,9 @@ struct starling_streams_base
     }
 
 protected:
-    std::unique_ptr<bam_dumper>
+    std::unique_ptr<sorted_bam_dumper>
     initialize_realign_bam(
+        const starling_base_options& opt,
         const std::string& filename,
         const bam_hdr_t& header);
 
@@ -76,7 +77,7 @@ protected:
                     const bam_hdr_t& header,
                     std::ostream& os);
 
-    std::vector<std::unique_ptr<bam_dumper>> _realign_bam_ptr;
+    std::vector<std::unique_ptr<sorted_bam_dumper>> _realign_bam_ptr;
 private:
     unsigned _sampleCount;
 };
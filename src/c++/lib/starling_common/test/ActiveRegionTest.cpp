@@ -22,9 +22,12 @@
 ///
 
 #include "starling_base_options_test.hh"
+#include "blt_util/WorkerThreadPool.hh"
 #include "starling_common/ActiveRegionDetector.hh"
 #include "starling_common/IndelBuffer.hh"
 
+#include <sstream>
+
 
 #include "boost/test/unit_test.hpp"
 
@@ -36,7 +39,9 @@ struct TestIndelBuffer
 {
     explicit
     TestIndelBuffer(
-        const reference_contig_segment& ref)
+        const reference_contig_segment& ref,
+        const unsigned sampleCount = 1)
+        : _opt(sampleCount)
     {
         // fake starling options
         _opt.is_user_genome_size = true;
@@ -46,8 +51,12 @@ struct TestIndelBuffer
         _doptPtr.reset(new starling_base_deriv_options(_opt));
 
         _IndelBufferPtr.reset(new IndelBuffer(_opt, *_doptPtr, ref));
-        _IndelBufferPtr->registerSample(depth_buffer(), depth_buffer(), maxDepth);
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            _IndelBufferPtr->registerSample(depth_buffer(), depth_buffer(), maxDepth);
+        }
         _IndelBufferPtr->finalizeSamples();
+        _sharedIndelBufferPtr.reset(new SharedIndelBuffer(*_IndelBufferPtr));
 
     }
 
@@ -57,10 +66,17 @@ struct TestIndelBuffer
         return *_IndelBufferPtr;
     }
 
+    SharedIndelBuffer&
+    getSharedIndelBuffer()
+    {
+        return *_sharedIndelBufferPtr;
+    }
+
 private:
     starling_base_options_test _opt;
     std::unique_ptr<starling_base_deriv_options> _doptPtr;
     std::unique_ptr<IndelBuffer> _IndelBufferPtr;
+    std::unique_ptr<SharedIndelBuffer> _sharedIndelBufferPtr;
 };
 
 
@@ -80,7 +96,7 @@ BOOST_AUTO_TEST_CASE( test_multiSampleMMDF )
 
     std::vector<std::unique_ptr<ActiveRegionDetector>> activeRegionDetector(sampleCount);
     for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
-        activeRegionDetector[sampleIndex].reset(new ActiveRegionDetector(ref, testBuffer.getIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex));
+        activeRegionDetector[sampleIndex].reset(new ActiveRegionDetector(ref, testBuffer.getSharedIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex));
 
     const auto snvPos = std::set<pos_t>({2, 4, 5});
 
@@ -151,7 +167,7 @@ BOOST_AUTO_TEST_CASE( test_indelCandidacy )
     TestIndelBuffer testBuffer(ref);
     CandidateSnvBuffer testSnvBuffer(sampleCount);
 
-    ActiveRegionDetector detector(ref, testBuffer.getIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex);
+    ActiveRegionDetector detector(ref, testBuffer.getSharedIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex);
 
     const int depth = 50;
 
@@ -221,7 +237,7 @@ BOOST_AUTO_TEST_CASE( test_jumpingPositions )
     TestIndelBuffer testBuffer(ref);
     CandidateSnvBuffer testSnvBuffer(sampleCount);
 
-    ActiveRegionDetector detector(ref, testBuffer.getIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex);
+    ActiveRegionDetector detector(ref, testBuffer.getSharedIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex);
 
     // fake reading reads
     const int depth = 50;
@@ -275,7 +291,7 @@ BOOST_AUTO_TEST_CASE( test_leftShiftIndel )
     TestIndelBuffer testBuffer(ref);
     CandidateSnvBuffer testSnvBuffer(sampleCount);
 
-    ActiveRegionDetector detector(ref, testBuffer.getIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex);
+    ActiveRegionDetector detector(ref, testBuffer.getSharedIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex);
 
     const int depth = 50;
 
@@ -320,4 +336,160 @@ BOOST_AUTO_TEST_CASE( test_leftShiftIndel )
     BOOST_REQUIRE_EQUAL(itr->second.isConfirmedInActiveRegion, true);
 }
 
+
+/// run active region detection for several samples sharing one indel buffer, with up to threadCount samples
+/// processed concurrently
+///
+/// Each sample has an insertion shared by all samples and one sample-specific insertion, both followed by a
+/// nearby SNV so that they are confirmed through haplotyping.
+///
+/// \return summary of the indel buffer and candidate SNV buffer contents
+static
+std::string
+runMultiSampleDetection(
+    const reference_contig_segment& ref,
+    const unsigned sampleCount,
+    const unsigned threadCount)
+{
+    const unsigned maxIndelSize = 50;
+    const int depth = 40;
+    const pos_t refLength = (pos_t)ref.seq().length();
+
+    TestIndelBuffer testBuffer(ref, sampleCount);
+    CandidateSnvBuffer testSnvBuffer(sampleCount);
+
+    std::vector<std::unique_ptr<ActiveRegionDetector>> activeRegionDetector(sampleCount);
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        activeRegionDetector[sampleIndex].reset(new ActiveRegionDetector(ref, testBuffer.getSharedIndelBuffer(), testSnvBuffer, maxIndelSize, sampleIndex));
+    }
+
+    auto getSnvBase = [&](const pos_t pos)
+    {
+        return ((ref.get_base(pos) == 'A') ? 'C' : 'A');
+    };
+
+    auto processSample = [&](const unsigned sampleIndex, const unsigned /*threadIndex*/)
+    {
+        ActiveRegionDetector& detector(*activeRegionDetector[sampleIndex]);
+        const pos_t indelPositions[] = {60, (pos_t)(100 + 20*sampleIndex)};
+
+        // fake reading reads
+        for (int readIndex=0; readIndex < depth; ++readIndex)
+        {
+            const int alignId = sampleIndex*depth + readIndex;
+            bool isForwardStrand = ((alignId % 4) == 0) or ((alignId % 4) == 3);
+            detector.getReadBuffer().setAlignInfo(alignId, sampleIndex, INDEL_ALIGN_TYPE::GENOME_TIER1_READ, isForwardStrand);
+            for (pos_t pos(0); pos<refLength; ++pos)
+            {
+                const bool isVariantRead(readIndex % 2);
+                bool isSnvPosition(false);
+                for (const auto indelPos : indelPositions)
+                {
+                    if (pos == (indelPos + 3)) isSnvPosition = true;
+                }
+
+                if (isVariantRead && isSnvPosition)
+                {
+                    detector.getReadBuffer().insertMismatch(alignId, pos, getSnvBase(pos));
+                }
+                else
+                {
+                    detector.getReadBuffer().insertMatch(alignId, pos);
+                }
+
+                for (const auto indelPos : indelPositions)
+                {
+                    if (isVariantRead && (pos == indelPos))
+                    {
+                        IndelObservation indelObservation;
+
+                        IndelObservationData indelObservationData;
+                        indelObservation.key = IndelKey(indelPos, INDEL::INDEL, 0, "AG");
+                        indelObservationData.id = alignId;
+                        indelObservationData.iat = INDEL_ALIGN_TYPE::GENOME_TIER1_READ;
+                        indelObservation.data = indelObservationData;
+
+                        detector.getReadBuffer().insertIndel(indelObservation);
+                    }
+                }
+            }
+        }
+
+        for (pos_t pos(0); pos<refLength; ++pos)
+        {
+            detector.updateEndPosition(pos);
+        }
+        detector.clear();
+    };
+
+    WorkerThreadPool pool(threadCount);
+    pool.run(sampleCount, processSample);
+
+    std::ostringstream oss;
+    const IndelBuffer& indelBuffer(testBuffer.getIndelBuffer());
+    indelBuffer.dump(oss);
+    const auto itEnd(indelBuffer.positionIterator(refLength));
+    for (auto it(indelBuffer.positionIterator(0)); it!=itEnd; ++it)
+    {
+        const IndelData& indelData(getIndelData(it));
+        oss << it->first << "confirmed: " << indelData.isConfirmedInActiveRegion << "\n";
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            const IndelSampleData& indelSampleData(indelData.getSampleData(sampleIndex));
+            oss << sampleIndex << " haplotypeId: " << (int)indelSampleData.haplotypeId
+                << " altAlleleHaplotypeCountRatio: " << indelSampleData.altAlleleHaplotypeCountRatio << "\n";
+        }
+    }
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        for (pos_t pos(0); pos<refLength; ++pos)
+        {
+            if (testSnvBuffer.isCandidateSnv(sampleIndex, pos, getSnvBase(pos)))
+            {
+                oss << "candidate SNV sample: " << sampleIndex << " pos: " << pos << "\n";
+            }
+        }
+    }
+    return oss.str();
+}
+
+
+
+// checks that concurrent active region detection for several samples sharing an indel buffer matches serial detection
+BOOST_AUTO_TEST_CASE( test_concurrentSampleDetection )
+{
+    // a reference without long repeats
+    std::string refSeq;
+    unsigned state(17);
+    for (unsigned i(0); i<200; ++i)
+    {
+        state = (state * 1103515245u) + 12345u;
+        refSeq.push_back("ACGT"[(state >> 16) % 4]);
+    }
+
+    reference_contig_segment ref;
+    ref.seq() = refSeq;
+
+    const unsigned sampleCount = 4;
+
+    const std::string serialResult(runMultiSampleDetection(ref, sampleCount, 1));
+
+    // check that both variant clusters form active regions in every sample
+    for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+    {
+        for (const pos_t pos : {(pos_t)60, (pos_t)(100 + 20*sampleIndex)})
+        {
+            std::ostringstream oss;
+            oss << "candidate SNV sample: " << sampleIndex << " pos: " << (pos + 3) << "\n";
+            BOOST_REQUIRE(serialResult.find(oss.str()) != std::string::npos);
+        }
+    }
+
+    for (unsigned repeatIndex(0); repeatIndex<20; ++repeatIndex)
+    {
+        BOOST_REQUIRE_EQUAL(runMultiSampleDetection(ref, sampleCount, sampleCount), serialResult);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
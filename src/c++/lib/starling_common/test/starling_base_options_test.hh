@@ -21,25 +21,29 @@
 
 #include "starling_base_shared.hh"
 
+#include <string>
+
 
 /// \brief This version of starling_base_options provides null implementations of required virtuals
 ///        so that unit tests are easier to setup
 struct starling_base_options_test final : public starling_base_options
 {
+    explicit
+    starling_base_options_test(
+        const unsigned sampleCount = 1)
+    {
+        for (unsigned sampleIndex(0); sampleIndex<sampleCount; ++sampleIndex)
+        {
+            _alignFileOpt.alignmentFilenames.push_back("sample" + std::to_string(sampleIndex) + ".bam");
+        }
+    }
+
     const AlignmentFileOptions&
     getAlignmentFileOptions() const override
     {
-        static const AlignmentFileOptions alignFileOpt(getTestAlignmentFileOptions());
-        return alignFileOpt;
+        return _alignFileOpt;
     }
 
 private:
-    static
-    AlignmentFileOptions
-    getTestAlignmentFileOptions()
-    {
-        AlignmentFileOptions alignFileOpt;
-        alignFileOpt.alignmentFilenames.push_back("sample.bam");
-        return alignFileOpt;
-    }
+    AlignmentFileOptions _alignFileOpt;
 };
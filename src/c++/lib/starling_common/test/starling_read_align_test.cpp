@@ -26,6 +26,8 @@
 #include "htsapi/align_path_bam_util.hh"
 #include "starling_read.hh"
 
+#include <random>
+
 
 
 BOOST_AUTO_TEST_SUITE( starling_read_align )
@@ -46,7 +48,10 @@ test_indel_placement(
     iset.insert(ikfixed);
     iset.insert(indelKey);
 
-    return make_start_pos_alignment(ref_start_pos,read_start_pos,is_fwd_strand,read_length,iset);
+    CandidateAlignment cal;
+    make_start_pos_alignment(ref_start_pos,read_start_pos,is_fwd_strand,read_length,
+                             std::vector<IndelKey>(iset.begin(),iset.end()),cal);
+    return cal;
 }
 
 
@@ -190,7 +195,8 @@ test_end_pin_indel_placement(
 
     pos_t ref_start_pos(0);
     pos_t read_start_pos(0);
-    get_end_pin_start_pos(iset,read_length,ref_end_pos,read_end_pos,ref_start_pos,read_start_pos);
+    get_end_pin_start_pos(std::vector<IndelKey>(iset.begin(),iset.end()),read_length,ref_end_pos,read_end_pos,
+                          ref_start_pos,read_start_pos);
 
     return std::make_pair(static_cast<int>(ref_start_pos),
                           static_cast<int>(read_start_pos));
@@ -394,7 +400,7 @@ BOOST_AUTO_TEST_CASE( test_realign_and_score_read )
         edit_bam_cigar(al.path, br);
 
         // 2) mock up the starling read
-        starling_read sread(bamRead, al, MAPLEVEL::UNKNOWN, 0);
+        starling_read sread(bamRead, al, MAPLEVEL::UNKNOWN, 0, ref);
 
         // 3) finally, get read_segment from starling_read
         read_segment& rseg(sread.get_full_segment());
@@ -402,11 +408,303 @@ BOOST_AUTO_TEST_CASE( test_realign_and_score_read )
         // create an active region detector instance
         const CandidateSnvBuffer candidateSnvBuffer(1);
 
+        CandidateAlignmentCache candidateAlignmentCache;
+        ReadIndelScoreUpdates indelScoreUpdates;
         realignAndScoreRead(opt, dopt, sample_opt, ref, realign_buffer_range, sampleIndex, candidateSnvBuffer, rseg,
-                            indelBuffer);
+                            indelBuffer, candidateAlignmentCache, indelScoreUpdates);
+        indelScoreUpdates.apply(indelBuffer);
 
         BOOST_REQUIRE(not rseg.is_realigned);
     }
 }
 
+
+
+/// mock up a starling read with the given alignment
+static
+std::unique_ptr<starling_read>
+getTestRead(
+    const char* readSeq,
+    const alignment& al,
+    const align_id_t readIndex,
+    const reference_contig_segment& ref)
+{
+    bam_record bamRead;
+    bamRead.set_qname("FOOREAD");
+    const std::vector<uint8_t> qual(strlen(readSeq), 40);
+    bamRead.set_readqual(readSeq, qual.data());
+
+    bam1_t& br(*(bamRead.get_data()));
+    br.core.pos = al.pos;
+    edit_bam_cigar(al.path, br);
+
+    return std::unique_ptr<starling_read>(new starling_read(bamRead, al, MAPLEVEL::UNKNOWN, readIndex, ref));
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_read_ref_basecalls )
+{
+    // BAM '=' basecalls should be decoded to the reference base at their aligned position
+    reference_contig_segment ref;
+    ref.seq() = "ACGTACGTACGT";
+
+    alignment al;
+    al.pos = 2;
+    ALIGNPATH::cigar_to_apath("1S3M1D2M", al.path);
+    const auto sread(getTestRead("==T=N=", al, 0, ref));
+
+    using namespace BASE_ID;
+    const uint8_t expectBaseIds[] = { ANY, G, T, A, ANY, T };
+    const uint8_t* baseIds(sread->get_full_segment().baseIds());
+    for (unsigned readPos(0); readPos<6; ++readPos)
+    {
+        BOOST_REQUIRE_EQUAL(static_cast<int>(baseIds[readPos]), static_cast<int>(expectBaseIds[readPos]));
+    }
+}
+
+
+
+static
+bool
+isSameCandidateAlignments(
+    const std::set<CandidateAlignment>& cal_set1,
+    const std::set<CandidateAlignment>& cal_set2)
+{
+    if (cal_set1.size() != cal_set2.size()) return false;
+    auto iter2(cal_set2.begin());
+    for (const auto& cal : cal_set1)
+    {
+        if ((cal < *iter2) || (*iter2 < cal)) return false;
+        ++iter2;
+    }
+    return true;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_candidate_alignment_cache )
+{
+    // reads with identical input alignments should share cached candidate alignments only when they have the
+    // same access to non-candidate indels
+    starling_base_options_test opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000000;
+
+    starling_base_deriv_options dopt(opt);
+    reference_contig_segment ref;
+    ref.seq() = "ACGTACGTACGTACGTACGTACGTACGTACGTACGTACGT";
+
+    const known_pos_range realign_buffer_range(0, 40);
+    const unsigned sampleIndex(0);
+
+    IndelBuffer indelBuffer(opt, dopt, ref);
+    depth_buffer db;
+    depth_buffer db2;
+    indelBuffer.registerSample(db, db2, false);
+    indelBuffer.finalizeSamples();
+
+    // one candidate indel:
+    {
+        IndelObservation obs;
+        obs.key = IndelKey(10, INDEL::INDEL, 4);
+        obs.data.is_external_candidate = true;
+        indelBuffer.addIndelObservation(sampleIndex, obs);
+    }
+
+    // one non-candidate indel supported only by read 1:
+    const align_id_t supportingReadIndex(1);
+    {
+        IndelObservation obs;
+        obs.key = IndelKey(18, INDEL::INDEL, 4);
+        obs.data.iat = INDEL_ALIGN_TYPE::GENOME_TIER1_READ;
+        obs.data.id = supportingReadIndex;
+        indelBuffer.addIndelObservation(sampleIndex, obs);
+    }
+    BOOST_REQUIRE(not indelBuffer.isCandidateIndel(IndelKey(18, INDEL::INDEL, 4)));
+
+    alignment al;
+    al.pos = 4;
+    ALIGNPATH::cigar_to_apath("24M", al.path);
+    const char readSeq[] = "ACGTACGTACGTACGTACGTACGT";
+
+    auto searchRead = [&](
+                          const align_id_t readIndex,
+                          CandidateAlignmentCache& cache)
+    {
+        const auto sread(getTestRead(readSeq, al, readIndex, ref));
+        const read_segment& rseg(sread->get_full_segment());
+        return getCandidateAlignments(opt, dopt, rseg, indelBuffer, sampleIndex, al, realign_buffer_range,
+                                      cache).candidateAlignments;
+    };
+
+    CandidateAlignmentCache emptyCache1;
+    CandidateAlignmentCache emptyCache2;
+    const std::set<CandidateAlignment> supportingSet(searchRead(supportingReadIndex, emptyCache1));
+    const std::set<CandidateAlignment> otherSet(searchRead(supportingReadIndex+1, emptyCache2));
+
+    // the non-candidate indel is only used in the search for the supporting read:
+    BOOST_REQUIRE_GT(supportingSet.size(), otherSet.size());
+
+    CandidateAlignmentCache sharedCache;
+    BOOST_REQUIRE(isSameCandidateAlignments(searchRead(supportingReadIndex, sharedCache), supportingSet));
+    BOOST_REQUIRE(isSameCandidateAlignments(searchRead(supportingReadIndex+1, sharedCache), otherSet));
+    BOOST_REQUIRE(isSameCandidateAlignments(searchRead(supportingReadIndex+2, sharedCache), otherSet));
+    BOOST_REQUIRE(isSameCandidateAlignments(searchRead(supportingReadIndex, sharedCache), supportingSet));
+}
+
+
+
+/// \return A random alignment path covering \p readLength read bases, including edge and swap indels
+static
+ALIGNPATH::path_t
+getRandomCandidatePath(
+    const unsigned readLength,
+    std::mt19937& generator)
+{
+    using namespace ALIGNPATH;
+
+    std::uniform_int_distribution<unsigned> typeDist(0,3);
+    std::uniform_int_distribution<unsigned> indelLengthDist(1,4);
+    std::uniform_int_distribution<unsigned> matchLengthDist(3,12);
+
+    path_t path;
+    unsigned remaining(readLength);
+    auto addSegment = [&](const align_t type, const unsigned length)
+    {
+        path.push_back(path_segment(type,length));
+        if ((type == MATCH) || (type == INSERT) || (type == SOFT_CLIP)) remaining -= length;
+    };
+
+    static const align_t edgeTypes[] = { NONE, SOFT_CLIP, INSERT, DELETE };
+    const align_t leadingType(edgeTypes[typeDist(generator)]);
+    if (leadingType != NONE) addSegment(leadingType, indelLengthDist(generator));
+
+    while (remaining > 20)
+    {
+        addSegment(MATCH, matchLengthDist(generator));
+        const unsigned indelType(typeDist(generator));
+        if (indelType != 0) addSegment(DELETE, indelLengthDist(generator));
+        if (indelType != 1) addSegment(INSERT, indelLengthDist(generator));
+    }
+
+    const align_t trailingType(edgeTypes[typeDist(generator)]);
+    const unsigned trailingLength((trailingType == NONE) ? 0 : indelLengthDist(generator));
+    addSegment(MATCH, remaining-((trailingType == DELETE) ? 0 : trailingLength));
+    if (trailingType != NONE) addSegment(trailingType, trailingLength);
+    return path;
+}
+
+
+
+BOOST_AUTO_TEST_CASE( test_candidate_alignment_scorer )
+{
+    // the incremental scorer should match the direct per-basecall evaluation of each candidate alignment
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<unsigned> baseDist(0,3);
+    std::uniform_int_distribution<unsigned> percentDist(0,99);
+    std::uniform_int_distribution<uint8_t> qualDist(2,40);
+    static const char bases[] = "ACGT";
+
+    starling_base_options_test opt;
+    opt.is_user_genome_size = true;
+    opt.user_genome_size = 1000000;
+    starling_base_deriv_options dopt(opt);
+
+    reference_contig_segment ref;
+    for (unsigned refPos(0); refPos<300; ++refPos) ref.seq().push_back(bases[baseDist(generator)]);
+
+    const unsigned sampleIndex(0);
+    IndelBuffer indelBuffer(opt, dopt, ref);
+    depth_buffer db;
+    depth_buffer db2;
+    indelBuffer.registerSample(db, db2, false);
+    indelBuffer.finalizeSamples();
+
+    CandidateSnvBuffer candidateSnvBuffer(1);
+    for (pos_t refPos(0); refPos<300; refPos += 7)
+    {
+        candidateSnvBuffer.addCandidateSnv(sampleIndex, refPos, bases[baseDist(generator)], 1, 0.5);
+    }
+
+    for (unsigned readIndex(0); readIndex<50; ++readIndex)
+    {
+        opt.is_short_haplotyping_enabled = ((readIndex % 2) == 1);
+        const unsigned readLength(40+(readIndex % 30));
+
+        // generate the read from the reference along the first candidate alignment, with random errors:
+        alignment al;
+        al.pos = 50+(readIndex % 20);
+        al.path = getRandomCandidatePath(readLength, generator);
+
+        std::string readSeq;
+        {
+            pos_t refPos(al.pos);
+            for (const ALIGNPATH::path_segment& ps : al.path)
+            {
+                for (unsigned segmentPos(0); segmentPos<ps.length; ++segmentPos)
+                {
+                    if (ps.type == ALIGNPATH::MATCH)
+                    {
+                        const unsigned percent(percentDist(generator));
+                        if (percent < 3) readSeq.push_back('N');
+                        else if (percent < 15) readSeq.push_back(bases[baseDist(generator)]);
+                        else readSeq.push_back(ref.get_base(refPos+segmentPos));
+                    }
+                    else if (ps.type != ALIGNPATH::DELETE)
+                    {
+                        readSeq.push_back(bases[baseDist(generator)]);
+                    }
+                }
+                if (is_segment_type_ref_length(ps.type)) refPos += ps.length;
+            }
+        }
+        BOOST_REQUIRE_EQUAL(readSeq.size(), readLength);
+
+        std::vector<uint8_t> qual(readLength);
+        for (auto& q : qual) q = qualDist(generator);
+
+        bam_record bamRead;
+        bamRead.set_qname("FOOREAD");
+        bamRead.set_readqual(readSeq.c_str(), qual.data());
+        bam1_t& br(*(bamRead.get_data()));
+        br.core.pos = al.pos;
+        edit_bam_cigar(al.path, br);
+        const starling_read sread(bamRead, al, MAPLEVEL::UNKNOWN, readIndex, ref);
+        const read_segment& rseg(sread.get_full_segment());
+
+        CandidateAlignmentScorer scorer(opt, indelBuffer, sampleIndex, candidateSnvBuffer, rseg, ref);
+        for (unsigned calIndex(0); calIndex<10; ++calIndex)
+        {
+            alignment candidateAl(al);
+            if (calIndex > 0)
+            {
+                candidateAl.pos = 45+(percentDist(generator) % 30);
+                candidateAl.path = getRandomCandidatePath(readLength, generator);
+            }
+
+            CandidateAlignment cal;
+            getCandidateAlignment(candidateAl, rseg, cal);
+            indel_set_t indels;
+            getAlignmentIndels(cal, rseg, opt.maxIndelSize, indels);
+            cal.setIndels(indels);
+
+            // make about half of the alignment indels candidates:
+            for (const IndelKey& indelKey : indels)
+            {
+                IndelObservation obs;
+                obs.key = indelKey;
+                obs.data.is_external_candidate = (percentDist(generator) < 50);
+                obs.data.iat = INDEL_ALIGN_TYPE::GENOME_TIER1_READ;
+                obs.data.id = readIndex;
+                indelBuffer.addIndelObservation(sampleIndex, obs);
+            }
+
+            const double expect(
+                scoreCandidateAlignment(opt, indelBuffer, sampleIndex, candidateSnvBuffer, rseg, cal, ref));
+            BOOST_REQUIRE_SMALL(scorer.scoreCandidateAlignment(cal)-expect, 1e-8);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -62,6 +62,10 @@ You must specify an alignment file (BAM or CRAM) for at least one sample.
                          help="Call variants on CHROM without a ploidy prior assumption, issuing calls with continuous variant frequencies (no default)")
         group.add_option("--rna", dest="isRNA", action="store_true",
                          help="Set options for RNA-Seq input.")
+        group.add_option("--writeSiteEvidence", dest="isWriteSiteEvidence", action="store_true",
+                         help="Write the SNV site evidence of the input sample to 'results/variants/siteEvidence.bin', so that the"
+                              " sample can later be jointly genotyped at SNV sites with other samples without re-reading its"
+                              " alignments. Only supported for single-sample analysis.")
 
         StrelkaSharedWorkflowOptionsBase.addWorkflowGroupOptions(self,group)
 
@@ -104,7 +108,8 @@ You must specify an alignment file (BAM or CRAM) for at least one sample.
             'thetaParamFile' : joinFile(configDir,'theta.json'),
             'indelErrorRateDefault' : joinFile(configDir,'indelErrorModel.json'),
             'isEstimateSequenceError' : True,
-            'isErrorEstimationFromAllData' : False
+            'isErrorEstimationFromAllData' : False,
+            'isWriteSiteEvidence' : False
             })
         return defaults
 
@@ -144,6 +149,12 @@ You must specify an alignment file (BAM or CRAM) for at least one sample.
         if safeLen(options.bamList) == 0 :
             raise OptParseException("No input sample alignment files specified")
 
+        if options.isWriteSiteEvidence :
+            if safeLen(options.bamList) != 1 :
+                raise OptParseException("Site evidence can only be written when analyzing a single sample")
+            if safeLen(options.callContinuousVf) != 0 :
+                raise OptParseException("Site evidence output does not support continuous variant frequency calling")
+
         bamSetChecker = BamSetChecker()
         bamSetChecker.appendBams(options.bamList,"Input")
         bamSetChecker.check(options.htsfileBin, options.referenceFasta)
@@ -200,7 +200,11 @@ def checkTabixIndexedFile(iname,label) :
     assert(iname is not None)
     if not os.path.isfile(iname) :
         raise OptParseException("Can't find expected %s file: '%s'" % (label,iname))
-    tabixIndexFile = iname + ".tbi"
+    # BCF input is indexed in CSI format:
+    if iname.endswith(".bcf") :
+        tabixIndexFile = iname + ".csi"
+    else :
+        tabixIndexFile = iname + ".tbi"
     if not os.path.isfile(tabixIndexFile) :
         raise OptParseException("Can't find expected %s index file: '%s'" % (label,tabixIndexFile))
 
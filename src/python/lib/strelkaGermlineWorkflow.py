@@ -59,13 +59,14 @@ def strelkaGermlineGetDepthFromAlignments(self,taskPrefix="getChromDepth",depend
 class TempVariantCallingSegmentFilesPerSample :
     def __init__(self) :
         self.gvcf = []
+        self.bamRealign = []
 
 
 class TempVariantCallingSegmentFiles :
     def __init__(self, sampleCount) :
         self.variants = []
-        self.bamRealign = []
         self.stats = []
+        self.siteEvidence = []
         self.sample = [TempVariantCallingSegmentFilesPerSample() for _ in range(sampleCount)]
 
 
@@ -131,8 +132,17 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
         segCmd.extend(["--chrom-depth-file", self.paths.getChromDepth()])
 
     # TODO STREL-125 come up with new solution for outbams
+    #
+    # realigned reads are written in coordinate-sorted order, so each segment file can be merged directly
     if self.params.isWriteRealignedBam :
-        segCmd.extend(["-realigned-read-file", self.paths.getTmpUnsortRealignBamPath(gid)])
+        segCmd.extend(["-realigned-read-file", self.paths.getTmpRealignBamPrefix(gid)])
+        for sampleIndex in range(len(self.params.bamList)) :
+            segFiles.sample[sampleIndex].bamRealign.append(self.paths.getTmpRealignBamPath(gid, sampleIndex))
+
+    # site evidence is written in genome order within each segment, so the segment files can be concatenated directly:
+    if self.params.isWriteSiteEvidence :
+        segFiles.siteEvidence.append(self.paths.getTmpSegmentSiteEvidencePath(gid))
+        segCmd.extend(["--site-evidence-file", segFiles.siteEvidence[-1]])
 
     if self.params.noCompressBed is not None :
         segCmd.extend(['--nocompress-bed', self.params.noCompressBed])
@@ -194,22 +204,6 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
         segFiles.sample[sampleIndex].gvcf.append(compressedVariantsPath)
 
 
-    if self.params.isWriteRealignedBam :
-        def sortRealignBam(sortList) :
-            unsorted = self.paths.getTmpUnsortRealignBamPath(gid)
-            sorted   = self.paths.getTmpRealignBamPath(gid)
-            sortList.append(sorted)
-
-            # adjust sorted to remove the ".bam" suffix
-            sorted = sorted[:-4]
-            sortCmd="\"%s\" sort \"%s\" \"%s\" && rm -f \"%s\"" % (self.params.samtoolsBin,unsorted,sorted,unsorted)
-
-            sortTaskLabel=preJoin(taskPrefix,"sortRealignedSegment_"+gid)
-            self.addTask(sortTaskLabel,sortCmd,dependencies=segTaskLabel,memMb=self.params.callMemMb)
-            nextStepWait.add(sortTaskLabel)
-
-        sortRealignBam(segFiles.bamRealign)
-
     return nextStepWait
 
 
@@ -259,12 +253,19 @@ def callGenome(self,taskPrefix="",dependencies=None):
     # merge segment stats:
     finishTasks.add(self.mergeRunStats(taskPrefix,completeSegmentsTask, segFiles.stats))
 
+    if self.params.isWriteSiteEvidence :
+        catCmd = [self.params.catScript, "--output", self.paths.getSiteEvidenceOutputPath()] + segFiles.siteEvidence
+        finishTasks.add(self.addTask(preJoin(taskPrefix,"concatSiteEvidence"), catCmd,
+                                     dependencies=completeSegmentsTask, isForceLocal=True))
+
     if self.params.isWriteRealignedBam :
         def finishBam(tmpList, output, label) :
             cmd = bamListCatCmd(self.params.samtoolsBin, tmpList, output)
             finishTasks.add(self.addTask(preJoin(taskPrefix,label+"_finalizeBAM"), cmd, dependencies=completeSegmentsTask))
 
-        finishBam(segFiles.bamRealign, self.paths.getRealignedBamPath(), "realigned")
+        for sampleIndex in range(sampleCount) :
+            finishBam(segFiles.sample[sampleIndex].bamRealign, self.paths.getRealignedBamPath(sampleIndex),
+                      "realigned_S%i" % (sampleIndex+1))
 
     if not self.params.isRetainTempFiles :
         rmTmpCmd = getRmdirCmd() + [tmpSegmentDir]
@@ -350,11 +351,14 @@ class PathInfo(SharedPathInfo):
     def getTmpSegmentGvcfPath(self, segStr, sampleIndex) :
         return self.getTmpSegmentGvcfPrefix(segStr) + "genome.S%i.vcf" % (sampleIndex+1)
 
-    def getTmpUnsortRealignBamPath(self, segStr) :
-        return os.path.join( self.getTmpSegmentDir(), "%s.unsorted.realigned.bam" % (segStr))
+    def getTmpSegmentSiteEvidencePath(self, segStr) :
+        return self.getTmpSegmentGvcfPrefix(segStr) + "siteEvidence.bin"
+
+    def getTmpRealignBamPrefix(self, segStr) :
+        return os.path.join( self.getTmpSegmentDir(), "%s.realigned" % (segStr))
 
-    def getTmpRealignBamPath(self, segStr,) :
-        return os.path.join( self.getTmpSegmentDir(), "%s.realigned.bam" % (segStr))
+    def getTmpRealignBamPath(self, segStr, sampleIndex) :
+        return self.getTmpRealignBamPrefix(segStr) + ".S%i.bam" % (sampleIndex)
 
     def getVariantsOutputPath(self) :
         return os.path.join( self.params.variantsDir, "variants.vcf.gz")
@@ -362,11 +366,14 @@ class PathInfo(SharedPathInfo):
     def getGvcfOutputPath(self, sampleIndex) :
         return os.path.join( self.params.variantsDir, "genome.S%i.vcf.gz" % (sampleIndex+1))
 
+    def getSiteEvidenceOutputPath(self) :
+        return os.path.join( self.params.variantsDir, "siteEvidence.bin")
+
     def getGvcfLegacyFilename(self) :
         return "genome.vcf.gz"
 
-    def getRealignedBamPath(self) :
-        return os.path.join( self.params.realignedDir, 'realigned.bam')
+    def getRealignedBamPath(self, sampleIndex) :
+        return os.path.join( self.params.realignedDir, "realigned.S%i.bam" % (sampleIndex+1))
 
     def getTmpSegmentNonemptySiteCountsPath(self, sampleIndex, segStr) :
         sampleIndexStr = str(sampleIndex).zfill(3)
@@ -400,6 +407,7 @@ class StrelkaGermlineWorkflow(StrelkaSharedWorkflow) :
 
         # format other:
         safeSetBool(self.params,"isWriteRealignedBam")
+        safeSetBool(self.params,"isWriteSiteEvidence")
 
         if self.params.isWriteRealignedBam :
             self.params.realignedDir=os.path.join(self.params.resultsDir,"realigned")
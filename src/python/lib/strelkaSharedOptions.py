@@ -53,14 +53,14 @@ class StrelkaSharedWorkflowOptionsBase(ConfigureWorkflowOptions) :
         group.add_option("--indelCandidates", type="string", dest="indelCandidatesList", metavar="FILE", action="append",
                          help="Specify a VCF of candidate indel alleles. These alleles are always"
                               " evaluated but only reported in the output when they are inferred to exist in the sample."
-                              " The VCF must be tabix indexed."
+                              " The VCF must be tabix indexed, or the input may be provided as a CSI-indexed BCF file."
                               " All indel alleles must be left-shifted/normalized, any unnormalized alleles will be ignored."
                               " This option may be specified more than once, multiple input VCFs will be merged."
                               " (default: None)")
         group.add_option("--forcedGT", type="string", dest="forcedGTList", metavar="FILE", action="append",
                          help="Specify a VCF of candidate alleles. These alleles are always"
                               " evaluated and reported even if they are unlikely to exist in the sample."
-                              " The VCF must be tabix indexed."
+                              " The VCF must be tabix indexed, or the input may be provided as a CSI-indexed BCF file."
                               " All indel alleles must be left-shifted/normalized, any unnormalized allele will trigger"
                               " a runtime error."
                               " This option may be specified more than once, multiple input VCFs will be merged."
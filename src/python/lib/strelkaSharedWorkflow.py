@@ -271,7 +271,7 @@ class SharedPathInfo(object):
         return os.path.join(self.params.workDir, "errorEstimation.tmpdir")
 
     def getTmpRunStatsPath(self, segStr) :
-        return os.path.join( self.getTmpSegmentDir(), "runStats.%s.xml" % (segStr))
+        return os.path.join( self.getTmpSegmentDir(), "runStats.%s.bin" % (segStr))
 
     def getRunStatsPath(self) :
         return os.path.join(self.params.statsDir,"runStats.xml")
@@ -133,9 +133,12 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
         segFiles.callable.append(tmpCallablePath+".gz")
         segCmd.extend(["--somatic-callable-regions-file", tmpCallablePath ])
 
+    # realigned reads are written in coordinate-sorted order, so each segment file can be merged directly
     if self.params.isWriteRealignedBam :
-        segCmd.extend(["-realigned-read-file", self.paths.getTmpUnsortRealignBamPath(gid, "normal")])
-        segCmd.extend(["--tumor-realigned-read-file",self.paths.getTmpUnsortRealignBamPath(gid, "tumor")])
+        segCmd.extend(["-realigned-read-file", self.paths.getTmpRealignBamPath(gid, "normal")])
+        segCmd.extend(["--tumor-realigned-read-file",self.paths.getTmpRealignBamPath(gid, "tumor")])
+        segFiles.normalRealign.append(self.paths.getTmpRealignBamPath(gid, "normal"))
+        segFiles.tumorRealign.append(self.paths.getTmpRealignBamPath(gid, "tumor"))
 
     def addListCmdOption(optList,arg) :
         if optList is None : return
@@ -187,23 +190,6 @@ def callGenomeSegment(self, gsegGroup, segFiles, taskPrefix="", dependencies=Non
     self.addTask(compressTask, compressCmd, dependencies=compressWaitFor, isForceLocal=True)
     nextStepWait.add(compressTask)
 
-    if self.params.isWriteRealignedBam :
-        def sortRealignBam(label, sortList) :
-            unsorted = self.paths.getTmpUnsortRealignBamPath(gid, label)
-            sorted   = self.paths.getTmpRealignBamPath(gid, label)
-            sortList.append(sorted)
-
-            # adjust sorted to remove the ".bam" suffix
-            sorted = sorted[:-4]
-            sortCmd="\"%s\" sort \"%s\" \"%s\" && rm -f \"%s\"" % (self.params.samtoolsBin,unsorted,sorted,unsorted)
-
-            sortTaskLabel=preJoin(taskPrefix,"sortRealignedSegment_"+label+"_"+gid)
-            self.addTask(sortTaskLabel,sortCmd,dependencies=callTask,memMb=self.params.callMemMb)
-            nextStepWait.add(sortTaskLabel)
-
-        sortRealignBam("normal", segFiles.normalRealign)
-        sortRealignBam("tumor", segFiles.tumorRealign)
-
     return nextStepWait
 
 
@@ -295,9 +281,6 @@ class PathInfo(SharedPathInfo):
     def getTmpSegmentRegionPath(self, segStr) :
         return os.path.join( self.getTmpSegmentDir(), "somatic.callable.regions.%s.bed" % (segStr))
 
-    def getTmpUnsortRealignBamPath(self, segStr, label) :
-        return os.path.join( self.getTmpSegmentDir(), "%s.%s.unsorted.realigned.bam" % (label, segStr))
-
     def getTmpRealignBamPath(self, segStr, label) :
         return os.path.join( self.getTmpSegmentDir(), "%s.%s.realigned.bam" % (label, segStr))
 
@@ -22,7 +22,7 @@
 python version of cat to work around portability/quoting and shell line limits
 """
 
-import os, sys
+import os, shutil, sys
 
 
 def ensureDir(d):
@@ -72,10 +72,12 @@ def main() :
 
     (options,args) = getOptions()
 
-    ofp = open(options.outFile,"w")
+    # copy in binary mode so that binary inputs are concatenated unchanged:
+    ofp = open(options.outFile,"wb")
     for arg in args :
-        for line in open(arg) :
-            ofp.write(line)
+        ifp = open(arg,"rb")
+        shutil.copyfileobj(ifp, ofp)
+        ifp.close()
 
 
 main()